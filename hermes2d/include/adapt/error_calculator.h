@@ -125,6 +125,10 @@ namespace Hermes
       std::vector<MeshFunctionSharedPtr<Scalar> > coarse_solutions;
       std::vector<MeshFunctionSharedPtr<Scalar> > fine_solutions;
 
+      /// Cached geometry of curved elements (if on, see Mesh::set_geometry_caching()) of the meshes of the coarse solutions
+      /// followed by those of the fine solutions, obtained outside of the parallel region.
+      std::vector<MeshGeometryCache*> geometry_caches;
+
       /// Absolute / Relative error.
       CalculatedErrorType errorType;
 
@@ -0,0 +1,75 @@
+/// This file is part of Hermes2D.
+///
+/// Hermes2D is free software: you can redistribute it and/or modify
+/// it under the terms of the GNU General Public License as published by
+/// the Free Software Foundation, either version 2 of the License, or
+/// (at your option) any later version.
+///
+/// Hermes2D is distributed in the hope that it will be useful,
+/// but WITHOUT ANY WARRANTY;without even the implied warranty of
+/// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+/// GNU General Public License for more details.
+///
+/// You should have received a copy of the GNU General Public License
+/// along with Hermes2D. If not, see <http:///www.gnu.org/licenses/>.
+
+#ifndef __H2D_DG_FACE_CONNECTIVITY_H
+#define __H2D_DG_FACE_CONNECTIVITY_H
+
+#include "neighbor_search.h"
+
+namespace Hermes
+{
+  namespace Hermes2D
+  {
+    /// Neighbors of all inner edges of the active elements of a mesh - what NeighborSearch::set_active_edge() finds, i.e. the
+    /// neighbor elements, their local edges and orientations, and the transformations of the central element (way down), resp.
+    /// of the neighbor (way up).
+    /// Built once for a mesh and valid until the mesh changes (its seq), so that DG assembling does not search for the neighbors
+    /// again in each assembling (Newton iteration, time step).
+    /// Read-only after construction, shared by the assembling threads.
+    /// Internal.
+    template<typename Scalar>
+    class HERMES_API DGFaceConnectivity
+    {
+    public:
+      /// Finds the neighbors of all inner edges of all active elements of the mesh.
+      DGFaceConnectivity(MeshSharedPtr mesh);
+
+      /// The mesh has not changed since the construction.
+      bool is_up_to_date() const;
+
+      MeshSharedPtr get_mesh() const;
+
+      /// The equivalent of ns->set_active_edge(edge) for ns->central_el, using the stored neighbors.
+      /// \return false if the edge is not stored (boundary edge, element that was not active at the construction), ns is not changed then.
+      bool set_active_edge(NeighborSearch<Scalar>* ns, int edge) const;
+
+    private:
+      /// One edge of one element.
+      struct Face
+      {
+        /// NeighborSearch::NeighborhoodType.
+        int neighborhood_type;
+        /// 0 for boundary edges.
+        unsigned int n_neighbors;
+        /// Index of the first neighbor in neighbors, neighbor_edges.
+        unsigned int first_neighbor;
+        /// Index of the first transformation in transformations - one per neighbor on the way down (central), one on the way up (neighbor).
+        unsigned int first_transformation;
+      };
+
+      MeshSharedPtr mesh;
+      /// Seq of the mesh at the construction.
+      unsigned int mesh_seq;
+
+      /// Per element id, the index of the face of its edge 0 in faces, -1 for elements that are not active.
+      std::vector<int> first_face;
+      std::vector<Face> faces;
+      std::vector<Element*> neighbors;
+      std::vector<typename NeighborSearch<Scalar>::NeighborEdgeInfo> neighbor_edges;
+      std::vector<typename NeighborSearch<Scalar>::Transformations> transformations;
+    };
+  }
+}
+#endif
@@ -25,6 +25,7 @@
 #include "exceptions.h"
 #include "mixins2d.h"
 #include "multimesh_dg_neighbor_tree.h"
+#include "dg_face_connectivity.h"
 #include "discrete_problem/discrete_problem_selective_assembler.h"
 
 namespace Hermes
@@ -40,18 +41,34 @@ namespace Hermes
     {
     public:
       /// Constructor copying data from DiscreteProblemThreadAssembler.
-      DiscreteProblemDGAssembler(DiscreteProblemThreadAssembler<Scalar>* threadAssembler, const std::vector<SpaceSharedPtr<Scalar> > spaces, std::vector<MeshSharedPtr>& meshes);
+      /// \param[in] element_first_states See init_element_first_states(), shared (read-only) by all threads.
+      /// \param[in] face_connectivities Neighbors of the edges of meshes (one per mesh in meshes), shared (read-only) by all threads, may be nullptr.
+      DiscreteProblemDGAssembler(DiscreteProblemThreadAssembler<Scalar>* threadAssembler, const std::vector<SpaceSharedPtr<Scalar> > spaces, std::vector<MeshSharedPtr>& meshes, int** element_first_states,
+        DGFaceConnectivity<Scalar>** face_connectivities = nullptr);
 
       /// Destructor.
       ~DiscreteProblemDGAssembler();
 
       /// Initialize assembling for a state.
-      void init_assembling_one_state(Traverse::State* current_state_);
+      /// \param[in] current_state_index Index of the state in the array of all states the element_first_states were calculated for.
+      void init_assembling_one_state(Traverse::State* current_state_, unsigned int current_state_index);
       /// Assemble DG forms.
       void assemble_one_state();
       /// Deinitialize assembling for a state.
       void deinit_assembling_one_state();
 
+      /// For every mesh in meshes, the index of the first state (in states) each element (by id) is a part of.
+      /// An interface is assembled (the matrix DG forms) in the state that comes later in the order of states - the one whose
+      /// neighbors on all meshes have already been a part of some state up to and including the current one.
+      /// This is what the serial assembling with marking the elements as visited does, only independent of the order in which the
+      /// states are processed by the threads.
+      /// With more threads, the additions to the matrix and vectors are recorded (DGAssemblyRecordMatrix, DGAssemblyRecordVector)
+      /// and added in the order of the states afterwards, so that the values are bitwise identical to the serial ones.
+      /// The arrays for meshes occurring more than once in meshes are shared.
+      static int** init_element_first_states(Traverse::State** states, unsigned int num_states, const std::vector<MeshSharedPtr>& meshes);
+      /// Deallocation of init_element_first_states().
+      static void free_element_first_states(int** element_first_states, const std::vector<MeshSharedPtr>& meshes);
+
       static unsigned int dg_order;
     private:
       /// There is a matrix form set on DG_INNER_EDGE area or not.
@@ -80,6 +97,13 @@ namespace Hermes
       unsigned int* num_neighbors;
       bool** processed;
 
+      /// See init_element_first_states().
+      int** element_first_states;
+      /// Index of current_state in the states element_first_states were calculated for.
+      unsigned int current_state_index;
+      /// See the constructor.
+      DGFaceConnectivity<Scalar>** face_connectivities;
+
       // Neighbor psss, refmaps.
       PrecalcShapesetAssembling ** npss;
       RefMap ** nrefmaps;
@@ -114,6 +138,62 @@ namespace Hermes
       void debug();
 #endif
     };
+
+    /// Matrix recording the additions in their order instead of adding them.
+    /// With several threads, DiscreteProblem gives one to each thread for DG assembling, and adds the records of the threads
+    /// (each of them has a contiguous range of states) to the global matrix one after another - the same additions in the
+    /// same order as in the serial assembling.
+    template<typename Scalar>
+    class HERMES_API DGAssemblyRecordMatrix : public SparseMatrix<Scalar>
+    {
+    public:
+      DGAssemblyRecordMatrix(unsigned int size);
+
+      virtual void alloc();
+      virtual void free();
+      virtual Scalar get(unsigned int m, unsigned int n) const;
+      virtual void zero();
+      virtual void add(unsigned int m, unsigned int n, Scalar v);
+      /// Records the entries outside of the Dirichlet rows and columns, one by one.
+      virtual void add(unsigned int m, unsigned int n, Scalar *mat, int *rows, int *cols, const int size);
+      virtual double get_fill_in() const;
+      virtual void export_to_file(const char* filename, const char* var_name, Algebra::MatrixExportFormat fmt, char* number_format = "%lf");
+
+      /// Adds the recorded values to mat in the recorded order, and clears the record.
+      void add_to(SparseMatrix<Scalar>* mat);
+
+    private:
+      std::vector<unsigned int> rows;
+      std::vector<unsigned int> cols;
+      std::vector<Scalar> values;
+    };
+
+    /// Vector recording the additions in their order instead of adding them, see DGAssemblyRecordMatrix.
+    template<typename Scalar>
+    class HERMES_API DGAssemblyRecordVector : public Vector<Scalar>
+    {
+    public:
+      DGAssemblyRecordVector(unsigned int size);
+
+      virtual void alloc(unsigned int ndofs);
+      virtual void free();
+      virtual Scalar get(unsigned int idx) const;
+      virtual Vector<Scalar>* duplicate() const;
+      virtual void extract(Scalar *v) const;
+      virtual void zero();
+      virtual Vector<Scalar>* change_sign();
+      virtual void set(unsigned int idx, Scalar y);
+      virtual void add(unsigned int idx, Scalar y);
+      virtual void add(unsigned int n, unsigned int *idx, Scalar *y);
+      virtual void export_to_file(const char* filename, const char* var_name, Algebra::MatrixExportFormat fmt, char* number_format = "%lf");
+
+      /// Adds the recorded values to vec in the recorded order, and clears the record.
+      void add_to(Vector<Scalar>* vec);
+
+    private:
+      std::vector<unsigned int> indices;
+      std::vector<Scalar> values;
+    };
   }
 }
 #endif
\ No newline at end of file
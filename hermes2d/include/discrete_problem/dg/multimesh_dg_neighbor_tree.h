@@ -31,7 +31,11 @@ namespace Hermes
     {
     public:
       /// The main method, for the passed neighbor searches, it will process all multi-mesh neighbor consolidation.
-      static void process_edge(NeighborSearch<Scalar>** neighbor_searches, unsigned char num_neighbor_searches, unsigned int& num_neighbors, bool*& processed);
+      /// \param[out] processed For each neighbor, whether the interface has already been assembled from the neighbor side - all the neighbor
+      /// elements (one per neighbor search) have the first state (element_first_states[i][id]) not later than current_state_index.
+      /// With element_first_states == nullptr, nothing is processed.
+      static void process_edge(NeighborSearch<Scalar>** neighbor_searches, unsigned char num_neighbor_searches, unsigned int& num_neighbors, bool*& processed,
+        int** element_first_states = nullptr, unsigned int current_state_index = 0);
 
     private:
       /// Initialize the tree for traversing multimesh neighbors.
@@ -83,6 +83,32 @@ namespace Hermes
       /// Without the matrix.
       bool assemble(Vector<Scalar>* rhs);
 
+      /// Assembling of several right-hand sides (load cases) at once.
+      /// The matrix (if any) is assembled once, all right-hand sides in the same traversal - every vector form goes into
+      /// the vector of rhs_block given by its load case (see Form::set_load_case()). The Dirichlet lift is added to all of them.
+      /// \param[in] num_rhs Number of load cases, rhs_block is (re)allocated to num_rhs vectors of the length of the number of DOFs.
+      bool assemble(Scalar*& coeff_vec, SparseMatrix<Scalar>* mat, SimpleVectorBlock<Scalar>* rhs_block, unsigned int num_rhs);
+      /// Light version passing nullptr for the coefficient vector. External solutions
+      /// are initialized with zeros.
+      bool assemble(SparseMatrix<Scalar>* mat, SimpleVectorBlock<Scalar>* rhs_block, unsigned int num_rhs);
+
+      /// Residual-only assembling (the vector forms), e.g. for the trial steps of a line search.
+      /// With set_lean_residual_assembling() on, the traversal states, the thread assemblers (their copies of the weak formulation)
+      /// and the assembly lists of the last assemble() call are reused as long as the spaces and the meshes do not change,
+      /// no matrix-related setup (sparse structure, Dirichlet lift matrix, static condensation) is done.
+      /// Otherwise (and for DG, static condensation), the same as assemble(coeff_vec, rhs).
+      /// Changes of the weak formulation in place since that assemble() call (its forms, their parameters, external functions)
+      /// are not detected - call invalidate_lean_residual_assembling() after them.
+      bool assemble_residual(Scalar*& coeff_vec, Vector<Scalar>* rhs);
+
+      /// Keep the traversal states of each assemble() for assemble_residual().
+      /// Default: false.
+      void set_lean_residual_assembling(bool to_set = true);
+
+      /// Drops what assemble_residual() reuses from the last assemble(), the next assemble_residual() is a full assemble().
+      /// Called by set_time(), set_time_step(), set_weak_formulation(), set_spaces().
+      void invalidate_lean_residual_assembling();
+
       /// set time information for time-dependent problems.
       void set_time(double time);
       void set_time_step(double time_step);
@@ -112,14 +138,33 @@ namespace Hermes
         }
       }
 
+      /// Static condensation of the bubble DOFs.
+      /// The bubble functions are eliminated element by element (the Schur complement of the element matrix), so that the assembled
+      /// matrix only couples the vertex and edge DOFs. The DOF numbering of the spaces is kept - the rows of the condensed DOFs
+      /// are the identity with a zero right-hand side, and reconstruct_condensed_dofs() computes them after the solve
+      /// (LinearSolver does that automatically).
+      /// Only for linear problems (not with NewtonSolver, PicardSolver, which do not reconstruct the condensed DOFs),
+      /// spaces (and external functions) on one mesh, not for DG forms and for multiple right-hand sides.
+      void set_static_condensation(bool to_set = true);
+      bool get_static_condensation() const;
+      /// Computes the condensed DOFs of the solution vector from the other ones, using the element data of the last assembling
+      /// (the matrix and the right-hand side).
+      void reconstruct_condensed_dofs(Scalar* sln_vector) const;
+
       /// See Hermes::Mixins::Loggable.
       virtual void set_verbose_output(bool to_set);
 
     protected:
+      /// The common worker of all assemble() methods - exactly one of rhs, rhs_block is used (or none).
+      bool assemble_internal(Scalar*& coeff_vec, SparseMatrix<Scalar>* mat, Vector<Scalar>* rhs, SimpleVectorBlock<Scalar>* rhs_block, unsigned int num_rhs);
+
       /// Initialize states.
       void init_assembling(Traverse::State**& states, unsigned int& num_states, std::vector<MeshSharedPtr>& meshes);
       void deinit_assembling(Traverse::State** states, unsigned  int num_states);
 
+      /// Assembling over the (initialized) states - the previous iterations and the parallel loop over the states.
+      void assemble_states(Scalar*& coeff_vec, Traverse::State** states, unsigned int num_states, std::vector<MeshSharedPtr>& meshes);
+
       /// RungeKutta helpers.
       void set_RK(int original_spaces_count, bool force_diagonal_blocks = nullptr, Table* block_weights = nullptr);
 
@@ -130,6 +175,14 @@ namespace Hermes
       /// Init function. Common code for the constructors.
       void init(bool linear, bool dirichlet_lift_accordingly, bool use_direct_for_Dirichlet_lift);
 
+      /// Static condensation - the condensed DOFs and the element data for the current spaces, passed to the assemblers.
+      void init_static_condensation();
+      void free_static_condensation();
+
+      /// DG face connectivities of the meshes (one per mesh in meshes), up to date, created if necessary.
+      /// The returned array is to be freed (free_with_check), the connectivities are owned by this instance.
+      DGFaceConnectivity<Scalar>** init_dg_face_connectivities(const std::vector<MeshSharedPtr>& meshes);
+
       /// Space instances for all equations in the system.
       std::vector<SpaceSharedPtr<Scalar> > spaces;
       int spaces_size;
@@ -143,6 +196,7 @@ namespace Hermes
       /// DiscreteProblemMatrixVector methods.
       bool set_matrix(SparseMatrix<Scalar>* mat);
       bool set_rhs(Vector<Scalar>* rhs);
+      void set_rhs_block(SimpleVectorBlock<Scalar>* rhs_block);
       void invalidate_matrix();
 
       /// Assembly data.
@@ -151,6 +205,34 @@ namespace Hermes
       /// Select the right things to assemble
       DiscreteProblemSelectiveAssembler<Scalar> selectiveAssembler;
 
+      /// Static condensation.
+      bool static_condensation;
+      /// Per DOF, if it is condensed (a bubble DOF).
+      bool* condensed_dofs;
+      /// Seq numbers of spaces condensed_dofs were calculated for.
+      std::vector<int> condensed_dofs_sp_seq;
+      /// DOF assignment stamps of spaces condensed_dofs were calculated for.
+      std::vector<unsigned int> condensed_dofs_dof_stamps;
+      /// Per element id.
+      StaticCondensationElement<Scalar>* condensation_elements;
+      int condensation_elements_count;
+
+      /// Neighbors of the inner edges of the meshes of the last DG assembling, reused while the meshes do not change.
+      std::vector<DGFaceConnectivity<Scalar>*> dg_face_connectivities;
+
+      /// Lean residual assembling - the states of the last assemble() and what they were created for.
+      bool lean_residual_assembling;
+      Traverse::State** lean_residual_states;
+      unsigned int lean_residual_num_states;
+      std::vector<MeshSharedPtr> lean_residual_meshes;
+      std::vector<unsigned int> lean_residual_mesh_seqs;
+      std::vector<int> lean_residual_space_seqs;
+      /// The weak formulation the thread assemblers were set up with.
+      WeakForm<Scalar>* lean_residual_wf;
+      /// The states are reusable (the spaces, meshes and the weak formulation did not change).
+      bool lean_residual_states_reusable() const;
+      void free_lean_residual_states();
+
       template<typename T> friend class Solver;
       template<typename T> friend class LinearSolver;
       template<typename T, typename S> friend class AdaptSolver;
@@ -73,9 +73,15 @@ namespace Hermes
 
         virtual bool set_matrix(SparseMatrix<Scalar>* mat);
         virtual bool set_rhs(Vector<Scalar>* rhs);
+        /// Several right-hand sides (load cases) assembled at once, used instead of current_rhs.
+        virtual void set_rhs_block(SimpleVectorBlock<Scalar>* rhs_block);
+
+        /// Whether any right-hand side is being assembled.
+        inline bool rhs_assembled() const { return this->current_rhs || this->current_rhs_block; }
 
         SparseMatrix<Scalar>* current_mat;
         Vector<Scalar>* current_rhs;
+        SimpleVectorBlock<Scalar>* current_rhs_block;
       };
     }
 
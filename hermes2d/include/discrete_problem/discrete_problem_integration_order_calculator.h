@@ -92,6 +92,8 @@ namespace Hermes
 
       /// For initialization of external functions.
       Solution<Scalar>** u_ext;
+      /// Orders of the previous iterations if they are not given by u_ext (evaluated directly from the coefficient vector).
+      int* u_ext_fn_orders;
       Func<Hermes::Ord>** ext_orders;
       Func<Hermes::Ord>** u_ext_orders;
       Traverse::State* current_state;
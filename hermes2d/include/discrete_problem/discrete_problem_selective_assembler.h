@@ -94,6 +94,27 @@ namespace Hermes
       bool vector_structure_reusable;
       Vector<Scalar>* previous_rhs;
 
+      /// Builds the matrix structure from the DOF-to-element graph given by the states, in parallel.
+      /// Not used for DG, there the neighbors contribute as well and the pages of SparseMatrix are used.
+      SparsityPattern* build_sparsity_pattern(std::vector<SpaceSharedPtr<Scalar> >& spaces, Traverse::State** states, unsigned int num_states, int ndof);
+
+      /// The cached pattern was built for the current seq numbers and DOF numberings of spaces (and the same blocks).
+      bool sparsity_pattern_reusable(std::vector<SpaceSharedPtr<Scalar> >& spaces, int ndof) const;
+      void invalidate_sparsity_pattern();
+
+      /// Cached matrix structure, shared by all matrices assembled with unchanged spaces.
+      SparsityPattern* sparsity_pattern;
+      /// Seq numbers of spaces the cached matrix structure was built for.
+      std::vector<int> sparsity_pattern_sp_seq;
+      /// DOF assignment stamps of spaces the cached matrix structure was built for (Space::assign_dofs() does not change seq).
+      std::vector<unsigned int> sparsity_pattern_dof_stamps;
+      bool sparsity_pattern_force_diagonal_blocks;
+
+      /// Static condensation (see DiscreteProblem::set_static_condensation()): per DOF, if it is condensed,
+      /// such DOFs only have the diagonal entry. nullptr if the static condensation is off.
+      const bool* condensed_dofs;
+      bool sparsity_pattern_condensed;
+
       friend class DiscreteProblem < Scalar > ;
       friend class DiscreteProblemIntegrationOrderCalculator < Scalar > ;
       friend class Solver < Scalar > ;
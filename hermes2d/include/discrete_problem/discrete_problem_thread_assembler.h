@@ -27,6 +27,29 @@ namespace Hermes
 {
   namespace Hermes2D
   {
+    /// Data of one element kept by the static condensation (see DiscreteProblem::set_static_condensation()).
+    /// With the local system split into the remaining (s) and the condensed bubble (b) DOFs, the condensed DOFs
+    /// of the solution are x_b = y - X x_s.
+    template<typename Scalar>
+    struct StaticCondensationElement
+    {
+      /// Numbers of the remaining and of the condensed DOFs.
+      int ns, nb;
+      /// The ns remaining DOFs followed by the nb condensed ones.
+      int* dofs;
+      /// LU decomposition of A_bb, for a right-hand side assembled without the matrix.
+      Scalar** lu_bb;
+      int* pivots;
+      /// A_sb, ns x nb, row-major.
+      Scalar* A_sb;
+      /// X = A_bb^{-1} A_bs, nb x ns, row-major.
+      Scalar* X;
+      /// y = A_bb^{-1} f_b.
+      Scalar* y;
+
+      void free();
+    };
+
     /// Discrete problem thread assembler class
     /// \brief This class is a one-thread (non-DG) assembly worker.
     ///
@@ -54,6 +77,14 @@ namespace Hermes
       /// Initializes the Transformable array for doing transformations.
       void init_assembling(Solution<Scalar>** u_ext_sln, const std::vector<SpaceSharedPtr<Scalar> >& spaces, bool add_dirichlet_lift);
 
+      /// Previous iterations evaluated directly from the coefficient vector - instead of from the u_ext Solutions - as the linear
+      /// combination of the (already calculated) shape function values of the assembly lists.
+      /// Has to be called before init_assembling(), coeff_vec == nullptr switches back to the u_ext Solutions.
+      /// @param[in] dof_offsets Per space, the value of a dof is coeff_vec[dof + dof_offsets[space]].
+      void set_u_ext_coeff_vec(const Scalar* coeff_vec, int* dof_offsets, bool add_dir_lift);
+      /// Calculate the orders of the previous iterations on the current state (the direct evaluation).
+      void calc_u_ext_fn_orders(const std::vector<SpaceSharedPtr<Scalar> >& spaces);
+
       /// Initialize Func storages.
       void init_funcs_wf();
       void init_funcs_space();
@@ -69,7 +100,9 @@ namespace Hermes
       void deinit_funcs_wf();
       bool funcs_wf_initialized;
       /// Initializitation of u-ext values into Funcs
-      void init_u_ext_values(int order);
+      /// @param[in] shape_funcs Values of the shape functions of the assembly lists at this order (the direct evaluation from
+      /// the coefficient vector), nullptr if they are to be calculated.
+      void init_u_ext_values(int order, Func<double>* (*shape_funcs)[H2D_MAX_LOCAL_BASIS_SIZE] = nullptr);
       /// Initializitation of ext values into Funcs
       template<typename Geom>
       void init_ext_values(Func<Scalar>** target_array, std::vector<MeshFunctionSharedPtr<Scalar> >& ext, std::vector<UExtFunctionSharedPtr<Scalar> >& u_ext_fns, int order, Func<Scalar>** u_ext_func, Geom* geometry);
@@ -89,6 +122,13 @@ namespace Hermes
       /// De-initialization of 1 state assembly
       void deinit_assembling_one_state();
 
+      /// Static condensation - the local DOFs of the state (the remaining ones first) and zeroing of the local system.
+      void init_condensation_one_state();
+      /// Static condensation - positions of the entries of the assembly list among the local DOFs (-1 for Dirichlet DOFs).
+      void get_condensation_positions(AsmList<Scalar>* al, int* positions);
+      /// Static condensation - the Schur complement of the local system into the matrix / rhs, the element data for the reconstruction.
+      void condense_one_state();
+
       /// De-initialization.
       void deinit_assembling();
 
@@ -108,6 +148,15 @@ namespace Hermes
       Solution<Scalar>** u_ext;
       std::vector<Transformable *> fns;
 
+      /// The direct evaluation of previous iterations, see set_u_ext_coeff_vec().
+      const Scalar* u_ext_coeff_vec;
+      int u_ext_dof_offsets[H2D_MAX_COMPONENTS];
+      bool u_ext_add_dir_lift;
+      /// Orders of the previous iterations on the current state.
+      int u_ext_fn_orders[H2D_MAX_COMPONENTS];
+      /// Storage for shape function values not available in funcs.
+      Func<double>* u_ext_shape_func;
+
       /// For selective reassembling.
       DiscreteProblemSelectiveAssembler<Scalar>* selectiveAssembler;
 
@@ -151,6 +200,20 @@ namespace Hermes
       friend class DiscreteProblem < Scalar > ;
       friend class DiscreteProblemDGAssembler < Scalar > ;
 
+      /// Static condensation, see DiscreteProblem::set_static_condensation().
+      /// Per DOF, if it is condensed, nullptr if the static condensation is off.
+      const bool* condensed_dofs;
+      /// Per element id, written in condense_one_state().
+      StaticCondensationElement<Scalar>* condensation_elements;
+      /// The local system of the current state: DOFs, matrix (row-major), right-hand side of the vector forms and the Dirichlet lift.
+      std::vector<int> condensation_dofs;
+      int condensation_ns;
+      std::vector<Scalar> condensation_matrix;
+      std::vector<Scalar> condensation_rhs;
+      std::vector<Scalar> condensation_lift;
+      int condensation_positions_i[H2D_MAX_LOCAL_BASIS_SIZE];
+      int condensation_positions_j[H2D_MAX_LOCAL_BASIS_SIZE];
+
       /// Experimental.
       bool** reusable_DOFs;
       bool** reusable_Dirichlet;
@@ -89,6 +89,10 @@ namespace Hermes
 
       virtual void copy(const MeshFunction<Scalar>* sln);
 
+      /// Like copy(), but the mesh is copied as well, so that the result does not share anything with 'sln'
+      /// and can be used (e.g. on another thread) while the original mesh is being refined or deleted.
+      void copy_with_mesh(const Solution<Scalar>* sln);
+
       /// Sets solution equal to Dirichlet lift only, solution vector = 0.
       void set_dirichlet_lift(SpaceSharedPtr<Scalar> space);
 
@@ -172,8 +176,21 @@ namespace Hermes
       /// Converts a coefficient vector into a Solution.
       virtual void set_coeff_vector(SpaceSharedPtr<Scalar> space, const Vector<Scalar>* vec, bool add_dir_lift, int start_index);
 
+      /// Converts a coefficient vector into a Solution, in parallel over the active elements.
+      /// If the solution has been created from the same (unchanged) space before, only the elements whose coefficients
+      /// have changed since are converted again (e.g. in Newton iterations / time steps reusing one Solution instance).
       virtual void set_coeff_vector(SpaceSharedPtr<Scalar> space, const Scalar* coeffs, bool add_dir_lift, int start_index);
 
+      /// The last coefficient vector (the part belonging to the space) this solution has been created from,
+      /// and what identifies the space, for the incremental set_coeff_vector().
+      Scalar* coeff_vec_copy;
+      int coeff_vec_space_seq;
+      int coeff_vec_mesh_seq;
+      /// The DOF numbering can change without a change of the seq (set_essential_bcs() + assign_dofs()).
+      unsigned int coeff_vec_dof_stamp;
+      bool coeff_vec_add_dir_lift;
+      bool coeff_vec_reusable(SpaceSharedPtr<Scalar> space, bool add_dir_lift) const;
+
       SolutionType sln_type;
       SpaceType space_type;
 
@@ -203,8 +220,8 @@ namespace Hermes
       void load_exact_solution(int number_of_components, SpaceSharedPtr<Scalar> space, bool complexness,
         double x_real, double y_real, double x_complex, double y_complex);
 
-      /// Utility.
-      Scalar x[H2D_MAX_INTEGRATION_POINTS_COUNT], y[H2D_MAX_INTEGRATION_POINTS_COUNT], tx[H2D_MAX_INTEGRATION_POINTS_COUNT];
+      /// Utility - the integration points in the reference domain of the element.
+      double x[H2D_MAX_INTEGRATION_POINTS_COUNT], y[H2D_MAX_INTEGRATION_POINTS_COUNT];
 
 #pragma region friends
       friend class RefMap;
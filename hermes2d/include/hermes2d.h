@@ -24,6 +24,7 @@
 #include "solver/picard_solver.h"
 #include "solver/linear_solver.h"
 #include "solver/nox_solver.h"
+#include "solver/pmultigrid_solver.h"
 
 #include "boundary_conditions/essential_boundary_conditions.h"
 
@@ -37,6 +38,7 @@
 #include "mesh/mesh_reader_h2d.h"
 #include "mesh/mesh_reader_h2d_xml.h"
 #include "mesh/mesh_reader_h2d_bson.h"
+#include "mesh/mesh_reader_h2d_binary.h"
 #include "mesh/mesh_reader_h1d_xml.h"
 #include "mesh/mesh_reader_exodusii.h"
 
@@ -75,6 +77,7 @@
 #include "views/scalar_view.h"
 #include "views/vector_base_view.h"
 #include "views/vector_view.h"
+#include "views/output_queue.h"
 
 #include "refinement_selectors/element_to_refine.h"
 #include "refinement_selectors/selector.h"
@@ -20,6 +20,9 @@
 #include "../shapeset/shapeset_common.h"
 #include "../shapeset/precalc.h"
 
+/// Bound on the number of bubble functions of the reference mapping (quads of the maximum order of H1ShapesetJacobi).
+#define H2D_MAX_REFMAP_BUBBLES 81
+
 namespace Hermes
 {
   namespace Hermes2D
@@ -185,11 +188,13 @@ namespace Hermes
       template<typename T> friend class Adapt;
       template<typename T> friend class KellyTypeAdapt;
       friend class RefMap;
+      friend class MeshHashGrid;
       friend class Mesh;
       friend class MeshReader;
       friend class MeshReaderH2D;
       friend class MeshReaderH2DXML;
       friend class MeshReaderH2DBSON;
+      friend class MeshReaderH2DBinary;
     };
 
     class CurvMapStatic
@@ -204,10 +209,15 @@ namespace Hermes
       /// Calculate the H1 seminorm products (\phi_i, \phi_j) for all 0 <= i, j < n, n is the number of bubble functions
       double** calculate_bubble_projection_matrix(short* indices, ElementMode2D mode);
       void precalculate_cholesky_projection_matrices_bubble();
+      /// Tabulation of the edge functions for calc_edge_projection().
+      void precalculate_edge_fn_values();
 
       /// projection matrix for each edge is the same
       double** edge_proj_matrix;
       unsigned short edge_proj_matrix_size;
+      /// Values of the edge functions l_2, ..., l_{edge_proj_matrix_size + 1} at the points of the maximum order 1D quadrature,
+      /// [i][j] is l_{i + 2} at the point j.
+      double** edge_fn_values;
       /// projection matrix for triangle bubbles
       double** bubble_proj_matrix_tri;
       /// projection matrix for quad bubbles
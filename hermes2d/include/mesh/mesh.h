@@ -106,6 +106,30 @@ namespace Hermes
       std::map<int, MarkerArea*> marker_areas;
 #pragma endregion
 
+#pragma region MeshCompactView
+      /// Returns the compact (structure-of-arrays) view of the active elements, see MeshCompactView.
+      /// The view is created on the first call, and re-created if the mesh has changed since.
+      /// Not thread-safe - call before entering a parallel region, and then use the returned pointer.
+      MeshCompactView* get_compact_view();
+
+      MeshCompactView* compact_view;
+#pragma endregion
+
+#pragma region MeshGeometryCache
+      /// Turns on / off caching of the geometry of the curved elements (see MeshGeometryCache) across assemblings.
+      /// \param[in] max_bytes The cap on the memory used by the cache.
+      void set_geometry_caching(bool to_set = true, size_t max_bytes = 256 * 1024 * 1024);
+
+      /// Returns the geometry cache, nullptr if the caching is off.
+      /// The cache is emptied if the mesh has changed since the last call, otherwise the values inserted since the last call are published.
+      /// Not thread-safe - call before entering a parallel region, and then use the returned pointer.
+      MeshGeometryCache* get_geometry_cache();
+
+      MeshGeometryCache* geometry_cache;
+      bool geometry_caching;
+      size_t geometry_cache_max_bytes;
+#pragma endregion
+
 #pragma region getters
       /// Retrieves an element by its id number.
       Element* get_element(int id) const;
@@ -154,6 +178,13 @@ namespace Hermes
       /// refine vertically.
       void refine_element_id(int id, int refinement = 0);
 
+      /// Refines the elements ids[i] according to refinements[i] (same meaning as in refine_element_id()) in one batch.
+      /// The storage for the new elements and nodes is allocated at once (and what is not used is freed at the end),
+      /// the topological changes are applied serially in the order given (they go through the shared node hash table,
+      /// the resulting ids are the same as with refine_element_id() called one by one), and the reference mapping
+      /// coefficients of all new curved elements are calculated in parallel at the end.
+      void refine_elements(const std::vector<int>& ids, const std::vector<int>& refinements);
+
       /// Refines all elements.
       /// \param[in] refinement Same meaning as in refine_element_id().
       void refine_all_elements(int refinement = 0, bool mark_as_initial = false);
@@ -289,6 +320,7 @@ namespace Hermes
         friend class Space < double > ;
         friend class Space < std::complex<double> > ;
         friend class Mesh;
+        friend class MeshReaderH2DBinary;
       };
 
       /// Frees all data associated with the mesh.
@@ -362,6 +394,10 @@ namespace Hermes
       int parents_size;
 
       int  get_edge_degree(Node* v1, Node* v2);
+      /// The refinement of e needed for the mesh to be n-irregular (-1 for none), see regularize().
+      int  get_regularization_refinement(Element* e, int n);
+      /// Adds the active elements having an edge that contains the edge (v1, v2) to elements.
+      void add_elements_containing_edge(Node* v1, Node* v2, std::vector<int>& elements);
       void assign_parent(Element* e, int i);
       void regularize_triangle(Element* e);
       void regularize_quad(Element* e);
@@ -385,6 +421,7 @@ namespace Hermes
       friend class MeshHashGrid;
       friend class MeshReaderH2D;
       friend class MeshReaderH2DBSON;
+      friend class MeshReaderH2DBinary;
       friend class MeshReaderH2DXML;
       friend class MeshReaderH1DXML;
       friend class MeshReaderExodusII;
@@ -442,6 +479,19 @@ namespace Hermes
       void refine_quad(Element* e, int refinement, Element** sons_out = nullptr);
       void refine_triangle_to_triangles(Element* e, Element** sons = nullptr);
 
+      /// Updates the reference mapping coefficients of a new curved element, or postpones it
+      /// until the end of the batch in refine_elements().
+      void update_son_refmap_coeffs(Element* son);
+      /// Batch of refine_elements() in progress - the curved elements waiting for update_son_refmap_coeffs().
+      bool refmap_coeffs_postponed;
+      std::vector<Element*> postponed_refmap_coeffs_elements;
+      /// Updates the reference mapping coefficients of the postponed elements, in parallel.
+      void update_postponed_refmap_coeffs();
+
+      /// Updates the reference mapping coefficients of all used curved elements (in parallel), and the inverse reference map
+      /// orders of all used elements. For the mesh readers, once the curves are assigned.
+      void update_all_refmap_coeffs();
+
       /// Computing vector length.
       static double vector_length(double a_1, double a_2);
 
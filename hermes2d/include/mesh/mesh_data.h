@@ -29,6 +29,22 @@ namespace Hermes
 {
   namespace Hermes2D
   {
+    /// Read-only contents of a whole file, memory-mapped where available (read at once otherwise).
+    /// Used by the mesh loaders.
+    class MeshFileContents
+    {
+    public:
+      MeshFileContents(const char* filename);
+      ~MeshFileContents();
+
+      /// The contents, nullptr if the file could not be read (or is empty).
+      const char* data;
+      size_t size;
+
+    private:
+      bool mapped;
+    };
+
     /// \brief Class to stored 2d mesh parameters.
     /// .
     /// The MeshData class organizes all the necessary data structures required to store information in the input mesh file.
@@ -49,6 +65,9 @@ namespace Hermes
       /// Restores ';' to blank spaces
       std::string restore(std::string &str);
 
+      /// Empties all the parsed data.
+      void clear();
+
     public:
       /// Map for storing variables in input mesh file
       std::map< std::string, std::vector< std::string > > vars_;
@@ -111,6 +130,15 @@ namespace Hermes
       /// This function parses a given input mesh file line by line and extracts the necessary information into the MeshData class variables
       void parse_mesh(void);
 
+      /// Fast path of parse_mesh().
+      /// The file is memory-mapped and tokenized by a hand-written scanner, the entries of the 'vertices', 'elements'
+      /// and 'boundaries' blocks are parsed in parallel.
+      /// Only files with literal values (no variables, no NURBS curves) are handled, for any other file false is returned
+      /// (and this instance is left empty), and parse_mesh() has to be used.
+      /// The same goes for entries that parse_mesh() reads in a way that depends on the surrounding entries
+      /// (unquoted integer markers of triangles, quoted numbers), so that both paths always give the same MeshData.
+      bool parse_mesh_fast(void);
+
       /// MeshData Constructor
       MeshData(const std::string &mesh_file);
 
@@ -0,0 +1,102 @@
+// This file is part of Hermes2D
+//
+// Hermes2D is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// Hermes2D is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Hermes2D; if not, see <http://www.gnu.prg/licenses/>.
+
+#ifndef _MESH_READER_H2D_BINARY_H_
+#define _MESH_READER_H2D_BINARY_H_
+
+#include "mesh_reader.h"
+
+namespace Hermes
+{
+  namespace Hermes2D
+  {
+    /// Mesh reader from a native binary snapshot.
+    ///
+    /// Unlike the other formats, the snapshot stores the current state of the mesh - the whole node table,
+    /// all (active and inactive) elements with the refinement tree, the marker conversion tables
+    /// and the CurvMap data including the projected coefficients of the reference mapping.
+    /// Loading is one bulk read followed by fixing up of the pointers, no refinements are replayed
+    /// and no reference mappings are re-projected, so that restarting an adapted computation is cheap.
+    /// All ids (of nodes as well as elements) are preserved, including the ones to be reused by further refinements.
+    ///
+    /// The format is versioned and specific to the platform (endianness, size of int / double) it has been saved on.
+    ///
+    /// Typical usage:
+    /// MeshSharedPtr mesh(new Mesh);
+    /// Hermes::Hermes2D::MeshReaderH2DBinary mloader;
+    /// mloader.save("adapted.h2db", mesh);
+    /// ...
+    /// try
+    /// {
+    ///&nbsp;mloader.load("adapted.h2db", mesh);
+    /// }
+    /// catch(Exceptions::MeshLoadFailureException& e)
+    /// {
+    ///&nbsp;e.print_msg();
+    ///&nbsp;return -1;
+    /// }
+    class HERMES_API MeshReaderH2DBinary : public MeshReader
+    {
+    public:
+      MeshReaderH2DBinary();
+      virtual ~MeshReaderH2DBinary();
+
+      /// This method loads a single mesh from a file.
+      virtual void load(const char *filename, MeshSharedPtr mesh);
+
+      /// This method saves a single mesh to a file.
+      void save(const char *filename, MeshSharedPtr mesh);
+
+      /// Current version of the format.
+      static const unsigned int version = 1;
+
+    private:
+      /// Fixed-size records of the node and element tables.
+      struct NodeRecord
+      {
+        int id;
+        int ref;
+        int p1, p2;
+        /// Edge nodes.
+        int marker;
+        int elem[2];
+        unsigned char type, bnd, used, pad;
+        /// Vertex nodes.
+        double x, y;
+      };
+
+      struct ElementRecord
+      {
+        int id;
+        int marker;
+        int parent;
+        int vn[H2D_MAX_NUMBER_VERTICES];
+        /// Edge nodes for active elements, sons for inactive ones.
+        int en_sons[H2D_MAX_ELEMENT_SONS];
+        /// Index of the CurvMap in the file, -1 for elements without one.
+        int curv_map;
+        unsigned short iro_cache;
+        unsigned char used, active, nvert, center_set;
+        double area, diameter, x_center, y_center;
+      };
+
+      void save_curve(FILE* f, Curve* curve);
+      Curve* load_curve(const char*& p, const char* end);
+      void save_markers(FILE* f, Mesh::MarkersConversion& markers);
+      void load_markers(const char*& p, const char* end, Mesh::MarkersConversion& markers);
+    };
+  }
+}
+#endif
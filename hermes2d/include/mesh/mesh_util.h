@@ -26,13 +26,14 @@ namespace Hermes
     class MeshHashGrid;
     class Mesh;
     class Nurbs;
+    class RefMap;
 
     typedef std::tr1::shared_ptr<Hermes::Hermes2D::Mesh> MeshSharedPtr;
 
     class MeshHashGridElement
     {
     public:
-      MeshHashGridElement(double lower_left_x, double lower_left_y, double upper_right_x, double upper_right_y, int depth = 0);
+      MeshHashGridElement(MeshHashGrid* grid, double lower_left_x, double lower_left_y, double upper_right_x, double upper_right_y, int depth = 0);
       ~MeshHashGridElement();
 
       /// Return the Element
@@ -43,6 +44,9 @@ namespace Hermes
       bool belongs(Hermes::Hermes2D::Element* element);
       void insert(Hermes::Hermes2D::Element* element);
 
+      /// The grid, for the bounding boxes of the elements.
+      MeshHashGrid* grid;
+
       double lower_left_x;
       double lower_left_y;
       double upper_right_x;
@@ -85,26 +89,48 @@ namespace Hermes
       static Arc* load_arc(MeshSharedPtr mesh, int id, Node** en, int p1, int p2, double angle, bool skip_check = false);
     };
 
+    /// Point location in a mesh - a uniform grid over the bounding box of the mesh, with adaptively subdivided cells.
+    /// The cells store the elements whose bounding boxes they intersect. The bounding boxes of curved elements enclose
+    /// the whole reference mapping (bounded through its coefficients), so every point of the domain is found in its cell.
     class MeshHashGrid
     {
     public:
       MeshHashGrid(Mesh* mesh);
       ~MeshHashGrid();
 
-      // smallest box interval_x X interval_y in which element is contained. If element is curvilinear, has to be made larger
-      // if we knew more about the shape of curvilinear element, this increase could be smaller
+      /// Box in which the element is contained - the box of the vertices, for curved elements enlarged by the sum of the
+      /// absolute values of the edge and bubble coefficients of the reference mapping times the bounds of their shape functions
+      /// (the vertex part is a convex combination of the vertices).
       static void elementBoundingBox(Hermes::Hermes2D::Element* element, double2& p1, double2& p2);
 
+      /// The bounding box of an active element as stored at the construction.
+      inline void get_element_bounding_box(Hermes::Hermes2D::Element* element, double2& p1, double2& p2) const
+      {
+        const double* box = &this->element_bounding_boxes[4 * element->id];
+        p1[0] = box[0];
+        p1[1] = box[1];
+        p2[0] = box[2];
+        p2[1] = box[3];
+      }
+
       Hermes::Hermes2D::Element* getElement(double x, double y);
 
       int get_mesh_seq() const;
 
     private:
+      /// Upper bound of the absolute value of a shape function of the reference mapping on the reference element: the maximum
+      /// at the points of a uniform grid (of the square, for triangles in the collapsed coordinates) enlarged according to
+      /// the Markov inequality for the polynomial degree. Calculated once per shape function.
+      static double get_shape_fn_bound(int index, ElementMode2D mode);
+
       MeshHashGridElement* m_grid[GRID_SIZE][GRID_SIZE];
 
       double intervals_x[GRID_SIZE + 1];
       double intervals_y[GRID_SIZE + 1];
 
+      /// Per element id, bottom left x, y and top right x, y.
+      std::vector<double> element_bounding_boxes;
+
       /// For detecting changes to the mesh that would require the hashgrid to be recalculated.
       int mesh_seq;
     };
@@ -123,6 +149,108 @@ namespace Hermes
       int mesh_seq;
     };
 
+    /// Compact (structure-of-arrays) view of the active elements of a Mesh.
+    /// The active element ids are stored contiguously, together with the data of those elements that is typically
+    /// needed in hot loops (number of vertices, vertex / edge node ids), so that iterating over the active
+    /// elements does not have to skip the inactive ones, nor chase the Node pointers through the HashTable.
+    /// Obtained by Mesh::get_compact_view(), which rebuilds it whenever the mesh changes.
+    class HERMES_API MeshCompactView
+    {
+    public:
+      MeshCompactView(Mesh* mesh);
+      ~MeshCompactView();
+
+      /// For detecting changes to the mesh that would require the view to be recalculated.
+      int get_mesh_seq() const;
+
+      /// Checks that the view still describes the mesh.
+      bool is_up_to_date(Mesh* mesh) const;
+
+      /// Number of active elements.
+      int num_active;
+      /// Ids of the active elements, ascending.
+      int* active_ids;
+
+      /// Per active element (indexed 0 .. num_active - 1).
+      unsigned char* nvert;
+      /// Per active element, H2D_MAX_NUMBER_VERTICES entries each, -1 for the fourth entry of triangles.
+      int* vertex_ids;
+      int* edge_ids;
+
+    private:
+      int mesh_seq;
+      int mesh_num_active;
+      int max_element_id;
+      int max_node_id;
+    };
+
+    /// Geometry of the curved elements of a Mesh at the integration points - what RefMap otherwise recomputes by summing over
+    /// all reference map shape functions each time an element is assembled: the jacobians together with the inverse reference maps,
+    /// the physical coordinates, and the edge tangents.
+    /// Stored per (element id, sub-element transformation, quadrature order), valid as long as the mesh does not change.
+    /// Entries are only added while the memory used stays below the cap, nothing is evicted.
+    /// Obtained by Mesh::get_geometry_cache() if enabled by Mesh::set_geometry_caching(), used by the RefMaps of the assembling
+    /// and of the error calculation (only with the standard quadrature).
+    /// Read-mostly: get() reads the published entries without any locking, insert() adds pending entries (under a lock, which is
+    /// only taken on a miss). The pending entries are published by publish(), called by Mesh::get_geometry_cache() outside of
+    /// parallel regions - i.e. the values computed in one assembling are used from the next one on.
+    class HERMES_API MeshGeometryCache
+    {
+    public:
+      MeshGeometryCache(Mesh* mesh, size_t max_bytes);
+
+      /// What is stored, the tangent of the edge i is GeometryCacheTangent + i.
+      enum Item
+      {
+        /// The jacobians followed by the inverse reference maps (4 values per point).
+        GeometryCacheInvRefMap = 0,
+        GeometryCachePhysX = 1,
+        GeometryCachePhysY = 2,
+        /// 3 values per point.
+        GeometryCacheTangent = 3
+      };
+
+      /// Checks that the cache still belongs to the mesh.
+      bool is_up_to_date(Mesh* mesh) const;
+
+      /// Copies the stored (published) values to data.
+      /// \return false if the values are not stored.
+      bool get(int element_id, uint64_t sub_idx, int item, int order, double* data) const;
+
+      /// Stores size values as pending, unless they are already stored, or the cap would be exceeded.
+      void insert(int element_id, uint64_t sub_idx, int item, int order, const double* data, int size);
+
+      /// Makes the pending values available to get().
+      /// Must not be called while other threads use the cache.
+      void publish();
+
+      /// The (approximate) memory used, in bytes.
+      size_t get_size_in_bytes() const;
+
+      size_t get_max_bytes() const;
+
+    private:
+      struct Key
+      {
+        int element_id;
+        int item;
+        int order;
+        uint64_t sub_idx;
+        bool operator<(const Key& other) const;
+      };
+
+      /// Published, not changed while the cache is in use by the threads.
+      std::map<Key, std::vector<double> > entries;
+      /// Inserted since the last publish().
+      std::map<Key, std::vector<double> > pending_entries;
+      size_t size_in_bytes;
+      size_t max_bytes;
+
+      int mesh_seq;
+      int mesh_num_active;
+      int max_element_id;
+    };
+
     /*  node and son numbering on a triangle:
 
     -Triangle to triangles refinement
@@ -242,6 +370,13 @@ namespace Hermes
     if (((e) = (mesh)->get_element_fast(_id))->used) \
     if ((e)->active)
 
+    /// Same as for_all_active_elements, only goes through the contiguous array of active element ids of Mesh::get_compact_view().
+    /// The mesh must not be refined / unrefined inside the loop.
+#define for_all_active_elements_compact(e, mesh) \
+    for (MeshCompactView* _view = (mesh)->get_compact_view(); _view != nullptr; _view = nullptr) \
+    for (int _i = 0, _max = _view->num_active; _i < _max; _i++) \
+    if (((e) = (mesh)->get_element_fast(_view->active_ids[_i])) != nullptr)
+
 #define for_all_inactive_elements(e, mesh) \
     for (int _id = 0, _max = (mesh)->get_max_element_id(); _id < _max; _id++) \
     if (((e) = (mesh)->get_element_fast(_id))->used) \
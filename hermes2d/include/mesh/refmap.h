@@ -162,10 +162,19 @@ namespace Hermes
 
       static void set_element_iro_cache(Element* element);
 
+      /// For internal use only.
+      /// The geometry of curved elements is taken from / stored to the cache (of the mesh of the elements this RefMap is used for).
+      /// nullptr (the default) for no caching.
+      /// Only used with the standard quadrature (g_quad_2d_std), the cache does not distinguish quadratures.
+      void set_geometry_cache(MeshGeometryCache* geometry_cache);
+
     private:
       /// re-init the storage
       void reinit_storage();
 
+      /// The geometry of the active element is taken from / stored to geometry_cache.
+      bool use_geometry_cache() const;
+
       H1ShapesetJacobi ref_map_shapeset;
       PrecalcShapesetAssembling ref_map_pss;
 
@@ -199,6 +208,8 @@ namespace Hermes
 
       Quad2D* quad_2d;
 
+      MeshGeometryCache* geometry_cache;
+
       void calc_inv_ref_map(int order);
 
       /// Quickly calculates the (hard-coded) reference mapping for elements with constant jacobians
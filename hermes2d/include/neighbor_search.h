@@ -15,6 +15,7 @@ namespace Hermes
   namespace Hermes2D
   {
     template<typename Scalar> class ErrorThreadCalculator;
+    template<typename Scalar> class DGFaceConnectivity;
 
     /*** Class NeighborSearch. ***/
 
@@ -111,7 +112,8 @@ namespace Hermes
       void set_active_edge(int edge);
 
       /// Enhancement of set_active_edge for multimesh assembling.
-      bool set_active_edge_multimesh(const int& edge);
+      /// \param[in] face_connectivity If passed, the neighbors found in advance are used instead of searching for them.
+      bool set_active_edge_multimesh(const int& edge, const DGFaceConnectivity<Scalar>* face_connectivity = nullptr);
 
       /// Extract transformations in the correct direction from the provided sub_idx.
       std::vector<unsigned int> get_transforms(uint64_t sub_idx) const;
@@ -459,6 +461,7 @@ namespace Hermes
       template<typename T> friend class DiscreteProblemDGAssembler;
       template<typename T> friend class DiscreteProblemIntegrationOrderCalculator;
       template<typename T> friend class ErrorThreadCalculator<T>::DGErrorCalculator;
+      template<typename T> friend class DGFaceConnectivity;
     };
   }
 }
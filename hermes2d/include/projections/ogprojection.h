@@ -24,6 +24,8 @@ namespace Hermes
 {
   namespace Hermes2D
   {
+    template <typename Scalar> class LinearSolver;
+
     /// \brief Class for (global) orthogonal projecting. If the projection is not necessary (if a solution belongs to the space), then its solution vector is used.
     template<typename Scalar>
     class HERMES_API OGProjection : public Hermes::Mixins::Loggable
@@ -69,6 +71,8 @@ namespace Hermes
       \param newton_tol              (optional) the newton tolerance.
       \param newton_max_iter         (optional) the newton maximum iterator.
       */
+      /// L2 spaces projected in the L2 norm are projected element by element (see OGProjectionEngine), with a temporary engine -
+      /// nothing is kept between calls. Use an OGProjectionEngine to keep the factorized mass blocks between projections.
       static void project_global(SpaceSharedPtr<Scalar> space, MeshFunctionSharedPtr<Scalar> source_meshfn,
         Scalar* target_vec, NormType proj_norm = HERMES_UNSET_NORM);
 
@@ -91,6 +95,9 @@ namespace Hermes
         std::vector<MeshFunctionSharedPtr<Scalar> > source_slns, std::vector<MeshFunctionSharedPtr<Scalar> > target_slns,
         std::vector<NormType> proj_norms = std::vector<NormType>(), bool delete_old_mesh = false);
 
+      /// The norm used for projecting onto the space if none is specified (matches the type of the space).
+      static NormType get_default_norm(SpaceSharedPtr<Scalar> space);
+
     protected:
       /// Underlying function for global orthogonal projection.
       /// Not intended for the user. NOTE: the weak form here must be
@@ -99,6 +106,84 @@ namespace Hermes
       /// PDE, the PDE will just be solved.
       static void project_internal(SpaceSharedPtr<Scalar> space, WeakFormSharedPtr<Scalar> proj_wf, Scalar* target_vec);
     };
+
+    /// \brief Orthogonal projection keeping its data between projections (between time levels, adaptivity steps, ...).
+    /// - L2 spaces projected in the L2 norm: the mass matrix is block diagonal, so only the right-hand side is assembled
+    /// globally and the element systems are solved independently, in parallel. The factorized mass blocks of elements
+    /// with a constant jacobian are cached per (shapeset, element mode, order), other elements factorize their own blocks.
+    /// - Other spaces / norms: the factorized global mass matrix is reused for as long as the target space (its seq, mesh
+    /// and DOF numbering) and the norm stay the same, further projections only assemble the right-hand side.
+    ///
+    /// Typical usage:
+    /// OGProjectionEngine<double> projection;
+    /// for (...time steps...)
+    /// {
+    ///&nbsp;...
+    ///&nbsp;projection.project(space, sln_prev_time_level, sln_projected);
+    /// }
+    template<typename Scalar>
+    class HERMES_API OGProjectionEngine : public Hermes::Mixins::Loggable
+    {
+    public:
+      OGProjectionEngine();
+      virtual ~OGProjectionEngine();
+
+      /// Project source_meshfn onto space, the result as a coefficient vector.
+      void project(SpaceSharedPtr<Scalar> space, MeshFunctionSharedPtr<Scalar> source_meshfn,
+        Scalar* target_vec, NormType proj_norm = HERMES_UNSET_NORM);
+
+      /// Wrapper that delivers a Solution instead of coefficient vector.
+      void project(SpaceSharedPtr<Scalar> space, MeshFunctionSharedPtr<Scalar> source_meshfn,
+        MeshFunctionSharedPtr<Scalar> target_sln, NormType proj_norm = HERMES_UNSET_NORM);
+
+      /// Release all the kept data.
+      void free();
+
+    protected:
+      /// Element-wise projection onto an L2 space in the L2 norm.
+      void project_local(SpaceSharedPtr<Scalar> space, MeshFunctionSharedPtr<Scalar> source_meshfn, Scalar* target_vec);
+
+      /// Projection with a global mass matrix, reused while possible.
+      void project_global(SpaceSharedPtr<Scalar> space, MeshFunctionSharedPtr<Scalar> source_meshfn,
+        Scalar* target_vec, NormType norm);
+
+      /// Factorized (Cholesky) mass matrix of one element.
+      struct MassBlock
+      {
+        unsigned short cnt;
+        double** a;
+        double* p;
+      };
+
+      /// Calculates and factorizes the mass matrix of the element e (with the assembly list al) into block.
+      /// With refmap == nullptr, the jacobian is omitted (the block of the reference element).
+      static void calc_mass_block(PrecalcShapeset* pss, RefMap* refmap, Element* e, int order, AsmList<Scalar>* al,
+        std::vector<double>& values, MassBlock* block);
+
+      /// Key of reference_mass_blocks - the (decoded) orders, so that no combination can collide with another one.
+      struct MassBlockKey
+      {
+        MassBlockKey(Shapeset* shapeset, Element* e, int order);
+        bool operator<(const MassBlockKey& other) const;
+
+        int shapeset_id;
+        int mode;
+        int h_order;
+        int v_order;
+      };
+
+      /// Factorized mass blocks of the reference elements.
+      std::map<MassBlockKey, MassBlock> reference_mass_blocks;
+
+      /// The global projection.
+      LinearSolver<Scalar>* linear_solver;
+      WeakFormSharedPtr<Scalar> global_wf;
+      SpaceSharedPtr<Scalar> global_space;
+      int global_space_seq;
+      int global_mesh_seq;
+      unsigned int global_dof_stamp;
+      NormType global_norm;
+    };
   }
 }
 #endif
@@ -236,6 +236,7 @@ namespace Hermes
       friend class CurvMap;
       friend class CurvMapStatic;
       friend class RefMap;
+      friend class MeshHashGrid;
       template<typename Scalar> friend class RefinementSelectors::H1ProjBasedSelector;
       template<typename Scalar> friend class RefinementSelectors::L2ProjBasedSelector;
       template<typename Scalar> friend class RefinementSelectors::HcurlProjBasedSelector;
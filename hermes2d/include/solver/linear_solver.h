@@ -78,6 +78,16 @@ namespace Hermes
       /// \param[in] coeff_vec initiall guess.
       virtual void solve(Scalar* coeff_vec);
 
+      /// Solve the problem for several right-hand sides (load cases) with the same matrix.
+      /// The matrix is assembled once, all right-hand sides in one traversal (vector forms are distributed by Form::set_load_case()),
+      /// and all the systems are solved with one factorization of the matrix.
+      /// The solutions are then stored one after another in get_sln_vector(), the k-th one starting at get_sln_vector() + k * ndof.
+      /// \param[in] num_rhs Number of load cases.
+      void solve_multiple(unsigned int num_rhs);
+
+      /// The right-hand sides of the last solve_multiple().
+      const SimpleVectorBlock<Scalar>* get_rhs_block() const;
+
       /// Get sln vector.
       Scalar* get_sln_vector();
 
@@ -94,6 +104,19 @@ namespace Hermes
       /// State querying helpers.
       virtual bool isOkay() const;
       inline std::string getClassName() const { return "LinearSolver"; }
+
+      /// Storage of the right-hand sides for solve_multiple().
+      SimpleVectorBlock<Scalar> rhs_block;
+
+      /// The spaces the reusable matrix was assembled on - with set_jacobian_constant(), the matrix is only reused while
+      /// none of them changed (seq, mesh, DOF numbering).
+      std::vector<int> jacobian_space_seqs;
+      std::vector<int> jacobian_mesh_seqs;
+      std::vector<unsigned int> jacobian_dof_stamps;
+      /// Stores the state of the spaces after the matrix is assembled.
+      void store_jacobian_spaces();
+      /// Sets jacobian_reusable to false if the spaces changed since the matrix was assembled.
+      void check_jacobian_spaces();
     };
   }
 }
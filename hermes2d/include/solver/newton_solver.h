@@ -99,7 +99,20 @@ namespace Hermes
       /// See Hermes::Mixins::Loggable.
       virtual void set_verbose_output(bool to_set);
 
+      /// Residuals (the trial steps of the automatic damping, the steps with a reused jacobian) are assembled by
+      /// DiscreteProblem::assemble_residual(), reusing the traversal states of the last jacobian assembling.
+      /// Together with set_line_search(NewtonLineSearchCubic), a damped step costs about one residual assembling per trial.
+      /// If the weak formulation is changed in place during solve() (e.g. in the callbacks of OutputAttachable),
+      /// invalidate_lean_residual_assembling() has to be called after the change.
+      /// Default: false.
+      void set_lean_residual_assembling(bool to_set = true);
+
+      /// See DiscreteProblem::invalidate_lean_residual_assembling(), called at the beginning of each solve().
+      void invalidate_lean_residual_assembling();
+
       virtual void assemble_residual(bool store_previous_residual);
+      /// The residuals of the GMRES iterations of the Jacobian-free Newton-Krylov steps, without process_vector_output().
+      virtual void assemble_jfnk_residual();
       /// \return Information if the jacobian structure was reused.
       virtual bool assemble_jacobian(bool store_previous_jacobian);
       /// \return Information if the jacobian structure was reused.
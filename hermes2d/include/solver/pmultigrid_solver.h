@@ -0,0 +1,175 @@
+// This file is part of Hermes2D
+//
+// Copyright (c) 2009 hp-FEM group at the University of Nevada, Reno (UNR).
+// Email: hpfem-group@unr.edu, home page: http://www.hpfem.org/.
+//
+// Hermes2D is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published
+// by the Free Software Foundation; either version 2 of the License,
+// or (at your option) any later version.
+//
+// Hermes2D is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Hermes2D; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+/*! \file pmultigrid_solver.h
+\brief Hierarchical p-multigrid solver.
+*/
+#ifndef __H2D_PMULTIGRID_SOLVER_H_
+#define __H2D_PMULTIGRID_SOLVER_H_
+
+#include "solvers/linear_matrix_solver.h"
+#include "space/space.h"
+
+namespace Hermes
+{
+  namespace Hermes2D
+  {
+    /// Smoothers of PMultigridSolver, both scaled by the diagonal of the matrix.
+    enum PMultigridSmoother
+    {
+      /// Damped Jacobi, the damping is 4 / (3 * lambda_max(D^{-1}A)).
+      PMultigridJacobi = 0,
+      /// Chebyshev polynomial on the interval [0.1, 1.1] * lambda_max(D^{-1}A).
+      PMultigridChebyshev = 1
+    };
+
+    /// \brief Hierarchical p-multigrid solver, usable also as a preconditioner.
+    ///
+    /// The levels are copies of the (fine) spaces with the element orders limited by p_max - 1, p_max - 2, ..., 1.
+    /// With a hierarchic shapeset (H1ShapesetJacobi, the Legendre L2 / Hcurl / Hdiv shapesets), the basis of a lower level is a subset
+    /// of the basis of the higher one, so that the prolongation extends the coefficient vector by zeros and the restriction truncates it,
+    /// both through the DOF maps of the spaces (assembly lists of the same element on the two levels).
+    /// The level matrices are the Galerkin products P^T A P, i.e. submatrices of the fine matrix, nothing is reassembled.
+    /// The smoothing runs on the level matrices in the CSR format, the coarsest (p = 1) problem is solved by the direct solver
+    /// (create_linear_solver() with use_direct_solver = true).
+    ///
+    /// Typical usage:<br>
+    /// // matrix, rhs assembled on the spaces (e.g. by DiscreteProblem), CSRMatrix, CSCMatrix or SymmetricCSCMatrix.<br>
+    /// Hermes::Hermes2D::PMultigridSolver<double> mg(spaces, matrix, rhs);<br>
+    /// mg.set_tolerance(1e-10, Hermes::Solvers::RelativeTolerance);<br>
+    /// mg.solve();<br>
+    /// double* sln_vector = mg.get_sln_vector();<br>
+    /// <br>
+    /// // As a preconditioner (one V-cycle from a zero initial guess), after setup() or solve():<br>
+    /// mg.apply(r, z);<br>
+    /// <br>
+    /// // Through the Hermes2D solvers (LinearSolver, NewtonSolver, PicardSolver), which pass the spaces of their DiscreteProblem:<br>
+    /// Hermes::HermesCommonApi.set_integral_param_value(Hermes::matrixSolverType, Hermes::SOLVER_PMULTIGRID);<br>
+    template<typename Scalar>
+    class HERMES_API PMultigridSolver : public Hermes::Solvers::LoopSolver < Scalar >, public Hermes::Preconditioners::VectorPrecond < Scalar >
+    {
+    public:
+      PMultigridSolver(SpaceSharedPtr<Scalar> space, SparseMatrix<Scalar>* matrix, Vector<Scalar>* rhs);
+      PMultigridSolver(std::vector<SpaceSharedPtr<Scalar> > spaces, SparseMatrix<Scalar>* matrix, Vector<Scalar>* rhs);
+      /// The spaces are to be set by set_spaces() before setup() / solve().
+      PMultigridSolver(SparseMatrix<Scalar>* matrix, Vector<Scalar>* rhs);
+      virtual ~PMultigridSolver();
+
+      virtual void free();
+
+      /// The (fine) spaces the matrix is assembled on, the levels are rebuilt if these differ from the current ones.
+      void set_spaces(std::vector<SpaceSharedPtr<Scalar> > spaces);
+
+      /// Creation function for create_linear_solver() (SOLVER_PMULTIGRID), set in the constructor of Api2D.
+      static Hermes::Solvers::LinearMatrixSolver<Scalar>* create_pmultigrid_solver(SparseMatrix<Scalar>* matrix, Vector<Scalar>* rhs);
+
+      /// V-cycles (or CG preconditioned by V-cycles, see set_krylov_acceleration()) from a zero initial guess.
+      virtual void solve();
+      /// V-cycles (or CG preconditioned by V-cycles) from the initial guess.
+      virtual void solve(Scalar* initial_guess);
+
+      /// Builds the hierarchy for the current matrix. Called by solve() unless the reuse scheme is HERMES_REUSE_MATRIX_STRUCTURE_COMPLETELY
+      /// (and the spaces did not change), to be called before apply() if that is used without solve().
+      void setup();
+
+      /// One V-cycle from a zero initial guess, z = M^{-1} r.
+      virtual void apply(const Scalar* r, Scalar* z);
+
+      virtual int get_num_iters();
+      virtual double get_residual_norm();
+      virtual int get_matrix_size();
+
+      /// Number of levels (1 for a problem with p_max = 1).
+      int get_num_levels() const;
+
+      /// Smoother, and its number of pre- and post-smoothing sweeps (the degree of the polynomial for Chebyshev).
+      /// Default: Chebyshev, 2.
+      void set_smoother(PMultigridSmoother smoother, int sweeps);
+
+      /// Use CG preconditioned by the V-cycle instead of plain V-cycles in solve().
+      /// For symmetric positive definite matrices.
+      void set_krylov_acceleration(bool to_set = true);
+
+    protected:
+      /// One level of the hierarchy, level 0 is the fine one.
+      struct Level
+      {
+        int ndof;
+        /// The matrix in CSR, owned except for the fine level of a CSRMatrix input.
+        CSRMatrix<Scalar>* matrix;
+        bool own_matrix;
+        Scalar* inv_diag;
+        /// Estimate of the largest eigenvalue of D^{-1}A.
+        double lambda_max;
+        /// Indices of the DOFs of the next coarser level among the DOFs of this level (nullptr for the coarsest level).
+        int* coarse_dofs;
+        /// Work vectors.
+        Scalar* x;
+        Scalar* b;
+        Scalar* r;
+        Scalar* d;
+      };
+
+      void init();
+
+      /// Level spaces and the DOF maps - only when the spaces changed.
+      void create_levels();
+      /// Level matrices, diagonals, eigenvalue estimates and the coarse solver.
+      void create_level_matrices();
+      void free_level_matrices();
+      void free_levels();
+
+      void v_cycle(int level_i);
+      void smooth(int level_i);
+      /// Coarsest problem.
+      void coarse_solve();
+      /// r = b - A x.
+      void residual(CSRMatrix<Scalar>* matrix, const Scalar* x, const Scalar* b, Scalar* r) const;
+      /// y = A x.
+      void multiply(CSRMatrix<Scalar>* matrix, const Scalar* x, Scalar* y) const;
+      /// Power iterations for lambda_max(D^{-1}A).
+      double estimate_lambda_max(Level& level);
+      /// The fine matrix in CSR.
+      CSRMatrix<Scalar>* get_fine_csr_matrix(bool& own);
+
+      /// Plain V-cycles, respectively PCG, on the fine level, sln contains the initial guess.
+      void solve_v_cycles(const Scalar* rhs);
+      void solve_pcg(const Scalar* rhs);
+
+      std::vector<SpaceSharedPtr<Scalar> > spaces;
+      /// Space seqs the levels were created for.
+      std::vector<int> spaces_seq;
+      std::vector<Level> levels;
+
+      /// The coarsest level direct solver.
+      SparseMatrix<Scalar>* coarse_matrix;
+      Vector<Scalar>* coarse_rhs;
+      Hermes::Solvers::LinearMatrixSolver<Scalar>* coarse_solver;
+      bool coarse_factorized;
+
+      bool levels_ready;
+      PMultigridSmoother smoother;
+      int sweeps;
+      bool krylov_acceleration;
+
+      int num_iters;
+      double residual_norm;
+    };
+  }
+}
+#endif
@@ -83,6 +83,9 @@ namespace Hermes
     protected:
       virtual bool isOkay() const;
 
+      /// Passes the spaces of the DiscreteProblem to a matrix solver that needs them (PMultigridSolver, SOLVER_PMULTIGRID).
+      void set_linear_matrix_solver_spaces(Hermes::Solvers::LinearMatrixSolver<Scalar>* linear_matrix_solver);
+
       /// FE problem being solved.
       DiscreteProblem<Scalar>* dp;
 
@@ -67,6 +67,7 @@ namespace Hermes
     {
       template<typename Scalar> class BaseView;
       template<typename Scalar> class VectorBaseView;
+      template<typename Scalar> class OutputQueue;
       class Orderizer;
       class OrderView;
     };
@@ -180,12 +181,28 @@ namespace Hermes
       /// Internal. Used by DiscreteProblem to detect changes in the space.
       int get_seq() const;
 
+      /// Internal. Used by DiscreteProblem to detect a new DOF numbering - assign_dofs() renumbers without changing seq.
+      /// Unique over all spaces, changed by assign_dofs() only if the numbering can differ from the last one.
+      unsigned int get_dof_assignment_stamp() const;
+
       /// Obtains an boundary conditions
       EssentialBCs<Scalar>* get_essential_bcs() const;
 
       /// Obtains an assembly list for the given element.
       virtual void get_element_assembly_list(Element* e, AsmList<Scalar>* al) const;
 
+      /// Caching of the assembly lists of all active elements, off by default.
+      /// The cache is built (in parallel) by update_assembly_list_cache(), called by the assembling (DiscreteProblem), by
+      /// Solution::set_coeff_vector() and by OGProjection before their loops over elements. get_element_assembly_list()
+      /// then copies the stored list instead of collecting the vertex, edge (with the constraints of hanging nodes) and bubble
+      /// functions again. A change of the space (its seq) or of the mesh, assign_dofs() and update_essential_bc_values()
+      /// invalidate the cache.
+      void set_assembly_list_caching(bool to_set = true);
+
+      /// Builds the assembly list cache if the caching is on and the cache is not up to date.
+      /// Not thread-safe - call before entering a parallel region.
+      void update_assembly_list_cache();
+
       /// Internal. Obtains the order of an edge, according to the minimum rule.
       virtual int get_edge_order(Element* e, int edge) const;
 
@@ -375,6 +392,8 @@ namespace Hermes
       unsigned int seq;
       /// Tracking changes - mark call to assign_dofs().
       unsigned int seq_assigned;
+      /// Tracking changes - changed by every call to assign_dofs().
+      unsigned int dof_assignment_stamp;
       /// Tracking changes - mesh.
       int mesh_seq;
 
@@ -455,12 +474,45 @@ namespace Hermes
       virtual void reset_dof_assignment();
       virtual void assign_vertex_dofs() = 0;
       virtual void assign_edge_dofs() = 0;
-      virtual void assign_bubble_dofs() = 0;
+      /// Default: Shapeset::get_num_bubbles() bubble functions per active element, numbered in the order of the active elements.
+      virtual void assign_bubble_dofs();
+
+      /// Parallel DOF assignment.
+      /// The items (active elements, or nodes) are split into contiguous chunks that are processed in parallel. In each chunk,
+      /// the DOFs are first numbered from zero and counted, then the chunk counts are prefix-summed and the chunks shifted.
+      /// As the chunks follow the order of the serial loop, the numbering is identical to the serial one for any number of threads.
+      /// Number of chunks for num_items items (at most H2D_MAX_DOF_ASSIGNMENT_CHUNKS).
+      int get_dof_assignment_chunk_count(int num_items) const;
+      /// Turns the DOF counts of the chunks into the first DOFs of the chunks (starting at next_dof), advances next_dof.
+      /// \return The number of DOFs in all chunks.
+      int prefix_sum_dof_assignment_chunks(int* chunk_dofs, int num_chunks);
+      /// Assigns get_edge_order_internal(en) + order_increment DOFs to each unconstrained edge node, in the order of the node ids.
+      /// Used by spaces with edge functions only (Hcurl, Hdiv).
+      void assign_edge_dofs_by_node_ids(int order_increment);
+      static const int H2D_MAX_DOF_ASSIGNMENT_CHUNKS = 64;
 
       virtual void get_vertex_assembly_list(Element* e, int iv, AsmList<Scalar>* al) const = 0;
       virtual void get_boundary_assembly_list_internal(Element* e, int surf_num, AsmList<Scalar>* al) const = 0;
       virtual void get_bubble_assembly_list(Element* e, AsmList<Scalar>* al) const;
 
+      /// Assembly list cache - the lists of the active elements in flat arrays (idx, dof, coef), addressed by the element id.
+      bool asmlist_caching;
+      /// The cache is valid for the seq and mesh seq it was built for (assign_dofs() etc. clear this flag).
+      bool asmlist_cache_valid;
+      unsigned int asmlist_cache_seq;
+      int asmlist_cache_mesh_seq;
+      /// Per element id, the index of the first triplet, and the count of triplets (0 for elements that are not stored).
+      std::vector<int> asmlist_cache_offsets;
+      std::vector<unsigned short> asmlist_cache_cnt;
+      std::vector<int> asmlist_cache_idx;
+      std::vector<int> asmlist_cache_dof;
+      std::vector<Scalar> asmlist_cache_coef;
+
+      /// Copies the cached assembly list of e to al.
+      /// \return False if the cache is not up to date or does not contain e, al is not changed then.
+      bool get_cached_element_assembly_list(Element* e, AsmList<Scalar>* al) const;
+      void free_assembly_list_cache();
+
       double** proj_mat;
       double*  chol_p;
 
@@ -508,6 +560,7 @@ namespace Hermes
       friend class Views::Orderizer;
       friend class Views::OrderView;
       template<typename T> friend class Views::VectorBaseView;
+      template<typename T> friend class Views::OutputQueue;
       friend class Adapt < Scalar > ;
       friend class DiscreteProblem < Scalar > ;
       friend class DiscreteProblemDGAssembler < Scalar > ;
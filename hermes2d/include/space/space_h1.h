@@ -58,9 +58,26 @@ namespace Hermes
       /// Common code for the constructors.
       void init(Shapeset* shapeset, int p_init, bool assign_dofs_init = true);
 
+      /// Vertex and edge DOFs are numbered in the order of the first visit of the nodes by the loop over active elements.
+      /// Done in parallel over chunks of active elements, a node belongs to the lowest chunk visiting it, see get_node_chunk_masks().
       virtual void assign_vertex_dofs();
       virtual void assign_edge_dofs();
-      virtual void assign_bubble_dofs();
+
+      /// For each vertex (vertices == true) or edge node of the active elements of a nonzero order, the bit mask of the chunks
+      /// of active elements (see Space::get_dof_assignment_chunk_count()) visiting the node, indexed by node ids.
+      /// Vertex nodes that are constrained are skipped. To be freed by free_with_check().
+      unsigned long long* get_node_chunk_masks(MeshCompactView* view, int num_chunks, bool vertices);
+      /// The lowest chunk in a mask from get_node_chunk_masks().
+      static inline int get_first_chunk(unsigned long long mask)
+      {
+        int c = 0;
+        while (!(mask & 1))
+        {
+          mask >>= 1;
+          c++;
+        }
+        return c;
+      }
 
       virtual void get_vertex_assembly_list(Element* e, int iv, AsmList<Scalar>* al) const;
       virtual void get_boundary_assembly_list_internal(Element* e, int ie, AsmList<Scalar>* al) const;
@@ -58,7 +58,6 @@ namespace Hermes
 
       virtual void assign_vertex_dofs() {}
       virtual void assign_edge_dofs();
-      virtual void assign_bubble_dofs();
 
       virtual void get_vertex_assembly_list(Element* e, int iv, AsmList<Scalar>* al) const {}
       virtual void get_boundary_assembly_list_internal(Element* e, int surf_num, AsmList<Scalar>* al) const;
@@ -0,0 +1,132 @@
+// This file is part of Hermes2D.
+//
+// Hermes2D is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 2 of the License, or
+// (at your option) any later version.
+//
+// Hermes2D is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Hermes2D.  If not, see <http://www.gnu.org/licenses/>.
+/*! \file output_queue.h
+\brief File containing OutputQueue class - asynchronous output of Solutions and Spaces.
+*/
+
+#ifndef __H2D_OUTPUT_QUEUE_H
+#define __H2D_OUTPUT_QUEUE_H
+
+#include "linearizer.h"
+#include "orderizer.h"
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+namespace Hermes
+{
+  namespace Hermes2D
+  {
+    namespace Views
+    {
+      /// OutputQueue moves the output (VTK export of a solution, saving of a solution, VTK export of orders)
+      /// off the solver thread.
+      /// Each call takes a snapshot of its input on the calling thread - for a Solution this is a copy
+      /// of mono_coeffs, elem_orders, elem_coeffs and of the mesh, for a Space a copy of the space on a copy of the mesh -
+      /// and returns. The linearization and the writing are done on background (writer) threads, so that they overlap
+      /// with the next assembly and solve.
+      /// At most max_in_flight snapshots exist at any time, a call that would exceed that blocks
+      /// until one of the writers is done (back-pressure when the disk is slow).
+      /// Typical usage in a time loop:
+      /// OutputQueue<double> output;
+      /// ...
+      ///&nbsp;output.save_solution_vtk(sln, filename, "u");
+      /// ...
+      /// output.wait();
+      template<typename Scalar>
+      class HERMES_API OutputQueue : public Hermes::Mixins::Loggable
+      {
+      public:
+        /// Constructor.
+        /// \param[in] max_in_flight Maximum number of snapshots waiting or being written at the same time.
+        /// \param[in] num_writers Number of background writer threads.
+        OutputQueue(unsigned int max_in_flight = 2, unsigned int num_writers = 1);
+        /// Destructor - waits for all the pending output to be written.
+        /// A failure that has not been reported by wait() or by one of the output calls can only be warned about here,
+        /// call wait() before the OutputQueue goes out of scope to have it rethrown.
+        ~OutputQueue();
+
+        /// Save a Solution in VTK format - see LinearizerMultidimensional::save_solution_vtk.
+        /// Only available for real-valued solutions.
+        void save_solution_vtk(MeshFunctionSharedPtr<Scalar> sln, const char* filename, const char* quantity_name, bool mode_3D = true, int item = H2D_FN_VAL_0);
+
+        /// Save a Solution - see Solution::save.
+        void save(MeshFunctionSharedPtr<Scalar> sln, const char* filename);
+
+        /// Saves the polynomial orders - see Orderizer::save_orders_vtk.
+        void save_orders_vtk(SpaceSharedPtr<Scalar> space, const char* filename);
+
+        /// Sets the criterion passed to the Linearizer used in save_solution_vtk().
+        void set_criterion(LinearizerCriterion criterion);
+
+        /// Blocks until everything enqueued so far is written (flushes the queue).
+        /// If any of the writers failed, the exception is rethrown here (on the calling thread).
+        /// A failure is also rethrown by the next save_solution_vtk(), save() or save_orders_vtk() call;
+        /// it is reported once.
+        void wait();
+
+        /// Number of snapshots waiting or being written.
+        unsigned int get_num_in_flight();
+
+      protected:
+        /// One unit of work for the writer threads, owns its snapshot.
+        class Job
+        {
+        public:
+          virtual ~Job() {};
+          virtual void process() = 0;
+        };
+        class SolutionVTKJob;
+        class SolutionSaveJob;
+        class OrdersVTKJob;
+
+        /// Blocks until the number of snapshots in flight drops below max_in_flight, and reserves a slot.
+        /// Called before the snapshot is taken, so that the memory used by snapshots stays bounded.
+        void acquire_slot();
+        /// Returns a slot reserved by acquire_slot() (job finished or failed to be created).
+        void release_slot();
+        /// Passes the job to the writers. The slot must have been reserved by acquire_slot().
+        void enqueue(Job* job);
+
+        /// Body of a writer thread.
+        void writer_loop();
+
+        /// Rethrows the message caught on a writer thread. Assumes lock.
+        void check_exception();
+
+        /// Snapshot of a Solution - coefficient arrays and a deep copy of the mesh.
+        Solution<Scalar>* snapshot(MeshFunctionSharedPtr<Scalar> sln) const;
+
+        unsigned int max_in_flight;
+        unsigned int in_flight;
+        bool terminate;
+
+        std::deque<Job*> jobs;
+        std::vector<std::thread> writers;
+
+        std::mutex queue_mutex;
+        std::condition_variable job_available;
+        std::condition_variable slot_available;
+
+        /// Message of the first exception caught on a writer thread.
+        std::string exception_message;
+
+        LinearizerCriterion criterion;
+      };
+    }
+  }
+}
+#endif
@@ -37,6 +37,7 @@ namespace Hermes
     template<typename T> class Func;
     template<typename T> class DiscontinuousFunc;
     template<typename T> class InterfaceGeom;
+    template<typename T> class Geom;
     template<typename T> class GeomVol;
     template<typename T> class GeomSurf;
 
@@ -297,9 +298,24 @@ namespace Hermes
       /// scaling factor
       void setScalingFactor(double scalingFactor);
 
+      /// Load case (right-hand side) this form contributes to when several right-hand sides are assembled at once,
+      /// see DiscreteProblem::assemble(SparseMatrix<Scalar>*, SimpleVectorBlock<Scalar>*, unsigned int). Only used for vector forms.
+      void set_load_case(unsigned short load_case);
+
+      /// Called by the assembler once per element (boundary edge) before value() is called for the basis functions there, with the same
+      /// quadrature, geometry and (external) functions value() will get. Meant for quantities independent of the basis functions, e.g.
+      /// (nonlinear) coefficients, that value() would otherwise evaluate again for each basis function (pair).
+      /// \return True if anything was precalculated - this->precalculated is then true in the following value() calls.
+      /// The default does nothing.
+      virtual bool precalculate(int n, double *wt, Func<Scalar> *u_ext[], Geom<double> *e, Func<Scalar> **ext);
+
       unsigned int i;
 
     protected:
+      /// Internal - precalculate() has been called for the element of the current value() calls.
+      /// False outside of the assembling (e.g. error calculation), where value() gets no precalculate().
+      bool precalculated;
+
       /// Set pointer to a WeakForm + handling of internal data.
       void set_weakform(WeakForm<Scalar>* wf);
 
@@ -336,6 +352,8 @@ namespace Hermes
       void set_uExtOffset(int u_ext_offset);
       /// Form will be always multiplied (scaled) with this number.
       double scaling_factor;
+      /// Load case, defaults to 0.
+      unsigned short load_case;
       /// For time-dependent right-hand side functions.
       /// E.g. for Runge-Kutta methods. Otherwise the one time for the whole WeakForm can be used.
       void set_current_stage_time(double time);
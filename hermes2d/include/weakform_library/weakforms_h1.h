@@ -50,6 +50,9 @@ namespace Hermes
         virtual Hermes::Ord ord(int n, double *wt, Func<Hermes::Ord> *u_ext[], Func<Hermes::Ord> *u,
           Func<Hermes::Ord> *v, GeomVol<Hermes::Ord> *e, Func<Ord> **ext) const;
 
+        /// Evaluates the coefficient in the quadrature points once per element.
+        virtual bool precalculate(int n, double *wt, Func<Scalar> *u_ext[], Geom<double> *e, Func<Scalar> **ext);
+
         virtual MatrixFormVol<Scalar>* clone() const;
 
       private:
@@ -57,6 +60,8 @@ namespace Hermes
         Hermes2DFunction<Scalar>* coeff;
         bool own_coeff;
         GeomType gt;
+        /// Coefficient values in the quadrature points of the current element, see precalculate().
+        Scalar coeff_values[H2D_MAX_INTEGRATION_POINTS_COUNT];
       };
 
       /* Default volumetric matrix form \int_{area} const_coeff * spline_coeff'(u_ext[0]) u \nabla u_ext[0] \cdot \nabla v
@@ -83,12 +88,19 @@ namespace Hermes
         virtual Hermes::Ord ord(int n, double *wt, Func<Hermes::Ord> *u_ext[], Func<Hermes::Ord> *u, Func<Hermes::Ord> *v,
           GeomVol<Hermes::Ord> *e, Func<Ord> **ext) const;
 
+        /// Evaluates the coefficient in the quadrature points once per element.
+        virtual bool precalculate(int n, double *wt, Func<Scalar> *u_ext[], Geom<double> *e, Func<Scalar> **ext);
+
         virtual MatrixFormVol<Scalar>* clone() const;
 
       private:
         Hermes1DFunction<Scalar>* coeff;
         bool own_coeff;
         GeomType gt;
+        /// Coefficient values in the quadrature points of the current element, see precalculate().
+        Scalar coeff_values[H2D_MAX_INTEGRATION_POINTS_COUNT];
+        /// Coefficient derivatives in the quadrature points of the current element, see precalculate().
+        Scalar coeff_derivatives[H2D_MAX_INTEGRATION_POINTS_COUNT];
       };
 
       template<typename Scalar>
@@ -175,6 +187,9 @@ namespace Hermes
         virtual Hermes::Ord ord(int n, double *wt, Func<Hermes::Ord> *u_ext[], Func<Hermes::Ord> *v,
           GeomVol<Hermes::Ord> *e, Func<Ord> **ext) const;
 
+        /// Evaluates the coefficient in the quadrature points once per element.
+        virtual bool precalculate(int n, double *wt, Func<Scalar> *u_ext[], Geom<double> *e, Func<Scalar> **ext);
+
         virtual VectorFormVol<Scalar>* clone() const;
 
       private:
@@ -182,6 +197,8 @@ namespace Hermes
         Hermes2DFunction<Scalar>* coeff;
         bool own_coeff;
         GeomType gt;
+        /// Coefficient values in the quadrature points of the current element, see precalculate().
+        Scalar coeff_values[H2D_MAX_INTEGRATION_POINTS_COUNT];
       };
 
       /* Default volumetric vector form \int_{area} const_coeff * function_coeff(x, y) * u_ext[0] * v d\bfx
@@ -206,6 +223,9 @@ namespace Hermes
         virtual Hermes::Ord ord(int n, double *wt, Func<Hermes::Ord> *u_ext[], Func<Hermes::Ord> *v,
           GeomVol<Hermes::Ord> *e, Func<Ord> **ext) const;
 
+        /// Evaluates the coefficient in the quadrature points once per element.
+        virtual bool precalculate(int n, double *wt, Func<Scalar> *u_ext[], Geom<double> *e, Func<Scalar> **ext);
+
         virtual VectorFormVol<Scalar>* clone() const;
 
       private:
@@ -213,6 +233,8 @@ namespace Hermes
         Hermes2DFunction<Scalar>* coeff;
         bool own_coeff;
         GeomType gt;
+        /// Coefficient values in the quadrature points of the current element, see precalculate().
+        Scalar coeff_values[H2D_MAX_INTEGRATION_POINTS_COUNT];
       };
 
       /* Default volumetric vector form \int_{area} const_coeff * spline_coeff(u_ext[0]) *
@@ -239,12 +261,17 @@ namespace Hermes
         virtual Hermes::Ord ord(int n, double *wt, Func<Hermes::Ord> *u_ext[], Func<Hermes::Ord> *v,
           GeomVol<Hermes::Ord> *e, Func<Ord> **ext) const;
 
+        /// Evaluates the coefficient in the quadrature points once per element.
+        virtual bool precalculate(int n, double *wt, Func<Scalar> *u_ext[], Geom<double> *e, Func<Scalar> **ext);
+
         virtual VectorFormVol<Scalar>* clone() const;
 
       private:
         Hermes1DFunction<Scalar>* coeff;
         bool own_coeff;
         GeomType gt;
+        /// Coefficient values in the quadrature points of the current element, see precalculate().
+        Scalar coeff_values[H2D_MAX_INTEGRATION_POINTS_COUNT];
       };
 
       /* Default volumetric vector form \int_{area} spline_coeff1(u_ext[0]) * u->dx * v->val
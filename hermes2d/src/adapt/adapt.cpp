@@ -640,6 +640,34 @@ namespace Hermes
     template<typename Scalar>
     void Adapt<Scalar>::apply_refinements(ElementToRefine* elems_to_refine, int num_elem_to_process)
     {
+      // h-refinements of every mesh in one batch, in the original order (the first refinement of an element shared
+      // by several components wins, as when refining one by one).
+      for (int i = 0; i < this->num; i++)
+      {
+        MeshSharedPtr mesh = this->spaces[i]->get_mesh();
+        bool mesh_done = false;
+        for (int j = 0; j < i; j++)
+          if (this->spaces[j]->get_mesh() == mesh)
+            mesh_done = true;
+        if (mesh_done)
+          continue;
+
+        std::vector<int> ids, refinements;
+        std::set<int> ids_set;
+        for (int k = 0; k < num_elem_to_process; k++)
+        {
+          const ElementToRefine& elem_ref = elems_to_refine[k];
+          if (!elem_ref.valid || elem_ref.split == H2D_REFINEMENT_P || this->spaces[elem_ref.comp]->get_mesh() != mesh)
+            continue;
+          if (!mesh->get_element(elem_ref.id)->active || !ids_set.insert(elem_ref.id).second)
+            continue;
+          ids.push_back(elem_ref.id);
+          refinements.push_back(elem_ref.split == H2D_REFINEMENT_H ? 0 : (elem_ref.split == H2D_REFINEMENT_H_ANISO_H ? 1 : 2));
+        }
+        mesh->refine_elements(ids, refinements);
+      }
+
+      // Orders (the refined elements are no longer active).
       for (int i = 0; i < num_elem_to_process; i++)
         apply_refinement(elems_to_refine[i]);
     }
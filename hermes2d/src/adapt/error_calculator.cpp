@@ -169,6 +169,11 @@ namespace Hermes
       for (int i = 0; i < this->component_count; i++)
         meshes.push_back(fine_solutions[i]->get_mesh());
 
+      // Cached geometry of curved elements (if on), the caches are (re-)created here, outside of the parallel region.
+      this->geometry_caches.clear();
+      for (unsigned int i = 0; i < meshes.size(); i++)
+        this->geometry_caches.push_back(meshes[i]->get_geometry_cache());
+
       unsigned int num_states;
       Traverse trav(this->component_count);
       Traverse::State** states = trav.get_states(meshes, num_states);
@@ -36,6 +36,8 @@ namespace Hermes
       {
         slns[j] = static_cast<Solution<Scalar>*>(errorCalculator->coarse_solutions[j]->clone());
         rslns[j] = static_cast<Solution<Scalar>*>(errorCalculator->fine_solutions[j]->clone());
+        slns[j]->get_refmap(false)->set_geometry_cache(errorCalculator->geometry_caches[j]);
+        rslns[j]->get_refmap(false)->set_geometry_cache(errorCalculator->geometry_caches[this->errorCalculator->component_count + j]);
       }
     }
 
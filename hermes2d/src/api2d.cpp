@@ -22,6 +22,7 @@
 #include "common.h"
 #include "exceptions.h"
 #include "api2d.h"
+#include "solver/pmultigrid_solver.h"
 #include <xercesc/util/PlatformUtils.hpp>
 using namespace xercesc;
 
@@ -59,6 +60,10 @@ namespace Hermes
 
       XMLPlatformUtils::Terminate();
 
+      // The p-multigrid solver for create_linear_solver() (SOLVER_PMULTIGRID).
+      Hermes::Solvers::PMultigridSolverCreation<double>::create_pmultigrid_solver = PMultigridSolver<double>::create_pmultigrid_solver;
+      Hermes::Solvers::PMultigridSolverCreation<std::complex<double> >::create_pmultigrid_solver = PMultigridSolver<std::complex<double> >::create_pmultigrid_solver;
+
 #ifdef WITH_PJLIB
       pj_init();
       pj_caching_pool_init(&Hermes2DMemoryPoolCache, NULL, 1024 * 1024 * 1024);
@@ -0,0 +1,129 @@
+// This file is part of Hermes2D.
+//
+// Hermes2D is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 2 of the License, or
+// (at your option) any later version.
+//
+// Hermes2D is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Hermes2D.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "discrete_problem/dg/dg_face_connectivity.h"
+
+namespace Hermes
+{
+  namespace Hermes2D
+  {
+    template<typename Scalar>
+    DGFaceConnectivity<Scalar>::DGFaceConnectivity(MeshSharedPtr mesh) : mesh(mesh), mesh_seq(mesh->get_seq())
+    {
+      first_face.resize(mesh->get_max_element_id(), -1);
+
+      Element* e;
+      for_all_active_elements(e, mesh)
+      {
+        first_face[e->id] = faces.size();
+
+        // One search per element, set_active_edge() resets it for each edge.
+        NeighborSearch<Scalar> ns(e, mesh);
+        for (int edge = 0; edge < e->get_nvert(); edge++)
+        {
+          Face face;
+          face.neighborhood_type = NeighborSearch<Scalar>::H2D_DG_NOT_INITIALIZED;
+          face.n_neighbors = 0;
+          face.first_neighbor = neighbors.size();
+          face.first_transformation = transformations.size();
+
+          if (!e->en[edge]->bnd)
+          {
+            ns.set_active_edge(edge);
+            face.neighborhood_type = ns.neighborhood_type;
+            face.n_neighbors = ns.n_neighbors;
+            for (unsigned int i = 0; i < ns.n_neighbors; i++)
+            {
+              neighbors.push_back(ns.neighbors[i]);
+              neighbor_edges.push_back(ns.neighbor_edges[i]);
+            }
+
+            if (ns.neighborhood_type == NeighborSearch<Scalar>::H2D_DG_GO_DOWN)
+            {
+              for (unsigned int i = 0; i < ns.n_neighbors; i++)
+                transformations.push_back(typename NeighborSearch<Scalar>::Transformations(ns.central_transformations[i]));
+            }
+            else if (ns.neighborhood_type == NeighborSearch<Scalar>::H2D_DG_GO_UP)
+              transformations.push_back(typename NeighborSearch<Scalar>::Transformations(ns.neighbor_transformations[0]));
+          }
+
+          faces.push_back(face);
+        }
+      }
+    }
+
+    template<typename Scalar>
+    bool DGFaceConnectivity<Scalar>::is_up_to_date() const
+    {
+      return this->mesh_seq == this->mesh->get_seq();
+    }
+
+    template<typename Scalar>
+    MeshSharedPtr DGFaceConnectivity<Scalar>::get_mesh() const
+    {
+      return this->mesh;
+    }
+
+    template<typename Scalar>
+    bool DGFaceConnectivity<Scalar>::set_active_edge(NeighborSearch<Scalar>* ns, int edge) const
+    {
+      Element* central_el = ns->central_el;
+      if ((unsigned int)central_el->id >= first_face.size() || first_face[central_el->id] == -1)
+        return false;
+
+      const Face& face = faces[first_face[central_el->id] + edge];
+      if (face.n_neighbors == 0)
+        return false;
+
+      // The state of ns after set_active_edge().
+      ns->reset_neighb_info();
+      ns->active_edge = edge;
+      ns->neighborhood_type = (typename NeighborSearch<Scalar>::NeighborhoodType)face.neighborhood_type;
+      ns->n_neighbors = face.n_neighbors;
+      for (unsigned int i = 0; i < face.n_neighbors; i++)
+      {
+        ns->neighbors.push_back(neighbors[face.first_neighbor + i]);
+        ns->neighbor_edges.push_back(neighbor_edges[face.first_neighbor + i]);
+      }
+
+      if (face.neighborhood_type == NeighborSearch<Scalar>::H2D_DG_GO_DOWN)
+      {
+        for (unsigned int i = 0; i < face.n_neighbors; i++)
+        {
+          if (i < ns->central_transformations_alloc_size && ns->central_transformations[i])
+            ns->central_transformations[i]->copy_from(&transformations[face.first_transformation + i]);
+          else
+            ns->add_central_transformations(new typename NeighborSearch<Scalar>::Transformations(&transformations[face.first_transformation + i]), i);
+        }
+      }
+      else if (face.neighborhood_type == NeighborSearch<Scalar>::H2D_DG_GO_UP)
+      {
+        if (ns->neighbor_transformations[0])
+          ns->neighbor_transformations[0]->copy_from(&transformations[face.first_transformation]);
+        else
+          ns->add_neighbor_transformations(new typename NeighborSearch<Scalar>::Transformations(&transformations[face.first_transformation]), 0);
+      }
+
+      // The search leaves the last neighbor found as the current one.
+      ns->neighb_el = ns->neighbors.back();
+      ns->neighbor_edge.local_num_of_edge = ns->neighbor_edges.back().local_num_of_edge;
+
+      return true;
+    }
+
+    template class HERMES_API DGFaceConnectivity < double > ;
+    template class HERMES_API DGFaceConnectivity < std::complex<double> > ;
+  }
+}
@@ -31,7 +31,8 @@ namespace Hermes
     unsigned int DiscreteProblemDGAssembler<Scalar>::dg_order = 20;
 
     template<typename Scalar>
-    DiscreteProblemDGAssembler<Scalar>::DiscreteProblemDGAssembler(DiscreteProblemThreadAssembler<Scalar>* threadAssembler, const std::vector<SpaceSharedPtr<Scalar> > spaces, std::vector<MeshSharedPtr>& meshes)
+    DiscreteProblemDGAssembler<Scalar>::DiscreteProblemDGAssembler(DiscreteProblemThreadAssembler<Scalar>* threadAssembler, const std::vector<SpaceSharedPtr<Scalar> > spaces, std::vector<MeshSharedPtr>& meshes, int** element_first_states,
+      DGFaceConnectivity<Scalar>** face_connectivities)
       : pss(threadAssembler->pss),
       refmaps(threadAssembler->refmaps),
       u_ext(threadAssembler->u_ext),
@@ -44,7 +45,10 @@ namespace Hermes
       current_state(nullptr),
       selectiveAssembler(threadAssembler->selectiveAssembler),
       spaces(spaces),
-      meshes(meshes)
+      meshes(meshes),
+      element_first_states(element_first_states),
+      current_state_index(0),
+      face_connectivities(face_connectivities)
     {
       this->DG_matrix_forms_present = false;
       this->DG_vector_forms_present = false;
@@ -71,6 +75,60 @@ namespace Hermes
       this->als = threadAssembler->als;
     }
 
+    template<typename Scalar>
+    int** DiscreteProblemDGAssembler<Scalar>::init_element_first_states(Traverse::State** states, unsigned int num_states, const std::vector<MeshSharedPtr>& meshes)
+    {
+      int** element_first_states = malloc_with_check<int*>(meshes.size());
+      for (unsigned int i = 0; i < meshes.size(); i++)
+      {
+        element_first_states[i] = nullptr;
+        for (unsigned int j = 0; j < i; j++)
+        {
+          if (meshes[j] == meshes[i])
+          {
+            element_first_states[i] = element_first_states[j];
+            break;
+          }
+        }
+        if (element_first_states[i])
+          continue;
+
+        // Elements that are not a part of any state come after all states.
+        int max_element_id = meshes[i]->get_max_element_id();
+        element_first_states[i] = malloc_with_check<int>(max_element_id);
+        for (int id = 0; id < max_element_id; id++)
+          element_first_states[i][id] = num_states;
+      }
+
+      // States are visited in their order, the first write is the minimum.
+      for (unsigned int state_i = 0; state_i < num_states; state_i++)
+      {
+        for (unsigned int i = 0; i < states[state_i]->num; i++)
+        {
+          Element* e = states[state_i]->e[i];
+          if (e && element_first_states[i][e->id] > (int)state_i)
+            element_first_states[i][e->id] = state_i;
+        }
+      }
+
+      return element_first_states;
+    }
+
+    template<typename Scalar>
+    void DiscreteProblemDGAssembler<Scalar>::free_element_first_states(int** element_first_states, const std::vector<MeshSharedPtr>& meshes)
+    {
+      for (unsigned int i = 0; i < meshes.size(); i++)
+      {
+        bool shared = false;
+        for (unsigned int j = 0; j < i; j++)
+          if (meshes[j] == meshes[i])
+            shared = true;
+        if (!shared)
+          free_with_check(element_first_states[i]);
+      }
+      free_with_check(element_first_states);
+    }
+
     template<typename Scalar>
     NeighborSearch<Scalar>* DiscreteProblemDGAssembler<Scalar>::get_neighbor_search_ext(WeakFormSharedPtr<Scalar> wf, NeighborSearch<Scalar>** neighbor_searches, int index)
     {
@@ -93,9 +151,10 @@ namespace Hermes
     }
 
     template<typename Scalar>
-    void DiscreteProblemDGAssembler<Scalar>::init_assembling_one_state(Traverse::State* current_state_)
+    void DiscreteProblemDGAssembler<Scalar>::init_assembling_one_state(Traverse::State* current_state_, unsigned int current_state_index)
     {
       this->current_state = current_state_;
+      this->current_state_index = current_state_index;
 
       this->neighbor_searches = new NeighborSearch<Scalar>**[this->current_state->rep->nvert];
       for (int i = 0; i < this->current_state->rep->nvert; i++)
@@ -116,46 +175,41 @@ namespace Hermes
     template<typename Scalar>
     void DiscreteProblemDGAssembler<Scalar>::assemble_one_state()
     {
-#pragma omp critical (DG)
+      for (current_state->isurf = 0; current_state->isurf < current_state->rep->nvert; current_state->isurf++)
       {
-        for (unsigned int i = 0; i < current_state->num; i++)
-          current_state->e[i]->visited = true;
-
-        for (current_state->isurf = 0; current_state->isurf < current_state->rep->nvert; current_state->isurf++)
+        if (!current_state->bnd[current_state->isurf])
         {
-          if (!current_state->bnd[current_state->isurf])
-          {
-            // If this edge is an inter-element one on all meshes.
-            if (!init_neighbors(neighbor_searches[current_state->isurf], current_state))
-              continue;
+          // If this edge is an inter-element one on all meshes.
+          if (!init_neighbors(neighbor_searches[current_state->isurf], current_state))
+            continue;
 
-            // Create a multimesh tree;
-            MultimeshDGNeighborTree<Scalar>::process_edge(neighbor_searches[current_state->isurf], this->current_state->num, this->num_neighbors[current_state->isurf], this->processed[current_state->isurf]);
-          }
+          // Create a multimesh tree;
+          MultimeshDGNeighborTree<Scalar>::process_edge(neighbor_searches[current_state->isurf], this->current_state->num, this->num_neighbors[current_state->isurf], this->processed[current_state->isurf],
+            this->element_first_states, this->current_state_index);
         }
-        for (current_state->isurf = 0; current_state->isurf < current_state->rep->nvert; current_state->isurf++)
+      }
+      for (current_state->isurf = 0; current_state->isurf < current_state->rep->nvert; current_state->isurf++)
+      {
+        if (!current_state->bnd[current_state->isurf])
         {
-          if (!current_state->bnd[current_state->isurf])
-          {
 #ifdef DEBUG_DG_ASSEMBLING
-            debug();
+          debug();
 #endif
-            for (unsigned int neighbor_i = 0; neighbor_i < num_neighbors[current_state->isurf]; neighbor_i++)
-            {
-              if (!DG_vector_forms_present && processed[current_state->isurf][neighbor_i])
-                continue;
-
-              // DG-inner-edge-wise parameters for WeakForm.
-              wf->set_active_DG_state(current_state->e, current_state->isurf);
+          for (unsigned int neighbor_i = 0; neighbor_i < num_neighbors[current_state->isurf]; neighbor_i++)
+          {
+            if (!DG_vector_forms_present && processed[current_state->isurf][neighbor_i])
+              continue;
 
-              assemble_one_neighbor(processed[current_state->isurf][neighbor_i], neighbor_i, neighbor_searches[current_state->isurf]);
-            }
+            // DG-inner-edge-wise parameters for WeakForm.
+            wf->set_active_DG_state(current_state->e, current_state->isurf);
 
-            deinit_neighbors(neighbor_searches[current_state->isurf], current_state);
+            assemble_one_neighbor(processed[current_state->isurf][neighbor_i], neighbor_i, neighbor_searches[current_state->isurf]);
           }
-          else
-            processed[current_state->isurf] = nullptr;
+
+          deinit_neighbors(neighbor_searches[current_state->isurf], current_state);
         }
+        else
+          processed[current_state->isurf] = nullptr;
       }
     }
 
@@ -470,7 +524,7 @@ namespace Hermes
           NeighborSearch<Scalar>* ns = new NeighborSearch<Scalar>(current_state->e[i], this->meshes[i]);
           ns->original_central_el_transform = current_state->sub_idx[i];
           current_neighbor_searches[i] = ns;
-          if (current_neighbor_searches[i]->set_active_edge_multimesh(current_state->isurf) && (i >= this->spaces_size || spaces[i]->get_type() == HERMES_L2_SPACE))
+          if (current_neighbor_searches[i]->set_active_edge_multimesh(current_state->isurf, this->face_connectivities ? this->face_connectivities[i] : nullptr) && (i >= this->spaces_size || spaces[i]->get_type() == HERMES_L2_SPACE))
             DG_intra = true;
           current_neighbor_searches[i]->clear_initial_sub_idx();
         }
@@ -547,7 +601,172 @@ namespace Hermes
     }
 #endif
 
+    template<typename Scalar>
+    DGAssemblyRecordMatrix<Scalar>::DGAssemblyRecordMatrix(unsigned int size) : SparseMatrix<Scalar>(size)
+    {
+    }
+
+    template<typename Scalar>
+    void DGAssemblyRecordMatrix<Scalar>::alloc()
+    {
+    }
+
+    template<typename Scalar>
+    void DGAssemblyRecordMatrix<Scalar>::free()
+    {
+      SparseMatrix<Scalar>::free();
+      this->zero();
+    }
+
+    template<typename Scalar>
+    Scalar DGAssemblyRecordMatrix<Scalar>::get(unsigned int m, unsigned int n) const
+    {
+      throw Hermes::Exceptions::MethodNotOverridenException("DGAssemblyRecordMatrix<Scalar>::get");
+      return Scalar(0);
+    }
+
+    template<typename Scalar>
+    void DGAssemblyRecordMatrix<Scalar>::zero()
+    {
+      this->rows.clear();
+      this->cols.clear();
+      this->values.clear();
+    }
+
+    template<typename Scalar>
+    void DGAssemblyRecordMatrix<Scalar>::add(unsigned int m, unsigned int n, Scalar v)
+    {
+      this->rows.push_back(m);
+      this->cols.push_back(n);
+      this->values.push_back(v);
+    }
+
+    template<typename Scalar>
+    void DGAssemblyRecordMatrix<Scalar>::add(unsigned int m, unsigned int n, Scalar *mat, int *rows, int *cols, const int size)
+    {
+      for (unsigned int i = 0; i < m; i++)
+      {
+        if (rows[i] < 0)
+          continue;
+        for (unsigned int j = 0; j < n; j++)
+        {
+          if (cols[j] >= 0)
+            this->add(rows[i], cols[j], mat[i * size + j]);
+        }
+      }
+    }
+
+    template<typename Scalar>
+    double DGAssemblyRecordMatrix<Scalar>::get_fill_in() const
+    {
+      return 0.;
+    }
+
+    template<typename Scalar>
+    void DGAssemblyRecordMatrix<Scalar>::export_to_file(const char* filename, const char* var_name, Algebra::MatrixExportFormat fmt, char* number_format)
+    {
+      throw Hermes::Exceptions::MethodNotOverridenException("DGAssemblyRecordMatrix<Scalar>::export_to_file");
+    }
+
+    template<typename Scalar>
+    void DGAssemblyRecordMatrix<Scalar>::add_to(SparseMatrix<Scalar>* mat)
+    {
+      for (unsigned int i = 0; i < this->values.size(); i++)
+        mat->add(this->rows[i], this->cols[i], this->values[i]);
+      this->zero();
+    }
+
+    template<typename Scalar>
+    DGAssemblyRecordVector<Scalar>::DGAssemblyRecordVector(unsigned int size) : Vector<Scalar>(size)
+    {
+    }
+
+    template<typename Scalar>
+    void DGAssemblyRecordVector<Scalar>::alloc(unsigned int ndofs)
+    {
+      this->size = ndofs;
+      this->zero();
+    }
+
+    template<typename Scalar>
+    void DGAssemblyRecordVector<Scalar>::free()
+    {
+      this->zero();
+    }
+
+    template<typename Scalar>
+    Scalar DGAssemblyRecordVector<Scalar>::get(unsigned int idx) const
+    {
+      throw Hermes::Exceptions::MethodNotOverridenException("DGAssemblyRecordVector<Scalar>::get");
+      return Scalar(0);
+    }
+
+    template<typename Scalar>
+    Vector<Scalar>* DGAssemblyRecordVector<Scalar>::duplicate() const
+    {
+      throw Hermes::Exceptions::MethodNotOverridenException("DGAssemblyRecordVector<Scalar>::duplicate");
+      return nullptr;
+    }
+
+    template<typename Scalar>
+    void DGAssemblyRecordVector<Scalar>::extract(Scalar *v) const
+    {
+      throw Hermes::Exceptions::MethodNotOverridenException("DGAssemblyRecordVector<Scalar>::extract");
+    }
+
+    template<typename Scalar>
+    void DGAssemblyRecordVector<Scalar>::zero()
+    {
+      this->indices.clear();
+      this->values.clear();
+    }
+
+    template<typename Scalar>
+    Vector<Scalar>* DGAssemblyRecordVector<Scalar>::change_sign()
+    {
+      throw Hermes::Exceptions::MethodNotOverridenException("DGAssemblyRecordVector<Scalar>::change_sign");
+      return nullptr;
+    }
+
+    template<typename Scalar>
+    void DGAssemblyRecordVector<Scalar>::set(unsigned int idx, Scalar y)
+    {
+      throw Hermes::Exceptions::MethodNotOverridenException("DGAssemblyRecordVector<Scalar>::set");
+    }
+
+    template<typename Scalar>
+    void DGAssemblyRecordVector<Scalar>::add(unsigned int idx, Scalar y)
+    {
+      this->indices.push_back(idx);
+      this->values.push_back(y);
+    }
+
+    template<typename Scalar>
+    void DGAssemblyRecordVector<Scalar>::add(unsigned int n, unsigned int *idx, Scalar *y)
+    {
+      for (unsigned int i = 0; i < n; i++)
+        this->add(idx[i], y[i]);
+    }
+
+    template<typename Scalar>
+    void DGAssemblyRecordVector<Scalar>::export_to_file(const char* filename, const char* var_name, Algebra::MatrixExportFormat fmt, char* number_format)
+    {
+      throw Hermes::Exceptions::MethodNotOverridenException("DGAssemblyRecordVector<Scalar>::export_to_file");
+    }
+
+    template<typename Scalar>
+    void DGAssemblyRecordVector<Scalar>::add_to(Vector<Scalar>* vec)
+    {
+      for (unsigned int i = 0; i < this->values.size(); i++)
+        vec->add(this->indices[i], this->values[i]);
+      this->zero();
+    }
+
     template class HERMES_API DiscreteProblemDGAssembler < double > ;
     template class HERMES_API DiscreteProblemDGAssembler < std::complex<double> > ;
+    template class HERMES_API DGAssemblyRecordMatrix < double > ;
+    template class HERMES_API DGAssemblyRecordMatrix < std::complex<double> > ;
+    template class HERMES_API DGAssemblyRecordVector < double > ;
+    template class HERMES_API DGAssemblyRecordVector < std::complex<double> > ;
   }
 }
\ No newline at end of file
@@ -20,7 +20,8 @@ namespace Hermes
   namespace Hermes2D
   {
     template<typename Scalar>
-    void MultimeshDGNeighborTree<Scalar>::process_edge(NeighborSearch<Scalar>** neighbor_searches, unsigned char num_neighbor_searches, unsigned int& num_neighbors, bool*& processed)
+    void MultimeshDGNeighborTree<Scalar>::process_edge(NeighborSearch<Scalar>** neighbor_searches, unsigned char num_neighbor_searches, unsigned int& num_neighbors, bool*& processed,
+      int** element_first_states, unsigned int current_state_index)
     {
       MultimeshDGNeighborTreeNode root(nullptr, 0);
 
@@ -44,21 +45,19 @@ namespace Hermes
           throw Hermes::Exceptions::Exception("Num_neighbors of different NeighborSearches not matching in assemble_one_state().");
       }
 
-      processed = new bool[num_neighbors];
+      processed = malloc_with_check<bool>(num_neighbors);
 
       for (unsigned int neighbor_i = 0; neighbor_i < num_neighbors; neighbor_i++)
       {
         // If the active segment has already been processed (when the neighbor element was assembled), it is skipped.
         // We test all neighbor searches, because in the case of intra-element edge, the neighboring (the same as central) element
-        // will be marked as visited, even though the edge was not calculated.
-        processed[neighbor_i] = true;
-        for (unsigned int i = 0; i < num_neighbor_searches; i++)
+        // is a part of the current state, even though the edge was not calculated.
+        // Only the (read-only) states order is used, so that this does not depend on what the other threads have already assembled.
+        processed[neighbor_i] = (element_first_states != nullptr);
+        for (unsigned int i = 0; i < num_neighbor_searches && processed[neighbor_i]; i++)
         {
-          if (!neighbor_searches[i]->neighbors.at(neighbor_i)->visited)
-          {
+          if (element_first_states[i][neighbor_searches[i]->neighbors.at(neighbor_i)->id] > (int)current_state_index)
             processed[neighbor_i] = false;
-            break;
-          }
         }
       }
     }
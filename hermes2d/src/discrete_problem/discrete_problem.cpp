@@ -55,6 +55,16 @@ namespace Hermes
     {
       this->reassembled_states_reuse_linear_system = nullptr;
 
+      this->lean_residual_assembling = false;
+      this->lean_residual_states = nullptr;
+      this->lean_residual_num_states = 0;
+      this->lean_residual_wf = nullptr;
+
+      this->static_condensation = false;
+      this->condensed_dofs = nullptr;
+      this->condensation_elements = nullptr;
+      this->condensation_elements_count = 0;
+
       this->spaces_size = this->spaces.size();
 
       this->nonlinear = !to_set;
@@ -84,6 +94,12 @@ namespace Hermes
 
       if (this->dirichlet_lift_rhs)
         delete this->dirichlet_lift_rhs;
+
+      this->free_static_condensation();
+      this->free_lean_residual_states();
+
+      for (unsigned int i = 0; i < this->dg_face_connectivities.size(); i++)
+        delete this->dg_face_connectivities[i];
     }
 
     template<typename Scalar>
@@ -113,17 +129,123 @@ namespace Hermes
       this->selectiveAssembler.set_verbose_output(to_set);
     }
 
+    template<typename Scalar>
+    void DiscreteProblem<Scalar>::set_static_condensation(bool to_set)
+    {
+      if (to_set && this->nonlinear)
+        throw Exceptions::Exception("DiscreteProblem: static condensation is only available for linear problems (LinearSolver).");
+      if (this->static_condensation != to_set)
+        this->invalidate_matrix();
+      this->static_condensation = to_set;
+      if (!to_set)
+        this->free_static_condensation();
+    }
+
+    template<typename Scalar>
+    bool DiscreteProblem<Scalar>::get_static_condensation() const
+    {
+      return this->static_condensation;
+    }
+
+    template<typename Scalar>
+    void DiscreteProblem<Scalar>::free_static_condensation()
+    {
+      free_with_check(this->condensed_dofs);
+      this->condensed_dofs_sp_seq.clear();
+      this->condensed_dofs_dof_stamps.clear();
+      for (int i = 0; i < this->condensation_elements_count; i++)
+        this->condensation_elements[i].free();
+      free_with_check(this->condensation_elements);
+      this->condensation_elements_count = 0;
+    }
+
+    template<typename Scalar>
+    void DiscreteProblem<Scalar>::init_static_condensation()
+    {
+      if (this->static_condensation)
+      {
+        if (this->nonlinear)
+          throw Exceptions::Exception("DiscreteProblem: static condensation is only available for linear problems (LinearSolver).");
+        if (this->wf->is_DG())
+          throw Exceptions::Exception("DiscreteProblem: static condensation is not available for DG forms.");
+        if (this->current_rhs_block)
+          throw Exceptions::Exception("DiscreteProblem: static condensation is not available for multiple right-hand sides.");
+
+        bool spaces_changed = this->condensed_dofs_sp_seq.size() != this->spaces_size;
+        // assign_dofs() renumbers without changing the seq.
+        for (int i = 0; i < this->spaces_size && !spaces_changed; i++)
+          spaces_changed = this->condensed_dofs_sp_seq[i] != this->spaces[i]->get_seq() || this->condensed_dofs_dof_stamps[i] != this->spaces[i]->get_dof_assignment_stamp();
+
+        if (spaces_changed)
+        {
+          this->free_static_condensation();
+
+          // The bubble DOFs, except for the marker-wise constant L2 space, where they are shared by all elements of a marker.
+          this->condensed_dofs = calloc_with_check<bool>(Space<Scalar>::get_num_dofs(this->spaces));
+          for (int i = 0; i < this->spaces_size; i++)
+          {
+            this->condensed_dofs_sp_seq.push_back(this->spaces[i]->get_seq());
+            this->condensed_dofs_dof_stamps.push_back(this->spaces[i]->get_dof_assignment_stamp());
+            if (this->spaces[i]->get_type() == HERMES_L2_MARKERWISE_CONST_SPACE)
+              continue;
+
+            Element* e;
+            for_all_active_elements(e, this->spaces[i]->get_mesh())
+            {
+              typename Space<Scalar>::ElementData* ed = &this->spaces[i]->edata[e->id];
+              for (int j = 0; j < ed->n; j++)
+                this->condensed_dofs[ed->bdof + j] = true;
+            }
+          }
+
+          this->condensation_elements_count = this->spaces[0]->get_mesh()->get_max_element_id();
+          this->condensation_elements = calloc_with_check<StaticCondensationElement<Scalar> >(this->condensation_elements_count);
+        }
+      }
+
+      this->selectiveAssembler.condensed_dofs = this->condensed_dofs;
+      for (int i = 0; i < this->num_threads_used; i++)
+      {
+        this->threadAssembler[i]->condensed_dofs = this->condensed_dofs;
+        this->threadAssembler[i]->condensation_elements = this->condensation_elements;
+      }
+    }
+
+    template<typename Scalar>
+    void DiscreteProblem<Scalar>::reconstruct_condensed_dofs(Scalar* sln_vector) const
+    {
+      if (!this->condensation_elements)
+        throw Exceptions::Exception("DiscreteProblem::reconstruct_condensed_dofs() called without an assembling with the static condensation.");
+
+      // x_b = y - X x_s, the condensed DOFs of every element are distinct.
+#pragma omp parallel for num_threads(this->num_threads_used) schedule(dynamic, 256)
+      for (int element_i = 0; element_i < this->condensation_elements_count; element_i++)
+      {
+        StaticCondensationElement<Scalar>& element_data = this->condensation_elements[element_i];
+        for (int b = 0; b < element_data.nb; b++)
+        {
+          Scalar value = element_data.y[b];
+          for (int s = 0; s < element_data.ns; s++)
+            value -= element_data.X[b * element_data.ns + s] * sln_vector[element_data.dofs[s]];
+          sln_vector[element_data.dofs[element_data.ns + b]] = value;
+        }
+      }
+    }
+
     template<typename Scalar>
     void DiscreteProblem<Scalar>::set_time(double time)
     {
       Space<Scalar>::update_essential_bc_values(spaces, time);
       this->wf->set_current_time(time);
+      // The copies of the weak formulation in the thread assemblers have the old time.
+      this->invalidate_lean_residual_assembling();
     }
 
     template<typename Scalar>
     void DiscreteProblem<Scalar>::set_time_step(double time_step)
     {
       this->wf->set_current_time_step(time_step);
+      this->invalidate_lean_residual_assembling();
     }
 
     template<typename Scalar>
@@ -156,6 +278,8 @@ namespace Hermes
 
       this->selectiveAssembler.set_weak_formulation(wf);
       this->selectiveAssembler.matrix_structure_reusable = false;
+
+      this->invalidate_lean_residual_assembling();
     }
 
     template<typename Scalar>
@@ -195,6 +319,15 @@ namespace Hermes
         return true;
     }
 
+    template<typename Scalar>
+    void DiscreteProblem<Scalar>::set_rhs_block(SimpleVectorBlock<Scalar>* rhs_block)
+    {
+      Mixins::DiscreteProblemMatrixVector<Scalar>::set_rhs_block(rhs_block);
+
+      for (int i = 0; i < this->num_threads_used; i++)
+        this->threadAssembler[i]->set_rhs_block(rhs_block);
+    }
+
     template<typename Scalar>
     void DiscreteProblem<Scalar>::set_spaces(std::vector<SpaceSharedPtr<Scalar> > spacesToSet)
     {
@@ -215,6 +348,8 @@ namespace Hermes
 
       for (int i = 0; i < this->num_threads_used; i++)
         this->threadAssembler[i]->init_spaces(spaces);
+
+      this->invalidate_lean_residual_assembling();
     }
 
     template<typename Scalar>
@@ -248,6 +383,18 @@ namespace Hermes
     template<typename Scalar>
     void DiscreteProblem<Scalar>::init_assembling(Traverse::State**& states, unsigned int& num_states, std::vector<MeshSharedPtr>& meshes)
     {
+      // Cached assembly lists (if on) for the selective and the thread assemblers.
+      for (unsigned int space_i = 0; space_i < spaces.size(); space_i++)
+        spaces[space_i]->update_assembly_list_cache();
+
+      // Cached geometry of curved elements (if on), the caches are (re-)created here, outside of the parallel region.
+      for (unsigned int space_i = 0; space_i < spaces.size(); space_i++)
+      {
+        MeshGeometryCache* geometry_cache = spaces[space_i]->get_mesh()->get_geometry_cache();
+        for (unsigned char i = 0; i < this->num_threads_used; i++)
+          this->threadAssembler[i]->refmaps[space_i]->set_geometry_cache(geometry_cache);
+      }
+
       // Vector of meshes.
       for (unsigned int space_i = 0; space_i < spaces.size(); space_i++)
         meshes.push_back(spaces[space_i]->get_mesh());
@@ -285,8 +432,40 @@ namespace Hermes
       }
     }
 
+    template<typename Scalar>
+    bool DiscreteProblem<Scalar>::assemble(SparseMatrix<Scalar>* mat, SimpleVectorBlock<Scalar>* rhs_block, unsigned int num_rhs)
+    {
+      Scalar* coeff_vec = nullptr;
+      return assemble(coeff_vec, mat, rhs_block, num_rhs);
+    }
+
     template<typename Scalar>
     bool DiscreteProblem<Scalar>::assemble(Scalar*& coeff_vec, SparseMatrix<Scalar>* mat, Vector<Scalar>* rhs)
+    {
+      return this->assemble_internal(coeff_vec, mat, rhs, nullptr, 0);
+    }
+
+    template<typename Scalar>
+    bool DiscreteProblem<Scalar>::assemble(Scalar*& coeff_vec, SparseMatrix<Scalar>* mat, SimpleVectorBlock<Scalar>* rhs_block, unsigned int num_rhs)
+    {
+      if (!rhs_block)
+        throw Exceptions::NullException(2);
+      if (num_rhs == 0)
+        throw Exceptions::ValueException("num_rhs", num_rhs, 1);
+      if (this->wf->is_DG())
+        throw Exceptions::Exception("DiscreteProblem: assembling of multiple right-hand sides is not available for DG forms.");
+      for (unsigned int i = 0; i < this->wf->vfvol.size(); i++)
+        if (this->wf->vfvol[i]->load_case >= num_rhs)
+          throw Exceptions::Exception("DiscreteProblem: a volumetric vector form has the load case %i, only %i right-hand sides assembled.", this->wf->vfvol[i]->load_case, num_rhs);
+      for (unsigned int i = 0; i < this->wf->vfsurf.size(); i++)
+        if (this->wf->vfsurf[i]->load_case >= num_rhs)
+          throw Exceptions::Exception("DiscreteProblem: a surface vector form has the load case %i, only %i right-hand sides assembled.", this->wf->vfsurf[i]->load_case, num_rhs);
+
+      return this->assemble_internal(coeff_vec, mat, nullptr, rhs_block, num_rhs);
+    }
+
+    template<typename Scalar>
+    bool DiscreteProblem<Scalar>::assemble_internal(Scalar*& coeff_vec, SparseMatrix<Scalar>* mat, Vector<Scalar>* rhs, SimpleVectorBlock<Scalar>* rhs_block, unsigned int num_rhs)
     {
       // Check.
       this->check();
@@ -294,12 +473,14 @@ namespace Hermes
 
       // Set the matrices.
       bool result = this->set_matrix(mat) && this->set_rhs(rhs);
+      this->set_rhs_block(rhs_block);
 
       // Initialize states && previous iterations.
       unsigned int num_states;
       Traverse::State** states;
       std::vector<MeshSharedPtr> meshes;
       this->init_assembling(states, num_states, meshes);
+      this->init_static_condensation();
       this->tick();
       this->info("\tDiscreteProblem: Initialization: %s.", this->last_str().c_str());
       this->tick();
@@ -311,119 +492,361 @@ namespace Hermes
         this->tick();
         this->info("\tDiscreteProblem: Prepare sparse structure: %s.", this->last_str().c_str());
 
+        // All right-hand sides in one contiguous block.
+        if (this->current_rhs_block)
+          this->current_rhs_block->alloc(Space<Scalar>::get_num_dofs(this->spaces), num_rhs);
+
         // The following does not make much sense to do just for rhs)
         if (this->current_mat && this->reassembled_states_reuse_linear_system)
           this->reassembled_states_reuse_linear_system(states, num_states, this->current_mat, this->current_rhs, this->dirichlet_lift_rhs, coeff_vec);
 
-        Solution<Scalar>** u_ext_sln = nullptr;
-        if (this->nonlinear && coeff_vec)
+        this->assemble_states(coeff_vec, states, num_states, meshes);
+      }
+
+      this->tick();
+
+      // Keep the states for assemble_residual().
+      if (this->lean_residual_assembling && num_states > 0 && !this->current_rhs_block)
+      {
+        this->free_lean_residual_states();
+        this->lean_residual_states = states;
+        this->lean_residual_num_states = num_states;
+        this->lean_residual_meshes = meshes;
+        for (unsigned int i = 0; i < meshes.size(); i++)
+          this->lean_residual_mesh_seqs.push_back(meshes[i]->get_seq());
+        for (int i = 0; i < this->spaces_size; i++)
+          this->lean_residual_space_seqs.push_back(this->spaces[i]->get_seq());
+        this->lean_residual_wf = this->wf.get();
+        states = nullptr;
+        num_states = 0;
+      }
+
+      // Deinitialize states && previous iterations.
+      this->deinit_assembling(states, num_states);
+
+      // Finish the algebraic structures for solving.
+      if (this->current_mat)
+        this->current_mat->finish();
+      if (this->current_rhs)
+        this->current_rhs->finish();
+
+      if (!this->exceptionMessageCaughtInParallelBlock.empty())
+        throw Hermes::Exceptions::Exception(this->exceptionMessageCaughtInParallelBlock.c_str());
+
+      Element* e;
+      for (unsigned int space_i = 0; space_i < spaces.size(); space_i++)
+      {
+        for_all_active_elements_compact(e, spaces[space_i]->get_mesh())
+          spaces[space_i]->edata[e->id].changed_in_last_adaptation = false;
+      }
+
+      this->tick();
+      this->info("\tDiscreteProblem: De-initialization: %s.", this->last_str().c_str());
+
+      return result;
+    }
+
+    template<typename Scalar>
+    void DiscreteProblem<Scalar>::assemble_states(Scalar*& coeff_vec, Traverse::State** states, unsigned int num_states, std::vector<MeshSharedPtr>& meshes)
+    {
+      // Previous iterations of scalar (H1, L2) spaces are evaluated directly from coeff_vec by the thread assemblers
+      // using the already calculated shape function values, without creating the Solutions (and their monomial coefficients).
+      bool u_ext_direct = this->nonlinear && coeff_vec && !this->wf->is_DG();
+      for (int i = 0; i < this->spaces_size && u_ext_direct; i++)
+        if (spaces[i]->get_shapeset()->get_num_components() > 1)
+          u_ext_direct = false;
+
+      int u_ext_dof_offsets[H2D_MAX_COMPONENTS];
+      if (u_ext_direct)
+      {
+        int first_dof = 0;
+        for (int i = 0; i < this->spaces_size; i++)
+        {
+          u_ext_dof_offsets[i] = first_dof - spaces[i]->first_dof;
+          first_dof += spaces[i]->get_num_dofs();
+        }
+      }
+      for (int i = 0; i < this->num_threads_used; i++)
+        this->threadAssembler[i]->set_u_ext_coeff_vec(u_ext_direct ? coeff_vec : nullptr, u_ext_dof_offsets, !this->rungeKutta);
+
+      Solution<Scalar>** u_ext_sln = nullptr;
+      if (this->nonlinear && coeff_vec && !u_ext_direct)
+      {
+        u_ext_sln = new Solution<Scalar>*[spaces_size];
+        int first_dof = 0;
+        for (int i = 0; i < this->spaces_size; i++)
         {
-          u_ext_sln = new Solution<Scalar>*[spaces_size];
-          int first_dof = 0;
-          for (int i = 0; i < this->spaces_size; i++)
+          u_ext_sln[i] = new Solution<Scalar>(spaces[i]->get_mesh());
+          Solution<Scalar>::vector_to_solution(coeff_vec, spaces[i], u_ext_sln[i], !this->rungeKutta, first_dof);
+          first_dof += spaces[i]->get_num_dofs();
+        }
+      }
+
+      if (num_states > 0)
+      {
+        // Is this a DG assembling.
+        bool is_DG = this->wf->is_DG();
+
+        // Which state assembles which interface, so that the threads do not need to synchronize.
+        int** element_first_states = nullptr;
+        DGFaceConnectivity<Scalar>** face_connectivities = nullptr;
+        if (is_DG)
+        {
+          element_first_states = DiscreteProblemDGAssembler<Scalar>::init_element_first_states(states, num_states, meshes);
+          face_connectivities = this->init_dg_face_connectivities(meshes);
+        }
+
+        // DG with several threads: the threads (each with a contiguous range of states) record their additions to the matrix
+        // and vectors, which are added to them in the order of the threads afterwards - bitwise the same sums as in the serial
+        // assembling. Several right-hand sides (not recordable) are assembled by one thread.
+        int num_threads = (is_DG && this->current_rhs_block) ? 1 : this->num_threads_used;
+        bool record = is_DG && num_threads > 1;
+        DGAssemblyRecordMatrix<Scalar>** record_mats = nullptr;
+        DGAssemblyRecordVector<Scalar>** record_rhss = nullptr;
+        DGAssemblyRecordVector<Scalar>** record_dirichlet_lift_rhss = nullptr;
+        Vector<Scalar>* dirichlet_lift_rhs = this->threadAssembler[0]->dirichlet_lift_rhs;
+        if (record)
+        {
+          unsigned int ndof = Space<Scalar>::get_num_dofs(spaces);
+          if (this->current_mat)
+            record_mats = new DGAssemblyRecordMatrix<Scalar>*[num_threads];
+          if (this->current_rhs)
+            record_rhss = new DGAssemblyRecordVector<Scalar>*[num_threads];
+          if (dirichlet_lift_rhs)
+            record_dirichlet_lift_rhss = new DGAssemblyRecordVector<Scalar>*[num_threads];
+          for (int i = 0; i < num_threads; i++)
           {
-            u_ext_sln[i] = new Solution<Scalar>(spaces[i]->get_mesh());
-            Solution<Scalar>::vector_to_solution(coeff_vec, spaces[i], u_ext_sln[i], !this->rungeKutta, first_dof);
-            first_dof += spaces[i]->get_num_dofs();
+            if (record_mats)
+              this->threadAssembler[i]->set_matrix(record_mats[i] = new DGAssemblyRecordMatrix<Scalar>(ndof));
+            if (record_rhss)
+              this->threadAssembler[i]->set_rhs(record_rhss[i] = new DGAssemblyRecordVector<Scalar>(ndof));
+            if (record_dirichlet_lift_rhss)
+              this->threadAssembler[i]->dirichlet_lift_rhs = record_dirichlet_lift_rhss[i] = new DGAssemblyRecordVector<Scalar>(ndof);
           }
         }
 
-        if (num_states > 0)
+#pragma omp parallel num_threads(num_threads)
         {
-          // Is this a DG assembling.
-          bool is_DG = this->wf->is_DG();
+          int thread_number = omp_get_thread_num();
+          int start = (num_states / num_threads) * thread_number;
+          int end = (num_states / num_threads) * (thread_number + 1);
+          if (thread_number == num_threads - 1)
+            end = num_states;
 
-#pragma omp parallel num_threads(this->num_threads_used)
+          try
           {
-            int thread_number = omp_get_thread_num();
-            int start = (num_states / this->num_threads_used) * thread_number;
-            int end = (num_states / this->num_threads_used) * (thread_number + 1);
-            if (thread_number == this->num_threads_used - 1)
-              end = num_states;
+            this->threadAssembler[thread_number]->init_assembling(u_ext_sln, spaces, this->add_dirichlet_lift);
 
-            try
-            {
-              this->threadAssembler[thread_number]->init_assembling(u_ext_sln, spaces, this->add_dirichlet_lift);
-
-              DiscreteProblemDGAssembler<Scalar>* dgAssembler;
-              if (is_DG)
-                dgAssembler = new DiscreteProblemDGAssembler<Scalar>(this->threadAssembler[thread_number], this->spaces, meshes);
+            DiscreteProblemDGAssembler<Scalar>* dgAssembler;
+            if (is_DG)
+              dgAssembler = new DiscreteProblemDGAssembler<Scalar>(this->threadAssembler[thread_number], this->spaces, meshes, element_first_states, face_connectivities);
 
-              for (int state_i = start; state_i < end; state_i++)
-              {
-                // Exception already thrown -> exit the loop.
-                if (!this->exceptionMessageCaughtInParallelBlock.empty())
-                  break;
+            for (int state_i = start; state_i < end; state_i++)
+            {
+              // Exception already thrown -> exit the loop.
+              if (!this->exceptionMessageCaughtInParallelBlock.empty())
+                break;
 
-                Traverse::State* current_state = states[state_i];
+              Traverse::State* current_state = states[state_i];
 
-                this->threadAssembler[thread_number]->init_assembling_one_state(spaces, current_state);
+              this->threadAssembler[thread_number]->init_assembling_one_state(spaces, current_state);
 
-                this->threadAssembler[thread_number]->assemble_one_state();
+              this->threadAssembler[thread_number]->assemble_one_state();
 
-                if (is_DG)
-                {
-                  dgAssembler->init_assembling_one_state(current_state);
-                  dgAssembler->assemble_one_state();
-                  dgAssembler->deinit_assembling_one_state();
-                }
-                this->threadAssembler[thread_number]->deinit_assembling_one_state();
+              if (is_DG)
+              {
+                dgAssembler->init_assembling_one_state(current_state, state_i);
+                dgAssembler->assemble_one_state();
+                dgAssembler->deinit_assembling_one_state();
               }
+              this->threadAssembler[thread_number]->deinit_assembling_one_state();
+            }
 
-              if (is_DG)
-                delete dgAssembler;
+            if (is_DG)
+              delete dgAssembler;
 
-              this->threadAssembler[thread_number]->deinit_assembling();
+            this->threadAssembler[thread_number]->deinit_assembling();
+          }
+          catch (Hermes::Exceptions::Exception& e)
+          {
+#pragma omp critical (exceptionMessageCaughtInParallelBlock)
+            this->exceptionMessageCaughtInParallelBlock = e.info();
+          }
+          catch (std::exception& e)
+          {
+#pragma omp critical (exceptionMessageCaughtInParallelBlock)
+            this->exceptionMessageCaughtInParallelBlock = e.what();
+          }
+        }
+
+        if (record)
+        {
+          for (int i = 0; i < num_threads; i++)
+          {
+            if (record_mats)
+            {
+              record_mats[i]->add_to(this->current_mat);
+              delete record_mats[i];
+              this->threadAssembler[i]->set_matrix(this->current_mat);
             }
-            catch (Hermes::Exceptions::Exception& e)
+            if (record_rhss)
             {
-#pragma omp critical (exceptionMessageCaughtInParallelBlock)
-              this->exceptionMessageCaughtInParallelBlock = e.info();
+              record_rhss[i]->add_to(this->current_rhs);
+              delete record_rhss[i];
+              this->threadAssembler[i]->set_rhs(this->current_rhs);
             }
-            catch (std::exception& e)
+            if (record_dirichlet_lift_rhss)
             {
-#pragma omp critical (exceptionMessageCaughtInParallelBlock)
-              this->exceptionMessageCaughtInParallelBlock = e.what();
+              record_dirichlet_lift_rhss[i]->add_to(dirichlet_lift_rhs);
+              delete record_dirichlet_lift_rhss[i];
+              this->threadAssembler[i]->dirichlet_lift_rhs = dirichlet_lift_rhs;
             }
           }
+          delete[] record_mats;
+          delete[] record_rhss;
+          delete[] record_dirichlet_lift_rhss;
         }
 
-        if (this->nonlinear && coeff_vec)
+        if (is_DG)
         {
-          for (int i = 0; i < this->spaces_size; i++)
-            delete u_ext_sln[i];
-          delete[] u_ext_sln;
+          DiscreteProblemDGAssembler<Scalar>::free_element_first_states(element_first_states, meshes);
+          free_with_check(face_connectivities);
         }
       }
 
+      if (u_ext_sln)
+      {
+        for (int i = 0; i < this->spaces_size; i++)
+          delete u_ext_sln[i];
+        delete[] u_ext_sln;
+      }
+    }
+
+    template<typename Scalar>
+    void DiscreteProblem<Scalar>::set_lean_residual_assembling(bool to_set)
+    {
+      this->lean_residual_assembling = to_set;
+      if (!to_set)
+        this->free_lean_residual_states();
+    }
+
+    template<typename Scalar>
+    void DiscreteProblem<Scalar>::invalidate_lean_residual_assembling()
+    {
+      this->free_lean_residual_states();
+    }
+
+    template<typename Scalar>
+    void DiscreteProblem<Scalar>::free_lean_residual_states()
+    {
+      for (unsigned int i = 0; i < this->lean_residual_num_states; i++)
+        delete this->lean_residual_states[i];
+      free_with_check(this->lean_residual_states);
+      this->lean_residual_num_states = 0;
+      this->lean_residual_meshes.clear();
+      this->lean_residual_mesh_seqs.clear();
+      this->lean_residual_space_seqs.clear();
+      this->lean_residual_wf = nullptr;
+    }
+
+    template<typename Scalar>
+    bool DiscreteProblem<Scalar>::lean_residual_states_reusable() const
+    {
+      if (!this->lean_residual_assembling || !this->lean_residual_states || this->lean_residual_wf != this->wf.get())
+        return false;
+      if (this->wf->is_DG() || this->static_condensation)
+        return false;
+
+      if (this->lean_residual_space_seqs.size() != this->spaces_size)
+        return false;
+      for (int i = 0; i < this->spaces_size; i++)
+        if (this->lean_residual_space_seqs[i] != this->spaces[i]->get_seq())
+          return false;
+      for (unsigned int i = 0; i < this->lean_residual_meshes.size(); i++)
+        if (this->lean_residual_mesh_seqs[i] != this->lean_residual_meshes[i]->get_seq())
+          return false;
+
+      return true;
+    }
+
+    template<typename Scalar>
+    bool DiscreteProblem<Scalar>::assemble_residual(Scalar*& coeff_vec, Vector<Scalar>* rhs)
+    {
+      if (!this->lean_residual_states_reusable())
+        return this->assemble(coeff_vec, rhs);
+
       this->tick();
 
-      // Deinitialize states && previous iterations.
-      this->deinit_assembling(states, num_states);
+      bool result = this->set_matrix(nullptr) && this->set_rhs(rhs);
+      this->set_rhs_block(nullptr);
 
-      // Finish the algebraic structures for solving.
-      if (this->current_mat)
-        this->current_mat->finish();
-      if (this->current_rhs)
-        this->current_rhs->finish();
+      // The vector only, the matrix structure of the last assembling is left as it is.
+      int ndof = Space<Scalar>::get_num_dofs(this->spaces);
+      if (rhs->get_size() == ndof)
+        rhs->zero();
+      else
+        rhs->alloc(ndof);
+
+      for (unsigned int space_i = 0; space_i < spaces.size(); space_i++)
+        spaces[space_i]->update_assembly_list_cache();
+
+      this->exceptionMessageCaughtInParallelBlock.clear();
+      if (this->add_dirichlet_lift)
+        this->dirichlet_lift_rhs->alloc(ndof);
+
+      this->assemble_states(coeff_vec, this->lean_residual_states, this->lean_residual_num_states, this->lean_residual_meshes);
+
+      // Only the Dirichlet lift, the states are kept.
+      this->deinit_assembling(nullptr, 0);
+
+      rhs->finish();
 
       if (!this->exceptionMessageCaughtInParallelBlock.empty())
         throw Hermes::Exceptions::Exception(this->exceptionMessageCaughtInParallelBlock.c_str());
 
-      Element* e;
-      for (unsigned int space_i = 0; space_i < spaces.size(); space_i++)
+      this->tick();
+      this->info("\tDiscreteProblem: Residual assembling: %s.", this->last_str().c_str());
+
+      return result;
+    }
+
+    template<typename Scalar>
+    DGFaceConnectivity<Scalar>** DiscreteProblem<Scalar>::init_dg_face_connectivities(const std::vector<MeshSharedPtr>& meshes)
+    {
+      DGFaceConnectivity<Scalar>** face_connectivities = malloc_with_check<DGFaceConnectivity<Scalar>*>(meshes.size());
+      std::vector<DGFaceConnectivity<Scalar>*> used_face_connectivities;
+      for (unsigned int i = 0; i < meshes.size(); i++)
       {
-        for_all_active_elements(e, spaces[space_i]->get_mesh())
+        face_connectivities[i] = nullptr;
+
+        // Already used for another of meshes.
+        for (unsigned int j = 0; j < used_face_connectivities.size() && !face_connectivities[i]; j++)
+          if (used_face_connectivities[j]->get_mesh() == meshes[i])
+            face_connectivities[i] = used_face_connectivities[j];
+        if (face_connectivities[i])
+          continue;
+
+        // From the last assembling, if the mesh has not changed.
+        for (unsigned int j = 0; j < this->dg_face_connectivities.size() && !face_connectivities[i]; j++)
         {
-          spaces[space_i]->edata[e->id].changed_in_last_adaptation = false;
-          e->visited = false;
+          if (this->dg_face_connectivities[j] && this->dg_face_connectivities[j]->get_mesh() == meshes[i] && this->dg_face_connectivities[j]->is_up_to_date())
+          {
+            face_connectivities[i] = this->dg_face_connectivities[j];
+            this->dg_face_connectivities[j] = nullptr;
+          }
         }
+
+        if (!face_connectivities[i])
+          face_connectivities[i] = new DGFaceConnectivity<Scalar>(meshes[i]);
+        used_face_connectivities.push_back(face_connectivities[i]);
       }
 
-      this->tick();
-      this->info("\tDiscreteProblem: De-initialization: %s.", this->last_str().c_str());
+      // The rest is for meshes that changed, or are no longer assembled on.
+      for (unsigned int j = 0; j < this->dg_face_connectivities.size(); j++)
+        delete this->dg_face_connectivities[j];
+      this->dg_face_connectivities = used_face_connectivities;
 
-      return result;
+      return face_connectivities;
     }
 
     template<typename Scalar>
@@ -436,6 +859,8 @@ namespace Hermes
       // Very important.
       if (this->add_dirichlet_lift && this->current_rhs)
         this->current_rhs->add_vector(this->dirichlet_lift_rhs);
+      if (this->add_dirichlet_lift && this->current_rhs_block)
+        this->current_rhs_block->add_vector_to_all(this->dirichlet_lift_rhs);
     }
 
     template class HERMES_API DiscreteProblem < double > ;
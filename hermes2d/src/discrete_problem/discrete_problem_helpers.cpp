@@ -73,7 +73,7 @@ namespace Hermes
       }
 
       template<typename Scalar>
-      DiscreteProblemMatrixVector<Scalar>::DiscreteProblemMatrixVector() : current_mat(nullptr), current_rhs(nullptr)
+      DiscreteProblemMatrixVector<Scalar>::DiscreteProblemMatrixVector() : current_mat(nullptr), current_rhs(nullptr), current_rhs_block(nullptr)
       {
       }
 
@@ -91,6 +91,12 @@ namespace Hermes
         return true;
       }
 
+      template<typename Scalar>
+      void DiscreteProblemMatrixVector<Scalar>::set_rhs_block(SimpleVectorBlock<Scalar>* rhs_block)
+      {
+        this->current_rhs_block = rhs_block;
+      }
+
       template class HERMES_API DiscreteProblemRungeKutta < double > ;
       template class HERMES_API DiscreteProblemRungeKutta < std::complex<double> > ;
 
@@ -73,7 +73,8 @@ namespace Hermes
     DiscreteProblemIntegrationOrderCalculator<Scalar>::DiscreteProblemIntegrationOrderCalculator(DiscreteProblemSelectiveAssembler<Scalar>* selectiveAssembler) :
       selectiveAssembler(selectiveAssembler),
       current_state(nullptr),
-      u_ext(nullptr)
+      u_ext(nullptr),
+      u_ext_fn_orders(nullptr)
     {
     }
 
@@ -267,7 +268,14 @@ namespace Hermes
     {
       Func<Hermes::Ord>** u_ext_func = nullptr;
       bool surface_form = (this->current_state->isurf > -1);
-      if (this->u_ext)
+      if (this->u_ext_fn_orders)
+      {
+        u_ext_func = new Func<Hermes::Ord>*[this->selectiveAssembler->spaces_size];
+
+        for (int i = 0; i < this->selectiveAssembler->spaces_size; i++)
+          u_ext_func[i] = &func_order[this->current_state->e[i] ? this->u_ext_fn_orders[i] : 0];
+      }
+      else if (this->u_ext)
       {
         u_ext_func = new Func<Hermes::Ord>*[this->selectiveAssembler->spaces_size];
 
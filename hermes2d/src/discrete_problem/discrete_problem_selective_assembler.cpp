@@ -27,7 +27,11 @@ namespace Hermes
       matrix_structure_reusable(false),
       previous_mat(nullptr),
       vector_structure_reusable(false),
-      previous_rhs(nullptr)
+      previous_rhs(nullptr),
+      sparsity_pattern(nullptr),
+      sparsity_pattern_force_diagonal_blocks(false),
+      condensed_dofs(nullptr),
+      sparsity_pattern_condensed(false)
     {
     }
 
@@ -36,6 +40,177 @@ namespace Hermes
     {
       if (sp_seq)
         delete[] sp_seq;
+      invalidate_sparsity_pattern();
+    }
+
+    template<typename Scalar>
+    void DiscreteProblemSelectiveAssembler<Scalar>::invalidate_sparsity_pattern()
+    {
+      if (this->sparsity_pattern)
+      {
+        delete this->sparsity_pattern;
+        this->sparsity_pattern = nullptr;
+      }
+      this->sparsity_pattern_sp_seq.clear();
+      this->sparsity_pattern_dof_stamps.clear();
+    }
+
+    template<typename Scalar>
+    bool DiscreteProblemSelectiveAssembler<Scalar>::sparsity_pattern_reusable(std::vector<SpaceSharedPtr<Scalar> >& spaces, int ndof) const
+    {
+      if (!this->sparsity_pattern || this->sparsity_pattern->get_size() != (unsigned int)ndof)
+        return false;
+      if (this->sparsity_pattern_force_diagonal_blocks != this->force_diagonal_blocks)
+        return false;
+      if (this->sparsity_pattern_condensed != (this->condensed_dofs != nullptr))
+        return false;
+      if (this->sparsity_pattern_sp_seq.size() != spaces.size())
+        return false;
+      for (unsigned int i = 0; i < spaces.size(); i++)
+        if (this->sparsity_pattern_sp_seq[i] != spaces[i]->get_seq() || this->sparsity_pattern_dof_stamps[i] != spaces[i]->get_dof_assignment_stamp())
+          return false;
+      return true;
+    }
+
+    template<typename Scalar>
+    SparsityPattern* DiscreteProblemSelectiveAssembler<Scalar>::build_sparsity_pattern(std::vector<SpaceSharedPtr<Scalar> >& spaces, Traverse::State** states, unsigned int num_states, int ndof)
+    {
+      bool **blocks = this->wf->get_blocks(this->force_diagonal_blocks);
+      int num_threads = std::max(1, std::min((int)this->num_threads_used, (int)num_states));
+
+      // 1 - Lists of (nonnegative) dofs for every state and space, the list of the space space_i
+      // on the state state_i is list_dofs[list_start[state_i * spaces_size + space_i]] ... list_dofs[list_start[state_i * spaces_size + space_i + 1] - 1].
+      int num_lists = num_states * spaces_size;
+      int* list_start = calloc_with_check<int>(num_lists + 1);
+      std::vector<int>* thread_list_dofs = new std::vector<int>[num_threads];
+
+#pragma omp parallel num_threads(num_threads)
+      {
+        int thread_number = omp_get_thread_num();
+        int start = (num_states / num_threads) * thread_number;
+        int end = (num_states / num_threads) * (thread_number + 1);
+        if (thread_number == num_threads - 1)
+          end = num_states;
+
+        AsmList<Scalar> al;
+        for (int state_i = start; state_i < end; state_i++)
+        {
+          for (unsigned int space_i = 0; space_i < spaces_size; space_i++)
+          {
+            if (!states[state_i]->e[space_i])
+              continue;
+            spaces[space_i]->get_element_assembly_list(states[state_i]->e[space_i], &al);
+            for (unsigned int i = 0; i < al.cnt; i++)
+            {
+              if (al.dof[i] >= 0 && !(this->condensed_dofs && this->condensed_dofs[al.dof[i]]))
+              {
+                thread_list_dofs[thread_number].push_back(al.dof[i]);
+                list_start[state_i * spaces_size + space_i + 1]++;
+              }
+            }
+          }
+        }
+      }
+
+      for (int list_i = 0; list_i < num_lists; list_i++)
+        list_start[list_i + 1] += list_start[list_i];
+      int* list_dofs = malloc_with_check<int>(list_start[num_lists]);
+      for (int thread_i = 0, position = 0; thread_i < num_threads; thread_i++)
+      {
+        if (!thread_list_dofs[thread_i].empty())
+          memcpy(list_dofs + position, &thread_list_dofs[thread_i][0], thread_list_dofs[thread_i].size() * sizeof(int));
+        position += thread_list_dofs[thread_i].size();
+      }
+      delete[] thread_list_dofs;
+
+      // 2 - Transposition: the lists every dof appears in, col_lists[col_start[dof]] ... col_lists[col_start[dof + 1] - 1].
+      int* col_start = calloc_with_check<int>(ndof + 1);
+      for (int i = 0; i < list_start[num_lists]; i++)
+        col_start[list_dofs[i] + 1]++;
+      for (int dof = 0; dof < ndof; dof++)
+        col_start[dof + 1] += col_start[dof];
+      int* col_lists = malloc_with_check<int>(col_start[ndof]);
+      int* col_position = malloc_with_check<int>(ndof);
+      memcpy(col_position, col_start, ndof * sizeof(int));
+      for (int list_i = 0; list_i < num_lists; list_i++)
+        for (int i = list_start[list_i]; i < list_start[list_i + 1]; i++)
+          col_lists[col_position[list_dofs[i]]++] = list_i;
+      free_with_check(col_position);
+
+      // 3 - Columns of the matrix: the column dof (of the space n) contains all rows from the lists of spaces m (blocks[m][n])
+      // on the states dof appears on. Duplicities are removed by a per-thread marker array, the first pass
+      // only counts the entries, so that Ap can be calculated by a prefix sum and Ai is filled directly.
+      int* Ap = malloc_with_check<int>(ndof + 1);
+      int* Ai = nullptr;
+      Ap[0] = 0;
+      for (int pass = 0; pass < 2; pass++)
+      {
+#pragma omp parallel num_threads(this->num_threads_used)
+        {
+          int* marker = malloc_with_check<int>(ndof);
+          for (int dof = 0; dof < ndof; dof++)
+            marker[dof] = -1;
+
+#pragma omp for schedule(dynamic, 256)
+          for (int col = 0; col < ndof; col++)
+          {
+            int count = 0;
+
+            // Static condensation: only the diagonal entry.
+            if (this->condensed_dofs && this->condensed_dofs[col])
+            {
+              if (pass == 1)
+                Ai[Ap[col]] = col;
+              count = 1;
+            }
+
+            for (int i = col_start[col]; i < col_start[col + 1]; i++)
+            {
+              int state_i = col_lists[i] / spaces_size;
+              int n = col_lists[i] % spaces_size;
+              for (unsigned int m = 0; m < spaces_size; m++)
+              {
+                if (!blocks[m][n])
+                  continue;
+                int list_i = state_i * spaces_size + m;
+                for (int j = list_start[list_i]; j < list_start[list_i + 1]; j++)
+                {
+                  int row = list_dofs[j];
+                  if (marker[row] != col)
+                  {
+                    marker[row] = col;
+                    if (pass == 1)
+                      Ai[Ap[col] + count] = row;
+                    count++;
+                  }
+                }
+              }
+            }
+
+            if (pass == 0)
+              Ap[col + 1] = count;
+            else
+              std::sort(Ai + Ap[col], Ai + Ap[col + 1]);
+          }
+
+          free_with_check(marker);
+        }
+
+        if (pass == 0)
+        {
+          for (int col = 0; col < ndof; col++)
+            Ap[col + 1] += Ap[col];
+          Ai = malloc_with_check<int>(Ap[ndof]);
+        }
+      }
+
+      free_with_check(list_start);
+      free_with_check(list_dofs);
+      free_with_check(col_start);
+      free_with_check(col_lists);
+      free_with_check(blocks, true);
+
+      return new SparsityPattern(ndof, Ap, Ai);
     }
 
     template<typename Scalar>
@@ -54,9 +229,41 @@ namespace Hermes
           rhs->zero();
       }
 
-      if ((!matrix_structure_reusable || (mat != this->previous_mat)) && mat)
+      bool create_matrix_structure = (!matrix_structure_reusable || (mat != this->previous_mat)) && mat;
+      bool is_DG = this->wf->is_DG() && !this->wf->mfDG.empty();
+
+      if (create_matrix_structure && !is_DG)
+      {
+        // Spaces have changed (or this is a different matrix): create the matrix from the sparsity pattern,
+        // that is only built again if the spaces have changed.
+        matrix_structure_reusable = true;
+        mat->free();
+
+        this->tick();
+        if (!this->sparsity_pattern_reusable(spaces, ndof))
+        {
+          this->invalidate_sparsity_pattern();
+          this->sparsity_pattern = this->build_sparsity_pattern(spaces, states, num_states, ndof);
+          this->sparsity_pattern_force_diagonal_blocks = this->force_diagonal_blocks;
+          this->sparsity_pattern_condensed = (this->condensed_dofs != nullptr);
+          for (unsigned int i = 0; i < spaces_size; i++)
+          {
+            this->sparsity_pattern_sp_seq.push_back(spaces[i]->get_seq());
+            this->sparsity_pattern_dof_stamps.push_back(spaces[i]->get_dof_assignment_stamp());
+          }
+          this->tick();
+          this->info("\tDiscreteProblemSelectiveAssembler: Sparsity pattern: %s.", this->last_str().c_str());
+        }
+
+        mat->alloc_from_pattern(this->sparsity_pattern);
+
+        this->tick();
+        this->info("\tDiscreteProblemSelectiveAssembler: Finish: %s.", this->last_str().c_str());
+      }
+
+      if (create_matrix_structure && is_DG)
       {
-        // Spaces have changed: create the matrix from scratch.
+        // DG: neighbors contribute to the structure as well, create the matrix from scratch.
         matrix_structure_reusable = true;
         mat->free();
         mat->prealloc(ndof);
@@ -277,6 +484,7 @@ namespace Hermes
 
       this->matrix_structure_reusable = false;
       this->vector_structure_reusable = false;
+      this->invalidate_sparsity_pattern();
 
       if (spaces_size == 0)
         return;
@@ -20,16 +20,48 @@
 #include "weakform/weakform.h"
 #include "function/exact_solution.h"
 
+using namespace Hermes::Algebra::DenseMatrixOperations;
+
 namespace Hermes
 {
   namespace Hermes2D
   {
+    template<typename Scalar>
+    void StaticCondensationElement<Scalar>::free()
+    {
+      free_with_check(this->dofs);
+      free_with_check(this->lu_bb, true);
+      free_with_check(this->pivots);
+      free_with_check(this->A_sb);
+      free_with_check(this->X);
+      free_with_check(this->y);
+      this->ns = this->nb = 0;
+    }
+
+    /// Adds the (nonzero) entries of a local matrix to the local system of the static condensation, the same as Matrix::add().
+    template<typename Scalar>
+    static void add_to_condensation_matrix(Scalar* condensation_matrix, int n, unsigned int rows_cnt, unsigned int cols_cnt, Scalar* local_matrix, int* row_positions, int* col_positions, int size)
+    {
+      for (unsigned int i = 0; i < rows_cnt; i++)
+      {
+        if (row_positions[i] < 0)
+          continue;
+        for (unsigned int j = 0; j < cols_cnt; j++)
+        {
+          Scalar entry = local_matrix[i * size + j];
+          if (entry != 0. && col_positions[j] >= 0)
+            condensation_matrix[row_positions[i] * n + col_positions[j]] += entry;
+        }
+      }
+    }
+
     template<typename Scalar>
     DiscreteProblemThreadAssembler<Scalar>::DiscreteProblemThreadAssembler(DiscreteProblemSelectiveAssembler<Scalar>* selectiveAssembler, bool nonlinear) :
-      pss(nullptr), refmaps(nullptr), u_ext(nullptr),
+      pss(nullptr), refmaps(nullptr), u_ext(nullptr), u_ext_coeff_vec(nullptr), u_ext_add_dir_lift(true), u_ext_shape_func(nullptr),
       selectiveAssembler(selectiveAssembler), integrationOrderCalculator(selectiveAssembler),
       ext_funcs(nullptr), ext_funcs_allocated_size(0), ext_funcs_local(nullptr), ext_funcs_local_allocated_size(0),
-      funcs_wf_initialized(false), funcs_space_initialized(false), spaces_size(0), nonlinear(nonlinear), reusable_DOFs(nullptr), reusable_Dirichlet(nullptr)
+      funcs_wf_initialized(false), funcs_space_initialized(false), spaces_size(0), nonlinear(nonlinear),
+      condensed_dofs(nullptr), condensation_elements(nullptr), condensation_ns(0), reusable_DOFs(nullptr), reusable_Dirichlet(nullptr)
     {
       // Init the memory pool - if PJLIB is linked, it will do the magic, if not, it will initialize the pointer to null.
       this->init_funcs_memory_pool();
@@ -106,6 +138,33 @@ namespace Hermes
       this->integrationOrderCalculator.u_ext = this->u_ext;
     }
 
+    template<typename Scalar>
+    void DiscreteProblemThreadAssembler<Scalar>::set_u_ext_coeff_vec(const Scalar* coeff_vec, int* dof_offsets, bool add_dir_lift)
+    {
+      this->u_ext_coeff_vec = coeff_vec;
+      this->u_ext_add_dir_lift = add_dir_lift;
+      if (coeff_vec)
+        memcpy(this->u_ext_dof_offsets, dof_offsets, this->spaces_size * sizeof(int));
+    }
+
+    template<typename Scalar>
+    void DiscreteProblemThreadAssembler<Scalar>::calc_u_ext_fn_orders(const std::vector<SpaceSharedPtr<Scalar> >& spaces)
+    {
+      // The same as the order of the Solution created from the coefficient vector.
+      for (int j = 0; j < this->spaces_size; j++)
+      {
+        Element* e = current_state->e[j];
+        if (!e)
+          continue;
+
+        int o = spaces[j]->get_element_order(e->id);
+        o = std::max(H2D_GET_H_ORDER(o), H2D_GET_V_ORDER(o));
+        for (unsigned char k = 0; k < e->get_nvert(); k++)
+          o = std::max(o, spaces[j]->get_edge_order(e, k));
+        this->u_ext_fn_orders[j] = o;
+      }
+    }
+
     template<typename Scalar>
     void DiscreteProblemThreadAssembler<Scalar>::init_assembling(Solution<Scalar>** u_ext_sln, const std::vector<SpaceSharedPtr<Scalar> >& spaces, bool add_dirichlet_lift_)
     {
@@ -142,11 +201,22 @@ namespace Hermes
       // - u_ext.
       if (this->nonlinear)
       {
-        init_u_ext(spaces, u_ext_sln);
-        for (unsigned j = 0; j < this->wf->get_neq(); j++)
+        if (this->u_ext_coeff_vec)
+        {
+          // Evaluated directly, nothing to transform.
+          free_u_ext();
+          this->integrationOrderCalculator.u_ext = nullptr;
+          this->integrationOrderCalculator.u_ext_fn_orders = this->u_ext_fn_orders;
+        }
+        else
         {
-          fns.push_back(u_ext[j]);
-          u_ext[j]->set_quad_2d(&g_quad_2d_std);
+          init_u_ext(spaces, u_ext_sln);
+          this->integrationOrderCalculator.u_ext_fn_orders = nullptr;
+          for (unsigned j = 0; j < this->wf->get_neq(); j++)
+          {
+            fns.push_back(u_ext[j]);
+            u_ext[j]->set_quad_2d(&g_quad_2d_std);
+          }
         }
       }
 
@@ -192,6 +262,9 @@ namespace Hermes
         if (this->nonlinear)
           this->u_ext_funcs[space_i] = preallocate_fn<Scalar>(this->FuncMemoryPool);
       }
+
+      if (this->nonlinear)
+        this->u_ext_shape_func = preallocate_fn<double>(this->FuncMemoryPool);
     }
 
     template<typename Scalar>
@@ -274,6 +347,9 @@ namespace Hermes
         if (this->nonlinear)
           delete this->u_ext_funcs[space_i];
       }
+
+      if (this->nonlinear)
+        delete this->u_ext_shape_func;
     }
 
     template<typename Scalar>
@@ -370,10 +446,162 @@ namespace Hermes
       }
 
       // Volumetric integration order.
+      if (this->nonlinear && this->u_ext_coeff_vec)
+        this->calc_u_ext_fn_orders(spaces);
       this->order = this->integrationOrderCalculator.calculate_order(spaces, this->refmaps, this->wf);
 
       // Init the variables (funcs, geometry, ...)
       this->init_calculation_variables();
+
+      if (this->condensed_dofs)
+        this->init_condensation_one_state();
+    }
+
+    template<typename Scalar>
+    void DiscreteProblemThreadAssembler<Scalar>::init_condensation_one_state()
+    {
+      // The bubble functions of an element have to be assembled on exactly one state.
+      for (int j = 0; j < this->spaces_size; j++)
+      {
+        if (!current_state->e[j] || current_state->sub_idx[j] != 0)
+          throw Exceptions::Exception("Static condensation needs all spaces and external functions on the same mesh.");
+      }
+
+      // The remaining DOFs first, then the condensed ones.
+      this->condensation_dofs.clear();
+      for (int condensed = 0; condensed < 2; condensed++)
+      {
+        for (int j = 0; j < this->spaces_size; j++)
+        {
+          for (unsigned int i = 0; i < this->als[j].cnt; i++)
+          {
+            int dof = this->als[j].dof[i];
+            if (dof < 0 || this->condensed_dofs[dof] != (condensed == 1))
+              continue;
+            if (std::find(this->condensation_dofs.begin(), this->condensation_dofs.end(), dof) == this->condensation_dofs.end())
+              this->condensation_dofs.push_back(dof);
+          }
+        }
+        if (condensed == 0)
+          this->condensation_ns = this->condensation_dofs.size();
+      }
+
+      int n = this->condensation_dofs.size();
+      this->condensation_matrix.assign(n * n, Scalar(0.));
+      this->condensation_rhs.assign(n, Scalar(0.));
+      this->condensation_lift.assign(n, Scalar(0.));
+    }
+
+    template<typename Scalar>
+    void DiscreteProblemThreadAssembler<Scalar>::get_condensation_positions(AsmList<Scalar>* al, int* positions)
+    {
+      for (unsigned int i = 0; i < al->cnt; i++)
+      {
+        if (al->dof[i] < 0)
+          positions[i] = -1;
+        else
+          positions[i] = std::find(this->condensation_dofs.begin(), this->condensation_dofs.end(), al->dof[i]) - this->condensation_dofs.begin();
+      }
+    }
+
+    template<typename Scalar>
+    void DiscreteProblemThreadAssembler<Scalar>::condense_one_state()
+    {
+      int n = this->condensation_dofs.size();
+      int ns = this->condensation_ns;
+      int nb = n - ns;
+      if (n == 0)
+        return;
+      int* dofs = &this->condensation_dofs[0];
+      Scalar* local_matrix = &this->condensation_matrix[0];
+      StaticCondensationElement<Scalar>& element_data = this->condensation_elements[current_state->e[0]->id];
+
+      if (this->current_mat)
+      {
+        element_data.free();
+        element_data.ns = ns;
+        element_data.nb = nb;
+        element_data.dofs = malloc_with_check<int>(n);
+        memcpy(element_data.dofs, dofs, n * sizeof(int));
+
+        if (nb > 0)
+        {
+          element_data.lu_bb = new_matrix<Scalar>(nb);
+          for (int b1 = 0; b1 < nb; b1++)
+            for (int b2 = 0; b2 < nb; b2++)
+              element_data.lu_bb[b1][b2] = local_matrix[(ns + b1) * n + ns + b2];
+          element_data.pivots = malloc_with_check<int>(nb);
+          double d;
+          ludcmp(element_data.lu_bb, nb, element_data.pivots, &d);
+
+          element_data.A_sb = malloc_with_check<Scalar>(ns * nb);
+          for (int s = 0; s < ns; s++)
+            for (int b = 0; b < nb; b++)
+              element_data.A_sb[s * nb + b] = local_matrix[s * n + ns + b];
+
+          // X = A_bb^{-1} A_bs, column by column.
+          element_data.X = malloc_with_check<Scalar>(nb * ns);
+          Scalar* column = malloc_with_check<Scalar>(nb);
+          for (int s = 0; s < ns; s++)
+          {
+            for (int b = 0; b < nb; b++)
+              column[b] = local_matrix[(ns + b) * n + s];
+            lubksb(element_data.lu_bb, nb, element_data.pivots, column);
+            for (int b = 0; b < nb; b++)
+              element_data.X[b * ns + s] = column[b];
+          }
+          free_with_check(column);
+
+          // The Schur complement A_ss - A_sb X in place of A_ss.
+          for (int s1 = 0; s1 < ns; s1++)
+          {
+            for (int s2 = 0; s2 < ns; s2++)
+            {
+              Scalar sum = 0.;
+              for (int b = 0; b < nb; b++)
+                sum += element_data.A_sb[s1 * nb + b] * element_data.X[b * ns + s2];
+              local_matrix[s1 * n + s2] -= sum;
+            }
+          }
+
+          element_data.y = calloc_with_check<Scalar>(nb);
+        }
+
+        this->current_mat->add(ns, ns, local_matrix, dofs, dofs, n);
+
+        // The rows of the condensed DOFs are the identity.
+        for (int b = 0; b < nb; b++)
+          this->current_mat->add(dofs[ns + b], dofs[ns + b], 1.0);
+      }
+
+      if (!this->current_rhs)
+        return;
+
+      if (nb > 0 && (element_data.ns != ns || element_data.nb != nb || !element_data.dofs || memcmp(element_data.dofs, dofs, n * sizeof(int))))
+        throw Exceptions::Exception("Static condensation: the right-hand side can only be assembled without the matrix on the spaces of the last assembled matrix.");
+
+      // g_s = f_s - A_sb A_bb^{-1} f_b, for the vector forms and the Dirichlet lift.
+      for (int part = 0; part < 2; part++)
+      {
+        if (part == 1 && !this->add_dirichlet_lift)
+          continue;
+        Scalar* local_rhs = (part == 0 ? &this->condensation_rhs[0] : &this->condensation_lift[0]);
+        Vector<Scalar>* global_rhs = (part == 0 ? this->current_rhs : this->dirichlet_lift_rhs);
+
+        if (nb > 0)
+        {
+          lubksb(element_data.lu_bb, nb, element_data.pivots, local_rhs + ns);
+          for (int s = 0; s < ns; s++)
+            for (int b = 0; b < nb; b++)
+              local_rhs[s] -= element_data.A_sb[s * nb + b] * local_rhs[ns + b];
+          for (int b = 0; b < nb; b++)
+            element_data.y[b] = (part == 0 ? local_rhs[ns + b] : element_data.y[b] + local_rhs[ns + b]);
+        }
+
+        for (int s = 0; s < ns; s++)
+          if (local_rhs[s] != Scalar(0.))
+            global_rhs->add(dofs[s], local_rhs[s]);
+      }
     }
 
     template<typename Scalar>
@@ -427,15 +655,66 @@ namespace Hermes
     }
 
     template<typename Scalar>
-    void DiscreteProblemThreadAssembler<Scalar>::init_u_ext_values(int order)
+    void DiscreteProblemThreadAssembler<Scalar>::init_u_ext_values(int order, Func<double>* (*shape_funcs)[H2D_MAX_LOCAL_BASIS_SIZE])
     {
-      if (this->nonlinear)
+      if (!this->nonlinear)
+        return;
+
+      if (!this->u_ext_coeff_vec)
       {
         for (int i = 0; i < spaces_size; i++)
         {
           if (u_ext[i]->get_active_element())
             init_fn_preallocated(u_ext_funcs[i], u_ext[i], order);
         }
+        return;
+      }
+
+      // u_ext = sum of coefficient * shape function over the assembly list.
+      for (int i = 0; i < spaces_size; i++)
+      {
+        if (!current_state->e[i])
+          continue;
+
+        Func<Scalar>* u = u_ext_funcs[i];
+        u->np = this->u_ext_shape_func->np = 0;
+        for (unsigned int k = 0; k < als[i].cnt; k++)
+        {
+          int dof = als[i].dof[k];
+          Scalar coef = als[i].coef[k] * (dof >= 0 ? this->u_ext_coeff_vec[dof + this->u_ext_dof_offsets[i]] : (this->u_ext_add_dir_lift ? 1.0 : 0.0));
+
+          Func<double>* shape_func;
+          if (shape_funcs)
+            shape_func = shape_funcs[i][k];
+          else
+          {
+            pss[i]->set_active_shape(als[i].idx[k]);
+            init_fn_preallocated(this->u_ext_shape_func, pss[i], refmaps[i], order);
+            shape_func = this->u_ext_shape_func;
+          }
+
+          if (k == 0)
+          {
+            u->np = shape_func->np;
+            u->nc = 1;
+            memset(u->val, 0, u->np * sizeof(Scalar));
+            memset(u->dx, 0, u->np * sizeof(Scalar));
+            memset(u->dy, 0, u->np * sizeof(Scalar));
+#ifdef H2D_USE_SECOND_DERIVATIVES
+            memset(u->laplace, 0, u->np * sizeof(Scalar));
+#endif
+          }
+
+          for (int p = 0; p < u->np; p++)
+          {
+            u->val[p] += coef * shape_func->val[p];
+            u->dx[p] += coef * shape_func->dx[p];
+            u->dy[p] += coef * shape_func->dy[p];
+#ifdef H2D_USE_SECOND_DERIVATIVES
+            u->laplace[p] += coef * shape_func->laplace[p];
+#endif
+          }
+        }
       }
     }
 
@@ -475,7 +754,7 @@ namespace Hermes
     void DiscreteProblemThreadAssembler<Scalar>::assemble_one_state()
     {
       // init - u_ext_func
-      this->init_u_ext_values(this->order);
+      this->init_u_ext_values(this->order, this->funcs);
 
       // init - ext
       this->init_ext_values(this->ext_funcs, this->wf->ext, this->wf->u_ext_fn, this->order, this->u_ext_funcs, &this->geometry);
@@ -493,7 +772,7 @@ namespace Hermes
           this->assemble_matrix_form(this->wf->mfvol[current_mfvol_i], order, funcs[form_j], funcs[form_i], &als[form_i], &als[form_j], n_quadrature_points, &geometry, jacobian_x_weights);
         }
       }
-      if (this->current_rhs)
+      if (this->rhs_assembled())
       {
         for (unsigned short current_vfvol_i = 0; current_vfvol_i < this->wf->vfvol.size(); current_vfvol_i++)
         {
@@ -540,7 +819,7 @@ namespace Hermes
             }
           }
 
-          if (this->current_rhs)
+          if (this->rhs_assembled())
           {
             for (unsigned short current_vfsurf_i = 0; current_vfsurf_i < this->wf->vfsurf.size(); current_vfsurf_i++)
             {
@@ -555,6 +834,9 @@ namespace Hermes
           }
         }
       }
+
+      if (this->condensed_dofs)
+        this->condense_one_state();
     }
 
     template<typename Scalar>
@@ -582,6 +864,17 @@ namespace Hermes
       if (this->rungeKutta)
         u_ext_local += form->u_ext_offset;
 
+      // Form-specific per element data.
+      form->precalculated = form->precalculate(n_quadrature_points, jacobian_x_weights, u_ext_local, geometry, ext_local);
+
+      // Static condensation: everything goes to the local system of the state.
+      bool condense = (this->condensed_dofs != nullptr);
+      if (condense)
+      {
+        this->get_condensation_positions(current_als_i, this->condensation_positions_i);
+        this->get_condensation_positions(current_als_j, this->condensation_positions_j);
+      }
+
       // Actual form-specific calculation.
       for (unsigned int i = 0; i < current_als_i->cnt; i++)
       {
@@ -644,16 +937,25 @@ namespace Hermes
               local_stiffness_matrix[local_matrix_index_array_transposed] = local_stiffness_matrix[local_matrix_index_array];
             }
           }
-          else if (this->add_dirichlet_lift && this->current_rhs)
+          else if (this->add_dirichlet_lift && this->rhs_assembled())
           {
-            this->dirichlet_lift_rhs->add(current_als_i->dof[i], -val);
+            if (condense)
+              this->condensation_lift[this->condensation_positions_i[i]] -= val;
+            else
+              this->dirichlet_lift_rhs->add(current_als_i->dof[i], -val);
           }
         }
       }
 
       // Insert the local stiffness matrix into the global one.
       if (this->current_mat)
-        this->current_mat->add(current_als_i->cnt, current_als_j->cnt, local_stiffness_matrix, current_als_i->dof, current_als_j->dof, H2D_MAX_LOCAL_BASIS_SIZE);
+      {
+        if (condense)
+          add_to_condensation_matrix(&this->condensation_matrix[0], this->condensation_dofs.size(), current_als_i->cnt, current_als_j->cnt, local_stiffness_matrix,
+          this->condensation_positions_i, this->condensation_positions_j, H2D_MAX_LOCAL_BASIS_SIZE);
+        else
+          this->current_mat->add(current_als_i->cnt, current_als_j->cnt, local_stiffness_matrix, current_als_i->dof, current_als_j->dof, H2D_MAX_LOCAL_BASIS_SIZE);
+      }
 
       // Insert also the off-diagonal (anti-)symmetric block, if required.
       if (tra)
@@ -663,9 +965,15 @@ namespace Hermes
         transpose(local_stiffness_matrix, current_als_i->cnt, current_als_j->cnt, H2D_MAX_LOCAL_BASIS_SIZE);
 
         if (this->current_mat)
-          this->current_mat->add(current_als_j->cnt, current_als_i->cnt, local_stiffness_matrix, current_als_j->dof, current_als_i->dof, H2D_MAX_LOCAL_BASIS_SIZE);
+        {
+          if (condense)
+            add_to_condensation_matrix(&this->condensation_matrix[0], this->condensation_dofs.size(), current_als_j->cnt, current_als_i->cnt, local_stiffness_matrix,
+            this->condensation_positions_j, this->condensation_positions_i, H2D_MAX_LOCAL_BASIS_SIZE);
+          else
+            this->current_mat->add(current_als_j->cnt, current_als_i->cnt, local_stiffness_matrix, current_als_j->dof, current_als_i->dof, H2D_MAX_LOCAL_BASIS_SIZE);
+        }
 
-        if (this->add_dirichlet_lift && this->current_rhs)
+        if (this->add_dirichlet_lift && this->rhs_assembled())
         {
           for (unsigned int j = 0; j < current_als_i->cnt; j++)
           {
@@ -676,13 +984,18 @@ namespace Hermes
                 if (current_als_j->dof[i] >= 0)
                 {
                   int local_matrix_index_array = i * H2D_MAX_LOCAL_BASIS_SIZE + j;
-                  this->dirichlet_lift_rhs->add(current_als_j->dof[i], -local_stiffness_matrix[local_matrix_index_array]);
+                  if (condense)
+                    this->condensation_lift[this->condensation_positions_j[i]] -= local_stiffness_matrix[local_matrix_index_array];
+                  else
+                    this->dirichlet_lift_rhs->add(current_als_j->dof[i], -local_stiffness_matrix[local_matrix_index_array]);
                 }
               }
             }
           }
         }
       }
+
+      form->precalculated = false;
     }
 
     template<typename Scalar>
@@ -705,6 +1018,14 @@ namespace Hermes
       if (this->rungeKutta)
         u_ext_local += form->u_ext_offset;
 
+      // Form-specific per element data.
+      form->precalculated = form->precalculate(n_quadrature_points, jacobian_x_weights, u_ext_local, geometry, ext_local);
+
+      // Static condensation: everything goes to the local system of the state.
+      bool condense = (this->condensed_dofs != nullptr);
+      if (condense)
+        this->get_condensation_positions(current_als_i, this->condensation_positions_i);
+
       // Actual form-specific calculation.
       for (unsigned int i = 0; i < current_als_i->cnt; i++)
       {
@@ -729,8 +1050,15 @@ namespace Hermes
         else
           val = form->value(n_quadrature_points, jacobian_x_weights, u_ext_local, v, geometry, ext_local) * form->scaling_factor * current_als_i->coef[i];
 
-        this->current_rhs->add(current_als_i->dof[i], val);
+        if (condense)
+          this->condensation_rhs[this->condensation_positions_i[i]] += val;
+        else if (this->current_rhs_block)
+          this->current_rhs_block->add(form->load_case, current_als_i->dof[i], val);
+        else
+          this->current_rhs->add(current_als_i->dof[i], val);
       }
+
+      form->precalculated = false;
     }
 
     template<typename Scalar>
@@ -789,6 +1117,8 @@ namespace Hermes
       }
     }
 
+    template struct HERMES_API StaticCondensationElement < double > ;
+    template struct HERMES_API StaticCondensationElement < std::complex<double> > ;
     template class HERMES_API DiscreteProblemThreadAssembler < double > ;
     template class HERMES_API DiscreteProblemThreadAssembler < std::complex<double> > ;
   }
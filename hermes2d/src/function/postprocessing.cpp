@@ -602,10 +602,7 @@ namespace Hermes
       void IntegralCalculator<std::complex<double> >::add_results(std::complex<double> * results_local, std::complex<double> * results)
       {
         for (int i = 0; i < this->number_of_integrals; i++)
-        {
-#pragma omp critical (integralAddition)
-          results[i] += results_local[i];
-        }
+          atomic_add(results[i], results_local[i]);
       }
 
       template<typename Scalar>
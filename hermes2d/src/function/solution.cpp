@@ -98,6 +98,7 @@ namespace Hermes
       this->num_components = 0;
 
       mono_coeffs = nullptr;
+      coeff_vec_copy = nullptr;
       elem_coeffs[0] = elem_coeffs[1] = nullptr;
       elem_orders = nullptr;
       dxdy_buffer = nullptr;
@@ -216,6 +217,16 @@ namespace Hermes
       this->element = nullptr;
     }
 
+    template<typename Scalar>
+    void Solution<Scalar>::copy_with_mesh(const Solution<Scalar>* sln)
+    {
+      this->copy(sln);
+
+      MeshSharedPtr mesh_copy(new Mesh);
+      mesh_copy->copy(sln->mesh);
+      this->mesh = mesh_copy;
+    }
+
     template<typename Scalar>
     MeshFunction<Scalar>* Solution<Scalar>::clone() const
     {
@@ -230,6 +241,7 @@ namespace Hermes
       free_with_check(mono_coeffs);
       free_with_check(elem_orders);
       free_with_check(dxdy_buffer);
+      free_with_check(coeff_vec_copy);
 
       for (int i = 0; i < this->num_components; i++)
         free_with_check(elem_coeffs[i]);
@@ -284,20 +296,20 @@ namespace Hermes
         unsigned char i, j, m, row;
         char k, l;
         double x, y, xn, yn;
-        unsigned char n = this->mode ? sqr(o + 1) : (o + 1)*(o + 2) / 2;
+        unsigned char n = mode ? sqr(o + 1) : (o + 1)*(o + 2) / 2;
 
         // loop through all chebyshev points
         mono_lu.mat[mode][o] = new_matrix<double>(n, n);
         for (k = o, row = 0; k >= 0; k--)
         {
           y = o ? cos(k * M_PI / o) : 1.0;
-          for (l = o; l >= (this->mode ? 0 : o - k); l--, row++)
+          for (l = o; l >= (mode ? 0 : o - k); l--, row++)
           {
             x = o ? cos(l * M_PI / o) : 1.0;
 
             // each row of the matrix contains all the monomials x^i*y^j
             for (i = 0, yn = 1.0, m = n - 1; i <= o; i++, yn *= y)
-              for (j = (this->mode ? 0 : i), xn = 1.0; j <= o; j++, xn *= x, m--)
+              for (j = (mode ? 0 : i), xn = 1.0; j <= o; j++, xn *= x, m--)
                 mono_lu.mat[mode][o][row][m] = xn * yn;
           }
         }
@@ -325,12 +337,64 @@ namespace Hermes
       free_with_check(coeffs);
     }
 
+    /// Monomial coefficients of single shape functions, i.e. the columns of the (shape function -> monomial)
+    /// matrix of a (mode, order) pair, so that converting an element is just a linear combination of those.
+    /// Filled on demand, for use by one thread (with its own PrecalcShapeset) in Solution::set_coeff_vector().
+    class ShapeMonoCoeffs
+    {
+    public:
+      ShapeMonoCoeffs(PrecalcShapeset* pss) : pss(pss)
+      {
+      }
+
+      ~ShapeMonoCoeffs()
+      {
+        for (int mode = 0; mode <= 1; mode++)
+          for (int o = 0; o <= 10; o++)
+            for (int l = 0; l < H2D_MAX_SOLUTION_COMPONENTS; l++)
+              for (std::map<int, double*>::iterator it = coeffs[mode][o][l].begin(); it != coeffs[mode][o][l].end(); it++)
+                free_with_check(it->second);
+      }
+
+      /// The monomial matrix (mono_lu) of the (mode, order) pair has to be calculated already.
+      const double* get(Element* e, unsigned char o, int component, int index)
+      {
+        int mode = e->get_mode();
+        std::map<int, double*>::iterator it = coeffs[mode][o][component].find(index);
+        if (it != coeffs[mode][o][component].end())
+          return it->second;
+
+        unsigned char np = g_quad_2d_cheb.get_num_points(o, e->get_mode());
+        double* shape_mono = malloc_with_check<double>(np);
+        pss->set_active_element(e);
+        pss->set_active_shape(index);
+        pss->set_quad_order(o, H2D_FN_VAL);
+        memcpy(shape_mono, pss->get_fn_values(component), np * sizeof(double));
+        lubksb(mono_lu.mat[mode][o], np, mono_lu.perm[mode][o], shape_mono);
+
+        coeffs[mode][o][component][index] = shape_mono;
+        return shape_mono;
+      }
+
+    private:
+      PrecalcShapeset* pss;
+      /// Per mode, order, component: shape function index -> np coefficients.
+      std::map<int, double*> coeffs[2][11][H2D_MAX_SOLUTION_COMPONENTS];
+    };
+
+    template<typename Scalar>
+    bool Solution<Scalar>::coeff_vec_reusable(SpaceSharedPtr<Scalar> space, bool add_dir_lift) const
+    {
+      return this->sln_type == HERMES_SLN && this->coeff_vec_copy && this->mesh == space->get_mesh()
+        && this->coeff_vec_space_seq == space->get_seq() && this->coeff_vec_mesh_seq == this->mesh->get_seq()
+        && this->coeff_vec_dof_stamp == space->get_dof_assignment_stamp()
+        && this->coeff_vec_add_dir_lift == add_dir_lift && this->num_dofs == space->get_num_dofs();
+    }
+
     template<typename Scalar>
     void Solution<Scalar>::set_coeff_vector(SpaceSharedPtr<Scalar> space,
       const Scalar* coeff_vec, bool add_dir_lift, int start_index)
     {
-      PrecalcShapeset pss(space->shapeset);
-
       if (Solution<Scalar>::static_verbose_output)
         Hermes::Mixins::Loggable::Static::info("Solution: set_coeff_vector called.");
 
@@ -343,96 +407,158 @@ namespace Hermes
       if (!space->is_up_to_date())
         throw Exceptions::Exception("Provided 'space' is not up to date.");
 
-      if (Solution<Scalar>::static_verbose_output)
-        Hermes::Mixins::Loggable::Static::info("Solution: set_coeff_vector - solution being freed.");
-
-      this->free();
-
-      this->space_type = space->get_type();
-      this->num_components = pss.get_num_components();
-      this->sln_type = HERMES_SLN;
-      this->mesh = space->get_mesh();
+      // By subtracting space->first_dof we make sure that it does not matter where the
+      // enumeration of dofs in the space starts. This ca be either zero or there can be some
+      // offset. By adding start_index we move to the desired section of coeff_vec.
+      const Scalar* space_coeff_vec = coeff_vec + start_index;
+      int ndof = space->get_num_dofs();
 
-      // Allocate the coefficient arrays.
-      num_elems = this->mesh->get_max_element_id();
-      free_with_check(elem_orders);
-      elem_orders = calloc_with_check<Solution<Scalar>, int>(num_elems, this);
-      for (int l = 0; l < this->num_components; l++)
+      // The same space as the last time: only the elements whose coefficients changed are converted again.
+      bool* dof_changed = nullptr;
+      if (this->coeff_vec_reusable(space, add_dir_lift))
       {
-        free_with_check(elem_coeffs[l]);
-        elem_coeffs[l] = calloc_with_check<Solution<Scalar>, int>(num_elems, this);
-      }
+        if (Solution<Scalar>::static_verbose_output)
+          Hermes::Mixins::Loggable::Static::info("Solution: set_coeff_vector - incremental update.");
 
-      // Obtain element orders, allocate mono_coeffs.
-      Element* e;
-      int o;
-      num_coeffs = 0;
-      for_all_active_elements(e, this->mesh)
+        dof_changed = malloc_with_check<Solution<Scalar>, bool>(ndof, this);
+        for (int i = 0; i < ndof; i++)
+          dof_changed[i] = (space_coeff_vec[i] != this->coeff_vec_copy[i]);
+      }
+      else
       {
-        this->mode = e->get_mode();
-        o = space->get_element_order(e->id);
-        o = std::max(H2D_GET_H_ORDER(o), H2D_GET_V_ORDER(o));
-        for (unsigned int k = 0; k < e->get_nvert(); k++)
+        if (Solution<Scalar>::static_verbose_output)
+          Hermes::Mixins::Loggable::Static::info("Solution: set_coeff_vector - solution being freed.");
+
+        this->free();
+
+        this->space_type = space->get_type();
+        this->num_components = space->shapeset->get_num_components();
+        this->sln_type = HERMES_SLN;
+        this->mesh = space->get_mesh();
+
+        // Allocate the coefficient arrays.
+        num_elems = this->mesh->get_max_element_id();
+        elem_orders = calloc_with_check<Solution<Scalar>, int>(num_elems, this);
+        for (int l = 0; l < this->num_components; l++)
+          elem_coeffs[l] = calloc_with_check<Solution<Scalar>, int>(num_elems, this);
+
+        // Obtain element orders and positions in mono_coeffs, allocate mono_coeffs.
+        Element* e;
+        int o;
+        num_coeffs = 0;
+        for_all_active_elements_compact(e, this->mesh)
         {
-          int eo = space->get_edge_order(e, k);
-          if (eo > o)
-            o = eo;
-        }
+          this->mode = e->get_mode();
+          o = space->get_element_order(e->id);
+          o = std::max(H2D_GET_H_ORDER(o), H2D_GET_V_ORDER(o));
+          for (unsigned int k = 0; k < e->get_nvert(); k++)
+          {
+            int eo = space->get_edge_order(e, k);
+            if (eo > o)
+              o = eo;
+          }
+
+          // Hcurl and Hdiv: actual order of functions is one higher than element order
+          if (space->shapeset->get_num_components() == 2)
+            if (o < space->shapeset->get_max_order())
+              o++;
 
-        // Hcurl and Hdiv: actual order of functions is one higher than element order
-        if (space->shapeset->get_num_components() == 2)
-          if (o < space->shapeset->get_max_order())
-            o++;
+          elem_orders[e->id] = o;
+          for (int l = 0; l < this->num_components; l++)
+          {
+            elem_coeffs[l][e->id] = num_coeffs;
+            num_coeffs += this->mode ? sqr(o + 1) : (o + 1)*(o + 2) / 2;
+          }
 
-        num_coeffs += this->mode ? sqr(o + 1) : (o + 1)*(o + 2) / 2;
-        elem_orders[e->id] = o;
+          // The monomial matrices are shared, calculate them before the parallel conversion.
+          calc_mono_matrix(this->mode, o);
+        }
+        mono_coeffs = malloc_with_check<Solution<Scalar>, Scalar>(num_coeffs, this);
+        this->coeff_vec_copy = malloc_with_check<Solution<Scalar>, Scalar>(ndof, this);
+        this->num_dofs = ndof;
+        this->coeff_vec_space_seq = space->get_seq();
+        this->coeff_vec_mesh_seq = this->mesh->get_seq();
+        this->coeff_vec_dof_stamp = space->get_dof_assignment_stamp();
+        this->coeff_vec_add_dir_lift = add_dir_lift;
       }
-      num_coeffs *= this->num_components;
-      free_with_check(mono_coeffs);
-      mono_coeffs = malloc_with_check<Solution<Scalar>, Scalar>(num_coeffs, this);
 
-      // Express the solution on elements as a linear combination of monomials.
-      Quad2D* quad = &g_quad_2d_cheb;
-      pss.set_quad_2d(quad);
-      Scalar* mono = mono_coeffs;
-      for_all_active_elements(e, this->mesh)
-      {
-        this->mode = e->get_mode();
-        o = elem_orders[e->id];
-        unsigned char np = quad->get_num_points(o, e->get_mode());
+      // Express the solution on elements as a linear combination of monomials, in parallel over ranges of elements.
+      // The monomial coefficients of every shape function are calculated only once (per thread), the conversion
+      // of an element is then a small dense matrix - vector product.
+      space->update_assembly_list_cache();
+      MeshCompactView* view = this->mesh->get_compact_view();
+      int num_threads = HermesCommonApi.get_integral_param_value(numThreads);
+      double dir_lift_coeff = add_dir_lift ? 1.0 : 0.0;
+      std::string exceptionMessageCaughtInParallelBlock;
 
-        AsmList<Scalar> al;
-        space->get_element_assembly_list(e, &al);
-        pss.set_active_element(e);
+#pragma omp parallel num_threads(num_threads)
+      {
+        int thread_number = omp_get_thread_num();
+        int start = (view->num_active / num_threads) * thread_number;
+        int end = (view->num_active / num_threads) * (thread_number + 1);
+        if (thread_number == num_threads - 1)
+          end = view->num_active;
 
-        for (int l = 0; l < this->num_components; l++)
+        try
         {
-          // Obtain solution values for the current element.
-          Scalar* val = mono;
-          elem_coeffs[l][e->id] = (int)(mono - mono_coeffs);
-          memset(val, 0, sizeof(Scalar)*np);
-          for (unsigned int k = 0; k < al.cnt; k++)
+          PrecalcShapeset pss(space->shapeset);
+          pss.set_quad_2d(&g_quad_2d_cheb);
+          ShapeMonoCoeffs shape_mono_coeffs(&pss);
+          AsmList<Scalar> al;
+
+          for (int view_i = start; view_i < end; view_i++)
           {
-            pss.set_active_shape(al.idx[k]);
-            pss.set_quad_order(o, H2D_FN_VAL);
-            int dof = al.dof[k];
-            double dir_lift_coeff = add_dir_lift ? 1.0 : 0.0;
-            // By subtracting space->first_dof we make sure that it does not matter where the
-            // enumeration of dofs in the space starts. This ca be either zero or there can be some
-            // offset. By adding start_index we move to the desired section of coeff_vec.
-            Scalar coef = al.coef[k] * (dof >= 0 ? coeff_vec[dof - space->first_dof + start_index] : dir_lift_coeff);
-            const double* shape = pss.get_fn_values(l);
-            for (int i = 0; i < np; i++)
-              val[i] += shape[i] * coef;
-          }
-          mono += np;
+            // Exception already thrown -> exit the loop.
+            if (!exceptionMessageCaughtInParallelBlock.empty())
+              break;
 
-          // solve for the monomial coefficients
-          calc_mono_matrix(this->mode, o);
-          lubksb(mono_lu.mat[this->mode][o], np, mono_lu.perm[this->mode][o], val);
+            Element* e = this->mesh->get_element_fast(view->active_ids[view_i]);
+            space->get_element_assembly_list(e, &al);
+
+            if (dof_changed)
+            {
+              // Elements with Dirichlet lift are always converted again, the lift values may have changed.
+              bool changed = false;
+              for (unsigned int k = 0; k < al.cnt && !changed; k++)
+                changed = (al.dof[k] >= 0 ? dof_changed[al.dof[k] - space->first_dof] : add_dir_lift);
+              if (!changed)
+                continue;
+            }
+
+            unsigned char o = elem_orders[e->id];
+            unsigned char np = g_quad_2d_cheb.get_num_points(o, e->get_mode());
+            for (int l = 0; l < this->num_components; l++)
+            {
+              Scalar* mono = mono_coeffs + elem_coeffs[l][e->id];
+              memset(mono, 0, sizeof(Scalar)*np);
+              for (unsigned int k = 0; k < al.cnt; k++)
+              {
+                int dof = al.dof[k];
+                Scalar coef = al.coef[k] * (dof >= 0 ? space_coeff_vec[dof - space->first_dof] : dir_lift_coeff);
+                const double* shape_mono = shape_mono_coeffs.get(e, o, l, al.idx[k]);
+                for (int i = 0; i < np; i++)
+                  mono[i] += shape_mono[i] * coef;
+              }
+            }
+          }
+        }
+        catch (std::exception& exception)
+        {
+#pragma omp critical (exceptionMessageCaughtInParallelBlock)
+          exceptionMessageCaughtInParallelBlock = exception.what();
         }
       }
 
+      free_with_check(dof_changed);
+      if (!exceptionMessageCaughtInParallelBlock.empty())
+      {
+        this->free();
+        this->sln_type = HERMES_UNDEF;
+        throw Hermes::Exceptions::Exception(exceptionMessageCaughtInParallelBlock.c_str());
+      }
+
+      memcpy(this->coeff_vec_copy, space_coeff_vec, ndof * sizeof(Scalar));
+
       init_dxdy_buffer();
       this->element = nullptr;
       if (Solution<Scalar>::static_verbose_output)
@@ -645,6 +771,8 @@ namespace Hermes
       {
         for (int i = 0; i < num_coeffs; i++)
           mono_coeffs[i] *= coef;
+        // The monomial coefficients do not correspond to the coefficient vector anymore.
+        free_with_check(coeff_vec_copy);
       }
       else if (sln_type == HERMES_EXACT)
         dynamic_cast<ExactSolution<Scalar>*>(this)->exact_multiplicator *= coef;
@@ -729,25 +857,96 @@ namespace Hermes
         throw Hermes::Exceptions::Exception("Uninitialized solution.");
     }
 
-    template<typename Scalar>
-    static inline void set_vec_num(int n, Scalar* y, Scalar num)
+    /// Number of points evaluated at once by the polynomial kernels - two vector registers (AVX, double),
+    /// so that the dependent multiply-adds of Horner's scheme in the two overlap.
+    static const int H2D_SOLUTION_SIMD_WIDTH = 8;
+
+    /// Horner's scheme for one polynomial of the order o in lanes points.
+    /// The coefficients are ordered by the descending powers of y, within those by the descending powers of x,
+    /// (o + 1) of them for each power of y in quads, 1, 2, ..., o + 1 in triangles.
+    /// The order is a template parameter so that the scheme unrolls completely, the lane loops are vectorized.
+    template<int o, bool quad, int lanes>
+    static inline void horner_block(const double* x, const double* y, const double* mono, double* result)
     {
-      for (int i = 0; i < n; i++)
-        y[i] = num;
+      double r[lanes], t[lanes];
+      for (int lane = 0; lane < lanes; lane++)
+        r[lane] = 0.;
+      for (int i = 0; i <= o; i++)
+      {
+        for (int lane = 0; lane < lanes; lane++)
+          t[lane] = *mono;
+        mono++;
+        for (int j = 1; j <= (quad ? o : i); j++, mono++)
+          for (int lane = 0; lane < lanes; lane++)
+            t[lane] = t[lane] * x[lane] + *mono;
+        for (int lane = 0; lane < lanes; lane++)
+          r[lane] = r[lane] * y[lane] + t[lane];
+      }
+      for (int lane = 0; lane < lanes; lane++)
+        result[lane] = r[lane];
     }
 
-    template<typename Scalar>
-    static inline void vec_x_vec_p_num(int n, Scalar* y, Scalar* x, Scalar num)
+    /// Evaluates num_polynomials polynomials of the order o in np points, in one pass over the points
+    /// (all polynomials on a block of H2D_SOLUTION_SIMD_WIDTH points, then the next block).
+    template<int o, bool quad>
+    static void evaluate_polynomials(int np, const double* x, const double* y, int num_polynomials, const double* const* monos, double* const* results)
     {
-      for (int i = 0; i < n; i++)
-        y[i] = y[i] * x[i] + num;
+      int p = 0;
+      for (; p + H2D_SOLUTION_SIMD_WIDTH <= np; p += H2D_SOLUTION_SIMD_WIDTH)
+        for (int m = 0; m < num_polynomials; m++)
+          horner_block<o, quad, H2D_SOLUTION_SIMD_WIDTH>(x + p, y + p, monos[m], results[m] + p);
+      for (; p < np; p++)
+        for (int m = 0; m < num_polynomials; m++)
+          horner_block<o, quad, 1>(x + p, y + p, monos[m], results[m] + p);
     }
 
-    template<typename Scalar>
-    static inline void vec_x_vec_p_vec(int n, Scalar* y, Scalar* x, Scalar* z)
+    typedef void(*PolynomialKernel)(int np, const double* x, const double* y, int num_polynomials, const double* const* monos, double* const* results);
+
+    /// The kernels for all orders supported by Solution (the size of dxdy_buffer), [quad][order].
+    static const PolynomialKernel polynomial_kernels[2][H2DRS_MAX_ORDER + 1] =
+    {
+      {
+        &evaluate_polynomials<0, false>, &evaluate_polynomials<1, false>, &evaluate_polynomials<2, false>, &evaluate_polynomials<3, false>,
+        &evaluate_polynomials<4, false>, &evaluate_polynomials<5, false>, &evaluate_polynomials<6, false>, &evaluate_polynomials<7, false>,
+        &evaluate_polynomials<8, false>, &evaluate_polynomials<9, false>, &evaluate_polynomials<10, false>
+      },
+      {
+        &evaluate_polynomials<0, true>, &evaluate_polynomials<1, true>, &evaluate_polynomials<2, true>, &evaluate_polynomials<3, true>,
+        &evaluate_polynomials<4, true>, &evaluate_polynomials<5, true>, &evaluate_polynomials<6, true>, &evaluate_polynomials<7, true>,
+        &evaluate_polynomials<8, true>, &evaluate_polynomials<9, true>, &evaluate_polynomials<10, true>
+      }
+    };
+
+    static void evaluate_solution_polynomials(PolynomialKernel kernel, int np, const double* x, const double* y, int num_polynomials, int num_coeffs, double** monos, double** results)
+    {
+      kernel(np, x, y, num_polynomials, monos, results);
+    }
+
+    /// Complex coefficients: split into the real and imaginary parts (the points are real), evaluated as separate real polynomials.
+    static void evaluate_solution_polynomials(PolynomialKernel kernel, int np, const double* x, const double* y, int num_polynomials, int num_coeffs, std::complex<double>** monos, std::complex<double>** results)
     {
-      for (int i = 0; i < n; i++)
-        y[i] = y[i] * x[i] + z[i];
+      double split_monos[2 * H2D_MAX_SOLUTION_COMPONENTS * H2D_NUM_FUNCTION_VALUES][(H2DRS_MAX_ORDER + 1) * (H2DRS_MAX_ORDER + 1)];
+      double split_results[2 * H2D_MAX_SOLUTION_COMPONENTS * H2D_NUM_FUNCTION_VALUES][H2D_MAX_INTEGRATION_POINTS_COUNT];
+      const double* split_monos_ptrs[2 * H2D_MAX_SOLUTION_COMPONENTS * H2D_NUM_FUNCTION_VALUES];
+      double* split_results_ptrs[2 * H2D_MAX_SOLUTION_COMPONENTS * H2D_NUM_FUNCTION_VALUES];
+      for (int m = 0; m < num_polynomials; m++)
+      {
+        for (int i = 0; i < num_coeffs; i++)
+        {
+          split_monos[2 * m][i] = monos[m][i].real();
+          split_monos[2 * m + 1][i] = monos[m][i].imag();
+        }
+        split_monos_ptrs[2 * m] = split_monos[2 * m];
+        split_monos_ptrs[2 * m + 1] = split_monos[2 * m + 1];
+        split_results_ptrs[2 * m] = split_results[2 * m];
+        split_results_ptrs[2 * m + 1] = split_results[2 * m + 1];
+      }
+
+      kernel(np, x, y, 2 * num_polynomials, split_monos_ptrs, split_results_ptrs);
+
+      for (int m = 0; m < num_polynomials; m++)
+        for (int i = 0; i < np; i++)
+          results[m][i] = std::complex<double>(split_results[2 * m][i], split_results[2 * m + 1][i]);
     }
 
     template<typename Scalar>
@@ -887,31 +1086,28 @@ namespace Hermes
 
         // obtain the solution values, this is the core of the whole module
         int o = elem_orders[this->element->id];
+        if (o > H2DRS_MAX_ORDER)
+          throw Hermes::Exceptions::Exception("Solution::precalculate: element order %i not supported.", o);
+
+        // all requested values in one pass
+        Scalar* monos[H2D_MAX_SOLUTION_COMPONENTS * H2D_NUM_FUNCTION_VALUES];
+        Scalar* results[H2D_MAX_SOLUTION_COMPONENTS * H2D_NUM_FUNCTION_VALUES];
+        int num_polynomials = 0;
         for (l = 0; l < this->num_components; l++)
         {
           for (k = 0; k < H2D_NUM_FUNCTION_VALUES; k++)
           {
             if (mask & this->idx2mask[k][l])
             {
-              Scalar* result = this->values[l][k];
-
-              // calculate the solution values using Horner's scheme
-              Scalar* mono = dxdy_coeffs[l][k];
-              for (i = 0; i <= o; i++)
-              {
-                set_vec_num(np, tx, *mono++);
-                for (j = 1; j <= (this->mode ? o : i); j++)
-                  vec_x_vec_p_num(np, tx, x, *mono++);
-
-                if (!i)
-                  memcpy(result, tx, sizeof(Scalar)*np);
-                else
-                  vec_x_vec_p_vec(np, result, y, tx);
-              }
+              monos[num_polynomials] = dxdy_coeffs[l][k];
+              results[num_polynomials++] = this->values[l][k];
             }
           }
         }
 
+        int num_coeffs = this->mode ? sqr(o + 1) : (o + 1) * (o + 2) / 2;
+        evaluate_solution_polynomials(polynomial_kernels[this->mode ? 1 : 0][o], np, x, y, num_polynomials, num_coeffs, monos, results);
+
         // transform gradient or vector solution, if required
         if (transform)
           transform_values(order, mask, np);
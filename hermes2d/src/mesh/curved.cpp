@@ -36,6 +36,39 @@ namespace Hermes
     H1ShapesetJacobi ref_map_shapeset;
     PrecalcShapesetAssembling ref_map_pss_static(&ref_map_shapeset);
 
+    /// The edge function l_i at x.
+    static double edge_fn(int i, double x)
+    {
+      switch (i)
+      {
+      case 0:
+        return l0(x);
+      case 1:
+        return l1(x);
+      case 2:
+        return l2(x);
+      case 3:
+        return l3(x);
+      case 4:
+        return l4(x);
+      case 5:
+        return l5(x);
+      case 6:
+        return l6(x);
+      case 7:
+        return l7(x);
+      case 8:
+        return l8(x);
+      case 9:
+        return l9(x);
+      case 10:
+        return l10(x);
+      case 11:
+        return l11(x);
+      }
+      return 0.;
+    }
+
     CurvMapStatic::CurvMapStatic()
     {
       int order = ref_map_shapeset.get_max_order();
@@ -57,8 +90,12 @@ namespace Hermes
       bubble_proj_matrix_quad = new_matrix<double>(quad_bubble_np, quad_bubble_np);
       bubble_quad_p = malloc_with_check<double>(quad_bubble_np);
 
+      // Edge functions at the points of the maximum order 1D quadrature.
+      this->edge_fn_values = new_matrix<double>(edge_proj_matrix_size, g_quad_1d_std.get_num_points(g_quad_1d_std.get_max_order()));
+
       this->precalculate_cholesky_projection_matrices_bubble();
       this->precalculate_cholesky_projection_matrix_edge();
+      this->precalculate_edge_fn_values();
     }
 
     CurvMapStatic::~CurvMapStatic()
@@ -66,6 +103,7 @@ namespace Hermes
       free_with_check(edge_proj_matrix, true);
       free_with_check(bubble_proj_matrix_tri, true);
       free_with_check(bubble_proj_matrix_quad, true);
+      free_with_check(edge_fn_values, true);
       free_with_check(edge_p);
       free_with_check(bubble_tri_p);
       free_with_check(bubble_quad_p);
@@ -162,87 +200,9 @@ namespace Hermes
           double val = 0.0;
           for (int k = 0; k < g_quad_1d_std.get_num_points(o); k++)
           {
-            double fi = 0;
-            double fj = 0;
             double x = pt[k][0];
-            switch (i + 2)
-            {
-            case 0:
-              fi = l0(x);
-              break;
-            case 1:
-              fi = l1(x);
-              break;
-            case 2:
-              fi = l2(x);
-              break;
-            case 3:
-              fi = l3(x);
-              break;
-            case 4:
-              fi = l4(x);
-              break;
-            case 5:
-              fi = l5(x);
-              break;
-            case 6:
-              fi = l6(x);
-              break;
-            case 7:
-              fi = l7(x);
-              break;
-            case 8:
-              fi = l8(x);
-              break;
-            case 9:
-              fi = l9(x);
-              break;
-            case 10:
-              fi = l10(x);
-              break;
-            case 11:
-              fi = l11(x);
-              break;
-            }
-            switch (j + 2)
-            {
-            case 0:
-              fj = l0(x);
-              break;
-            case 1:
-              fj = l1(x);
-              break;
-            case 2:
-              fj = l2(x);
-              break;
-            case 3:
-              fj = l3(x);
-              break;
-            case 4:
-              fj = l4(x);
-              break;
-            case 5:
-              fj = l5(x);
-              break;
-            case 6:
-              fj = l6(x);
-              break;
-            case 7:
-              fj = l7(x);
-              break;
-            case 8:
-              fj = l8(x);
-              break;
-            case 9:
-              fj = l9(x);
-              break;
-            case 10:
-              fj = l10(x);
-              break;
-            case 11:
-              fj = l11(x);
-              break;
-            }
+            double fi = edge_fn(i + 2, x);
+            double fj = edge_fn(j + 2, x);
             val += pt[k][1] * (fi * fj);
           }
           this->edge_proj_matrix[i][j] = this->edge_proj_matrix[j][i] = val;
@@ -253,6 +213,16 @@ namespace Hermes
       choldc(this->edge_proj_matrix, this->edge_proj_matrix_size, this->edge_p);
     }
 
+    void CurvMapStatic::precalculate_edge_fn_values()
+    {
+      unsigned short mo1 = g_quad_1d_std.get_max_order();
+      unsigned char np = g_quad_1d_std.get_num_points(mo1);
+      double2* pt = g_quad_1d_std.get_points(mo1);
+      for (int i = 0; i < this->edge_proj_matrix_size; i++)
+        for (int j = 0; j < np; j++)
+          this->edge_fn_values[i][j] = edge_fn(i + 2, pt[j][0]);
+    }
+
     CurvMapStatic curvMapStatic;
 
     Curve::Curve(CurvType type) : type(type)
@@ -600,51 +570,9 @@ namespace Hermes
       {
         for (i = 0; i < ne; i++)
         {
+          const double* fi = curvMapStatic.edge_fn_values[i];
           for (j = 0; j < np; j++)
-          {
-            double t = pt[j][0];
-            double fi = 0;
-            switch (i + 2)
-            {
-            case 0:
-              fi = l0(t);
-              break;
-            case 1:
-              fi = l1(t);
-              break;
-            case 2:
-              fi = l2(t);
-              break;
-            case 3:
-              fi = l3(t);
-              break;
-            case 4:
-              fi = l4(t);
-              break;
-            case 5:
-              fi = l5(t);
-              break;
-            case 6:
-              fi = l6(t);
-              break;
-            case 7:
-              fi = l7(t);
-              break;
-            case 8:
-              fi = l8(t);
-              break;
-            case 9:
-              fi = l9(t);
-              break;
-            case 10:
-              fi = l10(t);
-              break;
-            case 11:
-              fi = l11(t);
-              break;
-            }
-            rhside[k][i] += pt[j][1] * (fi * fn[j][k]);
-          }
+            rhside[k][i] += pt[j][1] * (fi[j] * fn[j][k]);
         }
         // solve
         cholsl(curvMapStatic.edge_proj_matrix, ne, curvMapStatic.edge_p, rhside[k], rhside[k]);
@@ -696,15 +624,19 @@ namespace Hermes
       unsigned short qo = e->is_quad() ? H2D_MAKE_QUAD_ORDER(order, order) : order;
       unsigned short nb = ref_map_shapeset.get_num_bubbles(qo, e->get_mode());
 
-      double2* fn = new double2[np];
+      // scratch storage on the stack, the sizes are bounded by the maximum orders
+      assert(np <= H2D_MAX_INTEGRATION_POINTS_COUNT && nb <= H2D_MAX_REFMAP_BUBBLES);
+      double2 fn[H2D_MAX_INTEGRATION_POINTS_COUNT];
       memset(fn, 0, np * sizeof(double2));
 
+      double rhside_storage[2][H2D_MAX_REFMAP_BUBBLES];
+      double old_storage[2][H2D_MAX_INTEGRATION_POINTS_COUNT];
       double* rhside[2];
       double* old[2];
       for (i = 0; i < 2; i++)
       {
-        rhside[i] = new double[nb];
-        old[i] = new double[np];
+        rhside[i] = rhside_storage[i];
+        old[i] = old_storage[i];
         memset(rhside[i], 0, sizeof(double)* nb);
         memset(old[i], 0, sizeof(double)* np);
       }
@@ -746,13 +678,6 @@ namespace Hermes
         for (i = 0; i < nb; i++)
           result[i][k] = rhside[k][i];
       }
-
-      for (i = 0; i < 2; i++)
-      {
-        delete[] rhside[i];
-        delete[] old[i];
-      }
-      delete[] fn;
     }
 
     void CurvMap::update_refmap_coeffs(Element* e)
@@ -30,8 +30,9 @@ namespace Hermes
     static const int H2D_DG_INNER_EDGE_INT = -54125631;
     static const std::string H2D_DG_INNER_EDGE = "-54125631";
 
-    Mesh::Mesh() : HashTable(), meshHashGrid(nullptr), nbase(0), nactive(0), ntopvert(0), ninitial(0), seq(g_mesh_seq++),
-      bounding_box_calculated(0)
+    Mesh::Mesh() : HashTable(), meshHashGrid(nullptr), compact_view(nullptr), geometry_cache(nullptr), geometry_caching(false),
+      geometry_cache_max_bytes(0), nbase(0), nactive(0), ntopvert(0), ninitial(0), seq(g_mesh_seq++),
+      bounding_box_calculated(0), refmap_coeffs_postponed(false)
     {
     }
 
@@ -437,7 +438,7 @@ namespace Hermes
       // update coefficients of curved reference mapping
       for (int i = 0; i < 4; i++)
         if (sons[i]->is_curved())
-          sons[i]->cm->update_refmap_coeffs(sons[i]);
+          update_son_refmap_coeffs(sons[i]);
 
       // deactivate this element and unregister from its nodes
       e->active = 0;
@@ -644,7 +645,7 @@ namespace Hermes
         if (sons[i])
         {
         if (sons[i]->cm)
-          sons[i]->cm->update_refmap_coeffs(sons[i]);
+          update_son_refmap_coeffs(sons[i]);
         }
 
       // set pointers to parent element for sons
@@ -749,6 +750,108 @@ namespace Hermes
       this->refine_element(e, refinement);
     }
 
+    void Mesh::update_son_refmap_coeffs(Element* son)
+    {
+      if (this->refmap_coeffs_postponed)
+        this->postponed_refmap_coeffs_elements.push_back(son);
+      else
+        son->cm->update_refmap_coeffs(son);
+    }
+
+    void Mesh::refine_elements(const std::vector<int>& ids, const std::vector<int>& refinements)
+    {
+      if (ids.size() != refinements.size())
+        throw Exceptions::LengthException(1, 2, ids.size(), refinements.size());
+
+      for (unsigned int i = 0; i < ids.size(); i++)
+      {
+        if (refinements[i] == -1)
+          continue;
+        Element* e = this->get_element(ids[i]);
+        if (!e->used)
+          throw Hermes::Exceptions::Exception("Invalid element id number.");
+        if (!e->active)
+          throw Hermes::Exceptions::Exception("Attempt to refine element #%d which has been refined already.", e->id);
+      }
+
+      // At most four sons, five new vertex nodes and twelve edge nodes per element.
+      // What is not used in the end (reused ids, nodes shared with neighbors) is freed by trim() below.
+      this->elements.reserve(H2D_MAX_ELEMENT_SONS * ids.size());
+      this->nodes.reserve(17 * ids.size());
+
+      // Topology - serial, the node tables are shared.
+      this->refmap_coeffs_postponed = true;
+      try
+      {
+        for (unsigned int i = 0; i < ids.size(); i++)
+        {
+          if (refinements[i] == -1)
+            continue;
+          Element* e = this->get_element(ids[i]);
+          if (!e->active)
+            throw Hermes::Exceptions::Exception("Attempt to refine element #%d which has been refined already.", e->id);
+          this->refine_element(e, refinements[i]);
+        }
+      }
+      catch (...)
+      {
+        this->refmap_coeffs_postponed = false;
+        this->postponed_refmap_coeffs_elements.clear();
+        this->elements.trim();
+        this->nodes.trim();
+        throw;
+      }
+      this->refmap_coeffs_postponed = false;
+      this->elements.trim();
+      this->nodes.trim();
+
+      this->update_postponed_refmap_coeffs();
+    }
+
+    void Mesh::update_postponed_refmap_coeffs()
+    {
+      // Projections of the reference mappings of the new curved elements - independent of each other.
+      int num_curved = this->postponed_refmap_coeffs_elements.size();
+      int num_threads = HermesCommonApi.get_integral_param_value(numThreads);
+      std::string exceptionMessageCaughtInParallelBlock;
+#pragma omp parallel for num_threads(num_threads) schedule(dynamic, 16)
+      for (int i = 0; i < num_curved; i++)
+      {
+        // Exception already thrown -> skip the rest.
+        if (!exceptionMessageCaughtInParallelBlock.empty())
+          continue;
+
+        try
+        {
+          Element* son = this->postponed_refmap_coeffs_elements[i];
+          son->cm->update_refmap_coeffs(son);
+        }
+        catch (std::exception& exception)
+        {
+#pragma omp critical (exceptionMessageCaughtInParallelBlock)
+          exceptionMessageCaughtInParallelBlock = exception.what();
+        }
+      }
+      this->postponed_refmap_coeffs_elements.clear();
+
+      if (!exceptionMessageCaughtInParallelBlock.empty())
+        throw Hermes::Exceptions::Exception(exceptionMessageCaughtInParallelBlock.c_str());
+    }
+
+    void Mesh::update_all_refmap_coeffs()
+    {
+      Element* e;
+      for_all_used_elements(e, this)
+      {
+        if (e->cm != nullptr)
+          this->postponed_refmap_coeffs_elements.push_back(e);
+      }
+      this->update_postponed_refmap_coeffs();
+
+      for_all_used_elements(e, this)
+        RefMap::set_element_iro_cache(e);
+    }
+
     void Mesh::refine_all_elements(int refinement, bool mark_as_initial)
     {
       ninitial = this->get_max_element_id();
@@ -760,8 +863,22 @@ namespace Hermes
 
       Element* e;
 
-      for_all_active_elements(e, this)
-        refine_element(e, refinement);
+      // The projections of the reference mappings of the curved sons are done at the end, in parallel.
+      this->refmap_coeffs_postponed = true;
+      try
+      {
+        for_all_active_elements(e, this)
+          refine_element(e, refinement);
+      }
+      catch (...)
+      {
+        this->refmap_coeffs_postponed = false;
+        this->postponed_refmap_coeffs_elements.clear();
+        elements.set_append_only(false);
+        throw;
+      }
+      this->refmap_coeffs_postponed = false;
+      this->update_postponed_refmap_coeffs();
 
       elements.set_append_only(false);
 
@@ -1262,7 +1379,22 @@ namespace Hermes
       HashTable::free();
 
       if (this->meshHashGrid)
+      {
         delete this->meshHashGrid;
+        this->meshHashGrid = nullptr;
+      }
+
+      if (this->compact_view)
+      {
+        delete this->compact_view;
+        this->compact_view = nullptr;
+      }
+
+      if (this->geometry_cache)
+      {
+        delete this->geometry_cache;
+        this->geometry_cache = nullptr;
+      }
 
       this->boundary_markers_conversion.conversion_table.clear();
       this->boundary_markers_conversion.conversion_table_inverse.clear();
@@ -1294,6 +1426,50 @@ namespace Hermes
       return this->meshHashGrid->getElement(x, y);
     }
 
+    MeshCompactView* Mesh::get_compact_view()
+    {
+      if (this->compact_view && !this->compact_view->is_up_to_date(this))
+      {
+        delete this->compact_view;
+        this->compact_view = nullptr;
+      }
+
+      if (!this->compact_view)
+        this->compact_view = new MeshCompactView(this);
+
+      return this->compact_view;
+    }
+
+    void Mesh::set_geometry_caching(bool to_set, size_t max_bytes)
+    {
+      this->geometry_caching = to_set;
+      if (this->geometry_cache && (!to_set || this->geometry_cache_max_bytes != max_bytes))
+      {
+        delete this->geometry_cache;
+        this->geometry_cache = nullptr;
+      }
+      this->geometry_cache_max_bytes = max_bytes;
+    }
+
+    MeshGeometryCache* Mesh::get_geometry_cache()
+    {
+      if (!this->geometry_caching)
+        return nullptr;
+
+      if (this->geometry_cache && !this->geometry_cache->is_up_to_date(this))
+      {
+        delete this->geometry_cache;
+        this->geometry_cache = nullptr;
+      }
+
+      if (!this->geometry_cache)
+        this->geometry_cache = new MeshGeometryCache(this, this->geometry_cache_max_bytes);
+      else
+        this->geometry_cache->publish();
+
+      return this->geometry_cache;
+    }
+
     double Mesh::get_marker_area(int marker)
     {
       std::map<int, MarkerArea*>::iterator area = marker_areas.find(marker);
@@ -1652,7 +1828,7 @@ namespace Hermes
       // update coefficients of curved reference mapping
       for (int i = 0; i < 3; i++)
         if (sons[i]->is_curved())
-          sons[i]->cm->update_refmap_coeffs(sons[i]);
+          update_son_refmap_coeffs(sons[i]);
 
       // deactivate this element and unregister from its nodes
       e->active = 0;
@@ -2679,10 +2855,56 @@ namespace Hermes
       }
     }
 
+    int Mesh::get_regularization_refinement(Element* e, int n)
+    {
+      if (e->is_triangle())
+      {
+        for (unsigned int i = 0; i < e->get_nvert(); i++)
+        {
+          if (get_edge_degree(e->vn[i], e->vn[e->next_vert(i)]) > n)
+            return 0;
+        }
+        return -1;
+      }
+
+      if (((get_edge_degree(e->vn[0], e->vn[1]) > n) || (get_edge_degree(e->vn[2], e->vn[3]) > n))
+        && (get_edge_degree(e->vn[1], e->vn[2]) <= n) && (get_edge_degree(e->vn[3], e->vn[0]) <= n))
+        return 2;
+      if ((get_edge_degree(e->vn[0], e->vn[1]) <= n) && (get_edge_degree(e->vn[2], e->vn[3]) <= n)
+        && ((get_edge_degree(e->vn[1], e->vn[2]) > n) || (get_edge_degree(e->vn[3], e->vn[0]) > n)))
+        return 1;
+      for (unsigned int i = 0; i < e->get_nvert(); i++)
+      {
+        if (get_edge_degree(e->vn[i], e->vn[e->next_vert(i)]) > n)
+          return 0;
+      }
+      return -1;
+    }
+
+    void Mesh::add_elements_containing_edge(Node* v1, Node* v2, std::vector<int>& elements)
+    {
+      // Go up through the bisections of the edge - the parent edge of (v1, v2) is (v1, v) if v2 is the midpoint of (v1, v), or vice versa.
+      while (true)
+      {
+        Node* edge = this->peek_edge_node(v1->id, v2->id);
+        if (edge)
+        {
+          for (int i = 0; i < 2; i++)
+            if (edge->elem[i] && edge->elem[i]->active)
+              elements.push_back(edge->elem[i]->id);
+        }
+
+        if (v2->p1 == v1->id || v2->p2 == v1->id)
+          v2 = &this->nodes[v2->p1 == v1->id ? v2->p2 : v2->p1];
+        else if (v1->p1 == v2->id || v1->p2 == v2->id)
+          v1 = &this->nodes[v1->p1 == v2->id ? v1->p2 : v1->p1];
+        else
+          break;
+      }
+    }
+
     int* Mesh::regularize(int n)
     {
-      int j;
-      bool ok;
       bool reg = false;
       Element* e;
 
@@ -2697,56 +2919,85 @@ namespace Hermes
       for_all_active_elements(e, this)
         parents[e->id] = e->id;
 
-      do
+      // Sweeps in the order of the serial loop - all active elements by id, each decision made in the state left by the
+      // refinements before it. The decisions are made in parallel at the beginning of the sweep (only reading the node tables)
+      // for the elements that may have changed since they were checked last (all of them in the first sweep), and made again
+      // before the refinement for the elements touched by a refinement earlier in the sweep - the resulting refinements are
+      // the same as those of the serial loop. The reference mappings of the new curved elements are calculated in parallel
+      // at the end of each sweep.
+      std::vector<int> to_check;
+      for_all_active_elements(e, this)
+        to_check.push_back(e->id);
+
+      int num_threads = HermesCommonApi.get_integral_param_value(numThreads);
+      std::vector<int> iso;
+      std::vector<int> touched_elements;
+      std::vector<bool> touched;
+      while (!to_check.empty())
       {
-        ok = true;
-        for_all_active_elements(e, this)
+        iso.resize(to_check.size());
+#pragma omp parallel for num_threads(num_threads) schedule(dynamic, 1024)
+        for (int i = 0; i < (int)to_check.size(); i++)
         {
-          int iso = -1;
-          if (e->is_triangle())
-          {
-            for (unsigned int i = 0; i < e->get_nvert(); i++)
-            {
-              j = e->next_vert(i);
-              if (get_edge_degree(e->vn[i], e->vn[j]) > n)
-              {
-                iso = 0; ok = false; break;
-              }
-            }
-          }
-          else
+          Element* e_to_check = this->get_element_fast(to_check[i]);
+          iso[i] = e_to_check->active ? get_regularization_refinement(e_to_check, n) : -1;
+        }
+
+        // Sons appended in this sweep are not visited until the next one (as in for_all_active_elements).
+        int max_id = this->get_max_element_id();
+        touched.assign(max_id, false);
+        touched_elements.clear();
+
+        this->refmap_coeffs_postponed = true;
+        try
+        {
+          unsigned int to_check_index = 0;
+          for (int id = 0; id < max_id; id++)
           {
-            if (((get_edge_degree(e->vn[0], e->vn[1]) > n) || (get_edge_degree(e->vn[2], e->vn[3]) > n))
-              && (get_edge_degree(e->vn[1], e->vn[2]) <= n) && (get_edge_degree(e->vn[3], e->vn[0]) <= n))
-            {
-              iso = 2; ok = false;
-            }
-            else if ((get_edge_degree(e->vn[0], e->vn[1]) <= n) && (get_edge_degree(e->vn[2], e->vn[3]) <= n)
-              && ((get_edge_degree(e->vn[1], e->vn[2]) > n) || (get_edge_degree(e->vn[3], e->vn[0]) > n)))
+            int refinement = -1;
+            if (to_check_index < to_check.size() && to_check[to_check_index] == id)
+              refinement = iso[to_check_index++];
+
+            e = this->get_element_fast(id);
+            if (!e->used || !e->active)
+              continue;
+            if (touched[id])
+              refinement = get_regularization_refinement(e, n);
+            if (refinement < 0)
+              continue;
+
+            this->refine_element(e, refinement);
+
+            unsigned int first_new = touched_elements.size();
+            for (int j = 0; j < 4; j++)
             {
-              iso = 1; ok = false;
+              assign_parent(e, j);
+              if (e->sons[j])
+                touched_elements.push_back(e->sons[j]->id);
             }
-            else
+            for (unsigned int j = 0; j < e->get_nvert(); j++)
+              add_elements_containing_edge(e->vn[j], e->vn[e->next_vert(j)], touched_elements);
+            for (unsigned int j = first_new; j < touched_elements.size(); j++)
             {
-              for (unsigned int i = 0; i < e->get_nvert(); i++)
-              {
-                j = e->next_vert(i);
-                if (get_edge_degree(e->vn[i], e->vn[j]) > n)
-                {
-                  iso = 0; ok = false; break;
-                }
-              }
+              if (touched_elements[j] < max_id)
+                touched[touched_elements[j]] = true;
             }
           }
-
-          if (iso >= 0)
-          {
-            refine_element_id(e->id, iso);
-            for (int i = 0; i < 4; i++)
-              assign_parent(e, i);
-          }
         }
-      } while (!ok);
+        catch (...)
+        {
+          this->refmap_coeffs_postponed = false;
+          this->postponed_refmap_coeffs_elements.clear();
+          throw;
+        }
+        this->refmap_coeffs_postponed = false;
+        this->update_postponed_refmap_coeffs();
+
+        // The following sweep only checks the frontier - the new elements, and the elements whose edges got new hanging nodes.
+        to_check.swap(touched_elements);
+        std::sort(to_check.begin(), to_check.end());
+        to_check.erase(std::unique(to_check.begin(), to_check.end()), to_check.end());
+      }
 
       if (reg)
       {
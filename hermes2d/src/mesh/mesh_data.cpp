@@ -14,6 +14,15 @@
 // along with Hermes2D.  If not, see <http://www.gnu.org/licenses/>.
 
 # include "mesh_data.h"
+# include "api.h"
+# include <cstring>
+# include <cctype>
+# ifndef _WINDOWS
+# include <sys/mman.h>
+# include <sys/stat.h>
+# include <fcntl.h>
+# include <unistd.h>
+# endif
 
 namespace Hermes
 {
@@ -487,5 +496,377 @@ namespace Hermes
       assert(ref_elt.size() == ref_type.size());
       n_ref = ref_elt.size();
     }
+
+    void MeshData::clear()
+    {
+      vars_.clear();
+      x_vertex.clear(); y_vertex.clear();
+      en1.clear(); en2.clear(); en3.clear(); en4.clear();
+      e_mtl.clear();
+      bdy_first.clear(); bdy_second.clear(); bdy_type.clear();
+      curv_first.clear(); curv_second.clear(); curv_third.clear();
+      curv_inner_pts.clear(); curv_knots.clear(); curv_nurbs.clear();
+      ref_elt.clear(); ref_type.clear();
+      n_vert = n_el = n_bdy = n_curv = n_ref = 0;
+    }
+
+    MeshFileContents::MeshFileContents(const char* filename) : data(nullptr), size(0), mapped(false)
+    {
+#ifndef _WINDOWS
+      int fd = open(filename, O_RDONLY);
+      if (fd < 0)
+        return;
+      struct stat st;
+      if (fstat(fd, &st) == 0 && st.st_size > 0)
+      {
+        void* map = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (map != MAP_FAILED)
+        {
+          madvise(map, st.st_size, MADV_SEQUENTIAL);
+          this->data = (const char*)map;
+          this->size = st.st_size;
+          this->mapped = true;
+        }
+      }
+      close(fd);
+#else
+      FILE* f = fopen(filename, "rb");
+      if (f == nullptr)
+        return;
+      fseek(f, 0, SEEK_END);
+      long file_size = ftell(f);
+      fseek(f, 0, SEEK_SET);
+      if (file_size > 0)
+      {
+        char* buffer = (char*)malloc(file_size);
+        if (buffer && fread(buffer, 1, file_size, f) == (size_t)file_size)
+        {
+          this->data = buffer;
+          this->size = file_size;
+        }
+        else
+          ::free(buffer);
+      }
+      fclose(f);
+#endif
+    }
+
+    MeshFileContents::~MeshFileContents()
+    {
+      if (this->data == nullptr)
+        return;
+#ifndef _WINDOWS
+      if (this->mapped)
+        munmap((void*)this->data, this->size);
+#else
+      ::free((void*)this->data);
+#endif
+    }
+
+    /// Scanner helpers for MeshData::parse_mesh_fast.
+    /// Skips white space, separators and comments.
+    static inline void fast_skip_blank(const char*& p, const char* end)
+    {
+      while (p < end)
+      {
+        char c = *p;
+        if (c == ' ' || c == '\t' || c == '\n' || c == '\r' || c == ',' || c == ';')
+          p++;
+        else if (c == '#')
+        {
+          const char* eol = (const char*)memchr(p, '\n', end - p);
+          p = eol ? eol + 1 : end;
+        }
+        else
+          return;
+      }
+    }
+
+    static inline bool fast_is_open(char c) { return c == '[' || c == '{'; }
+    static inline bool fast_is_close(char c) { return c == ']' || c == '}'; }
+
+    /// Finds the beginnings of all entries (one level of nested brackets) of the block starting at p,
+    /// moves p past the block.
+    static bool fast_find_entries(const char*& p, const char* end, std::vector<const char*>& entries)
+    {
+      fast_skip_blank(p, end);
+      if (p >= end || !fast_is_open(*p))
+        return false;
+      p++;
+
+      while (true)
+      {
+        fast_skip_blank(p, end);
+        if (p >= end)
+          return false;
+        if (fast_is_close(*p))
+        {
+          p++;
+          return true;
+        }
+        // Flat lists are left for the general parser.
+        if (!fast_is_open(*p))
+          return false;
+
+        entries.push_back(++p);
+        while (p < end && !fast_is_close(*p))
+        {
+          if (fast_is_open(*p))
+            return false;
+          if (*p == '"')
+          {
+            p = (const char*)memchr(p + 1, '"', end - p - 1);
+            if (p == nullptr)
+              return false;
+          }
+          else if (*p == '#')
+          {
+            p = (const char*)memchr(p, '\n', end - p);
+            if (p == nullptr)
+              return false;
+          }
+          p++;
+        }
+        if (p >= end)
+          return false;
+        p++;
+      }
+    }
+
+    /// Reads the next field of an entry, false at the end of the entry.
+    static inline bool fast_next_field(const char*& p, const char* end, const char*& token, const char*& token_end)
+    {
+      fast_skip_blank(p, end);
+      if (p >= end || fast_is_close(*p))
+        return false;
+
+      if (*p == '"')
+      {
+        token = p + 1;
+        token_end = (const char*)memchr(token, '"', end - token);
+        if (token_end == nullptr)
+          return false;
+        p = token_end + 1;
+        return true;
+      }
+
+      token = p;
+      while (p < end)
+      {
+        char c = *p;
+        if (c == ' ' || c == '\t' || c == '\n' || c == '\r' || c == ',' || c == ';' || c == '#' || c == '"' || fast_is_close(c) || fast_is_open(c))
+          break;
+        p++;
+      }
+      token_end = p;
+      return true;
+    }
+
+    /// A field read by fast_next_field() is never at the beginning of the file (it follows the opening bracket).
+    static inline bool fast_is_quoted(const char* token)
+    {
+      return token[-1] == '"';
+    }
+
+    /// The fields are always followed by a delimiter inside the file, so strtol / strtod stop within the buffer.
+    /// Quoted numbers are not numbers for parse_mesh() (it looks them up as variables), so they are rejected here as well.
+    static inline bool fast_to_int(const char* token, const char* token_end, int& value)
+    {
+      if (fast_is_quoted(token))
+        return false;
+      char* number_end;
+      value = (int)strtol(token, &number_end, 10);
+      return token != token_end && number_end == token_end;
+    }
+
+    static inline bool fast_to_double(const char* token, const char* token_end, double& value)
+    {
+      if (fast_is_quoted(token))
+        return false;
+      char* number_end;
+      value = strtod(token, &number_end);
+      return token != token_end && number_end == token_end;
+    }
+
+    /// Reads up to max_fields fields of one entry, returns the number of fields, or -1 if there are more.
+    static inline int fast_read_entry(const char* p, const char* end, const char** tokens, const char** token_ends, int max_fields)
+    {
+      int count = 0;
+      while (fast_next_field(p, end, tokens[count], token_ends[count]))
+      {
+        if (++count > max_fields - 1)
+        {
+          const char* dummy_token, *dummy_token_end;
+          return fast_next_field(p, end, dummy_token, dummy_token_end) ? -1 : count;
+        }
+      }
+      return count;
+    }
+
+    bool MeshData::parse_mesh_fast(void)
+    {
+      this->clear();
+
+      MeshFileContents file(mesh_file_.c_str());
+      if (file.data == nullptr)
+        return false;
+
+      const char* p = file.data;
+      const char* end = file.data + file.size;
+      int num_threads = HermesCommonApi.get_integral_param_value(numThreads);
+      bool success = true;
+
+      while (success)
+      {
+        fast_skip_blank(p, end);
+        if (p >= end)
+          break;
+
+        // Section name.
+        const char* name = p;
+        while (p < end && (isalnum(*p) || *p == '_'))
+          p++;
+        std::string section(name, p);
+        while (p < end && (*p == ' ' || *p == '\t' || *p == '\r' || *p == '\n'))
+          p++;
+        if (section.empty() || p >= end || *p != '=')
+        {
+          success = false;
+          break;
+        }
+        p++;
+
+        // Variables are left for the general parser.
+        std::vector<const char*> entries;
+        if (!fast_find_entries(p, end, entries))
+        {
+          success = false;
+          break;
+        }
+        int count = entries.size();
+
+        if (section == "vertices")
+        {
+          int offset = x_vertex.size();
+          x_vertex.resize(offset + count);
+          y_vertex.resize(offset + count);
+#pragma omp parallel for num_threads(num_threads) reduction(&&:success)
+          for (int i = 0; i < count; i++)
+          {
+            const char* tokens[2], *token_ends[2];
+            if (fast_read_entry(entries[i], end, tokens, token_ends, 2) != 2
+              || !fast_to_double(tokens[0], token_ends[0], x_vertex[offset + i])
+              || !fast_to_double(tokens[1], token_ends[1], y_vertex[offset + i]))
+              success = false;
+          }
+        }
+        else if (section == "elements")
+        {
+          int offset = en1.size();
+          en1.resize(offset + count);
+          en2.resize(offset + count);
+          en3.resize(offset + count);
+          en4.resize(offset + count);
+          e_mtl.resize(offset + count);
+#pragma omp parallel for num_threads(num_threads) reduction(&&:success)
+          for (int i = 0; i < count; i++)
+          {
+            const char* tokens[5], *token_ends[5];
+            int num_fields = fast_read_entry(entries[i], end, tokens, token_ends, 5);
+            // parse_mesh() reads an unquoted integer after three vertex indices as the fourth vertex index,
+            // such a triangle is left to it so that both paths read the file the same way.
+            int dummy;
+            if (num_fields == 4 && fast_to_int(tokens[3], token_ends[3], dummy))
+            {
+              success = false;
+              continue;
+            }
+            if (num_fields == 4)
+              en4[offset + i] = -1;
+            else if (num_fields != 5 || !fast_to_int(tokens[3], token_ends[3], en4[offset + i]))
+            {
+              success = false;
+              continue;
+            }
+            if (!fast_to_int(tokens[0], token_ends[0], en1[offset + i]) || !fast_to_int(tokens[1], token_ends[1], en2[offset + i])
+              || !fast_to_int(tokens[2], token_ends[2], en3[offset + i]))
+              success = false;
+            else
+              e_mtl[offset + i].assign(tokens[num_fields - 1], token_ends[num_fields - 1]);
+          }
+        }
+        else if (section == "boundaries")
+        {
+          int offset = bdy_first.size();
+          bdy_first.resize(offset + count);
+          bdy_second.resize(offset + count);
+          bdy_type.resize(offset + count);
+#pragma omp parallel for num_threads(num_threads) reduction(&&:success)
+          for (int i = 0; i < count; i++)
+          {
+            const char* tokens[3], *token_ends[3];
+            if (fast_read_entry(entries[i], end, tokens, token_ends, 3) != 3
+              || !fast_to_int(tokens[0], token_ends[0], bdy_first[offset + i])
+              || !fast_to_int(tokens[1], token_ends[1], bdy_second[offset + i]))
+              success = false;
+            else
+              bdy_type[offset + i].assign(tokens[2], token_ends[2]);
+          }
+        }
+        else if (section == "curves")
+        {
+          // Only circular arcs, NURBS curves refer to variables.
+          for (int i = 0; i < count && success; i++)
+          {
+            const char* tokens[3], *token_ends[3];
+            int first, second;
+            double angle;
+            if (fast_read_entry(entries[i], end, tokens, token_ends, 3) != 3 || !fast_to_int(tokens[0], token_ends[0], first)
+              || !fast_to_int(tokens[1], token_ends[1], second) || !fast_to_double(tokens[2], token_ends[2], angle))
+              success = false;
+            else
+            {
+              curv_first.push_back(first);
+              curv_second.push_back(second);
+              curv_third.push_back(angle);
+              curv_nurbs.push_back(false);
+              curv_inner_pts.push_back("none");
+              curv_knots.push_back("none");
+            }
+          }
+        }
+        else if (section == "refinements")
+        {
+          for (int i = 0; i < count && success; i++)
+          {
+            const char* tokens[2], *token_ends[2];
+            int id, type;
+            if (fast_read_entry(entries[i], end, tokens, token_ends, 2) != 2 || !fast_to_int(tokens[0], token_ends[0], id)
+              || !fast_to_int(tokens[1], token_ends[1], type))
+              success = false;
+            else
+            {
+              ref_elt.push_back(id);
+              ref_type.push_back(type);
+            }
+          }
+        }
+        else
+          success = false;
+      }
+
+      if (!success)
+      {
+        this->clear();
+        return false;
+      }
+
+      n_vert = x_vertex.size();
+      n_el = en1.size();
+      n_bdy = bdy_first.size();
+      n_curv = curv_first.size();
+      n_ref = ref_elt.size();
+      return true;
+    }
   }
 }
\ No newline at end of file
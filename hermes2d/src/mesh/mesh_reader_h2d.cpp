@@ -176,7 +176,9 @@ namespace Hermes
 			mesh->free();
 
 			MeshData m(filename);
-			m.parse_mesh();
+			// Files using variables or NURBS curves are left for the general parser.
+			if (!m.parse_mesh_fast())
+				m.parse_mesh();
 
 			//// vertices ////////////////////////////////////////////////////////////////
 
@@ -219,7 +221,7 @@ namespace Hermes
 				if (m.en4[i] == -1)  nv = 4;
 				else nv = 5;
 
-				int* idx = new int[nv - 1];
+				int idx[4];
 				std::string el_marker;
 				if (!nv) {
 					mesh->elements.skip_slot()->cm = nullptr;
@@ -227,10 +229,7 @@ namespace Hermes
 				}
 
 				if (nv < 4 || nv > 5)
-				{
-					delete[] idx;
 					throw Hermes::Exceptions::MeshLoadFailureException("File %s: element #%d: wrong number of vertex indices.", filename, i);
-				}
 
 				if (nv == 4) {
 					idx[0] = m.en1[i];
@@ -249,10 +248,7 @@ namespace Hermes
 				}
 				for (j = 0; j < nv - 1; j++)
 					if (idx[j] < 0 || idx[j] >= mesh->ntopvert)
-					{
-						delete[] idx;
 						throw Hermes::Exceptions::MeshLoadFailureException("File %s: error creating element #%d: vertex #%d does not exist.", filename, i, idx[j]);
-					}
 
 				Node *v0 = &mesh->nodes[idx[0]], *v1 = &mesh->nodes[idx[1]], *v2 = &mesh->nodes[idx[2]];
 
@@ -274,8 +270,6 @@ namespace Hermes
 				}
 
 				mesh->nactive++;
-
-				delete[] idx;
 			}
 			mesh->nbase = n;
 
@@ -339,13 +333,7 @@ namespace Hermes
 			}
 
 			// update refmap coeffs of curvilinear elements
-			Element* e;
-			for_all_used_elements(e, mesh)
-			{
-				if (e->cm != nullptr)
-					e->cm->update_refmap_coeffs(e);
-				this->ref_map.set_element_iro_cache(e);
-			}
+			mesh->update_all_refmap_coeffs();
 
 			//// refinements /////////////////////////////////////////////////////////////
 			if (m.n_ref > 0)
@@ -0,0 +1,486 @@
+// This file is part of Hermes2D
+//
+// Hermes2D is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// Hermes2D is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Hermes2D; if not, see <http://www.gnu.org/licenses/>.
+
+#include "mesh_reader_h2d_binary.h"
+#include "mesh_data.h"
+#include "api2d.h"
+
+namespace Hermes
+{
+  namespace Hermes2D
+  {
+    extern unsigned g_mesh_seq;
+
+    static const char binary_mesh_magic[8] = { 'H', '2', 'D', 'M', 'E', 'S', 'H', 'B' };
+    static const unsigned int binary_mesh_endianness = 0x01020304;
+
+    template<typename T>
+    static void write_value(FILE* f, const T& value)
+    {
+      fwrite(&value, sizeof(T), 1, f);
+    }
+
+    template<typename T>
+    static void write_array(FILE* f, const T* values, int count)
+    {
+      if (count > 0)
+        fwrite(values, sizeof(T), count, f);
+    }
+
+    /// The file is not necessarily aligned for T, hence the memcpy.
+    template<typename T>
+    static void read_array(const char*& p, const char* end, T* values, int count)
+    {
+      if (count < 0 || (size_t)(end - p) < sizeof(T) * count)
+        throw Exceptions::MeshLoadFailureException("Binary mesh file is truncated or corrupted.");
+      memcpy(values, p, sizeof(T) * count);
+      p += sizeof(T) * count;
+    }
+
+    template<typename T>
+    static T read_value(const char*& p, const char* end)
+    {
+      T value;
+      read_array(p, end, &value, 1);
+      return value;
+    }
+
+    const unsigned int MeshReaderH2DBinary::version;
+
+    MeshReaderH2DBinary::MeshReaderH2DBinary()
+    {
+    }
+
+    MeshReaderH2DBinary::~MeshReaderH2DBinary()
+    {
+    }
+
+    void MeshReaderH2DBinary::save_curve(FILE* f, Curve* curve)
+    {
+      if (curve == nullptr)
+      {
+        write_value<int>(f, -1);
+        return;
+      }
+
+      write_value<int>(f, curve->type);
+      if (curve->type == ArcType)
+      {
+        Arc* arc = (Arc*)curve;
+        write_value(f, arc->angle);
+        write_array(f, arc->kv, Arc::nk);
+        write_array(f, &arc->pt[0][0], 3 * Arc::np);
+      }
+      else
+      {
+        Nurbs* nurbs = (Nurbs*)curve;
+        write_value(f, nurbs->degree);
+        write_value(f, nurbs->np);
+        write_value(f, nurbs->nk);
+        write_array(f, &nurbs->pt[0][0], 3 * nurbs->np);
+        write_array(f, nurbs->kv, nurbs->nk);
+      }
+    }
+
+    Curve* MeshReaderH2DBinary::load_curve(const char*& p, const char* end)
+    {
+      int type = read_value<int>(p, end);
+      if (type == -1)
+        return nullptr;
+
+      if (type == ArcType)
+      {
+        Arc* arc = new Arc(read_value<double>(p, end));
+        read_array(p, end, arc->kv, Arc::nk);
+        read_array(p, end, &arc->pt[0][0], 3 * Arc::np);
+        return arc;
+      }
+      else if (type == NurbsType)
+      {
+        Nurbs* nurbs = new Nurbs;
+        nurbs->degree = read_value<unsigned char>(p, end);
+        nurbs->np = read_value<unsigned char>(p, end);
+        nurbs->nk = read_value<unsigned char>(p, end);
+        nurbs->pt = malloc_with_check<double3>(nurbs->np);
+        nurbs->kv = malloc_with_check<double>(nurbs->nk);
+        read_array(p, end, &nurbs->pt[0][0], 3 * nurbs->np);
+        read_array(p, end, nurbs->kv, nurbs->nk);
+        return nurbs;
+      }
+      else
+        throw Exceptions::MeshLoadFailureException("Binary mesh file: unknown curve type %i.", type);
+    }
+
+    void MeshReaderH2DBinary::save_markers(FILE* f, Mesh::MarkersConversion& markers)
+    {
+      write_value(f, markers.min_marker_unused);
+      write_value<int>(f, markers.conversion_table.size());
+      for (std::map<int, std::string>::iterator it = markers.conversion_table.begin(); it != markers.conversion_table.end(); ++it)
+      {
+        write_value(f, it->first);
+        write_value<int>(f, it->second.size());
+        write_array(f, it->second.c_str(), it->second.size());
+      }
+    }
+
+    void MeshReaderH2DBinary::load_markers(const char*& p, const char* end, Mesh::MarkersConversion& markers)
+    {
+      markers.conversion_table.clear();
+      markers.conversion_table_inverse.clear();
+      markers.min_marker_unused = read_value<int>(p, end);
+      int count = read_value<int>(p, end);
+      for (int i = 0; i < count; i++)
+      {
+        int internal_marker = read_value<int>(p, end);
+        int length = read_value<int>(p, end);
+        if (length < 0 || end - p < length)
+          throw Exceptions::MeshLoadFailureException("Binary mesh file is truncated or corrupted.");
+        std::string user_marker(p, length);
+        p += length;
+        markers.conversion_table.insert(std::pair<int, std::string>(internal_marker, user_marker));
+        markers.conversion_table_inverse.insert(std::pair<std::string, int>(user_marker, internal_marker));
+      }
+    }
+
+    void MeshReaderH2DBinary::save(const char *filename, MeshSharedPtr mesh)
+    {
+      if (!mesh)
+        throw Exceptions::NullException(1);
+
+      FILE* f = fopen(filename, "wb");
+      if (f == nullptr)
+        throw Exceptions::MeshLoadFailureException("Could not create mesh file %s.", filename);
+
+      // Header.
+      write_array(f, binary_mesh_magic, 8);
+      write_value(f, version);
+      write_value(f, binary_mesh_endianness);
+      write_value<int>(f, sizeof(NodeRecord));
+      write_value<int>(f, sizeof(ElementRecord));
+
+      write_value(f, mesh->nbase);
+      write_value(f, mesh->ntopvert);
+      write_value(f, mesh->ninitial);
+      write_value(f, mesh->nactive);
+
+      // Nodes, including the unused slots, so that the ids are preserved.
+      int num_nodes = mesh->nodes.get_size();
+      write_value(f, num_nodes);
+      write_value(f, mesh->nodes.get_num_unused());
+      for (int i = 0; i < mesh->nodes.get_num_unused(); i++)
+        write_value(f, mesh->nodes.get_unused(i));
+
+      NodeRecord* node_records = calloc_with_check<NodeRecord>(std::max(num_nodes, 1));
+      for (int i = 0; i < num_nodes; i++)
+      {
+        Node* node = &mesh->nodes[i];
+        NodeRecord& record = node_records[i];
+        record.id = i;
+        record.used = node->used;
+        if (!node->used)
+          continue;
+        record.ref = node->ref;
+        record.type = node->type;
+        record.bnd = node->bnd;
+        record.p1 = node->p1;
+        record.p2 = node->p2;
+        if (node->type == HERMES_TYPE_VERTEX)
+        {
+          record.x = node->x;
+          record.y = node->y;
+        }
+        else
+        {
+          record.marker = node->marker;
+          for (int j = 0; j < 2; j++)
+            record.elem[j] = node->elem[j] ? node->elem[j]->id : -1;
+        }
+      }
+      write_array(f, node_records, num_nodes);
+      free_with_check(node_records);
+
+      // Elements.
+      int num_elements = mesh->elements.get_size();
+      write_value(f, num_elements);
+      write_value(f, mesh->elements.get_num_unused());
+      for (int i = 0; i < mesh->elements.get_num_unused(); i++)
+        write_value(f, mesh->elements.get_unused(i));
+
+      // Whether the unused slots are in the list of unused ids (and are reused), or skipped forever.
+      std::vector<bool> reusable(num_elements, false);
+      for (int i = 0; i < mesh->elements.get_num_unused(); i++)
+        reusable[mesh->elements.get_unused(i)] = true;
+
+      std::vector<CurvMap*> curv_maps;
+      ElementRecord* element_records = calloc_with_check<ElementRecord>(std::max(num_elements, 1));
+      for (int i = 0; i < num_elements; i++)
+      {
+        Element* e = &mesh->elements[i];
+        ElementRecord& record = element_records[i];
+        record.id = i;
+        record.used = e->used ? 1 : (reusable[i] ? 0 : 2);
+        if (!e->used)
+          continue;
+
+        record.active = e->active;
+        record.nvert = e->nvert;
+        record.marker = e->marker;
+        record.parent = e->parent ? e->parent->id : -1;
+        for (int j = 0; j < H2D_MAX_NUMBER_VERTICES; j++)
+          record.vn[j] = j < e->nvert ? e->vn[j]->id : -1;
+        for (int j = 0; j < H2D_MAX_ELEMENT_SONS; j++)
+        {
+          if (e->active)
+            record.en_sons[j] = j < e->nvert ? e->en[j]->id : -1;
+          else
+            record.en_sons[j] = e->sons[j] ? e->sons[j]->id : -1;
+        }
+        record.area = e->area;
+        record.diameter = e->diameter;
+        record.center_set = e->center_set;
+        record.x_center = e->x_center;
+        record.y_center = e->y_center;
+        record.iro_cache = e->iro_cache;
+
+        if (e->cm)
+        {
+          record.curv_map = curv_maps.size();
+          curv_maps.push_back(e->cm);
+        }
+        else
+          record.curv_map = -1;
+      }
+      write_array(f, element_records, num_elements);
+      free_with_check(element_records);
+
+      // CurvMaps, including the coefficients of the projected reference mapping.
+      write_value<int>(f, curv_maps.size());
+      for (unsigned int i = 0; i < curv_maps.size(); i++)
+      {
+        CurvMap* cm = curv_maps[i];
+        write_value<unsigned char>(f, cm->toplevel);
+        write_value(f, cm->order);
+        write_value(f, cm->nc);
+        write_array(f, &cm->coeffs[0][0], 2 * cm->nc);
+        if (cm->toplevel)
+        {
+          for (int j = 0; j < H2D_MAX_NUMBER_EDGES; j++)
+            save_curve(f, cm->curves[j]);
+        }
+        else
+        {
+          write_value(f, cm->parent->id);
+          write_value(f, cm->sub_idx);
+        }
+      }
+
+      save_markers(f, mesh->element_markers_conversion);
+      save_markers(f, mesh->boundary_markers_conversion);
+
+      // Refinements, so that the mesh can still be saved in the other formats.
+      write_value<int>(f, mesh->refinements.size());
+      for (unsigned int i = 0; i < mesh->refinements.size(); i++)
+      {
+        write_value(f, mesh->refinements[i].first);
+        write_value(f, mesh->refinements[i].second);
+      }
+
+      bool failed = ferror(f) != 0;
+      if (fclose(f) != 0 || failed)
+        throw Exceptions::MeshLoadFailureException("Could not write mesh file %s.", filename);
+    }
+
+    void MeshReaderH2DBinary::load(const char *filename, MeshSharedPtr mesh)
+    {
+      if (!mesh)
+        throw Exceptions::NullException(1);
+
+      MeshFileContents file(filename);
+      if (file.data == nullptr)
+        throw Exceptions::MeshLoadFailureException("Mesh file %s not found or empty.", filename);
+      const char* p = file.data;
+      const char* end = file.data + file.size;
+
+      // Header.
+      char magic[8];
+      read_array(p, end, magic, 8);
+      if (memcmp(magic, binary_mesh_magic, 8))
+        throw Exceptions::MeshLoadFailureException("File %s is not a binary mesh file.", filename);
+      unsigned int file_version = read_value<unsigned int>(p, end);
+      if (file_version != version)
+        throw Exceptions::MeshLoadFailureException("Binary mesh file %s: version %u, expected %u.", filename, file_version, version);
+      if (read_value<unsigned int>(p, end) != binary_mesh_endianness || read_value<int>(p, end) != sizeof(NodeRecord) || read_value<int>(p, end) != sizeof(ElementRecord))
+        throw Exceptions::MeshLoadFailureException("Binary mesh file %s has been saved on an incompatible platform.", filename);
+
+      mesh->free();
+
+      int nbase = read_value<int>(p, end);
+      int ntopvert = read_value<int>(p, end);
+      int ninitial = read_value<int>(p, end);
+      int nactive = read_value<int>(p, end);
+
+      // Nodes.
+      int num_nodes = read_value<int>(p, end);
+      int num_unused_nodes = read_value<int>(p, end);
+      std::vector<int> unused_nodes(std::max(num_unused_nodes, 0));
+      read_array(p, end, unused_nodes.data(), num_unused_nodes);
+      if (num_nodes < 0 || (size_t)(end - p) < sizeof(NodeRecord) * num_nodes)
+        throw Exceptions::MeshLoadFailureException("Binary mesh file %s is truncated or corrupted.", filename);
+      const char* node_records = p;
+      p += sizeof(NodeRecord) * num_nodes;
+
+      int size = HashTable::H2D_DEFAULT_HASH_SIZE;
+      while (size < 8 * num_nodes)
+        size *= 2;
+      mesh->init(size);
+
+      // Slots first (removed ids are put back to the list of unused ids in the original order), then the contents.
+      for (int i = 0; i < num_nodes; i++)
+        mesh->nodes.add();
+      for (int i = 0; i < num_unused_nodes; i++)
+        mesh->nodes.remove(unused_nodes[i]);
+
+      // Elements.
+      int num_elements = read_value<int>(p, end);
+      int num_unused_elements = read_value<int>(p, end);
+      std::vector<int> unused_elements(std::max(num_unused_elements, 0));
+      read_array(p, end, unused_elements.data(), num_unused_elements);
+      if (num_elements < 0 || (size_t)(end - p) < sizeof(ElementRecord) * num_elements)
+        throw Exceptions::MeshLoadFailureException("Binary mesh file %s is truncated or corrupted.", filename);
+      const char* element_records = p;
+      p += sizeof(ElementRecord) * num_elements;
+
+      for (int i = 0; i < num_elements; i++)
+      {
+        ElementRecord record;
+        memcpy(&record, element_records + sizeof(ElementRecord) * i, sizeof(ElementRecord));
+        if (record.used == 2)
+          mesh->elements.skip_slot()->cm = nullptr;
+        else
+          mesh->elements.add();
+      }
+      for (int i = 0; i < num_unused_elements; i++)
+        mesh->elements.remove(unused_elements[i]);
+
+      // Node contents.
+      for (int i = 0; i < num_nodes; i++)
+      {
+        NodeRecord record;
+        memcpy(&record, node_records + sizeof(NodeRecord) * i, sizeof(NodeRecord));
+        if (!record.used)
+          continue;
+        Node* node = &mesh->nodes[i];
+        node->ref = record.ref;
+        node->type = record.type;
+        node->bnd = record.bnd;
+        node->p1 = record.p1;
+        node->p2 = record.p2;
+        node->next_hash = nullptr;
+        if (node->type == HERMES_TYPE_VERTEX)
+        {
+          node->x = record.x;
+          node->y = record.y;
+        }
+        else
+        {
+          node->marker = record.marker;
+          for (int j = 0; j < 2; j++)
+            node->elem[j] = record.elem[j] == -1 ? nullptr : &mesh->elements[record.elem[j]];
+        }
+      }
+
+      // CurvMaps.
+      int num_curv_maps = read_value<int>(p, end);
+      std::vector<CurvMap*> curv_maps(std::max(num_curv_maps, 0));
+      for (int i = 0; i < num_curv_maps; i++)
+      {
+        CurvMap* cm = new CurvMap;
+        curv_maps[i] = cm;
+        cm->toplevel = read_value<unsigned char>(p, end) != 0;
+        cm->order = read_value<unsigned short>(p, end);
+        cm->nc = read_value<unsigned short>(p, end);
+        cm->coeffs = malloc_with_check<double2>(cm->nc, true);
+        read_array(p, end, &cm->coeffs[0][0], 2 * cm->nc);
+        if (cm->toplevel)
+        {
+          for (int j = 0; j < H2D_MAX_NUMBER_EDGES; j++)
+            cm->curves[j] = load_curve(p, end);
+        }
+        else
+        {
+          cm->parent = &mesh->elements[read_value<int>(p, end)];
+          cm->sub_idx = read_value<uint64_t>(p, end);
+        }
+      }
+
+      // Element contents.
+      for (int i = 0; i < num_elements; i++)
+      {
+        ElementRecord record;
+        memcpy(&record, element_records + sizeof(ElementRecord) * i, sizeof(ElementRecord));
+        Element* e = &mesh->elements[i];
+        if (record.used != 1)
+        {
+          e->cm = nullptr;
+          continue;
+        }
+
+        e->active = record.active != 0;
+        e->nvert = record.nvert;
+        e->marker = record.marker;
+        e->visited = false;
+        e->parent = record.parent == -1 ? nullptr : &mesh->elements[record.parent];
+        for (int j = 0; j < H2D_MAX_NUMBER_VERTICES; j++)
+          e->vn[j] = record.vn[j] == -1 ? nullptr : &mesh->nodes[record.vn[j]];
+        for (int j = 0; j < H2D_MAX_ELEMENT_SONS; j++)
+        {
+          if (e->active)
+            e->en[j] = record.en_sons[j] == -1 ? nullptr : &mesh->nodes[record.en_sons[j]];
+          else
+            e->sons[j] = record.en_sons[j] == -1 ? nullptr : &mesh->elements[record.en_sons[j]];
+        }
+        e->area = record.area;
+        e->diameter = record.diameter;
+        e->center_set = record.center_set != 0;
+        e->x_center = record.x_center;
+        e->y_center = record.y_center;
+        e->iro_cache = record.iro_cache;
+        e->cm = record.curv_map == -1 ? nullptr : curv_maps[record.curv_map];
+      }
+
+      load_markers(p, end, mesh->element_markers_conversion);
+      load_markers(p, end, mesh->boundary_markers_conversion);
+
+      int num_refinements = read_value<int>(p, end);
+      for (int i = 0; i < num_refinements; i++)
+      {
+        unsigned int id = read_value<unsigned int>(p, end);
+        int refinement = read_value<int>(p, end);
+        mesh->refinements.push_back(std::pair<unsigned int, int>(id, refinement));
+      }
+
+      mesh->rebuild();
+
+      mesh->nbase = nbase;
+      mesh->ntopvert = ntopvert;
+      mesh->ninitial = ninitial;
+      mesh->nactive = nactive;
+
+      mesh->seq = g_mesh_seq++;
+      if (HermesCommonApi.get_integral_param_value(checkMeshesOnLoad))
+        mesh->initial_single_check();
+    }
+  }
+}
@@ -303,12 +303,7 @@ namespace Hermes
       }
 
       // update refmap coeffs of curvilinear elements
-      for_all_used_elements(e, mesh)
-      {
-        if (e->cm != nullptr)
-          e->cm->update_refmap_coeffs(e);
-        RefMap::set_element_iro_cache(e);
-      }
+      mesh->update_all_refmap_coeffs();
 
       delete[] p1s;
       delete[] p2s;
@@ -1027,12 +1022,7 @@ namespace Hermes
           }
 
           // update refmap coeffs of curvilinear elements
-          for_all_used_elements(e, meshes[subdomains_i])
-          {
-            if (e->cm != nullptr)
-              e->cm->update_refmap_coeffs(e);
-            RefMap::set_element_iro_cache(e);
-          }
+          meshes[subdomains_i]->update_all_refmap_coeffs();
 
           // refinements.
           if (!subdomains.at(subdomains_i).refinements.empty() && subdomains.at(subdomains_i).refinements.size() > 0)
@@ -1257,12 +1247,7 @@ namespace Hermes
       }
 
       // update refmap coeffs of curvilinear elements
-      for_all_used_elements(e, mesh)
-      {
-        if (e->cm != nullptr)
-          e->cm->update_refmap_coeffs(e);
-        RefMap::set_element_iro_cache(e);
-      }
+      mesh->update_all_refmap_coeffs();
     }
   }
 }
@@ -521,12 +521,7 @@ namespace Hermes
             }
 
             // update refmap coeffs of curvilinear elements
-            for_all_used_elements(e, meshes[subdomains_i])
-            {
-              if (e->cm != nullptr)
-                e->cm->update_refmap_coeffs(e);
-              RefMap::set_element_iro_cache(e);
-            }
+            meshes[subdomains_i]->update_all_refmap_coeffs();
 
             // refinements.
             if (parsed_xml_domain->subdomains().subdomain().at(subdomains_i).refinements().present() && parsed_xml_domain->subdomains().subdomain().at(subdomains_i).refinements()->ref().size() > 0)
@@ -924,12 +919,7 @@ namespace Hermes
         }
 
         // update refmap coeffs of curvilinear elements
-        for_all_used_elements(e, mesh)
-        {
-          if (e->cm != nullptr)
-            e->cm->update_refmap_coeffs(e);
-          RefMap::set_element_iro_cache(e);
-        }
+        mesh->update_all_refmap_coeffs();
       }
       catch (const xml_schema::exception& e)
       {
@@ -1168,12 +1158,7 @@ namespace Hermes
         }
 
         // update refmap coeffs of curvilinear elements
-        for_all_used_elements(e, mesh)
-        {
-          if (e->cm != nullptr)
-            e->cm->update_refmap_coeffs(e);
-          RefMap::set_element_iro_cache(e);
-        }
+        mesh->update_all_refmap_coeffs();
       }
       catch (const xml_schema::exception& e)
       {
@@ -165,14 +165,44 @@ namespace Hermes
 
     MeshHashGrid::MeshHashGrid(Mesh* mesh) : mesh_seq(mesh->get_seq())
     {
-      mesh->calc_bounding_box();
+      // bounding boxes of the elements, the grid covers all of them (curved edges may bulge out of the box of the vertices)
+      this->element_bounding_boxes.resize(4 * mesh->get_max_element_id());
+      Element *element;
+      double2 p1, p2;
+      double bottom_left_x = 0., bottom_left_y = 0., top_right_x = 0., top_right_y = 0.;
+      bool first = true;
+      for_all_active_elements_compact(element, mesh)
+      {
+        elementBoundingBox(element, p1, p2);
+        double* box = &this->element_bounding_boxes[4 * element->id];
+        box[0] = p1[0];
+        box[1] = p1[1];
+        box[2] = p2[0];
+        box[3] = p2[1];
+
+        if (first)
+        {
+          bottom_left_x = p1[0];
+          bottom_left_y = p1[1];
+          top_right_x = p2[0];
+          top_right_y = p2[1];
+          first = false;
+        }
+        else
+        {
+          bottom_left_x = std::min(bottom_left_x, p1[0]);
+          bottom_left_y = std::min(bottom_left_y, p1[1]);
+          top_right_x = std::max(top_right_x, p2[0]);
+          top_right_y = std::max(top_right_y, p2[1]);
+        }
+      }
 
       // create grid
-      double interval_len_x = (mesh->top_right_x - mesh->bottom_left_x) / GRID_SIZE;
-      double interval_len_y = (mesh->top_right_y - mesh->bottom_left_y) / GRID_SIZE;
+      double interval_len_x = (top_right_x - bottom_left_x) / GRID_SIZE;
+      double interval_len_y = (top_right_y - bottom_left_y) / GRID_SIZE;
 
-      intervals_x[0] = mesh->bottom_left_x;
-      intervals_y[0] = mesh->bottom_left_y;
+      intervals_x[0] = bottom_left_x;
+      intervals_y[0] = bottom_left_y;
 
       for (int i = 1; i < GRID_SIZE; i++)
       {
@@ -180,24 +210,22 @@ namespace Hermes
         intervals_y[i] = intervals_y[i - 1] + interval_len_y;
       }
 
-      intervals_x[GRID_SIZE] = mesh->top_right_x;
-      intervals_y[GRID_SIZE] = mesh->top_right_y;
+      intervals_x[GRID_SIZE] = top_right_x;
+      intervals_y[GRID_SIZE] = top_right_y;
 
       for (int i = 0; i < GRID_SIZE; i++)
       {
         for (int j = 0; j < GRID_SIZE; j++)
         {
-          m_grid[i][j] = new MeshHashGridElement(intervals_x[i], intervals_y[j], intervals_x[i + 1], intervals_y[j + 1]);
+          m_grid[i][j] = new MeshHashGridElement(this, intervals_x[i], intervals_y[j], intervals_x[i + 1], intervals_y[j + 1]);
         }
       }
 
       // assign elements
-      Element *element;
-      double2 p1, p2;
       int x_min, x_max, y_min, y_max;
-      for_all_active_elements(element, mesh)
+      for_all_active_elements_compact(element, mesh)
       {
-        elementBoundingBox(element, p1, p2);
+        get_element_bounding_box(element, p1, p2);
 
         x_min = 0;
         while (intervals_x[x_min + 1] < p1[0])
@@ -239,7 +267,7 @@ namespace Hermes
       }
     }
 
-    MeshHashGridElement::MeshHashGridElement(double lower_left_x, double lower_left_y, double upper_right_x, double upper_right_y, int depth) : lower_left_x(lower_left_x), lower_left_y(lower_left_y), upper_right_x(upper_right_x), upper_right_y(upper_right_y), m_depth(depth), m_active(true), element_count(0)
+    MeshHashGridElement::MeshHashGridElement(MeshHashGrid* grid, double lower_left_x, double lower_left_y, double upper_right_x, double upper_right_y, int depth) : grid(grid), lower_left_x(lower_left_x), lower_left_y(lower_left_y), upper_right_x(upper_right_x), upper_right_y(upper_right_y), m_depth(depth), m_active(true), element_count(0)
     {
       this->elements = new Element*[MAX_ELEMENTS];
       for (int i = 0; i < 2; i++)
@@ -260,7 +288,7 @@ namespace Hermes
     bool MeshHashGridElement::belongs(Element *element)
     {
       double2 p1, p2;
-      MeshHashGrid::elementBoundingBox(element, p1, p2);
+      this->grid->get_element_bounding_box(element, p1, p2);
       return ((p1[0] <= upper_right_x) && (p2[0] >= lower_left_x) && (p1[1] <= upper_right_y) && (p2[1] >= lower_left_y));
     }
 
@@ -286,7 +314,7 @@ namespace Hermes
 
               assert(m_sons[i][j] == nullptr);
 
-              m_sons[i][j] = new MeshHashGridElement(x0, y0, x1, y1, m_depth + 1);
+              m_sons[i][j] = new MeshHashGridElement(this->grid, x0, y0, x1, y1, m_depth + 1);
 
               for (int elem_i = 0; elem_i < this->element_count; elem_i++)
               {
@@ -316,26 +344,36 @@ namespace Hermes
 
     bool MeshHashGridElement::belongs(double x, double y)
     {
-      return (x >= lower_left_x) && (x <= upper_right_x) && (y <= lower_left_y) && (y >= upper_right_y);
+      return (x >= lower_left_x) && (x <= upper_right_x) && (y >= lower_left_y) && (y <= upper_right_y);
     }
 
     Element* MeshHashGridElement::getElement(double x, double y)
     {
       if (m_active)
       {
+        double2 p1, p2;
         for (int elem_i = 0; elem_i < this->element_count; elem_i++)
+        {
+          // the bounding box first, the (inverse) reference mapping of curved elements is expensive
+          this->grid->get_element_bounding_box(elements[elem_i], p1, p2);
+          if (x < p1[0] || x > p2[0] || y < p1[1] || y > p2[1])
+            continue;
           if (RefMap::is_element_on_physical_coordinates(elements[elem_i], x, y))
             return elements[elem_i];
+        }
 
         return nullptr;
       }
       else
       {
+        // only the sons containing the point (more of them for points on their common boundaries)
         Element* element;
         for (int i = 0; i < 2; i++)
         {
           for (int j = 0; j < 2; j++)
           {
+            if (!m_sons[i][j]->belongs(x, y))
+              continue;
             element = m_sons[i][j]->getElement(x, y);
             if (element)
               return element;
@@ -345,6 +383,54 @@ namespace Hermes
       }
     }
 
+    /// The shapeset of the reference mapping (see RefMap).
+    static H1ShapesetJacobi& get_ref_map_shapeset()
+    {
+      static H1ShapesetJacobi ref_map_shapeset;
+      return ref_map_shapeset;
+    }
+
+    double MeshHashGrid::get_shape_fn_bound(int index, ElementMode2D mode)
+    {
+      static std::map<std::pair<int, int>, double> bounds;
+
+      double bound;
+#pragma omp critical (MeshHashGridShapeFnBounds)
+      {
+        std::map<std::pair<int, int>, double>::iterator it = bounds.find(std::pair<int, int>(mode, index));
+        if (it != bounds.end())
+          bound = it->second;
+        else
+        {
+          H1ShapesetJacobi& shapeset = get_ref_map_shapeset();
+          unsigned short order = shapeset.get_order(index, mode);
+          int degree = (mode == HERMES_MODE_QUAD) ? std::max(H2D_GET_H_ORDER(order), H2D_GET_V_ORDER(order)) : order;
+          degree = std::max(degree, 1);
+
+          // Every point is at most 1 / n from a point of the grid with n intervals in each direction, and |p'| <= degree^2 max|p|
+          // on [-1, 1] (Markov) - max|p| <= max_grid|p| / (1 - degree^2 / n) along the lines of the grid, and the same across them.
+          // Triangles in the collapsed coordinates (u, v) -> (-1 + (u + 1)(1 - v) / 2, v), where p is of the same degree in u and v.
+          int n = 8 * degree * degree;
+          double max_value = 0.;
+          for (int i = 0; i <= n; i++)
+          {
+            double v = -1. + 2. * i / n;
+            for (int j = 0; j <= n; j++)
+            {
+              double u = -1. + 2. * j / n;
+              if (mode == HERMES_MODE_TRIANGLE)
+                u = -1. + (u + 1.) * (1. - v) / 2.;
+              max_value = std::max(max_value, std::abs(shapeset.get_fn_value(index, u, v, 0, mode)));
+            }
+          }
+          bound = max_value / ((1. - 1. / 8.) * (1. - 1. / 8.));
+          bounds[std::pair<int, int>(mode, index)] = bound;
+        }
+      }
+
+      return bound;
+    }
+
     void MeshHashGrid::elementBoundingBox(Element *element, double2 &p1, double2 &p2)
     {
       p1[0] = p2[0] = element->vn[0]->x;
@@ -366,14 +452,36 @@ namespace Hermes
 
       if (element->is_curved())
       {
-        // todo: should be improved
-        double diameter_x = p2[0] - p1[0];
-        p2[0] += diameter_x;
-        p1[0] -= diameter_x;
-
-        double diameter_y = p2[1] - p1[1];
-        p2[1] += diameter_y;
-        p1[1] -= diameter_y;
+        // The reference mapping is the sum of coeffs[i] * phi_i (the same shapes as in RefMap::set_active_element()), the vertex
+        // functions are nonnegative and sum up to one.
+        H1ShapesetJacobi& shapeset = get_ref_map_shapeset();
+        ElementMode2D mode = element->get_mode();
+        CurvMap* cm = element->cm;
+        double radius_x = 0., radius_y = 0.;
+        int k = element->get_nvert();
+        for (unsigned char i = 0; i < element->get_nvert(); i++)
+        {
+          for (unsigned short j = 2; j <= cm->order; j++, k++)
+          {
+            double bound = get_shape_fn_bound(shapeset.get_edge_index(i, 0, j, mode), mode);
+            radius_x += std::abs(cm->coeffs[k][0]) * bound;
+            radius_y += std::abs(cm->coeffs[k][1]) * bound;
+          }
+        }
+
+        unsigned short bubble_order = element->is_quad() ? H2D_MAKE_QUAD_ORDER(cm->order, cm->order) : cm->order;
+        short* bubble_indices = shapeset.get_bubble_indices(bubble_order, mode);
+        for (unsigned short i = 0; i < shapeset.get_num_bubbles(bubble_order, mode); i++, k++)
+        {
+          double bound = get_shape_fn_bound(bubble_indices[i], mode);
+          radius_x += std::abs(cm->coeffs[k][0]) * bound;
+          radius_y += std::abs(cm->coeffs[k][1]) * bound;
+        }
+
+        p1[0] -= radius_x;
+        p2[0] += radius_x;
+        p1[1] -= radius_y;
+        p2[1] += radius_y;
       }
     }
 
@@ -387,11 +495,11 @@ namespace Hermes
       while ((j < GRID_SIZE) && (intervals_y[j + 1] < y))
         j++;
 
-      // this means that x or y is outside mesh, but it can hapen
-      if ((i >= GRID_SIZE) || (j >= GRID_SIZE))
-        return nullptr;
-      else
+      // this means that x or y is outside the grid, i.e. outside all elements
+      if ((i < GRID_SIZE) && (j < GRID_SIZE))
         return m_grid[i][j]->getElement(x, y);
+      else
+        return nullptr;
     }
 
     int MeshHashGrid::get_mesh_seq() const
@@ -403,7 +511,7 @@ namespace Hermes
     {
       area = 0;
       Element* elem;
-      for_all_active_elements(elem, mesh)
+      for_all_active_elements_compact(elem, mesh)
       {
         if (elem->marker == marker)
         {
@@ -422,5 +530,126 @@ namespace Hermes
     {
       return this->area;
     }
+
+    MeshCompactView::MeshCompactView(Mesh* mesh) : num_active(0), active_ids(nullptr), nvert(nullptr), vertex_ids(nullptr), edge_ids(nullptr),
+      mesh_seq(mesh->get_seq()), mesh_num_active(mesh->get_num_active_elements()), max_element_id(mesh->get_max_element_id()),
+      max_node_id(mesh->get_max_node_id())
+    {
+      // Active element ids, ascending - the order of for_all_active_elements.
+      this->active_ids = malloc_with_check<int>(std::max(mesh->get_num_active_elements(), 1));
+      Element* e;
+      for_all_active_elements(e, mesh)
+        this->active_ids[this->num_active++] = e->id;
+
+      int size = std::max(this->num_active, 1);
+      this->nvert = malloc_with_check<unsigned char>(size);
+      this->vertex_ids = malloc_with_check<int>(size * H2D_MAX_NUMBER_VERTICES);
+      this->edge_ids = malloc_with_check<int>(size * H2D_MAX_NUMBER_VERTICES);
+
+      for (int i = 0; i < this->num_active; i++)
+      {
+        e = mesh->get_element_fast(this->active_ids[i]);
+        this->nvert[i] = e->nvert;
+        for (int j = 0; j < H2D_MAX_NUMBER_VERTICES; j++)
+        {
+          this->vertex_ids[i * H2D_MAX_NUMBER_VERTICES + j] = j < e->nvert ? e->vn[j]->id : -1;
+          this->edge_ids[i * H2D_MAX_NUMBER_VERTICES + j] = j < e->nvert ? e->en[j]->id : -1;
+        }
+      }
+    }
+
+    MeshCompactView::~MeshCompactView()
+    {
+      free_with_check(this->active_ids);
+      free_with_check(this->nvert);
+      free_with_check(this->vertex_ids);
+      free_with_check(this->edge_ids);
+    }
+
+    int MeshCompactView::get_mesh_seq() const
+    {
+      return this->mesh_seq;
+    }
+
+    bool MeshCompactView::is_up_to_date(Mesh* mesh) const
+    {
+      // The sequence number can be set from outside (Space::set_mesh_seq), so also the sizes are checked.
+      return this->mesh_seq == mesh->get_seq() && this->mesh_num_active == mesh->get_num_active_elements()
+        && this->max_element_id == mesh->get_max_element_id() && this->max_node_id == mesh->get_max_node_id();
+    }
+
+    MeshGeometryCache::MeshGeometryCache(Mesh* mesh, size_t max_bytes) : size_in_bytes(0), max_bytes(max_bytes),
+      mesh_seq(mesh->get_seq()), mesh_num_active(mesh->get_num_active_elements()), max_element_id(mesh->get_max_element_id())
+    {
+    }
+
+    bool MeshGeometryCache::Key::operator<(const Key& other) const
+    {
+      if (this->element_id != other.element_id)
+        return this->element_id < other.element_id;
+      if (this->sub_idx != other.sub_idx)
+        return this->sub_idx < other.sub_idx;
+      if (this->item != other.item)
+        return this->item < other.item;
+      return this->order < other.order;
+    }
+
+    bool MeshGeometryCache::is_up_to_date(Mesh* mesh) const
+    {
+      return this->mesh_seq == mesh->get_seq() && this->mesh_num_active == mesh->get_num_active_elements()
+        && this->max_element_id == mesh->get_max_element_id();
+    }
+
+    bool MeshGeometryCache::get(int element_id, uint64_t sub_idx, int item, int order, double* data) const
+    {
+      Key key = { element_id, item, order, sub_idx };
+      // No locking - entries only change in publish().
+      std::map<Key, std::vector<double> >::const_iterator it = this->entries.find(key);
+      if (it == this->entries.end())
+        return false;
+      memcpy(data, &it->second[0], it->second.size() * sizeof(double));
+      return true;
+    }
+
+    void MeshGeometryCache::insert(int element_id, uint64_t sub_idx, int item, int order, const double* data, int size)
+    {
+      Key key = { element_id, item, order, sub_idx };
+      if (this->entries.find(key) != this->entries.end())
+        return;
+      // Values, and (roughly) the map node.
+      size_t entry_bytes = size * sizeof(double) + sizeof(Key) + sizeof(std::vector<double>) + 4 * sizeof(void*);
+#pragma omp critical (MeshGeometryCache)
+      {
+        if (this->size_in_bytes + entry_bytes <= this->max_bytes && this->pending_entries.find(key) == this->pending_entries.end())
+        {
+          this->pending_entries[key].assign(data, data + size);
+          this->size_in_bytes += entry_bytes;
+        }
+      }
+    }
+
+    void MeshGeometryCache::publish()
+    {
+      if (this->pending_entries.empty())
+        return;
+      if (this->entries.empty())
+        this->entries.swap(this->pending_entries);
+      else
+      {
+        for (std::map<Key, std::vector<double> >::iterator it = this->pending_entries.begin(); it != this->pending_entries.end(); ++it)
+          this->entries[it->first].swap(it->second);
+        this->pending_entries.clear();
+      }
+    }
+
+    size_t MeshGeometryCache::get_size_in_bytes() const
+    {
+      return this->size_in_bytes;
+    }
+
+    size_t MeshGeometryCache::get_max_bytes() const
+    {
+      return this->max_bytes;
+    }
   }
 }
\ No newline at end of file
@@ -21,7 +21,7 @@ namespace Hermes
 {
   namespace Hermes2D
   {
-    RefMap::RefMap() : ref_map_shapeset(H1ShapesetJacobi()), ref_map_pss(&ref_map_shapeset)
+    RefMap::RefMap() : ref_map_shapeset(H1ShapesetJacobi()), ref_map_pss(&ref_map_shapeset), geometry_cache(nullptr)
     {
       quad_2d = nullptr;
       set_quad_2d(&g_quad_2d_std);
@@ -135,6 +135,16 @@ namespace Hermes
       }
     }
 
+    void RefMap::set_geometry_cache(MeshGeometryCache* geometry_cache)
+    {
+      this->geometry_cache = geometry_cache;
+    }
+
+    bool RefMap::use_geometry_cache() const
+    {
+      return this->geometry_cache && element->cm && this->quad_2d == &g_quad_2d_std;
+    }
+
     void RefMap::reinit_storage()
     {
       jacobian_calculated = -1;
@@ -165,6 +175,18 @@ namespace Hermes
     {
       int i, j, np = quad_2d->get_num_points(order, element->get_mode());
 
+      // curved elements - the stored values, if any
+      bool use_cache = this->use_geometry_cache();
+      double cached[5 * H2D_MAX_INTEGRATION_POINTS_COUNT];
+      if (use_cache && this->geometry_cache->get(element->id, sub_idx, MeshGeometryCache::GeometryCacheInvRefMap, order, cached))
+      {
+        memcpy(this->jacobian, cached, np * sizeof(double));
+        memcpy(this->inv_ref_map, cached + np, np * sizeof(double2x2));
+        this->inv_ref_map_calculated = order;
+        this->jacobian_calculated = order;
+        return;
+      }
+
       // construct jacobi matrices of the direct reference map for all integration points
       ref_map_pss.force_transform(sub_idx, ctm);
 
@@ -220,6 +242,13 @@ namespace Hermes
         jac[i] *= trj;
       }
 
+      if (use_cache)
+      {
+        memcpy(cached, jac, np * sizeof(double));
+        memcpy(cached + np, irm, np * sizeof(double2x2));
+        this->geometry_cache->insert(element->id, sub_idx, MeshGeometryCache::GeometryCacheInvRefMap, order, cached, 5 * np);
+      }
+
       this->inv_ref_map_calculated = order;
       this->jacobian_calculated = order;
     }
@@ -247,6 +276,12 @@ namespace Hermes
       // transform all x coordinates of the integration points
       int i, j, np = quad_2d->get_num_points(order, element->get_mode());
       double* x = this->phys_x;
+      bool use_cache = this->use_geometry_cache();
+      if (use_cache && this->geometry_cache->get(element->id, sub_idx, MeshGeometryCache::GeometryCachePhysX, order, x))
+      {
+        this->phys_x_calculated = order;
+        return;
+      }
       memset(x, 0, np * sizeof(double));
       ref_map_pss.force_transform(sub_idx, ctm);
       for (i = 0; i < nc; i++)
@@ -257,6 +292,8 @@ namespace Hermes
         for (j = 0; j < np; j++)
           x[j] += coeffs[i][0] * fn[j];
       }
+      if (use_cache)
+        this->geometry_cache->insert(element->id, sub_idx, MeshGeometryCache::GeometryCachePhysX, order, x, np);
       this->phys_x_calculated = order;
     }
 
@@ -265,6 +302,12 @@ namespace Hermes
       // transform all y coordinates of the integration points
       int i, j, np = quad_2d->get_num_points(order, element->get_mode());
       double* y = this->phys_y;
+      bool use_cache = this->use_geometry_cache();
+      if (use_cache && this->geometry_cache->get(element->id, sub_idx, MeshGeometryCache::GeometryCachePhysY, order, y))
+      {
+        this->phys_y_calculated = order;
+        return;
+      }
       memset(y, 0, np * sizeof(double));
       ref_map_pss.force_transform(sub_idx, ctm);
       for (i = 0; i < nc; i++)
@@ -275,6 +318,8 @@ namespace Hermes
         for (j = 0; j < np; j++)
           y[j] += coeffs[i][1] * fn[j];
       }
+      if (use_cache)
+        this->geometry_cache->insert(element->id, sub_idx, MeshGeometryCache::GeometryCachePhysY, order, y, np);
       this->phys_y_calculated = order;
     }
 
@@ -299,6 +344,10 @@ namespace Hermes
         for (i = 1; i < np; i++)
           memcpy(tan + i, tan, sizeof(double3));
       }
+      else if (this->use_geometry_cache() && this->geometry_cache->get(element->id, sub_idx, MeshGeometryCache::GeometryCacheTangent + edge, eo, (double*)tan))
+      {
+        // stored
+      }
       else
       {
         // construct jacobi matrices of the direct reference map at integration points along the edge
@@ -338,6 +387,9 @@ namespace Hermes
           t[1] *= inorm;
           t[2] *= (edge == 0 || edge == 2) ? ctm->m[0] : ctm->m[1];
         }
+
+        if (this->use_geometry_cache())
+          this->geometry_cache->insert(element->id, sub_idx, MeshGeometryCache::GeometryCacheTangent + edge, eo, (double*)tan, 3 * np);
       }
 
       this->tan_calculated[edge] = eo;
@@ -611,7 +663,20 @@ namespace Hermes
       }
       else
       {
+        // initial guess: the inverse of the affine map through the vertices 0, 1 and 2 (triangle), resp. 3 (quad)
         double xi1_old = 0.0, xi2_old = 0.0;
+        {
+          int k = e->is_triangle() ? 2 : 3;
+          double m00 = e->vn[1]->x - e->vn[0]->x, m01 = e->vn[k]->x - e->vn[0]->x;
+          double m10 = e->vn[1]->y - e->vn[0]->y, m11 = e->vn[k]->y - e->vn[0]->y;
+          double det = m00 * m11 - m01 * m10;
+          if (det > 0.0)
+          {
+            double dx = x - e->vn[0]->x, dy = y - e->vn[0]->y;
+            xi1_old = std::max(-1.0, std::min(1.0, 2.0 * (m11 * dx - m01 * dy) / det - 1.0));
+            xi2_old = std::max(-1.0, std::min(1.0, 2.0 * (-m10 * dx + m00 * dy) / det - 1.0));
+          }
+        }
         double vx, vy;
         double2x2 m;
         // number of Newton iterations
@@ -771,6 +836,7 @@ namespace Hermes
       double xi1, xi2;
 
       // Optionally try the fastest approach for a multitude of successive calls - using the MeshHashGrid grid.
+      // The grid tests the curved elements its cells miss, so a point it does not find is not in the mesh.
       if (use_MeshHashGrid)
       {
         if (e = mesh->element_on_physical_coordinates(x, y))
@@ -785,6 +851,9 @@ namespace Hermes
           }
           return e;
         }
+
+        Hermes::Mixins::Loggable::Static::warn("Point (%g, %g) does not lie in any element.", x, y);
+        return nullptr;
       }
 
       // vector for curved elements that do not contain the point when considering straightened edges.
@@ -14,6 +14,7 @@
 // along with Hermes2D.  If not, see <http://www.gnu.org/licenses/>.
 
 #include "neighbor_search.h"
+#include "discrete_problem/dg/dg_face_connectivity.h"
 #include <algorithm>
 
 namespace Hermes
@@ -264,13 +265,14 @@ namespace Hermes
     }
 
     template<typename Scalar>
-    bool NeighborSearch<Scalar>::set_active_edge_multimesh(const int& edge)
+    bool NeighborSearch<Scalar>::set_active_edge_multimesh(const int& edge, const DGFaceConnectivity<Scalar>* face_connectivity)
     {
       std::vector<unsigned int> transformations = get_transforms(original_central_el_transform);
       // Inter-element edge.
       if (is_inter_edge(edge, transformations))
       {
-        set_active_edge(edge);
+        if (!face_connectivity || !face_connectivity->set_active_edge(this, edge))
+          set_active_edge(edge);
         update_according_to_sub_idx(transformations);
         return true;
       }
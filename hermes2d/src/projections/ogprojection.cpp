@@ -16,6 +16,9 @@
 #include "projections/ogprojection.h"
 #include "space.h"
 #include "solver/linear_solver.h"
+#include "quadrature/limit_order.h"
+
+using namespace Hermes::Algebra::DenseMatrixOperations;
 
 namespace Hermes
 {
@@ -134,21 +137,16 @@ namespace Hermes
 
       // If projection norm is not provided, set it
       // to match the type of the space.
-      NormType norm = HERMES_UNSET_NORM;
-      if (proj_norm == HERMES_UNSET_NORM)
+      NormType norm = (proj_norm == HERMES_UNSET_NORM) ? get_default_norm(space) : proj_norm;
+
+      // The mass matrix of an L2 space is block diagonal - project element by element.
+      if (space->get_type() == HERMES_L2_SPACE && norm == HERMES_L2_NORM)
       {
-        SpaceType space_type = space->get_type();
-        switch (space_type)
-        {
-        case HERMES_H1_SPACE: norm = HERMES_H1_NORM; break;
-        case HERMES_HCURL_SPACE: norm = HERMES_HCURL_NORM; break;
-        case HERMES_HDIV_SPACE: norm = HERMES_HDIV_NORM; break;
-        case HERMES_L2_SPACE: norm = HERMES_L2_NORM; break;
-        case HERMES_L2_MARKERWISE_CONST_SPACE: norm = HERMES_L2_NORM; break;
-        default: throw Hermes::Exceptions::Exception("Unknown space type in OGProjection<Scalar>::project_global().");
-        }
+        // A static method has nowhere to keep the engine, the reference mass blocks are calculated again in every call.
+        OGProjectionEngine<Scalar> engine;
+        engine.project(space, source_meshfn, target_vec, norm);
+        return;
       }
-      else norm = proj_norm;
 
       // Define temporary projection weak form.
       WeakFormSharedPtr<Scalar> proj_wf(new WeakForm<Scalar>(1));
@@ -169,18 +167,7 @@ namespace Hermes
       NormType proj_norm)
     {
       if (proj_norm == HERMES_UNSET_NORM)
-      {
-        SpaceType space_type = space->get_type();
-        switch (space_type)
-        {
-        case HERMES_H1_SPACE: proj_norm = HERMES_H1_NORM; break;
-        case HERMES_HCURL_SPACE: proj_norm = HERMES_HCURL_NORM; break;
-        case HERMES_HDIV_SPACE: proj_norm = HERMES_HDIV_NORM; break;
-        case HERMES_L2_SPACE: proj_norm = HERMES_L2_NORM; break;
-        case HERMES_L2_MARKERWISE_CONST_SPACE: proj_norm = HERMES_L2_NORM; break;
-        default: throw Hermes::Exceptions::Exception("Unknown space type in OGProjection<Scalar>::project_global().");
-        }
-      }
+        proj_norm = get_default_norm(space);
 
       // Calculate the coefficient vector.
       Scalar* target_vec = malloc_with_check<Scalar>(space->get_num_dofs());
@@ -251,7 +238,283 @@ namespace Hermes
       }
     }
 
+    template<typename Scalar>
+    NormType OGProjection<Scalar>::get_default_norm(SpaceSharedPtr<Scalar> space)
+    {
+      switch (space->get_type())
+      {
+      case HERMES_H1_SPACE: return HERMES_H1_NORM;
+      case HERMES_HCURL_SPACE: return HERMES_HCURL_NORM;
+      case HERMES_HDIV_SPACE: return HERMES_HDIV_NORM;
+      case HERMES_L2_SPACE: return HERMES_L2_NORM;
+      case HERMES_L2_MARKERWISE_CONST_SPACE: return HERMES_L2_NORM;
+      default: throw Hermes::Exceptions::Exception("Unknown space type in OGProjection<Scalar>::project_global().");
+      }
+      return HERMES_UNSET_NORM;
+    }
+
+    template<typename Scalar>
+    OGProjectionEngine<Scalar>::OGProjectionEngine() : linear_solver(nullptr), global_space_seq(-1), global_mesh_seq(-1), global_dof_stamp(0),
+      global_norm(HERMES_UNSET_NORM)
+    {
+    }
+
+    template<typename Scalar>
+    OGProjectionEngine<Scalar>::~OGProjectionEngine()
+    {
+      this->free();
+    }
+
+    template<typename Scalar>
+    void OGProjectionEngine<Scalar>::free()
+    {
+      for (typename std::map<MassBlockKey, MassBlock>::iterator it = this->reference_mass_blocks.begin(); it != this->reference_mass_blocks.end(); ++it)
+      {
+        free_with_check(it->second.a, true);
+        free_with_check(it->second.p);
+      }
+      this->reference_mass_blocks.clear();
+
+      delete this->linear_solver;
+      this->linear_solver = nullptr;
+      this->global_wf.reset();
+      this->global_space.reset();
+      this->global_space_seq = -1;
+      this->global_mesh_seq = -1;
+      this->global_norm = HERMES_UNSET_NORM;
+    }
+
+    template<typename Scalar>
+    void OGProjectionEngine<Scalar>::project(SpaceSharedPtr<Scalar> space, MeshFunctionSharedPtr<Scalar> source_meshfn,
+      Scalar* target_vec, NormType proj_norm)
+    {
+      // Sanity checks.
+      if (target_vec == nullptr)
+        throw Exceptions::NullException(3);
+
+      NormType norm = (proj_norm == HERMES_UNSET_NORM) ? OGProjection<Scalar>::get_default_norm(space) : proj_norm;
+
+      if (space->get_type() == HERMES_L2_SPACE && norm == HERMES_L2_NORM)
+        this->project_local(space, source_meshfn, target_vec);
+      else
+        this->project_global(space, source_meshfn, target_vec, norm);
+    }
+
+    template<typename Scalar>
+    void OGProjectionEngine<Scalar>::project(SpaceSharedPtr<Scalar> space, MeshFunctionSharedPtr<Scalar> source_meshfn,
+      MeshFunctionSharedPtr<Scalar> target_sln, NormType proj_norm)
+    {
+      // Calculate the coefficient vector.
+      Scalar* target_vec = malloc_with_check<Scalar>(space->get_num_dofs());
+      this->project(space, source_meshfn, target_vec, proj_norm);
+
+      // Translate coefficient vector into a Solution.
+      Solution<Scalar>::vector_to_solution(target_vec, space, target_sln);
+
+      // Clean up.
+      free_with_check(target_vec);
+    }
+
+    template<typename Scalar>
+    void OGProjectionEngine<Scalar>::project_global(SpaceSharedPtr<Scalar> space, MeshFunctionSharedPtr<Scalar> source_meshfn,
+      Scalar* target_vec, NormType norm)
+    {
+      // A refined mesh or new essential BCs (a new DOF numbering) do not have to change the seq of the space.
+      if (!this->linear_solver || this->global_space != space || this->global_space_seq != space->get_seq() || this->global_norm != norm
+        || this->global_mesh_seq != space->get_mesh()->get_seq() || this->global_dof_stamp != space->get_dof_assignment_stamp())
+      {
+        delete this->linear_solver;
+
+        this->global_wf = WeakFormSharedPtr<Scalar>(new WeakForm<Scalar>(1));
+        this->global_wf->set_verbose_output(false);
+        this->global_wf->add_matrix_form(new MatrixDefaultNormFormVol<Scalar>(0, 0, norm));
+        this->global_wf->add_vector_form(new VectorDefaultNormFormVol<Scalar>(0, norm));
+
+        this->linear_solver = new LinearSolver<Scalar>(this->global_wf, space, true);
+        this->linear_solver->set_verbose_output(false);
+        // The matrix is assembled and factorized only in the first solve, then only the rhs is assembled.
+        this->linear_solver->set_jacobian_constant();
+
+        this->global_space = space;
+        this->global_space_seq = space->get_seq();
+        this->global_norm = norm;
+      }
+
+      // The weak form is cloned in every assembling, setting the new source is enough.
+      this->global_wf->set_ext(source_meshfn);
+
+      this->linear_solver->solve();
+      // Stored after the solve - assign_dofs() in it gives a new stamp e.g. after a refinement.
+      this->global_mesh_seq = space->get_mesh()->get_seq();
+      this->global_dof_stamp = space->get_dof_assignment_stamp();
+
+      memcpy(target_vec, this->linear_solver->get_sln_vector(), space->get_num_dofs() * sizeof(Scalar));
+    }
+
+    template<typename Scalar>
+    OGProjectionEngine<Scalar>::MassBlockKey::MassBlockKey(Shapeset* shapeset, Element* e, int order) :
+      shapeset_id(shapeset->get_id()), mode(e->get_mode()), h_order(H2D_GET_H_ORDER(order)), v_order(H2D_GET_V_ORDER(order))
+    {
+    }
+
+    template<typename Scalar>
+    bool OGProjectionEngine<Scalar>::MassBlockKey::operator<(const MassBlockKey& other) const
+    {
+      if (this->shapeset_id != other.shapeset_id)
+        return this->shapeset_id < other.shapeset_id;
+      if (this->mode != other.mode)
+        return this->mode < other.mode;
+      if (this->h_order != other.h_order)
+        return this->h_order < other.h_order;
+      return this->v_order < other.v_order;
+    }
+
+    template<typename Scalar>
+    void OGProjectionEngine<Scalar>::calc_mass_block(PrecalcShapeset* pss, RefMap* refmap, Element* e, int order, AsmList<Scalar>* al,
+      std::vector<double>& values, MassBlock* block)
+    {
+      ElementMode2D mode = e->get_mode();
+      int o = 2 * std::max(H2D_GET_H_ORDER(order), H2D_GET_V_ORDER(order));
+      if (refmap)
+        o += refmap->get_inv_ref_order();
+      limit_order_nowarn(o, mode);
+
+      double3* pt = g_quad_2d_std.get_points(o, mode);
+      unsigned char np = g_quad_2d_std.get_num_points(o, mode);
+      double* jac = refmap ? refmap->get_jacobian(o) : nullptr;
+
+      // Shape function values at the integration points (the values of L2 functions are not transformed).
+      unsigned short cnt = al->cnt;
+      values.resize(cnt * np);
+      pss->set_active_element(e);
+      for (unsigned short i = 0; i < cnt; i++)
+      {
+        pss->set_active_shape(al->idx[i]);
+        pss->set_quad_order(o, H2D_FN_VAL);
+        memcpy(&values[i * np], pss->get_fn_values(), np * sizeof(double));
+      }
+
+      block->cnt = cnt;
+      block->a = new_matrix<double>(cnt, cnt);
+      block->p = malloc_with_check<double>(cnt);
+      for (unsigned short i = 0; i < cnt; i++)
+      {
+        for (unsigned short j = 0; j <= i; j++)
+        {
+          double val = 0.;
+          for (unsigned char k = 0; k < np; k++)
+            val += pt[k][2] * (jac ? jac[k] : 1.) * values[i * np + k] * values[j * np + k];
+          block->a[i][j] = block->a[j][i] = val;
+        }
+      }
+
+      choldc(block->a, (int)cnt, block->p);
+    }
+
+    template<typename Scalar>
+    void OGProjectionEngine<Scalar>::project_local(SpaceSharedPtr<Scalar> space, MeshFunctionSharedPtr<Scalar> source_meshfn, Scalar* target_vec)
+    {
+      // The right-hand side is assembled globally (the source may live on a different mesh).
+      space->assign_dofs();
+      WeakFormSharedPtr<Scalar> proj_wf(new WeakForm<Scalar>(1));
+      proj_wf->set_verbose_output(false);
+      proj_wf->set_ext(source_meshfn);
+      proj_wf->add_vector_form(new VectorDefaultNormFormVol<Scalar>(0, HERMES_L2_NORM));
+
+      SimpleVector<Scalar> rhs;
+      DiscreteProblem<Scalar> dp(proj_wf, space, true);
+      dp.set_verbose_output(false);
+      dp.assemble(&rhs);
+
+      MeshSharedPtr mesh = space->get_mesh();
+      MeshCompactView* view = mesh->get_compact_view();
+      Shapeset* shapeset = space->get_shapeset();
+      space->update_assembly_list_cache();
+
+      // The reference blocks are shared by the threads, calculate the missing ones first.
+      {
+        PrecalcShapeset pss(shapeset);
+        AsmList<Scalar> al;
+        std::vector<double> values;
+        for (int view_i = 0; view_i < view->num_active; view_i++)
+        {
+          Element* e = mesh->get_element_fast(view->active_ids[view_i]);
+          int order = space->get_element_order(e->id);
+          MassBlockKey key(shapeset, e, order);
+          if (this->reference_mass_blocks.find(key) != this->reference_mass_blocks.end())
+            continue;
+          space->get_element_assembly_list(e, &al);
+          calc_mass_block(&pss, nullptr, e, order, &al, values, &this->reference_mass_blocks[key]);
+        }
+      }
+
+      int num_threads = HermesCommonApi.get_integral_param_value(numThreads);
+      std::string exceptionMessageCaughtInParallelBlock;
+
+#pragma omp parallel num_threads(num_threads)
+      {
+        int thread_number = omp_get_thread_num();
+        int start = (view->num_active / num_threads) * thread_number;
+        int end = (view->num_active / num_threads) * (thread_number + 1);
+        if (thread_number == num_threads - 1)
+          end = view->num_active;
+
+        try
+        {
+          PrecalcShapeset pss(shapeset);
+          RefMap refmap;
+          refmap.set_quad_2d(&g_quad_2d_std);
+          AsmList<Scalar> al;
+          std::vector<double> values;
+          Scalar b[H2D_MAX_LOCAL_BASIS_SIZE];
+
+          for (int view_i = start; view_i < end; view_i++)
+          {
+            // Exception already thrown -> exit the loop.
+            if (!exceptionMessageCaughtInParallelBlock.empty())
+              break;
+
+            Element* e = mesh->get_element_fast(view->active_ids[view_i]);
+            space->get_element_assembly_list(e, &al);
+            for (unsigned int i = 0; i < al.cnt; i++)
+              b[i] = rhs.v[al.dof[i]];
+
+            refmap.set_active_element(e);
+            if (refmap.is_jacobian_const())
+            {
+              // M_e = |J| * M_ref.
+              const MassBlock& block = this->reference_mass_blocks.find(MassBlockKey(shapeset, e, space->get_element_order(e->id)))->second;
+              cholsl(block.a, (int)block.cnt, block.p, b, b);
+              double inv_jac = 1. / refmap.get_const_jacobian();
+              for (unsigned int i = 0; i < al.cnt; i++)
+                target_vec[al.dof[i]] = b[i] * inv_jac;
+            }
+            else
+            {
+              MassBlock block;
+              calc_mass_block(&pss, &refmap, e, space->get_element_order(e->id), &al, values, &block);
+              cholsl(block.a, (int)block.cnt, block.p, b, b);
+              for (unsigned int i = 0; i < al.cnt; i++)
+                target_vec[al.dof[i]] = b[i];
+              free_with_check(block.a, true);
+              free_with_check(block.p);
+            }
+          }
+        }
+        catch (std::exception& exception)
+        {
+#pragma omp critical (exceptionMessageCaughtInParallelBlock)
+          exceptionMessageCaughtInParallelBlock = exception.what();
+        }
+      }
+
+      if (!exceptionMessageCaughtInParallelBlock.empty())
+        throw Hermes::Exceptions::Exception(exceptionMessageCaughtInParallelBlock.c_str());
+    }
+
     template class HERMES_API OGProjection < double > ;
     template class HERMES_API OGProjection < std::complex<double> > ;
+    template class HERMES_API OGProjectionEngine < double > ;
+    template class HERMES_API OGProjectionEngine < std::complex<double> > ;
   }
 }
\ No newline at end of file
@@ -103,6 +103,8 @@ namespace Hermes
 
       // Extremely important.
       Space<Scalar>::assign_dofs(this->dp->get_spaces());
+      this->set_linear_matrix_solver_spaces(this->linear_matrix_solver);
+      this->check_jacobian_spaces();
 
       // Assemble the residual always and the Matrix when necessary (nonconstant jacobian, not reusable, ...).
       if (this->jacobian_reusable && this->constant_jacobian)
@@ -119,6 +121,8 @@ namespace Hermes
           this->info("\tLinearSolver: assembling... [assembling the matrix and rhs anew].");
         this->dp->assemble(coeff_vec, this->get_jacobian(), this->get_residual());
         this->linear_matrix_solver->set_reuse_scheme(Hermes::Solvers::HERMES_CREATE_STRUCTURE_FROM_SCRATCH);
+        this->jacobian_reusable = true;
+        this->store_jacobian_spaces();
       }
 
       this->process_matrix_output(this->get_jacobian(), 1);
@@ -133,12 +137,102 @@ namespace Hermes
 
       this->sln_vector = this->linear_matrix_solver->get_sln_vector();
 
+      // The condensed DOFs are not a part of the solved system.
+      if (this->dp->get_static_condensation())
+        this->dp->reconstruct_condensed_dofs(this->sln_vector);
+
       this->on_finish();
 
       this->tick();
       this->info("\tLinearSolver: solving done in %s.", this->last_str().c_str());
     }
 
+    template<typename Scalar>
+    void LinearSolver<Scalar>::solve_multiple(unsigned int num_rhs)
+    {
+      this->check();
+
+      this->on_initialization();
+
+      this->tick();
+
+      // Extremely important.
+      Space<Scalar>::assign_dofs(this->dp->get_spaces());
+      this->set_linear_matrix_solver_spaces(this->linear_matrix_solver);
+      this->check_jacobian_spaces();
+
+      // Assemble all the right-hand sides always and the Matrix when necessary.
+      Scalar* coeff_vec = nullptr;
+      if (this->jacobian_reusable && this->constant_jacobian)
+      {
+        this->info("\tLinearSolver: assembling... [reusing matrix, assembling %i right-hand sides].", num_rhs);
+        this->dp->assemble(coeff_vec, nullptr, &this->rhs_block, num_rhs);
+        this->linear_matrix_solver->set_reuse_scheme(Hermes::Solvers::HERMES_REUSE_MATRIX_STRUCTURE_COMPLETELY);
+      }
+      else
+      {
+        this->info("\tLinearSolver: assembling... [assembling the matrix and %i right-hand sides anew].", num_rhs);
+        this->dp->assemble(coeff_vec, this->get_jacobian(), &this->rhs_block, num_rhs);
+        this->linear_matrix_solver->set_reuse_scheme(Hermes::Solvers::HERMES_CREATE_STRUCTURE_FROM_SCRATCH);
+        this->jacobian_reusable = true;
+        this->store_jacobian_spaces();
+      }
+
+      this->process_matrix_output(this->get_jacobian(), 1);
+
+      this->tick();
+      this->info("\tLinearSolver: assembling done in %s. Solving...", this->last_str().c_str());
+      this->tick();
+
+      // One factorization, num_rhs back-substitutions.
+      this->linear_matrix_solver->solve_multiple(this->rhs_block.v, num_rhs);
+
+      this->sln_vector = this->linear_matrix_solver->get_sln_vector();
+
+      this->on_finish();
+
+      this->tick();
+      this->info("\tLinearSolver: solving done in %s.", this->last_str().c_str());
+    }
+
+    template<typename Scalar>
+    void LinearSolver<Scalar>::store_jacobian_spaces()
+    {
+      std::vector<SpaceSharedPtr<Scalar> > spaces = this->dp->get_spaces();
+      this->jacobian_space_seqs.clear();
+      this->jacobian_mesh_seqs.clear();
+      this->jacobian_dof_stamps.clear();
+      for (unsigned int i = 0; i < spaces.size(); i++)
+      {
+        this->jacobian_space_seqs.push_back(spaces[i]->get_seq());
+        this->jacobian_mesh_seqs.push_back(spaces[i]->get_mesh()->get_seq());
+        this->jacobian_dof_stamps.push_back(spaces[i]->get_dof_assignment_stamp());
+      }
+    }
+
+    template<typename Scalar>
+    void LinearSolver<Scalar>::check_jacobian_spaces()
+    {
+      if (!this->jacobian_reusable)
+        return;
+
+      std::vector<SpaceSharedPtr<Scalar> > spaces = this->dp->get_spaces();
+      bool spaces_changed = spaces.size() != this->jacobian_space_seqs.size();
+      for (unsigned int i = 0; i < spaces.size() && !spaces_changed; i++)
+      {
+        spaces_changed = this->jacobian_space_seqs[i] != spaces[i]->get_seq() || this->jacobian_mesh_seqs[i] != spaces[i]->get_mesh()->get_seq()
+          || this->jacobian_dof_stamps[i] != spaces[i]->get_dof_assignment_stamp();
+      }
+      if (spaces_changed)
+        this->jacobian_reusable = false;
+    }
+
+    template<typename Scalar>
+    const SimpleVectorBlock<Scalar>* LinearSolver<Scalar>::get_rhs_block() const
+    {
+      return &this->rhs_block;
+    }
+
     template class HERMES_API LinearSolver < double > ;
     template class HERMES_API LinearSolver < std::complex<double> > ;
   }
@@ -61,6 +61,10 @@ namespace Hermes
     template<typename Scalar>
     void NewtonSolver<Scalar>::solve(Scalar* coeff_vec)
     {
+      // The condensed DOFs would not be reconstructed in the iterations.
+      if (this->dp->get_static_condensation())
+        throw Exceptions::Exception("NewtonSolver: static condensation of the DiscreteProblem is only available for LinearSolver.");
+      this->set_linear_matrix_solver_spaces(this->linear_matrix_solver);
       NewtonMatrixSolver<Scalar>::solve(coeff_vec);
     }
 
@@ -77,14 +81,33 @@ namespace Hermes
       this->dp->set_verbose_output(to_set);
     }
 
+    template<typename Scalar>
+    void NewtonSolver<Scalar>::set_lean_residual_assembling(bool to_set)
+    {
+      this->dp->set_lean_residual_assembling(to_set);
+    }
+
+    template<typename Scalar>
+    void NewtonSolver<Scalar>::invalidate_lean_residual_assembling()
+    {
+      this->dp->invalidate_lean_residual_assembling();
+    }
+
     template<typename Scalar>
     void NewtonSolver<Scalar>::assemble_residual(bool store_previous_residual)
     {
-      this->dp->assemble(this->sln_vector, this->get_residual());
+      this->dp->assemble_residual(this->sln_vector, this->get_residual());
       this->process_vector_output(this->get_residual(), this->get_current_iteration_number());
       this->get_residual()->change_sign();
     }
 
+    template<typename Scalar>
+    void NewtonSolver<Scalar>::assemble_jfnk_residual()
+    {
+      this->dp->assemble_residual(this->sln_vector, this->get_residual());
+      this->get_residual()->change_sign();
+    }
+
     template<typename Scalar>
     bool NewtonSolver<Scalar>::assemble_jacobian(bool store_previous_jacobian)
     {
@@ -125,6 +148,8 @@ namespace Hermes
     void NewtonSolver<Scalar>::init_solving(Scalar* coeff_vec)
     {
       this->problem_size = Space<Scalar>::assign_dofs(this->get_spaces());
+      // The weak formulation (time, parameters) may have changed since the last solve.
+      this->dp->invalidate_lean_residual_assembling();
       NewtonMatrixSolver<Scalar>::init_solving(coeff_vec);
     }
 
@@ -61,6 +61,10 @@ namespace Hermes
     template<typename Scalar>
     void PicardSolver<Scalar>::solve(Scalar* coeff_vec)
     {
+      // The condensed DOFs would not be reconstructed in the iterations.
+      if (this->dp->get_static_condensation())
+        throw Exceptions::Exception("PicardSolver: static condensation of the DiscreteProblem is only available for LinearSolver.");
+      this->set_linear_matrix_solver_spaces(this->linear_matrix_solver);
       PicardMatrixSolver<Scalar>::solve(coeff_vec);
     }
 
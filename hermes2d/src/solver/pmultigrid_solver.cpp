@@ -0,0 +1,825 @@
+// This file is part of Hermes2D
+//
+// Copyright (c) 2009 hp-FEM group at the University of Nevada, Reno (UNR).
+// Email: hpfem-group@unr.edu, home page: http://www.hpfem.org/.
+//
+// Hermes2D is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published
+// by the Free Software Foundation; either version 2 of the License,
+// or (at your option) any later version.
+//
+// Hermes2D is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Hermes2D; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+#include "solver/pmultigrid_solver.h"
+#include "api.h"
+
+using namespace Hermes::Algebra;
+using namespace Hermes::Solvers;
+
+namespace Hermes
+{
+  namespace Hermes2D
+  {
+    /// (Shape function index, position in the assembly list) pairs of the entries of an assembly list.
+    template<typename Scalar>
+    static void get_sorted_assembly_list_indices(AsmList<Scalar>* al, std::vector<std::pair<int, int> >& indices)
+    {
+      indices.resize(al->cnt);
+      for (unsigned int i = 0; i < al->cnt; i++)
+        indices[i] = std::pair<int, int>(al->idx[i], i);
+      std::sort(indices.begin(), indices.end());
+    }
+
+    /// Position of the entry of the assembly list that is the only one with the shape function index indices[i].first,
+    /// and is an unconstrained DOF, -1 otherwise.
+    template<typename Scalar>
+    static int get_unconstrained_entry(AsmList<Scalar>* al, std::vector<std::pair<int, int> >& indices, int i)
+    {
+      if (i > 0 && indices[i - 1].first == indices[i].first)
+        return -1;
+      if (i < (int)indices.size() - 1 && indices[i + 1].first == indices[i].first)
+        return -1;
+      int pos = indices[i].second;
+      if (al->dof[pos] < 0 || al->coef[pos] != 1.0)
+        return -1;
+      return pos;
+    }
+
+    /// Ordering of the (column, value) entries of a matrix row.
+    template<typename Scalar>
+    static bool compare_column_entries(const std::pair<int, Scalar>& a, const std::pair<int, Scalar>& b)
+    {
+      return a.first < b.first;
+    }
+
+    template<typename Scalar>
+    PMultigridSolver<Scalar>::PMultigridSolver(SpaceSharedPtr<Scalar> space, SparseMatrix<Scalar>* matrix, Vector<Scalar>* rhs) : LoopSolver<Scalar>(matrix, rhs)
+    {
+      this->init();
+      this->set_spaces(std::vector<SpaceSharedPtr<Scalar> >(1, space));
+    }
+
+    template<typename Scalar>
+    PMultigridSolver<Scalar>::PMultigridSolver(std::vector<SpaceSharedPtr<Scalar> > spaces, SparseMatrix<Scalar>* matrix, Vector<Scalar>* rhs) : LoopSolver<Scalar>(matrix, rhs)
+    {
+      this->init();
+      this->set_spaces(spaces);
+    }
+
+    template<typename Scalar>
+    PMultigridSolver<Scalar>::PMultigridSolver(SparseMatrix<Scalar>* matrix, Vector<Scalar>* rhs) : LoopSolver<Scalar>(matrix, rhs)
+    {
+      this->init();
+    }
+
+    template<typename Scalar>
+    LinearMatrixSolver<Scalar>* PMultigridSolver<Scalar>::create_pmultigrid_solver(SparseMatrix<Scalar>* matrix, Vector<Scalar>* rhs)
+    {
+      return new PMultigridSolver<Scalar>(matrix, rhs);
+    }
+
+    template<typename Scalar>
+    void PMultigridSolver<Scalar>::init()
+    {
+      this->coarse_matrix = nullptr;
+      this->coarse_rhs = nullptr;
+      this->coarse_solver = nullptr;
+      this->coarse_factorized = false;
+      this->levels_ready = false;
+      this->smoother = PMultigridChebyshev;
+      this->sweeps = 2;
+      this->krylov_acceleration = false;
+      this->num_iters = 0;
+      this->residual_norm = 0.;
+      this->toleranceType = RelativeTolerance;
+    }
+
+    template<typename Scalar>
+    PMultigridSolver<Scalar>::~PMultigridSolver()
+    {
+      this->free();
+    }
+
+    template<typename Scalar>
+    void PMultigridSolver<Scalar>::free()
+    {
+      this->free_levels();
+    }
+
+    template<typename Scalar>
+    void PMultigridSolver<Scalar>::set_spaces(std::vector<SpaceSharedPtr<Scalar> > spaces)
+    {
+      if (spaces.empty())
+        throw Exceptions::LengthException(1, 0, 1);
+      this->spaces = spaces;
+    }
+
+    template<typename Scalar>
+    void PMultigridSolver<Scalar>::set_smoother(PMultigridSmoother smoother, int sweeps)
+    {
+      if (sweeps < 1)
+        throw Exceptions::ValueException("sweeps", sweeps, 1);
+      this->smoother = smoother;
+      this->sweeps = sweeps;
+    }
+
+    template<typename Scalar>
+    void PMultigridSolver<Scalar>::set_krylov_acceleration(bool to_set)
+    {
+      this->krylov_acceleration = to_set;
+    }
+
+    template<typename Scalar>
+    int PMultigridSolver<Scalar>::get_num_iters()
+    {
+      return this->num_iters;
+    }
+
+    template<typename Scalar>
+    double PMultigridSolver<Scalar>::get_residual_norm()
+    {
+      return this->residual_norm;
+    }
+
+    template<typename Scalar>
+    int PMultigridSolver<Scalar>::get_matrix_size()
+    {
+      return this->general_matrix->get_size();
+    }
+
+    template<typename Scalar>
+    int PMultigridSolver<Scalar>::get_num_levels() const
+    {
+      return this->levels.size();
+    }
+
+    template<typename Scalar>
+    void PMultigridSolver<Scalar>::create_levels()
+    {
+      this->free_levels();
+
+      int num_spaces = this->spaces.size();
+      int p_max = 1;
+      for (int space_i = 0; space_i < num_spaces; space_i++)
+      {
+        Element* e;
+        for_all_active_elements(e, this->spaces[space_i]->get_mesh())
+        {
+          int order = this->spaces[space_i]->get_element_order(e->id);
+          p_max = std::max(p_max, std::max(H2D_GET_H_ORDER(order), H2D_GET_V_ORDER(order)));
+        }
+      }
+
+      // Spaces of the levels, level 0 are the spaces themselves.
+      std::vector<std::vector<SpaceSharedPtr<Scalar> > > level_spaces(1, this->spaces);
+      for (int p = p_max - 1; p >= 1; p--)
+      {
+        std::vector<SpaceSharedPtr<Scalar> > p_spaces;
+        for (int space_i = 0; space_i < num_spaces; space_i++)
+        {
+          SpaceSharedPtr<Scalar> space = this->spaces[space_i];
+          typename Space<Scalar>::ReferenceSpaceCreator copy_creator(space, space->get_mesh(), 0);
+          SpaceSharedPtr<Scalar> p_space = copy_creator.create_ref_space(false);
+          if (p_space.get() == space.get())
+            throw Exceptions::Exception("PMultigridSolver does not support spaces without polynomial orders (L2MarkerWiseConstSpace).");
+
+          Element* e;
+          for_all_active_elements(e, space->get_mesh())
+          {
+            int order = space->get_element_order(e->id);
+            if (e->is_triangle())
+              p_space->set_element_order(e->id, std::min(order, p));
+            else
+              p_space->set_element_order(e->id, std::min(H2D_GET_H_ORDER(order), p), std::min(H2D_GET_V_ORDER(order), p));
+          }
+          p_spaces.push_back(p_space);
+        }
+        Space<Scalar>::assign_dofs(p_spaces);
+        level_spaces.push_back(p_spaces);
+      }
+
+      int num_levels = level_spaces.size();
+      this->levels.resize(num_levels);
+      for (int level_i = 0; level_i < num_levels; level_i++)
+      {
+        Level& level = this->levels[level_i];
+        level.ndof = Space<Scalar>::get_num_dofs(level_spaces[level_i]);
+        level.matrix = nullptr;
+        level.own_matrix = false;
+        level.inv_diag = nullptr;
+        level.lambda_max = 0.;
+        level.coarse_dofs = nullptr;
+        level.x = malloc_with_check<Scalar>(std::max(level.ndof, 1));
+        level.b = malloc_with_check<Scalar>(std::max(level.ndof, 1));
+        level.r = malloc_with_check<Scalar>(std::max(level.ndof, 1));
+        level.d = malloc_with_check<Scalar>(std::max(level.ndof, 1));
+      }
+
+      // DOF maps: the coarse DOF is the fine DOF of the same shape function on the same element.
+      // Only the entries of the assembly lists that are neither constrained, nor Dirichlet ones are used, each DOF is such on some element.
+      std::vector<std::pair<int, int> > fine_indices, coarse_indices;
+      AsmList<Scalar> fine_al, coarse_al;
+      for (int level_i = 0; level_i < num_levels - 1; level_i++)
+      {
+        int coarse_ndof = this->levels[level_i + 1].ndof;
+        int* coarse_dofs = malloc_with_check<int>(std::max(coarse_ndof, 1));
+        for (int i = 0; i < coarse_ndof; i++)
+          coarse_dofs[i] = -1;
+        this->levels[level_i].coarse_dofs = coarse_dofs;
+
+        for (int space_i = 0; space_i < num_spaces; space_i++)
+        {
+          SpaceSharedPtr<Scalar> fine_space = level_spaces[level_i][space_i];
+          SpaceSharedPtr<Scalar> coarse_space = level_spaces[level_i + 1][space_i];
+          Element* e;
+          for_all_active_elements(e, fine_space->get_mesh())
+          {
+            fine_space->get_element_assembly_list(e, &fine_al);
+            coarse_space->get_element_assembly_list(e, &coarse_al);
+            get_sorted_assembly_list_indices(&fine_al, fine_indices);
+            get_sorted_assembly_list_indices(&coarse_al, coarse_indices);
+
+            // Merge of the two sorted lists.
+            unsigned int fine_i = 0;
+            for (unsigned int coarse_i = 0; coarse_i < coarse_indices.size(); coarse_i++)
+            {
+              int coarse_pos = get_unconstrained_entry(&coarse_al, coarse_indices, coarse_i);
+              if (coarse_pos == -1)
+                continue;
+              while (fine_i < fine_indices.size() && fine_indices[fine_i].first < coarse_indices[coarse_i].first)
+                fine_i++;
+              if (fine_i == fine_indices.size() || fine_indices[fine_i].first != coarse_indices[coarse_i].first)
+                throw Exceptions::Exception("PMultigridSolver: the basis of a lower order is not a subset of the basis of a higher order, a hierarchic shapeset is needed.");
+              int fine_pos = get_unconstrained_entry(&fine_al, fine_indices, fine_i);
+              if (fine_pos == -1)
+                continue;
+
+              int coarse_dof = coarse_al.dof[coarse_pos];
+              if (coarse_dofs[coarse_dof] != -1 && coarse_dofs[coarse_dof] != fine_al.dof[fine_pos])
+                throw Exceptions::Exception("PMultigridSolver: inconsistent DOF maps of the levels %i and %i.", level_i, level_i + 1);
+              coarse_dofs[coarse_dof] = fine_al.dof[fine_pos];
+            }
+          }
+        }
+
+        for (int i = 0; i < coarse_ndof; i++)
+          if (coarse_dofs[i] == -1)
+            throw Exceptions::Exception("PMultigridSolver: DOF %i of the level %i has no counterpart on the level %i.", i, level_i + 1, level_i);
+      }
+
+      this->spaces_seq.clear();
+      for (int space_i = 0; space_i < num_spaces; space_i++)
+        this->spaces_seq.push_back(this->spaces[space_i]->get_seq());
+
+      this->info("\tPMultigridSolver: %i levels, %i DOFs on the finest, %i DOFs on the coarsest.", num_levels, this->levels[0].ndof, this->levels[num_levels - 1].ndof);
+    }
+
+    template<typename Scalar>
+    CSRMatrix<Scalar>* PMultigridSolver<Scalar>::get_fine_csr_matrix(bool& own)
+    {
+      CSRMatrix<Scalar>* csr_matrix = dynamic_cast<CSRMatrix<Scalar>*>(this->general_matrix);
+      if (csr_matrix)
+      {
+        own = false;
+        return csr_matrix;
+      }
+
+      CSCMatrix<Scalar>* csc_matrix = dynamic_cast<CSCMatrix<Scalar>*>(this->general_matrix);
+      if (!csc_matrix)
+        throw Exceptions::Exception("PMultigridSolver needs a CSRMatrix or a CSCMatrix.");
+
+      // One triangle stored - the full symmetric matrix in CSC is the same as in CSR.
+      SymmetricCSCMatrix<Scalar>* symmetric_matrix = dynamic_cast<SymmetricCSCMatrix<Scalar>*>(csc_matrix);
+      if (symmetric_matrix)
+      {
+        CSCMatrix<Scalar>* full_matrix = symmetric_matrix->create_full_matrix();
+        csr_matrix = new CSRMatrix<Scalar>;
+        csr_matrix->create(full_matrix->get_size(), full_matrix->get_nnz(), full_matrix->get_Ap(), full_matrix->get_Ai(), full_matrix->get_Ax());
+        delete full_matrix;
+        own = true;
+        return csr_matrix;
+      }
+
+      // Transposition of the arrays, the column indices in the rows end up sorted.
+      int size = csc_matrix->get_size();
+      int nnz = csc_matrix->get_nnz();
+      int* csc_Ap = csc_matrix->get_Ap();
+      int* csc_Ai = csc_matrix->get_Ai();
+      Scalar* csc_Ax = csc_matrix->get_Ax();
+
+      int* Ap = calloc_with_check<int>(size + 1);
+      int* Ai = malloc_with_check<int>(std::max(nnz, 1));
+      Scalar* Ax = malloc_with_check<Scalar>(std::max(nnz, 1));
+      for (int i = 0; i < nnz; i++)
+        Ap[csc_Ai[i] + 1]++;
+      for (int i = 0; i < size; i++)
+        Ap[i + 1] += Ap[i];
+      int* row_position = malloc_with_check<int>(std::max(size, 1));
+      memcpy(row_position, Ap, size * sizeof(int));
+      for (int col = 0; col < size; col++)
+      {
+        for (int i = csc_Ap[col]; i < csc_Ap[col + 1]; i++)
+        {
+          int position = row_position[csc_Ai[i]]++;
+          Ai[position] = col;
+          Ax[position] = csc_Ax[i];
+        }
+      }
+
+      csr_matrix = new CSRMatrix<Scalar>;
+      csr_matrix->create(size, nnz, Ap, Ai, Ax);
+      free_with_check(row_position);
+      free_with_check(Ap);
+      free_with_check(Ai);
+      free_with_check(Ax);
+
+      own = true;
+      return csr_matrix;
+    }
+
+    template<typename Scalar>
+    void PMultigridSolver<Scalar>::create_level_matrices()
+    {
+      this->free_level_matrices();
+
+      int num_levels = this->levels.size();
+      this->levels[0].matrix = this->get_fine_csr_matrix(this->levels[0].own_matrix);
+
+      // Galerkin products with the (injection) prolongation - submatrices of the finer matrices.
+      for (int level_i = 1; level_i < num_levels; level_i++)
+      {
+        Level& fine_level = this->levels[level_i - 1];
+        Level& level = this->levels[level_i];
+        int* fine_Ap = fine_level.matrix->get_Ap();
+        int* fine_Ai = fine_level.matrix->get_Ai();
+        Scalar* fine_Ax = fine_level.matrix->get_Ax();
+
+        int* fine_to_coarse = malloc_with_check<int>(std::max(fine_level.ndof, 1));
+        for (int i = 0; i < fine_level.ndof; i++)
+          fine_to_coarse[i] = -1;
+        for (int i = 0; i < level.ndof; i++)
+          fine_to_coarse[fine_level.coarse_dofs[i]] = i;
+
+        int* Ap = malloc_with_check<int>(level.ndof + 1);
+        Ap[0] = 0;
+        for (int i = 0; i < level.ndof; i++)
+        {
+          int fine_row = fine_level.coarse_dofs[i];
+          int count = 0;
+          for (int j = fine_Ap[fine_row]; j < fine_Ap[fine_row + 1]; j++)
+            if (fine_to_coarse[fine_Ai[j]] != -1)
+              count++;
+          Ap[i + 1] = Ap[i] + count;
+        }
+
+        int nnz = Ap[level.ndof];
+        int* Ai = malloc_with_check<int>(std::max(nnz, 1));
+        Scalar* Ax = malloc_with_check<Scalar>(std::max(nnz, 1));
+        int num_threads = HermesCommonApi.get_integral_param_value(numThreads);
+#pragma omp parallel num_threads(num_threads)
+        {
+          std::vector<std::pair<int, Scalar> > row;
+#pragma omp for schedule(dynamic, 256)
+          for (int i = 0; i < level.ndof; i++)
+          {
+            int fine_row = fine_level.coarse_dofs[i];
+            row.clear();
+            for (int j = fine_Ap[fine_row]; j < fine_Ap[fine_row + 1]; j++)
+              if (fine_to_coarse[fine_Ai[j]] != -1)
+                row.push_back(std::pair<int, Scalar>(fine_to_coarse[fine_Ai[j]], fine_Ax[j]));
+            std::sort(row.begin(), row.end(), compare_column_entries<Scalar>);
+            for (unsigned int j = 0; j < row.size(); j++)
+            {
+              Ai[Ap[i] + j] = row[j].first;
+              Ax[Ap[i] + j] = row[j].second;
+            }
+          }
+        }
+
+        level.matrix = new CSRMatrix<Scalar>;
+        level.matrix->create(level.ndof, nnz, Ap, Ai, Ax);
+        level.own_matrix = true;
+        free_with_check(fine_to_coarse);
+        free_with_check(Ap);
+        free_with_check(Ai);
+        free_with_check(Ax);
+      }
+
+      // Diagonals and the spectral estimates for the smoothers.
+      for (int level_i = 0; level_i < num_levels - 1; level_i++)
+      {
+        Level& level = this->levels[level_i];
+        int* Ap = level.matrix->get_Ap();
+        int* Ai = level.matrix->get_Ai();
+        Scalar* Ax = level.matrix->get_Ax();
+        level.inv_diag = malloc_with_check<Scalar>(std::max(level.ndof, 1));
+        for (int i = 0; i < level.ndof; i++)
+        {
+          level.inv_diag[i] = 1.0;
+          for (int j = Ap[i]; j < Ap[i + 1]; j++)
+            if (Ai[j] == i && Ax[j] != 0.0)
+              level.inv_diag[i] = 1.0 / Ax[j];
+        }
+        level.lambda_max = this->estimate_lambda_max(level);
+      }
+
+      // The coarsest level through the matrix interface of the direct solver.
+      Level& coarsest_level = this->levels[num_levels - 1];
+      this->levels_ready = true;
+      if (coarsest_level.ndof == 0)
+        return;
+      int* Ap = coarsest_level.matrix->get_Ap();
+      int* Ai = coarsest_level.matrix->get_Ai();
+      Scalar* Ax = coarsest_level.matrix->get_Ax();
+      this->coarse_matrix = create_matrix<Scalar>(true);
+      this->coarse_matrix->prealloc(coarsest_level.ndof);
+      for (int i = 0; i < coarsest_level.ndof; i++)
+        for (int j = Ap[i]; j < Ap[i + 1]; j++)
+          this->coarse_matrix->pre_add_ij(i, Ai[j]);
+      this->coarse_matrix->alloc();
+      for (int i = 0; i < coarsest_level.ndof; i++)
+        for (int j = Ap[i]; j < Ap[i + 1]; j++)
+          this->coarse_matrix->add(i, Ai[j], Ax[j]);
+      this->coarse_matrix->finish();
+      this->coarse_rhs = create_vector<Scalar>(true);
+      this->coarse_rhs->alloc(coarsest_level.ndof);
+      this->coarse_solver = create_linear_solver<Scalar>(this->coarse_matrix, this->coarse_rhs, true);
+      this->coarse_factorized = false;
+    }
+
+    template<typename Scalar>
+    double PMultigridSolver<Scalar>::estimate_lambda_max(Level& level)
+    {
+      // A few power iterations for D^{-1}A, from a fixed (pseudo-random) vector so that the result is reproducible.
+      const int power_iterations = 10;
+      Scalar* v = level.r;
+      Scalar* w = level.d;
+      for (int i = 0; i < level.ndof; i++)
+        v[i] = 1.0 + 0.5 * std::sin(1.0 + i);
+
+      double lambda = 0.;
+      for (int iteration = 0; iteration < power_iterations; iteration++)
+      {
+        double v_norm = get_l2_norm(v, level.ndof);
+        if (v_norm == 0.)
+          break;
+        this->multiply(level.matrix, v, w);
+        for (int i = 0; i < level.ndof; i++)
+          w[i] *= level.inv_diag[i];
+        lambda = get_l2_norm(w, level.ndof) / v_norm;
+        std::swap(v, w);
+      }
+      return lambda;
+    }
+
+    template<typename Scalar>
+    void PMultigridSolver<Scalar>::free_level_matrices()
+    {
+      for (unsigned int level_i = 0; level_i < this->levels.size(); level_i++)
+      {
+        Level& level = this->levels[level_i];
+        if (level.own_matrix)
+          delete level.matrix;
+        level.matrix = nullptr;
+        level.own_matrix = false;
+        free_with_check(level.inv_diag);
+      }
+
+      if (this->coarse_solver)
+      {
+        delete this->coarse_solver;
+        this->coarse_solver = nullptr;
+      }
+      if (this->coarse_matrix)
+      {
+        delete this->coarse_matrix;
+        this->coarse_matrix = nullptr;
+      }
+      if (this->coarse_rhs)
+      {
+        delete this->coarse_rhs;
+        this->coarse_rhs = nullptr;
+      }
+
+      this->levels_ready = false;
+    }
+
+    template<typename Scalar>
+    void PMultigridSolver<Scalar>::free_levels()
+    {
+      this->free_level_matrices();
+      for (unsigned int level_i = 0; level_i < this->levels.size(); level_i++)
+      {
+        Level& level = this->levels[level_i];
+        free_with_check(level.coarse_dofs);
+        free_with_check(level.x);
+        free_with_check(level.b);
+        free_with_check(level.r);
+        free_with_check(level.d);
+      }
+      this->levels.clear();
+      this->spaces_seq.clear();
+    }
+
+    template<typename Scalar>
+    void PMultigridSolver<Scalar>::setup()
+    {
+      if (this->spaces.empty())
+        throw Exceptions::Exception("PMultigridSolver needs the spaces, see set_spaces().");
+
+      bool spaces_changed = this->spaces_seq.size() != this->spaces.size();
+      for (unsigned int space_i = 0; !spaces_changed && space_i < this->spaces.size(); space_i++)
+        spaces_changed = this->spaces_seq[space_i] != this->spaces[space_i]->get_seq();
+      if (spaces_changed)
+        this->create_levels();
+
+      if (this->levels[0].ndof != this->get_matrix_size())
+        throw Exceptions::ValueException("matrix size", this->get_matrix_size(), this->levels[0].ndof);
+
+      this->create_level_matrices();
+    }
+
+    template<typename Scalar>
+    void PMultigridSolver<Scalar>::multiply(CSRMatrix<Scalar>* matrix, const Scalar* x, Scalar* y) const
+    {
+      int size = matrix->get_size();
+      int* Ap = matrix->get_Ap();
+      int* Ai = matrix->get_Ai();
+      Scalar* Ax = matrix->get_Ax();
+      int num_threads = HermesCommonApi.get_integral_param_value(numThreads);
+#pragma omp parallel for num_threads(num_threads) schedule(static) if (size > 4096)
+      for (int i = 0; i < size; i++)
+      {
+        Scalar sum = 0.;
+        for (int j = Ap[i]; j < Ap[i + 1]; j++)
+          sum += Ax[j] * x[Ai[j]];
+        y[i] = sum;
+      }
+    }
+
+    template<typename Scalar>
+    void PMultigridSolver<Scalar>::residual(CSRMatrix<Scalar>* matrix, const Scalar* x, const Scalar* b, Scalar* r) const
+    {
+      int size = matrix->get_size();
+      int* Ap = matrix->get_Ap();
+      int* Ai = matrix->get_Ai();
+      Scalar* Ax = matrix->get_Ax();
+      int num_threads = HermesCommonApi.get_integral_param_value(numThreads);
+#pragma omp parallel for num_threads(num_threads) schedule(static) if (size > 4096)
+      for (int i = 0; i < size; i++)
+      {
+        Scalar sum = b[i];
+        for (int j = Ap[i]; j < Ap[i + 1]; j++)
+          sum -= Ax[j] * x[Ai[j]];
+        r[i] = sum;
+      }
+    }
+
+    template<typename Scalar>
+    void PMultigridSolver<Scalar>::smooth(int level_i)
+    {
+      Level& level = this->levels[level_i];
+      int size = level.ndof;
+
+      // A level without DOFs (or with a zero matrix) has lambda_max = 0, there is nothing to smooth.
+      if (size == 0 || level.lambda_max <= 0.)
+        return;
+
+      if (this->smoother == PMultigridJacobi)
+      {
+        double omega = 4. / (3. * level.lambda_max);
+        for (int sweep = 0; sweep < this->sweeps; sweep++)
+        {
+          this->residual(level.matrix, level.x, level.b, level.r);
+          for (int i = 0; i < size; i++)
+            level.x[i] += omega * level.inv_diag[i] * level.r[i];
+        }
+      }
+      else
+      {
+        // Chebyshev iteration for D^{-1}A with the spectrum bounded by [lower, upper] (Saad, Iterative methods for sparse linear systems, Alg. 12.1).
+        double upper = 1.1 * level.lambda_max, lower = 0.1 * level.lambda_max;
+        double theta = (upper + lower) / 2., delta = (upper - lower) / 2.;
+        double sigma = theta / delta, rho = 1. / sigma;
+
+        this->residual(level.matrix, level.x, level.b, level.r);
+        for (int i = 0; i < size; i++)
+          level.d[i] = level.inv_diag[i] * level.r[i] / theta;
+
+        for (int degree = 0; degree < this->sweeps; degree++)
+        {
+          for (int i = 0; i < size; i++)
+            level.x[i] += level.d[i];
+          if (degree == this->sweeps - 1)
+            break;
+          this->residual(level.matrix, level.x, level.b, level.r);
+          double rho_new = 1. / (2. * sigma - rho);
+          for (int i = 0; i < size; i++)
+            level.d[i] = rho_new * rho * level.d[i] + 2. * rho_new / delta * level.inv_diag[i] * level.r[i];
+          rho = rho_new;
+        }
+      }
+    }
+
+    template<typename Scalar>
+    void PMultigridSolver<Scalar>::coarse_solve()
+    {
+      Level& level = this->levels.back();
+      if (level.ndof == 0)
+        return;
+      this->coarse_rhs->set_vector(level.b);
+      this->coarse_solver->set_reuse_scheme(this->coarse_factorized ? HERMES_REUSE_MATRIX_STRUCTURE_COMPLETELY : HERMES_CREATE_STRUCTURE_FROM_SCRATCH);
+      this->coarse_solver->solve();
+      this->coarse_factorized = true;
+      memcpy(level.x, this->coarse_solver->get_sln_vector(), level.ndof * sizeof(Scalar));
+    }
+
+    template<typename Scalar>
+    void PMultigridSolver<Scalar>::v_cycle(int level_i)
+    {
+      if (level_i == (int)this->levels.size() - 1)
+      {
+        this->coarse_solve();
+        return;
+      }
+
+      Level& level = this->levels[level_i];
+      Level& coarse_level = this->levels[level_i + 1];
+
+      this->smooth(level_i);
+
+      // Restriction of the residual - truncation of the hierarchic coefficients.
+      this->residual(level.matrix, level.x, level.b, level.r);
+      for (int i = 0; i < coarse_level.ndof; i++)
+      {
+        coarse_level.b[i] = level.r[level.coarse_dofs[i]];
+        coarse_level.x[i] = 0.;
+      }
+
+      this->v_cycle(level_i + 1);
+
+      // Prolongation of the correction - extension by zeros.
+      for (int i = 0; i < coarse_level.ndof; i++)
+        level.x[level.coarse_dofs[i]] += coarse_level.x[i];
+
+      this->smooth(level_i);
+    }
+
+    template<typename Scalar>
+    void PMultigridSolver<Scalar>::apply(const Scalar* r, Scalar* z)
+    {
+      if (!this->levels_ready)
+        throw Exceptions::Exception("PMultigridSolver::apply() called before setup().");
+
+      Level& level = this->levels[0];
+      memcpy(level.b, r, level.ndof * sizeof(Scalar));
+      memset(level.x, 0, level.ndof * sizeof(Scalar));
+      this->v_cycle(0);
+      memcpy(z, level.x, level.ndof * sizeof(Scalar));
+    }
+
+    template<typename Scalar>
+    void PMultigridSolver<Scalar>::solve()
+    {
+      this->solve(nullptr);
+    }
+
+    template<typename Scalar>
+    void PMultigridSolver<Scalar>::solve(Scalar* initial_guess)
+    {
+      this->tick();
+
+      if (!this->levels_ready || this->reuse_scheme != HERMES_REUSE_MATRIX_STRUCTURE_COMPLETELY || this->levels[0].ndof != this->get_matrix_size())
+        this->setup();
+      else
+      {
+        // The spaces may have changed in the meantime.
+        for (unsigned int space_i = 0; space_i < this->spaces.size(); space_i++)
+          if (this->spaces_seq[space_i] != this->spaces[space_i]->get_seq())
+          {
+            this->setup();
+            break;
+          }
+      }
+
+      int size = this->get_matrix_size();
+      free_with_check(this->sln);
+      this->sln = malloc_with_check<Scalar>(std::max(size, 1));
+      if (initial_guess)
+        memcpy(this->sln, initial_guess, size * sizeof(Scalar));
+      else
+        memset(this->sln, 0, size * sizeof(Scalar));
+
+      Scalar* rhs = malloc_with_check<Scalar>(std::max(size, 1));
+      this->general_rhs->extract(rhs);
+
+      if (this->krylov_acceleration)
+        this->solve_pcg(rhs);
+      else
+        this->solve_v_cycles(rhs);
+
+      free_with_check(rhs);
+
+      this->tick();
+      this->time = this->accumulated();
+    }
+
+    template<typename Scalar>
+    void PMultigridSolver<Scalar>::solve_v_cycles(const Scalar* rhs)
+    {
+      Level& level = this->levels[0];
+      int size = level.ndof;
+      double rhs_norm = get_l2_norm(const_cast<Scalar*>(rhs), size);
+
+      memcpy(level.b, rhs, size * sizeof(Scalar));
+      memcpy(level.x, this->sln, size * sizeof(Scalar));
+
+      this->num_iters = 0;
+      while (true)
+      {
+        this->residual(level.matrix, level.x, level.b, level.r);
+        this->residual_norm = get_l2_norm(level.r, size);
+        if (this->residual_norm <= this->tolerance * (this->toleranceType == AbsoluteTolerance ? 1. : rhs_norm) || this->num_iters >= this->max_iters)
+          break;
+        this->v_cycle(0);
+        this->num_iters++;
+      }
+
+      memcpy(this->sln, level.x, size * sizeof(Scalar));
+      if (this->residual_norm > this->tolerance * (this->toleranceType == AbsoluteTolerance ? 1. : rhs_norm))
+        this->warn("PMultigridSolver: no convergence in %i V-cycles, residual norm %g.", this->num_iters, this->residual_norm);
+    }
+
+    template<typename Scalar>
+    void PMultigridSolver<Scalar>::solve_pcg(const Scalar* rhs)
+    {
+      Level& level = this->levels[0];
+      int size = level.ndof;
+      double rhs_norm = get_l2_norm(const_cast<Scalar*>(rhs), size);
+      double target_norm = this->tolerance * (this->toleranceType == AbsoluteTolerance ? 1. : rhs_norm);
+
+      Scalar* x = this->sln;
+      Scalar* r = malloc_with_check<Scalar>(std::max(size, 1));
+      Scalar* z = malloc_with_check<Scalar>(std::max(size, 1));
+      Scalar* p = malloc_with_check<Scalar>(std::max(size, 1));
+      Scalar* q = malloc_with_check<Scalar>(std::max(size, 1));
+
+      this->residual(level.matrix, x, rhs, r);
+      this->residual_norm = get_l2_norm(r, size);
+      this->num_iters = 0;
+      if (this->residual_norm > target_norm)
+      {
+        this->apply(r, z);
+        memcpy(p, z, size * sizeof(Scalar));
+        Scalar rz = 0.;
+        for (int i = 0; i < size; i++)
+          rz += conj(r[i]) * z[i];
+
+        while (this->num_iters < this->max_iters)
+        {
+          this->multiply(level.matrix, p, q);
+          Scalar pq = 0.;
+          for (int i = 0; i < size; i++)
+            pq += conj(p[i]) * q[i];
+          Scalar alpha = rz / pq;
+          for (int i = 0; i < size; i++)
+          {
+            x[i] += alpha * p[i];
+            r[i] -= alpha * q[i];
+          }
+          this->num_iters++;
+
+          this->residual_norm = get_l2_norm(r, size);
+          if (this->residual_norm <= target_norm)
+            break;
+
+          this->apply(r, z);
+          Scalar rz_new = 0.;
+          for (int i = 0; i < size; i++)
+            rz_new += conj(r[i]) * z[i];
+          Scalar beta = rz_new / rz;
+          rz = rz_new;
+          for (int i = 0; i < size; i++)
+            p[i] = z[i] + beta * p[i];
+        }
+      }
+
+      free_with_check(r);
+      free_with_check(z);
+      free_with_check(p);
+      free_with_check(q);
+
+      if (this->residual_norm > target_norm)
+        this->warn("PMultigridSolver: no convergence in %i CG iterations, residual norm %g.", this->num_iters, this->residual_norm);
+    }
+
+    template HERMES_API class PMultigridSolver < double > ;
+    template HERMES_API class PMultigridSolver < std::complex<double> > ;
+  }
+}
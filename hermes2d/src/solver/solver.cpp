@@ -21,6 +21,7 @@
 */
 #include "solver/solver.h"
 #include "projections/ogprojection.h"
+#include "solver/pmultigrid_solver.h"
 
 using namespace Hermes::Algebra;
 using namespace Hermes::Solvers;
@@ -68,6 +69,14 @@ namespace Hermes
       }
     }
 
+    template<typename Scalar>
+    void Solver<Scalar>::set_linear_matrix_solver_spaces(LinearMatrixSolver<Scalar>* linear_matrix_solver)
+    {
+      PMultigridSolver<Scalar>* pmultigrid_solver = dynamic_cast<PMultigridSolver<Scalar>*>(linear_matrix_solver);
+      if (pmultigrid_solver)
+        pmultigrid_solver->set_spaces(this->dp->get_spaces());
+    }
+
     template<typename Scalar>
     void Solver<Scalar>::solve()
     {
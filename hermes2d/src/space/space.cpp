@@ -80,6 +80,7 @@ namespace Hermes
     }
 
     unsigned g_space_seq = 0;
+    unsigned g_space_dof_assignment_stamp = 0;
 
     template<typename Scalar>
     void Space<Scalar>::init()
@@ -90,10 +91,13 @@ namespace Hermes
       this->mesh_seq = -1;
       this->seq = g_space_seq++;
       this->seq_assigned = -1;
+      this->dof_assignment_stamp = g_space_dof_assignment_stamp++;
       this->ndof = 0;
       this->proj_mat = nullptr;
       this->chol_p = nullptr;
       this->vertex_functions_count = this->edge_functions_count = this->bubble_functions_count = 0;
+      this->asmlist_caching = false;
+      this->asmlist_cache_valid = false;
 
       if (essential_bcs != nullptr)
       {
@@ -109,6 +113,7 @@ namespace Hermes
     void Space<Scalar>::free()
     {
       free_bc_data();
+      free_assembly_list_cache();
       if (nsize)
       {
         free_with_check(ndata, true);
@@ -842,6 +847,12 @@ namespace Hermes
       return seq;
     }
 
+    template<typename Scalar>
+    unsigned int Space<Scalar>::get_dof_assignment_stamp() const
+    {
+      return this->dof_assignment_stamp;
+    }
+
     template<typename Scalar>
     void Space<Scalar>::distribute_orders(MeshSharedPtr mesh, int* parents)
     {
@@ -883,6 +894,13 @@ namespace Hermes
 
       resize_tables();
 
+      // The DOFs, the constraints and the Dirichlet coefficients change without a change of seq.
+      this->asmlist_cache_valid = false;
+      // The numbering itself only changes with the orders, the mesh, the first DOF (and the essential BCs, see set_essential_bcs()),
+      // so that repeated calls (every LinearSolver::solve()) keep the caches keyed on the stamp.
+      if (seq_assigned != this->seq || this->mesh_seq != this->mesh->get_seq() || this->first_dof != first_dof)
+        this->dof_assignment_stamp = g_space_dof_assignment_stamp++;
+
       this->first_dof = next_dof = first_dof;
 
       reset_dof_assignment();
@@ -909,8 +927,10 @@ namespace Hermes
       // First assume that all vertex nodes are part of a natural BC. the member NodeData::n
       // is misused for this purpose, since it stores nothing at this point. Also assume
       // that all DOFs are unassigned.
-      int i, j;
-      for (i = 0; i < mesh->get_max_node_id(); i++)
+      int max_node_id = mesh->get_max_node_id();
+      int num_threads = HermesCommonApi.get_integral_param_value(numThreads);
+#pragma omp parallel for num_threads(num_threads) schedule(static)
+      for (int i = 0; i < max_node_id; i++)
       {
         // Natural boundary condition. The point is that it is not (0 == Dirichlet).
         ndata[i].n = 1;
@@ -928,7 +948,7 @@ namespace Hermes
             if (essential_bcs != nullptr)
               if (essential_bcs->get_boundary_condition(mesh->boundary_markers_conversion.get_user_marker(e->en[i]->marker).marker) != nullptr)
               {
-            j = e->next_vert(i);
+            int j = e->next_vert(i);
             ndata[e->vn[i]->id].n = 0;
             ndata[e->vn[j]->id].n = 0;
               }
@@ -936,6 +956,112 @@ namespace Hermes
       }
     }
 
+    template<typename Scalar>
+    int Space<Scalar>::get_dof_assignment_chunk_count(int num_items) const
+    {
+      // Small problems are not worth the overhead.
+      if (num_items < 1024)
+        return 1;
+      int num_threads = HermesCommonApi.get_integral_param_value(numThreads);
+      return std::max(1, std::min(std::min(num_threads, (int)H2D_MAX_DOF_ASSIGNMENT_CHUNKS), num_items));
+    }
+
+    template<typename Scalar>
+    int Space<Scalar>::prefix_sum_dof_assignment_chunks(int* chunk_dofs, int num_chunks)
+    {
+      int first_dof_of_chunks = this->next_dof;
+      for (int c = 0; c < num_chunks; c++)
+      {
+        int count = chunk_dofs[c];
+        chunk_dofs[c] = this->next_dof;
+        this->next_dof += count;
+      }
+      return this->next_dof - first_dof_of_chunks;
+    }
+
+    template<typename Scalar>
+    void Space<Scalar>::assign_bubble_dofs()
+    {
+      MeshCompactView* view = this->mesh->get_compact_view();
+      int num_chunks = this->get_dof_assignment_chunk_count(view->num_active);
+      int chunk_dofs[H2D_MAX_DOF_ASSIGNMENT_CHUNKS];
+
+      // Count & number the bubble functions within the chunks.
+#pragma omp parallel for num_threads(num_chunks) schedule(static, 1)
+      for (int c = 0; c < num_chunks; c++)
+      {
+        chunk_dofs[c] = 0;
+        for (int i = (int)((long long)view->num_active * c / num_chunks); i < (int)((long long)view->num_active * (c + 1) / num_chunks); i++)
+        {
+          Element* e = this->mesh->get_element_fast(view->active_ids[i]);
+          ElementData* ed = &this->edata[e->id];
+          ed->bdof = chunk_dofs[c];
+          ed->n = this->shapeset->get_num_bubbles(ed->order, e->get_mode());
+          chunk_dofs[c] += ed->n;
+        }
+      }
+
+      this->bubble_functions_count = this->prefix_sum_dof_assignment_chunks(chunk_dofs, num_chunks);
+
+#pragma omp parallel for num_threads(num_chunks) schedule(static, 1)
+      for (int c = 0; c < num_chunks; c++)
+      {
+        for (int i = (int)((long long)view->num_active * c / num_chunks); i < (int)((long long)view->num_active * (c + 1) / num_chunks); i++)
+          this->edata[view->active_ids[i]].bdof += chunk_dofs[c];
+      }
+    }
+
+    template<typename Scalar>
+    void Space<Scalar>::assign_edge_dofs_by_node_ids(int order_increment)
+    {
+      int max_node_id = this->mesh->get_max_node_id();
+      int num_chunks = this->get_dof_assignment_chunk_count(max_node_id);
+      int chunk_dofs[H2D_MAX_DOF_ASSIGNMENT_CHUNKS];
+
+      // Count & number the edge functions within the chunks.
+#pragma omp parallel for num_threads(num_chunks) schedule(static, 1)
+      for (int c = 0; c < num_chunks; c++)
+      {
+        chunk_dofs[c] = 0;
+        for (int id = (int)((long long)max_node_id * c / num_chunks); id < (int)((long long)max_node_id * (c + 1) / num_chunks); id++)
+        {
+          Node* en = this->mesh->get_node(id);
+          if (!en->used || !en->type)
+            continue;
+
+          NodeData* nd = &this->ndata[id];
+          if (en->ref > 1 || en->bnd || this->mesh->peek_vertex_node(en->p1, en->p2) != nullptr)
+          {
+            int ndofs = this->get_edge_order_internal(en) + order_increment;
+            nd->n = ndofs;
+            if (en->bnd && this->essential_bcs != nullptr && this->essential_bcs->get_boundary_condition(this->mesh->boundary_markers_conversion.get_user_marker(en->marker).marker) != nullptr)
+              nd->dof = H2D_CONSTRAINED_DOF;
+            else
+            {
+              nd->dof = chunk_dofs[c];
+              chunk_dofs[c] += ndofs;
+            }
+          }
+          else
+            nd->n = -1;
+        }
+      }
+
+      this->edge_functions_count = this->prefix_sum_dof_assignment_chunks(chunk_dofs, num_chunks);
+
+      // All edge nodes have been (re)numbered above, the non-negative DOFs are the ones local to the chunks.
+#pragma omp parallel for num_threads(num_chunks) schedule(static, 1)
+      for (int c = 0; c < num_chunks; c++)
+      {
+        for (int id = (int)((long long)max_node_id * c / num_chunks); id < (int)((long long)max_node_id * (c + 1) / num_chunks); id++)
+        {
+          Node* en = this->mesh->get_node(id);
+          if (en->used && en->type && this->ndata[id].n >= 0 && this->ndata[id].dof >= 0)
+            this->ndata[id].dof += chunk_dofs[c];
+        }
+      }
+    }
+
     template<typename Scalar>
     int Space<Scalar>::get_vertex_functions_count()
     {
@@ -965,6 +1091,9 @@ namespace Hermes
         throw Hermes::Exceptions::Exception("The space in get_element_assembly_list() is out of date. You need to update it with assign_dofs()"
         " any time the mesh changes.");
 
+      if (this->get_cached_element_assembly_list(e, al))
+        return;
+
       // add vertex, edge and bubble functions to the assembly list
       al->cnt = 0;
       for (unsigned char i = 0; i < e->get_nvert(); i++)
@@ -997,10 +1126,127 @@ namespace Hermes
         al->add_triplet(*indices, dof, 1.0);
     }
 
+    template<typename Scalar>
+    void Space<Scalar>::set_assembly_list_caching(bool to_set)
+    {
+      this->asmlist_caching = to_set;
+      if (!to_set)
+        this->free_assembly_list_cache();
+    }
+
+    template<typename Scalar>
+    void Space<Scalar>::free_assembly_list_cache()
+    {
+      this->asmlist_cache_valid = false;
+      this->asmlist_cache_offsets.clear();
+      this->asmlist_cache_cnt.clear();
+      this->asmlist_cache_idx.clear();
+      this->asmlist_cache_dof.clear();
+      this->asmlist_cache_coef.clear();
+    }
+
+    template<typename Scalar>
+    void Space<Scalar>::update_assembly_list_cache()
+    {
+      if (!this->asmlist_caching)
+        return;
+      if (this->asmlist_cache_valid && this->asmlist_cache_seq == this->seq && this->asmlist_cache_mesh_seq == this->mesh->get_seq())
+        return;
+
+      // The lists are collected by get_element_assembly_list() - not from the cache.
+      this->free_assembly_list_cache();
+
+      MeshCompactView* view = this->mesh->get_compact_view();
+      int num_chunks = this->get_dof_assignment_chunk_count(view->num_active);
+      int chunk_first_triplet[H2D_MAX_DOF_ASSIGNMENT_CHUNKS];
+      std::vector<std::vector<int> > chunk_idx(num_chunks), chunk_dof(num_chunks);
+      std::vector<std::vector<Scalar> > chunk_coef(num_chunks);
+
+      this->asmlist_cache_offsets.resize(this->mesh->get_max_element_id(), 0);
+      this->asmlist_cache_cnt.resize(this->mesh->get_max_element_id(), 0);
+
+      std::string exceptionMessageCaughtInParallelBlock;
+
+      // Collect the lists of the chunks, offsets within the chunks.
+#pragma omp parallel for num_threads(num_chunks) schedule(static, 1)
+      for (int c = 0; c < num_chunks; c++)
+      {
+        try
+        {
+          AsmList<Scalar> al;
+          for (int i = (int)((long long)view->num_active * c / num_chunks); i < (int)((long long)view->num_active * (c + 1) / num_chunks); i++)
+          {
+            Element* e = this->mesh->get_element_fast(view->active_ids[i]);
+            this->get_element_assembly_list(e, &al);
+            this->asmlist_cache_offsets[e->id] = chunk_idx[c].size();
+            this->asmlist_cache_cnt[e->id] = al.cnt;
+            chunk_idx[c].insert(chunk_idx[c].end(), al.idx, al.idx + al.cnt);
+            chunk_dof[c].insert(chunk_dof[c].end(), al.dof, al.dof + al.cnt);
+            chunk_coef[c].insert(chunk_coef[c].end(), al.coef, al.coef + al.cnt);
+          }
+        }
+        catch (std::exception& exception)
+        {
+#pragma omp critical (exceptionMessageCaughtInParallelBlock)
+          exceptionMessageCaughtInParallelBlock = exception.what();
+        }
+      }
+
+      if (!exceptionMessageCaughtInParallelBlock.empty())
+      {
+        this->free_assembly_list_cache();
+        throw Hermes::Exceptions::Exception(exceptionMessageCaughtInParallelBlock.c_str());
+      }
+
+      // First triplets of the chunks in the flat arrays.
+      int num_triplets = 0;
+      for (int c = 0; c < num_chunks; c++)
+      {
+        chunk_first_triplet[c] = num_triplets;
+        num_triplets += chunk_idx[c].size();
+      }
+
+      this->asmlist_cache_idx.resize(num_triplets);
+      this->asmlist_cache_dof.resize(num_triplets);
+      this->asmlist_cache_coef.resize(num_triplets);
+
+      // Concatenate the chunks, shift the offsets.
+#pragma omp parallel for num_threads(num_chunks) schedule(static, 1)
+      for (int c = 0; c < num_chunks; c++)
+      {
+        std::copy(chunk_idx[c].begin(), chunk_idx[c].end(), this->asmlist_cache_idx.begin() + chunk_first_triplet[c]);
+        std::copy(chunk_dof[c].begin(), chunk_dof[c].end(), this->asmlist_cache_dof.begin() + chunk_first_triplet[c]);
+        std::copy(chunk_coef[c].begin(), chunk_coef[c].end(), this->asmlist_cache_coef.begin() + chunk_first_triplet[c]);
+        for (int i = (int)((long long)view->num_active * c / num_chunks); i < (int)((long long)view->num_active * (c + 1) / num_chunks); i++)
+          this->asmlist_cache_offsets[view->active_ids[i]] += chunk_first_triplet[c];
+      }
+
+      this->asmlist_cache_seq = this->seq;
+      this->asmlist_cache_mesh_seq = this->mesh->get_seq();
+      this->asmlist_cache_valid = true;
+    }
+
+    template<typename Scalar>
+    bool Space<Scalar>::get_cached_element_assembly_list(Element* e, AsmList<Scalar>* al) const
+    {
+      if (!this->asmlist_cache_valid || this->asmlist_cache_seq != this->seq || this->asmlist_cache_mesh_seq != this->mesh->get_seq())
+        return false;
+      if (e->id >= (int)this->asmlist_cache_cnt.size() || !this->asmlist_cache_cnt[e->id])
+        return false;
+
+      int offset = this->asmlist_cache_offsets[e->id];
+      al->cnt = this->asmlist_cache_cnt[e->id];
+      memcpy(al->idx, &this->asmlist_cache_idx[offset], al->cnt * sizeof(int));
+      memcpy(al->dof, &this->asmlist_cache_dof[offset], al->cnt * sizeof(int));
+      memcpy(al->coef, &this->asmlist_cache_coef[offset], al->cnt * sizeof(Scalar));
+      return true;
+    }
+
     template<typename Scalar>
     void Space<Scalar>::set_essential_bcs(EssentialBCs<Scalar>* essential_bcs)
     {
       this->essential_bcs = essential_bcs;
+      this->dof_assignment_stamp = g_space_dof_assignment_stamp++;
     }
 
     template<typename Scalar>
@@ -1067,6 +1313,9 @@ namespace Hermes
     template<typename Scalar>
     void Space<Scalar>::update_essential_bc_values()
     {
+      // The Dirichlet coefficients in the assembly lists change.
+      this->asmlist_cache_valid = false;
+
       Element* e;
       for_all_active_elements(e, mesh)
       {
@@ -109,18 +109,27 @@ namespace Hermes
       // all elements in the mesh.
 
       // Vertex dofs.
-      Element* e;
-      this->vertex_functions_count = 0;
-      for_all_active_elements(e, this->mesh)
+      MeshCompactView* view = this->mesh->get_compact_view();
+      int num_chunks = this->get_dof_assignment_chunk_count(view->num_active);
+      int chunk_dofs[Space<Scalar>::H2D_MAX_DOF_ASSIGNMENT_CHUNKS];
+      std::vector<int> chunk_nodes[Space<Scalar>::H2D_MAX_DOF_ASSIGNMENT_CHUNKS];
+      unsigned long long* chunk_masks = this->get_node_chunk_masks(view, num_chunks, true);
+
+      // Count & number the vertex functions within the chunks.
+#pragma omp parallel for num_threads(num_chunks) schedule(static, 1)
+      for (int c = 0; c < num_chunks; c++)
       {
-        int order = this->get_element_order(e->id);
-        if (order > 0)
+        chunk_dofs[c] = 0;
+        for (int i = (int)((long long)view->num_active * c / num_chunks); i < (int)((long long)view->num_active * (c + 1) / num_chunks); i++)
         {
-          for (unsigned char i = 0; i < e->get_nvert(); i++)
+          if (this->get_element_order(view->active_ids[i]) <= 0)
+            continue;
+          for (unsigned char j = 0; j < view->nvert[i]; j++)
           {
-            Node* vn = e->vn[i];
-            typename Space<Scalar>::NodeData* nd = this->ndata + vn->id;
-            if (!vn->is_constrained_vertex() && nd->dof == this->H2D_UNASSIGNED_DOF)
+            int node_id = view->vertex_ids[i * H2D_MAX_NUMBER_VERTICES + j];
+            typename Space<Scalar>::NodeData* nd = this->ndata + node_id;
+            // Nodes of other chunks are not touched (constrained vertices have an empty mask).
+            if (chunk_masks[node_id] && get_first_chunk(chunk_masks[node_id]) == c && nd->dof == this->H2D_UNASSIGNED_DOF)
             {
               if (nd->n == 0)
               {
@@ -128,87 +137,112 @@ namespace Hermes
               }
               else
               {
-                nd->dof = this->next_dof;
-                this->next_dof++;
-                this->vertex_functions_count++;
+                nd->dof = chunk_dofs[c]++;
+                chunk_nodes[c].push_back(node_id);
               }
               nd->n = 1;
             }
           }
         }
       }
+      free_with_check(chunk_masks);
+
+      this->vertex_functions_count = this->prefix_sum_dof_assignment_chunks(chunk_dofs, num_chunks);
+
+#pragma omp parallel for num_threads(num_chunks) schedule(static, 1)
+      for (int c = 0; c < num_chunks; c++)
+      {
+        for (unsigned int i = 0; i < chunk_nodes[c].size(); i++)
+          this->ndata[chunk_nodes[c][i]].dof += chunk_dofs[c];
+      }
     }
 
     template<typename Scalar>
     void H1Space<Scalar>::assign_edge_dofs()
     {
       // Edge dofs.
-      Element* e;
-      this->edge_functions_count = 0;
-      for_all_active_elements(e, this->mesh)
+      MeshCompactView* view = this->mesh->get_compact_view();
+      int num_chunks = this->get_dof_assignment_chunk_count(view->num_active);
+      int chunk_dofs[Space<Scalar>::H2D_MAX_DOF_ASSIGNMENT_CHUNKS];
+      std::vector<int> chunk_nodes[Space<Scalar>::H2D_MAX_DOF_ASSIGNMENT_CHUNKS];
+      unsigned long long* chunk_masks = this->get_node_chunk_masks(view, num_chunks, false);
+
+      // Count & number the edge functions within the chunks.
+#pragma omp parallel for num_threads(num_chunks) schedule(static, 1)
+      for (int c = 0; c < num_chunks; c++)
       {
-        int order = this->get_element_order(e->id);
-        if (order > 0)
+        chunk_dofs[c] = 0;
+        for (int i = (int)((long long)view->num_active * c / num_chunks); i < (int)((long long)view->num_active * (c + 1) / num_chunks); i++)
         {
-          for (unsigned char i = 0; i < e->get_nvert(); i++)
+          if (this->get_element_order(view->active_ids[i]) <= 0)
+            continue;
+          for (unsigned char j = 0; j < view->nvert[i]; j++)
           {
-            Node* vn = e->vn[i];
-            typename Space<Scalar>::NodeData* nd = this->ndata + vn->id;
-            Node* en = e->en[i];
-            nd = this->ndata + en->id;
-            if (nd->dof == this->H2D_UNASSIGNED_DOF)
+            int node_id = view->edge_ids[i * H2D_MAX_NUMBER_VERTICES + j];
+            typename Space<Scalar>::NodeData* nd = this->ndata + node_id;
+            if (get_first_chunk(chunk_masks[node_id]) != c || nd->dof != this->H2D_UNASSIGNED_DOF)
+              continue;
+
+            Node* en = this->mesh->get_node(node_id);
+            // If the edge node is not constrained, assign it dofs.
+            if (en->ref > 1 || en->bnd || this->mesh->peek_vertex_node(en->p1, en->p2) != nullptr)
             {
-              // If the edge node is not constrained, assign it dofs.
-              if (en->ref > 1 || en->bnd || this->mesh->peek_vertex_node(en->p1, en->p2) != nullptr)
+              int ndofs = this->get_edge_order_internal(en) - 1;
+              nd->n = ndofs;
+
+              if (en->bnd && this->essential_bcs != nullptr && this->essential_bcs->get_boundary_condition(this->mesh->boundary_markers_conversion.get_user_marker(en->marker).marker) != nullptr)
+                nd->dof = this->H2D_CONSTRAINED_DOF;
+              else
               {
-                int ndofs = this->get_edge_order_internal(en) - 1;
-                nd->n = ndofs;
-
-                if (en->bnd)
-                  if (this->essential_bcs != nullptr)
-                    if (this->essential_bcs->get_boundary_condition(this->mesh->boundary_markers_conversion.get_user_marker(e->en[i]->marker).marker) != nullptr)
-                      nd->dof = this->H2D_CONSTRAINED_DOF;
-                    else
-                    {
-                      nd->dof = this->next_dof;
-                      this->next_dof += ndofs;
-                      this->edge_functions_count += ndofs;
-                    }
-                  else
-                  {
-                    nd->dof = this->next_dof;
-                    this->next_dof += ndofs;
-                    this->edge_functions_count += ndofs;
-                  }
-                else
-                {
-                  nd->dof = this->next_dof;
-                  this->next_dof += ndofs;
-                  this->edge_functions_count += ndofs;
-                }
+                nd->dof = chunk_dofs[c];
+                chunk_dofs[c] += ndofs;
+                chunk_nodes[c].push_back(node_id);
               }
-              else // Constrained edge node.
-                nd->n = -1;
             }
+            else // Constrained edge node.
+              nd->n = -1;
           }
         }
       }
+      free_with_check(chunk_masks);
+
+      this->edge_functions_count = this->prefix_sum_dof_assignment_chunks(chunk_dofs, num_chunks);
+
+#pragma omp parallel for num_threads(num_chunks) schedule(static, 1)
+      for (int c = 0; c < num_chunks; c++)
+      {
+        for (unsigned int i = 0; i < chunk_nodes[c].size(); i++)
+          this->ndata[chunk_nodes[c][i]].dof += chunk_dofs[c];
+      }
     }
 
     template<typename Scalar>
-    void H1Space<Scalar>::assign_bubble_dofs()
+    unsigned long long* H1Space<Scalar>::get_node_chunk_masks(MeshCompactView* view, int num_chunks, bool vertices)
     {
-      // Bubble dofs.
-      Element* e;
-      this->bubble_functions_count = 0;
-      for_all_active_elements(e, this->mesh)
+      unsigned long long* chunk_masks = calloc_with_check<unsigned long long>(this->mesh->get_max_node_id());
+      int* node_ids = vertices ? view->vertex_ids : view->edge_ids;
+
+#pragma omp parallel for num_threads(num_chunks) schedule(static, 1)
+      for (int c = 0; c < num_chunks; c++)
       {
-        typename Space<Scalar>::ElementData* ed = &this->edata[e->id];
-        ed->bdof = this->next_dof;
-        ed->n = this->shapeset->get_num_bubbles(ed->order, e->get_mode());
-        this->next_dof += ed->n;
-        this->bubble_functions_count += ed->n;
+        unsigned long long chunk_bit = 1ULL << c;
+        for (int i = (int)((long long)view->num_active * c / num_chunks); i < (int)((long long)view->num_active * (c + 1) / num_chunks); i++)
+        {
+          if (this->get_element_order(view->active_ids[i]) <= 0)
+            continue;
+          for (unsigned char j = 0; j < view->nvert[i]; j++)
+          {
+            int node_id = node_ids[i * H2D_MAX_NUMBER_VERTICES + j];
+            if (vertices && this->mesh->get_node(node_id)->is_constrained_vertex())
+              continue;
+            // Only nodes on the boundaries of the chunks are visited by more of them.
+#pragma omp atomic
+            chunk_masks[node_id] |= chunk_bit;
+          }
+        }
       }
+
+      return chunk_masks;
     }
 
     template<typename Scalar>
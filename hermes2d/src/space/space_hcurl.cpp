@@ -106,55 +106,7 @@ namespace Hermes
     template<typename Scalar>
     void HcurlSpace<Scalar>::assign_edge_dofs()
     {
-      Node* en;
-      this->edge_functions_count = 0;
-      for_all_edge_nodes(en, this->mesh)
-      {
-        if (en->ref > 1 || en->bnd || this->mesh->peek_vertex_node(en->p1, en->p2) != nullptr)
-        {
-          int ndofs = this->get_edge_order_internal(en) + 1;
-          this->ndata[en->id].n = ndofs;
-          if (en->bnd)
-            if (this->essential_bcs != nullptr)
-              if (this->essential_bcs->get_boundary_condition(this->mesh->boundary_markers_conversion.get_user_marker(en->marker).marker) != nullptr)
-                this->ndata[en->id].dof = this->H2D_CONSTRAINED_DOF;
-              else
-              {
-                this->ndata[en->id].dof = this->next_dof;
-                this->next_dof += ndofs;
-                this->edge_functions_count += ndofs;
-              }
-            else
-            {
-              this->ndata[en->id].dof = this->next_dof;
-              this->next_dof += ndofs;
-              this->edge_functions_count += ndofs;
-            }
-          else
-          {
-            this->ndata[en->id].dof = this->next_dof;
-            this->next_dof += ndofs;
-            this->edge_functions_count += ndofs;
-          }
-        }
-        else
-          this->ndata[en->id].n = -1;
-      }
-    }
-
-    template<typename Scalar>
-    void HcurlSpace<Scalar>::assign_bubble_dofs()
-    {
-      Element* e;
-      this->bubble_functions_count = 0;
-      for_all_active_elements(e, this->mesh)
-      {
-        typename Space<Scalar>::ElementData* ed = &this->edata[e->id];
-        ed->bdof = this->next_dof;
-        ed->n = this->shapeset->get_num_bubbles(ed->order, e->get_mode());
-        this->next_dof += ed->n;
-        this->bubble_functions_count += ed->n;
-      }
+      this->assign_edge_dofs_by_node_ids(1);
     }
 
     template<typename Scalar>
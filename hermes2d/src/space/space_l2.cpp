@@ -91,22 +91,6 @@ namespace Hermes
       }
     }
 
-    template<typename Scalar>
-    void L2Space<Scalar>::assign_bubble_dofs()
-    {
-      Element* e;
-      this->bubble_functions_count = 0;
-      for_all_active_elements(e, this->mesh)
-      {
-        typename Space<Scalar>::ElementData* ed = &this->edata[e->id];
-        ed->bdof = this->next_dof;
-        //FIXME: this function might return invalid value because retrieved bubble functions for non-uniform orders might be invalid for the given order.
-        ed->n = this->shapeset->get_num_bubbles(ed->order, e->get_mode());
-        this->next_dof += ed->n;
-        this->bubble_functions_count += ed->n;
-      }
-    }
-
     template<typename Scalar>
     void L2Space<Scalar>::get_vertex_assembly_list(Element* e, int iv, AsmList<Scalar>* al) const
     {}
@@ -114,6 +98,9 @@ namespace Hermes
     template<typename Scalar>
     void L2Space<Scalar>::get_element_assembly_list(Element* e, AsmList<Scalar>* al) const
     {
+      if (this->get_cached_element_assembly_list(e, al))
+        return;
+
       // add bubble functions to the assembly list
       al->cnt = 0;
       get_bubble_assembly_list(e, al);
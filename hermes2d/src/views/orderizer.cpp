@@ -242,7 +242,7 @@ namespace Hermes
 
         // make a mesh illustrating the distribution of polynomial orders over the space
         Element* e;
-        for_all_active_elements(e, mesh)
+        for_all_active_elements_compact(e, mesh)
         {
           oo = o[4] = o[5] = space->get_element_order(e->id);
           if (show_edge_orders)
@@ -0,0 +1,299 @@
+// This file is part of Hermes2D.
+//
+// Hermes2D is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 2 of the License, or
+// (at your option) any later version.
+//
+// Hermes2D is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Hermes2D.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "output_queue.h"
+#include "space.h"
+
+namespace Hermes
+{
+  namespace Hermes2D
+  {
+    namespace Views
+    {
+      /// Linearizer only handles real-valued functions.
+      template<typename Scalar>
+      static void save_snapshot_vtk(MeshFunctionSharedPtr<Scalar> sln, const char* filename, const char* quantity_name, bool mode_3D, int item, LinearizerCriterion criterion);
+
+      template<>
+      void save_snapshot_vtk<double>(MeshFunctionSharedPtr<double> sln, const char* filename, const char* quantity_name, bool mode_3D, int item, LinearizerCriterion criterion)
+      {
+        Linearizer linearizer(FileExport);
+        linearizer.set_criterion(criterion);
+        linearizer.save_solution_vtk(sln, filename, quantity_name, mode_3D, item);
+      }
+
+      template<>
+      void save_snapshot_vtk<std::complex<double> >(MeshFunctionSharedPtr<std::complex<double> > sln, const char* filename, const char* quantity_name, bool mode_3D, int item, LinearizerCriterion criterion)
+      {
+        throw Exceptions::Exception("OutputQueue::save_solution_vtk() is only available for real-valued solutions.");
+      }
+
+      template<typename Scalar>
+      class OutputQueue<Scalar>::SolutionVTKJob : public OutputQueue<Scalar>::Job
+      {
+      public:
+        SolutionVTKJob(Solution<Scalar>* sln, const char* filename, const char* quantity_name, bool mode_3D, int item, LinearizerCriterion criterion) :
+          sln(sln), filename(filename), quantity_name(quantity_name), mode_3D(mode_3D), item(item), criterion(criterion)
+        {
+        }
+
+        virtual void process()
+        {
+          save_snapshot_vtk<Scalar>(sln, filename.c_str(), quantity_name.c_str(), mode_3D, item, criterion);
+        }
+
+        MeshFunctionSharedPtr<Scalar> sln;
+        std::string filename;
+        std::string quantity_name;
+        bool mode_3D;
+        int item;
+        LinearizerCriterion criterion;
+      };
+
+      template<typename Scalar>
+      class OutputQueue<Scalar>::SolutionSaveJob : public OutputQueue<Scalar>::Job
+      {
+      public:
+        SolutionSaveJob(Solution<Scalar>* sln, const char* filename) : sln(sln), filename(filename)
+        {
+        }
+
+        virtual void process()
+        {
+          sln.get_solution()->save(filename.c_str());
+        }
+
+        MeshFunctionSharedPtr<Scalar> sln;
+        std::string filename;
+      };
+
+      template<typename Scalar>
+      class OutputQueue<Scalar>::OrdersVTKJob : public OutputQueue<Scalar>::Job
+      {
+      public:
+        OrdersVTKJob(SpaceSharedPtr<Scalar> space, const char* filename) : space(space), filename(filename)
+        {
+        }
+
+        virtual void process()
+        {
+          Orderizer orderizer;
+          orderizer.save_orders_vtk(space, filename.c_str());
+        }
+
+        SpaceSharedPtr<Scalar> space;
+        std::string filename;
+      };
+
+      template<typename Scalar>
+      OutputQueue<Scalar>::OutputQueue(unsigned int max_in_flight, unsigned int num_writers) :
+        max_in_flight(std::max(max_in_flight, 1u)), in_flight(0), terminate(false), criterion(LinearizerCriterionFixed(1))
+      {
+        for (unsigned int i = 0; i < std::max(num_writers, 1u); i++)
+          this->writers.push_back(std::thread(&OutputQueue<Scalar>::writer_loop, this));
+      }
+
+      template<typename Scalar>
+      OutputQueue<Scalar>::~OutputQueue()
+      {
+        {
+          std::lock_guard<std::mutex> lock(this->queue_mutex);
+          this->terminate = true;
+        }
+        this->job_available.notify_all();
+
+        // The writers only finish once the queue is empty.
+        for (unsigned int i = 0; i < this->writers.size(); i++)
+          this->writers[i].join();
+
+        if (!this->exception_message.empty())
+          this->warn("OutputQueue: output failed: %s", this->exception_message.c_str());
+      }
+
+      template<typename Scalar>
+      void OutputQueue<Scalar>::set_criterion(LinearizerCriterion criterion)
+      {
+        this->criterion = criterion;
+      }
+
+      template<typename Scalar>
+      Solution<Scalar>* OutputQueue<Scalar>::snapshot(MeshFunctionSharedPtr<Scalar> sln) const
+      {
+        Solution<Scalar>* solution = dynamic_cast<Solution<Scalar>*>(sln.get());
+        if (solution == nullptr || solution->get_type() != HERMES_SLN)
+          throw Exceptions::Exception("OutputQueue: only Solutions coming from computation can be output asynchronously.");
+
+        Solution<Scalar>* solution_snapshot = new Solution<Scalar>();
+        solution_snapshot->copy_with_mesh(solution);
+        return solution_snapshot;
+      }
+
+      template<typename Scalar>
+      void OutputQueue<Scalar>::save_solution_vtk(MeshFunctionSharedPtr<Scalar> sln, const char* filename, const char* quantity_name, bool mode_3D, int item)
+      {
+        this->acquire_slot();
+        Job* job;
+        try
+        {
+          job = new SolutionVTKJob(this->snapshot(sln), filename, quantity_name, mode_3D, item, this->criterion);
+        }
+        catch (...)
+        {
+          this->release_slot();
+          throw;
+        }
+        this->enqueue(job);
+      }
+
+      template<typename Scalar>
+      void OutputQueue<Scalar>::save(MeshFunctionSharedPtr<Scalar> sln, const char* filename)
+      {
+        this->acquire_slot();
+        Job* job;
+        try
+        {
+          job = new SolutionSaveJob(this->snapshot(sln), filename);
+        }
+        catch (...)
+        {
+          this->release_slot();
+          throw;
+        }
+        this->enqueue(job);
+      }
+
+      template<typename Scalar>
+      void OutputQueue<Scalar>::save_orders_vtk(SpaceSharedPtr<Scalar> space, const char* filename)
+      {
+        this->acquire_slot();
+        Job* job;
+        try
+        {
+          // The copy of the space lives on its own copy of the mesh, and with its own (default) shapeset.
+          MeshSharedPtr mesh_copy(new Mesh);
+          SpaceSharedPtr<Scalar> space_copy = Space<Scalar>::init_empty_space(space->get_type(), mesh_copy, nullptr);
+          space_copy->copy(space, mesh_copy);
+          job = new OrdersVTKJob(space_copy, filename);
+        }
+        catch (...)
+        {
+          this->release_slot();
+          throw;
+        }
+        this->enqueue(job);
+      }
+
+      template<typename Scalar>
+      void OutputQueue<Scalar>::check_exception()
+      {
+        if (!this->exception_message.empty())
+        {
+          std::string message = this->exception_message;
+          this->exception_message.clear();
+          throw Exceptions::Exception("OutputQueue: output failed: %s", message.c_str());
+        }
+      }
+
+      template<typename Scalar>
+      void OutputQueue<Scalar>::acquire_slot()
+      {
+        std::unique_lock<std::mutex> lock(this->queue_mutex);
+        this->check_exception();
+        while (this->in_flight >= this->max_in_flight)
+          this->slot_available.wait(lock);
+        this->in_flight++;
+      }
+
+      template<typename Scalar>
+      void OutputQueue<Scalar>::release_slot()
+      {
+        {
+          std::lock_guard<std::mutex> lock(this->queue_mutex);
+          this->in_flight--;
+        }
+        this->slot_available.notify_all();
+      }
+
+      template<typename Scalar>
+      void OutputQueue<Scalar>::enqueue(Job* job)
+      {
+        {
+          std::lock_guard<std::mutex> lock(this->queue_mutex);
+          this->jobs.push_back(job);
+        }
+        this->job_available.notify_one();
+      }
+
+      template<typename Scalar>
+      void OutputQueue<Scalar>::wait()
+      {
+        std::unique_lock<std::mutex> lock(this->queue_mutex);
+        while (this->in_flight > 0)
+          this->slot_available.wait(lock);
+        this->check_exception();
+      }
+
+      template<typename Scalar>
+      unsigned int OutputQueue<Scalar>::get_num_in_flight()
+      {
+        std::lock_guard<std::mutex> lock(this->queue_mutex);
+        return this->in_flight;
+      }
+
+      template<typename Scalar>
+      void OutputQueue<Scalar>::writer_loop()
+      {
+        while (true)
+        {
+          Job* job;
+          {
+            std::unique_lock<std::mutex> lock(this->queue_mutex);
+            while (this->jobs.empty() && !this->terminate)
+              this->job_available.wait(lock);
+            if (this->jobs.empty())
+              return;
+            job = this->jobs.front();
+            this->jobs.pop_front();
+          }
+
+          try
+          {
+            job->process();
+          }
+          catch (std::exception& e)
+          {
+            std::lock_guard<std::mutex> lock(this->queue_mutex);
+            if (this->exception_message.empty())
+              this->exception_message = e.what();
+          }
+          // Anything else escaping process() would terminate the writer thread (and the program).
+          catch (...)
+          {
+            std::lock_guard<std::mutex> lock(this->queue_mutex);
+            if (this->exception_message.empty())
+              this->exception_message = "unknown exception";
+          }
+
+          // Frees the snapshot.
+          delete job;
+          this->release_slot();
+        }
+      }
+
+      template class HERMES_API OutputQueue < double > ;
+      template class HERMES_API OutputQueue < std::complex<double> > ;
+    }
+  }
+}
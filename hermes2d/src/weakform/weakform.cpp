@@ -299,7 +299,7 @@ namespace Hermes
     }
 
     template<typename Scalar>
-    Form<Scalar>::Form(int i) : scaling_factor(1.0), wf(nullptr), assembleEverywhere(false), i(i)
+    Form<Scalar>::Form(int i) : scaling_factor(1.0), load_case(0), wf(nullptr), assembleEverywhere(false), precalculated(false), i(i)
     {
       areas.push_back(HERMES_ANY);
       stage_time = 0.0;
@@ -310,6 +310,12 @@ namespace Hermes
     {
     }
 
+    template<typename Scalar>
+    bool Form<Scalar>::precalculate(int n, double *wt, Func<Scalar> *u_ext[], Geom<double> *e, Func<Scalar> **ext)
+    {
+      return false;
+    }
+
     template<typename Scalar>
     void Form<Scalar>::set_current_stage_time(double time)
     {
@@ -346,6 +352,12 @@ namespace Hermes
       this->scaling_factor = scalingFactor;
     }
 
+    template<typename Scalar>
+    void Form<Scalar>::set_load_case(unsigned short load_case)
+    {
+      this->load_case = load_case;
+    }
+
     template<typename Scalar>
     void Form<Scalar>::set_ext(MeshFunctionSharedPtr<Scalar> ext)
     {
@@ -383,6 +395,7 @@ namespace Hermes
     {
       this->stage_time = other_form->stage_time;
       this->scaling_factor = other_form->scaling_factor;
+      this->load_case = other_form->load_case;
       this->u_ext_offset = other_form->u_ext_offset;
       this->previous_iteration_space_index = other_form->previous_iteration_space_index;
     }
@@ -99,6 +99,15 @@ namespace Hermes
         GeomVol<double> *e, Func<Scalar> **ext) const
       {
         Scalar result = 0;
+
+        // Coefficient values in the quadrature points - precalculated, or evaluated here if called outside of the assembling.
+        const Scalar* coeff_values = this->coeff_values;
+        Scalar coeff_values_local[H2D_MAX_INTEGRATION_POINTS_COUNT];
+        if (!this->precalculated && !(gt == HERMES_PLANAR && coeff->is_constant()))
+        {
+          coeff->values(n, e->x, e->y, coeff_values_local);
+          coeff_values = coeff_values_local;
+        }
         if (gt == HERMES_PLANAR)
         {
           if (coeff->is_constant())
@@ -110,18 +119,18 @@ namespace Hermes
           else
           {
             for (int i = 0; i < n; i++)
-              result += wt[i] * coeff->value(e->x[i], e->y[i]) * u->val[i] * v->val[i];
+              result += wt[i] * coeff_values[i] * u->val[i] * v->val[i];
           }
         }
         else {
           if (gt == HERMES_AXISYM_X) {
             for (int i = 0; i < n; i++) {
-              result += wt[i] * e->y[i] * coeff->value(e->x[i], e->y[i]) * u->val[i] * v->val[i];
+              result += wt[i] * e->y[i] * coeff_values[i] * u->val[i] * v->val[i];
             }
           }
           else {
             for (int i = 0; i < n; i++) {
-              result += wt[i] * e->x[i] * coeff->value(e->x[i], e->y[i]) * u->val[i] * v->val[i];
+              result += wt[i] * e->x[i] * coeff_values[i] * u->val[i] * v->val[i];
             }
           }
         }
@@ -155,6 +164,17 @@ namespace Hermes
         return result;
       }
 
+      template<typename Scalar>
+      bool DefaultMatrixFormVol<Scalar>::precalculate(int n, double *wt, Func<Scalar> *u_ext[], Geom<double> *e, Func<Scalar> **ext)
+      {
+        // The constant coefficient is taken out of the sum in value().
+        if (gt == HERMES_PLANAR && coeff->is_constant())
+          return false;
+
+        coeff->values(n, e->x, e->y, this->coeff_values);
+        return true;
+      }
+
       template<typename Scalar>
       MatrixFormVol<Scalar>* DefaultMatrixFormVol<Scalar>::clone() const
       {
@@ -206,6 +226,19 @@ namespace Hermes
         Func<double> *v, GeomVol<double> *e, Func<Scalar> **ext) const
       {
         Scalar result = 0;
+
+        // Coefficient values and derivatives in the quadrature points - precalculated, or evaluated here if called outside of the assembling.
+        const Scalar* coeff_values = this->coeff_values;
+        const Scalar* coeff_derivatives = this->coeff_derivatives;
+        Scalar coeff_values_local[H2D_MAX_INTEGRATION_POINTS_COUNT];
+        Scalar coeff_derivatives_local[H2D_MAX_INTEGRATION_POINTS_COUNT];
+        if (!this->precalculated && !(gt == HERMES_PLANAR && coeff->is_constant()))
+        {
+          coeff->values(n, u_ext[this->previous_iteration_space_index]->val, coeff_values_local);
+          coeff->derivatives(n, u_ext[this->previous_iteration_space_index]->val, coeff_derivatives_local);
+          coeff_values = coeff_values_local;
+          coeff_derivatives = coeff_derivatives_local;
+        }
         if (gt == HERMES_PLANAR)
         {
           if (coeff->is_constant())
@@ -224,9 +257,9 @@ namespace Hermes
           {
             for (int i = 0; i < n; i++)
             {
-              result += wt[i] * (coeff->derivative(u_ext[this->previous_iteration_space_index]->val[i]) * u->val[i] *
+              result += wt[i] * (coeff_derivatives[i] * u->val[i] *
                 (u_ext[this->previous_iteration_space_index]->dx[i] * v->dx[i] + u_ext[this->previous_iteration_space_index]->dy[i] * v->dy[i])
-                + coeff->value(u_ext[this->previous_iteration_space_index]->val[i])
+                + coeff_values[i]
                 * (u->dx[i] * v->dx[i] + u->dy[i] * v->dy[i]));
             }
           }
@@ -234,17 +267,17 @@ namespace Hermes
         else {
           if (gt == HERMES_AXISYM_X) {
             for (int i = 0; i < n; i++) {
-              result += wt[i] * e->y[i] * (coeff->derivative(u_ext[this->previous_iteration_space_index]->val[i]) * u->val[i] *
+              result += wt[i] * e->y[i] * (coeff_derivatives[i] * u->val[i] *
                 (u_ext[this->previous_iteration_space_index]->dx[i] * v->dx[i] + u_ext[this->previous_iteration_space_index]->dy[i] * v->dy[i])
-                + coeff->value(u_ext[this->previous_iteration_space_index]->val[i])
+                + coeff_values[i]
                 * (u->dx[i] * v->dx[i] + u->dy[i] * v->dy[i]));
             }
           }
           else {
             for (int i = 0; i < n; i++) {
-              result += wt[i] * e->x[i] * (coeff->derivative(u_ext[this->previous_iteration_space_index]->val[i]) * u->val[i] *
+              result += wt[i] * e->x[i] * (coeff_derivatives[i] * u->val[i] *
                 (u_ext[this->previous_iteration_space_index]->dx[i] * v->dx[i] + u_ext[this->previous_iteration_space_index]->dy[i] * v->dy[i])
-                + coeff->value(u_ext[this->previous_iteration_space_index]->val[i])
+                + coeff_values[i]
                 * (u->dx[i] * v->dx[i] + u->dy[i] * v->dy[i]));
             }
           }
@@ -288,6 +321,18 @@ namespace Hermes
         return result;
       }
 
+      template<typename Scalar>
+      bool DefaultJacobianDiffusion<Scalar>::precalculate(int n, double *wt, Func<Scalar> *u_ext[], Geom<double> *e, Func<Scalar> **ext)
+      {
+        // The constant coefficient is taken out of the sum in value().
+        if (gt == HERMES_PLANAR && coeff->is_constant())
+          return false;
+
+        coeff->values(n, u_ext[this->previous_iteration_space_index]->val, this->coeff_values);
+        coeff->derivatives(n, u_ext[this->previous_iteration_space_index]->val, this->coeff_derivatives);
+        return true;
+      }
+
       template<typename Scalar>
       MatrixFormVol<Scalar>* DefaultJacobianDiffusion<Scalar>::clone() const
       {
@@ -536,20 +581,29 @@ namespace Hermes
         GeomVol<double> *e, Func<Scalar> **ext) const
       {
         Scalar result = 0;
+
+        // Coefficient values in the quadrature points - precalculated, or evaluated here if called outside of the assembling.
+        const Scalar* coeff_values = this->coeff_values;
+        Scalar coeff_values_local[H2D_MAX_INTEGRATION_POINTS_COUNT];
+        if (!this->precalculated)
+        {
+          coeff->values(n, e->x, e->y, coeff_values_local);
+          coeff_values = coeff_values_local;
+        }
         if (gt == HERMES_PLANAR) {
           for (int i = 0; i < n; i++) {
-            result += wt[i] * coeff->value(e->x[i], e->y[i]) * v->val[i];
+            result += wt[i] * coeff_values[i] * v->val[i];
           }
         }
         else {
           if (gt == HERMES_AXISYM_X) {
             for (int i = 0; i < n; i++) {
-              result += wt[i] * e->y[i] * coeff->value(e->x[i], e->y[i]) * v->val[i];
+              result += wt[i] * e->y[i] * coeff_values[i] * v->val[i];
             }
           }
           else {
             for (int i = 0; i < n; i++) {
-              result += wt[i] * e->x[i] * coeff->value(e->x[i], e->y[i]) * v->val[i];
+              result += wt[i] * e->x[i] * coeff_values[i] * v->val[i];
             }
           }
         }
@@ -582,6 +636,13 @@ namespace Hermes
         return result;
       }
 
+      template<typename Scalar>
+      bool DefaultVectorFormVol<Scalar>::precalculate(int n, double *wt, Func<Scalar> *u_ext[], Geom<double> *e, Func<Scalar> **ext)
+      {
+        coeff->values(n, e->x, e->y, this->coeff_values);
+        return true;
+      }
+
       template<typename Scalar>
       VectorFormVol<Scalar>* DefaultVectorFormVol<Scalar>::clone() const
       {
@@ -632,20 +693,29 @@ namespace Hermes
         GeomVol<double> *e, Func<Scalar> **ext) const
       {
         Scalar result = 0;
+
+        // Coefficient values in the quadrature points - precalculated, or evaluated here if called outside of the assembling.
+        const Scalar* coeff_values = this->coeff_values;
+        Scalar coeff_values_local[H2D_MAX_INTEGRATION_POINTS_COUNT];
+        if (!this->precalculated)
+        {
+          coeff->values(n, e->x, e->y, coeff_values_local);
+          coeff_values = coeff_values_local;
+        }
         if (gt == HERMES_PLANAR) {
           for (int i = 0; i < n; i++) {
-            result += wt[i] * coeff->value(e->x[i], e->y[i]) * u_ext[this->previous_iteration_space_index]->val[i] * v->val[i];
+            result += wt[i] * coeff_values[i] * u_ext[this->previous_iteration_space_index]->val[i] * v->val[i];
           }
         }
         else {
           if (gt == HERMES_AXISYM_X) {
             for (int i = 0; i < n; i++) {
-              result += wt[i] * e->y[i] * coeff->value(e->x[i], e->y[i]) * u_ext[this->previous_iteration_space_index]->val[i] * v->val[i];
+              result += wt[i] * e->y[i] * coeff_values[i] * u_ext[this->previous_iteration_space_index]->val[i] * v->val[i];
             }
           }
           else {
             for (int i = 0; i < n; i++) {
-              result += wt[i] * e->x[i] * coeff->value(e->x[i], e->y[i]) * u_ext[this->previous_iteration_space_index]->val[i] * v->val[i];
+              result += wt[i] * e->x[i] * coeff_values[i] * u_ext[this->previous_iteration_space_index]->val[i] * v->val[i];
             }
           }
         }
@@ -678,6 +748,13 @@ namespace Hermes
         return result;
       }
 
+      template<typename Scalar>
+      bool DefaultResidualVol<Scalar>::precalculate(int n, double *wt, Func<Scalar> *u_ext[], Geom<double> *e, Func<Scalar> **ext)
+      {
+        coeff->values(n, e->x, e->y, this->coeff_values);
+        return true;
+      }
+
       template<typename Scalar>
       VectorFormVol<Scalar>* DefaultResidualVol<Scalar>::clone() const
       {
@@ -726,22 +803,31 @@ namespace Hermes
         GeomVol<double> *e, Func<Scalar> **ext) const
       {
         Scalar result = 0;
+
+        // Coefficient values in the quadrature points - precalculated, or evaluated here if called outside of the assembling.
+        const Scalar* coeff_values = this->coeff_values;
+        Scalar coeff_values_local[H2D_MAX_INTEGRATION_POINTS_COUNT];
+        if (!this->precalculated)
+        {
+          coeff->values(n, u_ext[this->previous_iteration_space_index]->val, coeff_values_local);
+          coeff_values = coeff_values_local;
+        }
         if (gt == HERMES_PLANAR) {
           for (int i = 0; i < n; i++) {
-            result += wt[i] * coeff->value(u_ext[this->previous_iteration_space_index]->val[i])
+            result += wt[i] * coeff_values[i]
               * (u_ext[this->previous_iteration_space_index]->dx[i] * v->dx[i] + u_ext[this->previous_iteration_space_index]->dy[i] * v->dy[i]);
           }
         }
         else {
           if (gt == HERMES_AXISYM_X) {
             for (int i = 0; i < n; i++) {
-              result += wt[i] * e->y[i] * coeff->value(u_ext[this->previous_iteration_space_index]->val[i])
+              result += wt[i] * e->y[i] * coeff_values[i]
                 * (u_ext[this->previous_iteration_space_index]->dx[i] * v->dx[i] + u_ext[this->previous_iteration_space_index]->dy[i] * v->dy[i]);
             }
           }
           else {
             for (int i = 0; i < n; i++) {
-              result += wt[i] * e->x[i] * coeff->value(u_ext[this->previous_iteration_space_index]->val[i])
+              result += wt[i] * e->x[i] * coeff_values[i]
                 * (u_ext[this->previous_iteration_space_index]->dx[i] * v->dx[i] + u_ext[this->previous_iteration_space_index]->dy[i] * v->dy[i]);
             }
           }
@@ -764,6 +850,13 @@ namespace Hermes
         return result;
       }
 
+      template<typename Scalar>
+      bool DefaultResidualDiffusion<Scalar>::precalculate(int n, double *wt, Func<Scalar> *u_ext[], Geom<double> *e, Func<Scalar> **ext)
+      {
+        coeff->values(n, u_ext[this->previous_iteration_space_index]->val, this->coeff_values);
+        return true;
+      }
+
       template<typename Scalar>
       VectorFormVol<Scalar>* DefaultResidualDiffusion<Scalar>::clone() const
       {
@@ -0,0 +1,69 @@
+#include "hermes2d.h"
+
+using namespace Hermes;
+using namespace Hermes::Hermes2D;
+using namespace Hermes::Hermes2D::Views;
+
+// Checks that a failure on the writer thread of OutputQueue reaches the caller,
+// and that the queue keeps working afterwards.
+int main(int argc, char* argv[])
+{
+  MeshSharedPtr mesh(new Mesh);
+  MeshReaderH2D mloader;
+  mloader.load("square.mesh", mesh);
+  mesh->refine_all_elements();
+  mesh->refine_all_elements();
+
+  SpaceSharedPtr<double> space(new H1Space<double>(mesh, 2));
+  int ndof = space->get_num_dofs();
+  double* coeffs = new double[ndof];
+  for (int i = 0; i < ndof; i++)
+    coeffs[i] = (double)i / ndof;
+
+  MeshFunctionSharedPtr<double> sln(new Solution<double>);
+  Solution<double>::vector_to_solution(coeffs, space, sln);
+  delete[] coeffs;
+
+  OutputQueue<double> output;
+
+  // The directory does not exist, the writer fails.
+  output.save_solution_vtk(sln, "no-such-directory/sln.vtk", "u");
+  bool caught = false;
+  try
+  {
+    output.wait();
+  }
+  catch (Exceptions::Exception&)
+  {
+    caught = true;
+  }
+  if (!caught)
+  {
+    std::cout << "Failure - writer exception not rethrown by wait()!";
+    return -1;
+  }
+
+  // The failure is reported once, the queue is usable again.
+  try
+  {
+    output.save_solution_vtk(sln, "output-queue-sln.vtk", "u");
+    output.save_orders_vtk(space, "output-queue-orders.vtk");
+    output.wait();
+  }
+  catch (Exceptions::Exception& e)
+  {
+    std::cout << "Failure - " << e.what();
+    return -1;
+  }
+
+  FILE* f = fopen("output-queue-sln.vtk", "r");
+  if (f == nullptr)
+  {
+    std::cout << "Failure - output not written!";
+    return -1;
+  }
+  fclose(f);
+
+  std::cout << "Success!";
+  return 0;
+}
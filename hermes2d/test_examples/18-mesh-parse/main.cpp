@@ -0,0 +1,57 @@
+#include "hermes2d.h"
+
+using namespace Hermes;
+using namespace Hermes::Hermes2D;
+
+// Parses the same file with MeshData::parse_mesh_fast() and MeshData::parse_mesh()
+// and checks that both give the same data.
+bool same(const MeshData& a, const MeshData& b)
+{
+  return a.n_vert == b.n_vert && a.n_el == b.n_el && a.n_bdy == b.n_bdy && a.n_curv == b.n_curv && a.n_ref == b.n_ref
+    && a.x_vertex == b.x_vertex && a.y_vertex == b.y_vertex
+    && a.en1 == b.en1 && a.en2 == b.en2 && a.en3 == b.en3 && a.en4 == b.en4 && a.e_mtl == b.e_mtl
+    && a.bdy_first == b.bdy_first && a.bdy_second == b.bdy_second && a.bdy_type == b.bdy_type
+    && a.curv_first == b.curv_first && a.curv_second == b.curv_second && a.curv_third == b.curv_third
+    && a.curv_nurbs == b.curv_nurbs && a.curv_inner_pts == b.curv_inner_pts && a.curv_knots == b.curv_knots
+    && a.ref_elt == b.ref_elt && a.ref_type == b.ref_type;
+}
+
+int main(int argc, char* argv[])
+{
+  MeshData fast("domain.mesh"), general("domain.mesh");
+  if (!fast.parse_mesh_fast())
+  {
+    std::cout << "Failure - fast path declined a file it handles!";
+    return -1;
+  }
+  general.parse_mesh();
+
+  if (!same(fast, general))
+  {
+    std::cout << "Failure - the fast and the general parser differ!";
+    return -1;
+  }
+
+  if (fast.n_el != 4 || fast.en4[2] != -1 || fast.e_mtl[2] != "1" || fast.e_mtl[1] != "7")
+  {
+    std::cout << "Failure - wrong element data!";
+    return -1;
+  }
+
+  // An unquoted numeric marker of a triangle is read as a vertex index by parse_mesh(),
+  // the fast path must leave such a file to it.
+  MeshData ambiguous("triangle-numeric-marker.mesh");
+  if (ambiguous.parse_mesh_fast() || ambiguous.n_el != 0)
+  {
+    std::cout << "Failure - fast path accepted a file parse_mesh() reads differently!";
+    return -1;
+  }
+
+  // The mesh also loads.
+  MeshSharedPtr mesh(new Mesh);
+  MeshReaderH2D mloader;
+  mloader.load("domain.mesh", mesh);
+
+  std::cout << "Success!";
+  return 0;
+}
@@ -0,0 +1,71 @@
+#include "hermes2d.h"
+
+using namespace Hermes;
+using namespace Hermes::Hermes2D;
+using namespace Hermes::Hermes2D::WeakFormsH1;
+
+// -Laplace u = f, f constant, with the volume source term assigned to a load case.
+WeakFormSharedPtr<double> create_weak_form(std::vector<double> sources)
+{
+  WeakFormSharedPtr<double> wf(new WeakForm<double>(1));
+  wf->add_matrix_form(new DefaultJacobianDiffusion<double>(0, 0));
+  for (unsigned short load_case = 0; load_case < sources.size(); load_case++)
+  {
+    VectorFormVol<double>* form = new DefaultVectorFormVol<double>(0, HERMES_ANY, new Hermes2DFunction<double>(sources[load_case]));
+    form->set_load_case(load_case);
+    wf->add_vector_form(form);
+  }
+  return wf;
+}
+
+// Solves several load cases with LinearSolver::solve_multiple() and compares
+// each of the solutions with a separate LinearSolver::solve() of that load case.
+int main(int argc, char* argv[])
+{
+  MeshSharedPtr mesh(new Mesh);
+  MeshReaderH2D mloader;
+  mloader.load("square.mesh", mesh);
+  mesh->refine_all_elements();
+  mesh->refine_all_elements();
+  mesh->refine_all_elements();
+
+  // Non-zero Dirichlet data, the lift has to be added to every right-hand side.
+  DefaultEssentialBCConst<double> bc("Bdy", 1.0);
+  EssentialBCs<double> bcs(&bc);
+  SpaceSharedPtr<double> space(new H1Space<double>(mesh, &bcs, 3));
+  int ndof = space->get_num_dofs();
+
+  std::vector<double> sources;
+  sources.push_back(1.0);
+  sources.push_back(-2.0);
+  sources.push_back(5.0);
+
+  LinearSolver<double> multi_solver(create_weak_form(sources), space);
+  multi_solver.solve_multiple(sources.size());
+  double* multi_sln = new double[ndof * sources.size()];
+  memcpy(multi_sln, multi_solver.get_sln_vector(), ndof * sources.size() * sizeof(double));
+
+  for (unsigned int load_case = 0; load_case < sources.size(); load_case++)
+  {
+    LinearSolver<double> solver(create_weak_form(std::vector<double>(1, sources[load_case])), space);
+    solver.solve();
+
+    double max_difference = 0., max_value = 0.;
+    for (int i = 0; i < ndof; i++)
+    {
+      max_difference = std::max(max_difference, std::abs(solver.get_sln_vector()[i] - multi_sln[load_case * ndof + i]));
+      max_value = std::max(max_value, std::abs(solver.get_sln_vector()[i]));
+    }
+
+    if (max_difference > 1e-10 * std::max(max_value, 1.))
+    {
+      std::cout << "Failure - load case " << load_case << " differs by " << max_difference << "!";
+      delete[] multi_sln;
+      return -1;
+    }
+  }
+
+  delete[] multi_sln;
+  std::cout << "Success!";
+  return 0;
+}
@@ -0,0 +1,99 @@
+#include "hermes2d.h"
+
+using namespace Hermes;
+using namespace Hermes::Hermes2D;
+
+// Creates a space of the given type with varying element orders.
+SpaceSharedPtr<double> create_space(SpaceType type, MeshSharedPtr mesh, EssentialBCs<double>* bcs)
+{
+  SpaceSharedPtr<double> space;
+  switch (type)
+  {
+  case HERMES_H1_SPACE:
+    space = new H1Space<double>(mesh, bcs, 2);
+    break;
+  case HERMES_HCURL_SPACE:
+    space = new HcurlSpace<double>(mesh, 2);
+    break;
+  case HERMES_HDIV_SPACE:
+    space = new HdivSpace<double>(mesh, 2);
+    break;
+  default:
+    space = new L2Space<double>(mesh, 2);
+  }
+
+  Element* e;
+  for_all_active_elements(e, mesh)
+  {
+    if (e->id % 5 == 0)
+      space->set_element_order(e->id, 4);
+    else if (e->id % 7 == 0)
+      space->set_element_order(e->id, 3);
+  }
+  space->assign_dofs();
+  return space;
+}
+
+// The assembly lists of all active elements are the same.
+bool same_numbering(SpaceSharedPtr<double> a, SpaceSharedPtr<double> b)
+{
+  if (a->get_num_dofs() != b->get_num_dofs())
+    return false;
+
+  AsmList<double> al_a, al_b;
+  Element* e;
+  for_all_active_elements(e, a->get_mesh())
+  {
+    a->get_element_assembly_list(e, &al_a);
+    b->get_element_assembly_list(e, &al_b);
+    if (al_a.cnt != al_b.cnt)
+      return false;
+    for (unsigned int i = 0; i < al_a.cnt; i++)
+      if (al_a.idx[i] != al_b.idx[i] || al_a.dof[i] != al_b.dof[i] || al_a.coef[i] != al_b.coef[i])
+        return false;
+  }
+  return true;
+}
+
+// The parallel DOF assignment has to give exactly the numbering of the serial one,
+// on a mesh large enough for it to be used, with hanging nodes and varying orders.
+int main(int argc, char* argv[])
+{
+  MeshSharedPtr mesh(new Mesh);
+  MeshReaderH2D mloader;
+  mloader.load("square.mesh", mesh);
+  for (int i = 0; i < 5; i++)
+    mesh->refine_all_elements();
+  mesh->refine_all_elements(2);
+
+  // Hanging nodes.
+  Element* e;
+  std::vector<int> to_refine;
+  for_all_active_elements(e, mesh)
+    if (e->id % 3 == 0)
+      to_refine.push_back(e->id);
+  for (unsigned int i = 0; i < to_refine.size(); i++)
+    mesh->refine_element_id(to_refine[i]);
+
+  DefaultEssentialBCConst<double> bc("Bdy", 1.0);
+  EssentialBCs<double> bcs(&bc);
+
+  SpaceType types[4] = { HERMES_H1_SPACE, HERMES_HCURL_SPACE, HERMES_HDIV_SPACE, HERMES_L2_SPACE };
+  for (int type_i = 0; type_i < 4; type_i++)
+  {
+    HermesCommonApi.set_integral_param_value(numThreads, 1);
+    SpaceSharedPtr<double> serial_space = create_space(types[type_i], mesh, &bcs);
+
+    HermesCommonApi.set_integral_param_value(numThreads, 4);
+    SpaceSharedPtr<double> parallel_space = create_space(types[type_i], mesh, &bcs);
+
+    if (!same_numbering(serial_space, parallel_space))
+    {
+      std::cout << "Failure - the numbering of a " << spaceTypeToString(types[type_i]) << " space depends on the number of threads!";
+      return -1;
+    }
+  }
+
+  std::cout << "Success!";
+  return 0;
+}
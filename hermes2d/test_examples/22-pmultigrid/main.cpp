@@ -0,0 +1,111 @@
+#include "hermes2d.h"
+
+using namespace Hermes;
+using namespace Hermes::Hermes2D;
+using namespace Hermes::Hermes2D::WeakFormsH1;
+
+// -Laplace u = 1, the linear form.
+WeakFormSharedPtr<double> create_weak_form()
+{
+  WeakFormSharedPtr<double> wf(new WeakForm<double>(1));
+  wf->add_matrix_form(new DefaultMatrixFormDiffusion<double>(0, 0));
+  wf->add_vector_form(new DefaultVectorFormVol<double>(0, HERMES_ANY, new Hermes2DFunction<double>(1.0)));
+  return wf;
+}
+
+// -Laplace u = 1, the Jacobian and the residual for NewtonSolver.
+WeakFormSharedPtr<double> create_newton_weak_form()
+{
+  WeakFormSharedPtr<double> wf(new WeakForm<double>(1));
+  wf->add_matrix_form(new DefaultJacobianDiffusion<double>(0, 0));
+  wf->add_vector_form(new DefaultResidualDiffusion<double>(0));
+  wf->add_vector_form(new DefaultVectorFormVol<double>(0, HERMES_ANY, new Hermes2DFunction<double>(-1.0)));
+  return wf;
+}
+
+// Relative difference of two coefficient vectors.
+double get_difference(double* a, double* b, int ndof)
+{
+  double max_difference = 0., max_value = 0.;
+  for (int i = 0; i < ndof; i++)
+  {
+    max_difference = std::max(max_difference, std::abs(a[i] - b[i]));
+    max_value = std::max(max_value, std::abs(a[i]));
+  }
+  return max_difference / std::max(max_value, 1e-12);
+}
+
+// Solution by LinearSolver with the p-multigrid selected through matrixSolverType.
+double* solve_pmultigrid(SpaceSharedPtr<double> space)
+{
+  HermesCommonApi.set_integral_param_value(matrixSolverType, SOLVER_PMULTIGRID);
+  LinearSolver<double> solver(create_weak_form(), space);
+  HermesCommonApi.set_integral_param_value(matrixSolverType, SOLVER_UMFPACK);
+
+  Solvers::LoopSolver<double>* loop_solver = dynamic_cast<Solvers::LoopSolver<double>*>(solver.get_linear_matrix_solver());
+  if (!dynamic_cast<PMultigridSolver<double>*>(loop_solver))
+    throw Exceptions::Exception("SOLVER_PMULTIGRID did not create a PMultigridSolver.");
+  loop_solver->set_tolerance(1e-12, Solvers::RelativeTolerance);
+  loop_solver->set_max_iters(200);
+
+  solver.solve();
+  int ndof = space->get_num_dofs();
+  double* sln = new double[ndof];
+  memcpy(sln, solver.get_sln_vector(), ndof * sizeof(double));
+  return sln;
+}
+
+// The p-multigrid through create_linear_solver() (LinearSolver, NewtonSolver) compared with the direct solver,
+// also with a coarsest level without DOFs (one element, Dirichlet conditions on the whole boundary).
+int main(int argc, char* argv[])
+{
+  MeshSharedPtr mesh(new Mesh), one_element_mesh(new Mesh);
+  MeshReaderH2D mloader;
+  mloader.load("square.mesh", mesh);
+  mloader.load("square.mesh", one_element_mesh);
+  mesh->refine_all_elements();
+  mesh->refine_all_elements();
+  mesh->refine_all_elements();
+
+  DefaultEssentialBCConst<double> bc("Bdy", 1.0);
+  EssentialBCs<double> bcs(&bc);
+  SpaceSharedPtr<double> space(new H1Space<double>(mesh, &bcs, 4));
+  SpaceSharedPtr<double> one_element_space(new H1Space<double>(one_element_mesh, &bcs, 4));
+
+  SpaceSharedPtr<double> spaces[2] = { space, one_element_space };
+  for (int space_i = 0; space_i < 2; space_i++)
+  {
+    int ndof = spaces[space_i]->get_num_dofs();
+
+    LinearSolver<double> direct_solver(create_weak_form(), spaces[space_i]);
+    direct_solver.solve();
+
+    double* pmultigrid_sln = solve_pmultigrid(spaces[space_i]);
+    double difference = get_difference(direct_solver.get_sln_vector(), pmultigrid_sln, ndof);
+    delete[] pmultigrid_sln;
+    if (difference > 1e-8)
+    {
+      std::cout << "Failure - LinearSolver with the p-multigrid differs by " << difference << " on the space " << space_i << "!";
+      return -1;
+    }
+  }
+
+  HermesCommonApi.set_integral_param_value(matrixSolverType, SOLVER_PMULTIGRID);
+  NewtonSolver<double> newton(create_newton_weak_form(), space);
+  HermesCommonApi.set_integral_param_value(matrixSolverType, SOLVER_UMFPACK);
+  dynamic_cast<Solvers::LoopSolver<double>*>(newton.get_linear_matrix_solver())->set_tolerance(1e-12, Solvers::RelativeTolerance);
+  newton.set_tolerance(1e-10, Solvers::ResidualNormAbsolute);
+  newton.solve();
+
+  LinearSolver<double> direct_solver(create_weak_form(), space);
+  direct_solver.solve();
+  double difference = get_difference(direct_solver.get_sln_vector(), newton.get_sln_vector(), space->get_num_dofs());
+  if (difference > 1e-8)
+  {
+    std::cout << "Failure - NewtonSolver with the p-multigrid differs by " << difference << "!";
+    return -1;
+  }
+
+  std::cout << "Success!";
+  return 0;
+}
@@ -0,0 +1,93 @@
+#include "hermes2d.h"
+
+using namespace Hermes;
+using namespace Hermes::Hermes2D;
+using namespace Hermes::Hermes2D::WeakFormsH1;
+
+// -Laplace u + u = 1.
+WeakFormSharedPtr<double> create_weak_form()
+{
+  WeakFormSharedPtr<double> wf(new WeakForm<double>(1));
+  wf->add_matrix_form(new DefaultMatrixFormDiffusion<double>(0, 0));
+  wf->add_matrix_form(new DefaultMatrixFormVol<double>(0, 0));
+  wf->add_vector_form(new DefaultVectorFormVol<double>(0, HERMES_ANY, new Hermes2DFunction<double>(1.0)));
+  return wf;
+}
+
+// Relative difference of the solution with the static condensation from the one without it.
+double get_difference(SpaceSharedPtr<double> space, LinearSolver<double>& condensed_solver)
+{
+  LinearSolver<double> solver(create_weak_form(), space);
+  solver.solve();
+  condensed_solver.solve();
+
+  double max_difference = 0., max_value = 0.;
+  for (int i = 0; i < space->get_num_dofs(); i++)
+  {
+    max_difference = std::max(max_difference, std::abs(solver.get_sln_vector()[i] - condensed_solver.get_sln_vector()[i]));
+    max_value = std::max(max_value, std::abs(solver.get_sln_vector()[i]));
+  }
+  return max_difference / std::max(max_value, 1e-12);
+}
+
+// LinearSolver with the static condensation compared with the one without it, also after a renumbering
+// of the DOFs without a change of the space seq (other essential BCs), and NewtonSolver is refused.
+int main(int argc, char* argv[])
+{
+  MeshSharedPtr mesh(new Mesh);
+  MeshReaderH2D mloader;
+  mloader.load("square.mesh", mesh);
+  mesh->refine_all_elements();
+  mesh->refine_all_elements();
+
+  DefaultEssentialBCConst<double> bc("Bdy", 1.0);
+  EssentialBCs<double> dirichlet_bcs(&bc);
+  EssentialBCs<double> natural_bcs;
+  SpaceSharedPtr<double> space(new H1Space<double>(mesh, &dirichlet_bcs, 4));
+
+  DiscreteProblem<double> dp(create_weak_form(), space, true);
+  dp.set_static_condensation();
+  LinearSolver<double> condensed_solver(&dp);
+
+  double difference = get_difference(space, condensed_solver);
+  if (difference > 1e-10)
+  {
+    std::cout << "Failure - the static condensation changes the solution by " << difference << "!";
+    return -1;
+  }
+
+  // Different bubble DOF numbers, the same seq.
+  space->set_essential_bcs(&natural_bcs);
+  difference = get_difference(space, condensed_solver);
+  if (difference > 1e-10)
+  {
+    std::cout << "Failure - the static condensation after the renumbering changes the solution by " << difference << "!";
+    return -1;
+  }
+
+  // The Newton and Picard iterations do not reconstruct the condensed DOFs.
+  NewtonSolver<double> newton(&dp);
+  try
+  {
+    newton.solve();
+    std::cout << "Failure - NewtonSolver accepted a DiscreteProblem with the static condensation!";
+    return -1;
+  }
+  catch (Exceptions::Exception&)
+  {
+  }
+
+  DiscreteProblem<double> nonlinear_dp(create_weak_form(), space);
+  try
+  {
+    nonlinear_dp.set_static_condensation();
+    std::cout << "Failure - a nonlinear DiscreteProblem accepted the static condensation!";
+    return -1;
+  }
+  catch (Exceptions::Exception&)
+  {
+  }
+
+  std::cout << "Success!";
+  return 0;
+}
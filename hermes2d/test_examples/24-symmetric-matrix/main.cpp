@@ -0,0 +1,122 @@
+#include "hermes2d.h"
+
+using namespace Hermes;
+using namespace Hermes::Algebra;
+using namespace Hermes::Hermes2D;
+using namespace Hermes::Hermes2D::WeakFormsH1;
+
+// -Laplace u + u = 1.
+WeakFormSharedPtr<double> create_weak_form()
+{
+  WeakFormSharedPtr<double> wf(new WeakForm<double>(1));
+  wf->add_matrix_form(new DefaultMatrixFormDiffusion<double>(0, 0));
+  wf->add_matrix_form(new DefaultMatrixFormVol<double>(0, 0));
+  wf->add_vector_form(new DefaultVectorFormVol<double>(0, HERMES_ANY, new Hermes2DFunction<double>(1.0)));
+  return wf;
+}
+
+// Relative difference of two vectors.
+double get_difference(double* a, double* b, int size)
+{
+  double max_difference = 0., max_value = 0.;
+  for (int i = 0; i < size; i++)
+  {
+    max_difference = std::max(max_difference, std::abs(a[i] - b[i]));
+    max_value = std::max(max_value, std::abs(a[i]));
+  }
+  return max_difference / std::max(max_value, 1e-12);
+}
+
+// SymmetricCSCMatrix from create_matrix() (useSymmetricMatrices) compared with CSCMatrix: the solution, the product
+// with a vector, a refactorization with the reused structure, and the operations that have to be refused.
+int main(int argc, char* argv[])
+{
+  MeshSharedPtr mesh(new Mesh);
+  MeshReaderH2D mloader;
+  mloader.load("square.mesh", mesh);
+  mesh->refine_all_elements();
+  mesh->refine_all_elements();
+  mesh->refine_all_elements();
+
+  DefaultEssentialBCConst<double> bc("Bdy", 1.0);
+  EssentialBCs<double> bcs(&bc);
+  SpaceSharedPtr<double> space(new H1Space<double>(mesh, &bcs, 3));
+  int ndof = space->get_num_dofs();
+
+  HermesCommonApi.set_integral_param_value(useSymmetricMatrices, 1);
+  LinearSolver<double> symmetric_solver(create_weak_form(), space);
+  HermesCommonApi.set_integral_param_value(useSymmetricMatrices, 0);
+  LinearSolver<double> solver(create_weak_form(), space);
+
+  SymmetricCSCMatrix<double>* symmetric_matrix = dynamic_cast<SymmetricCSCMatrix<double>*>(symmetric_solver.get_jacobian());
+  if (!symmetric_matrix)
+  {
+    std::cout << "Failure - useSymmetricMatrices did not give a SymmetricCSCMatrix!";
+    return -1;
+  }
+
+  symmetric_solver.solve();
+  solver.solve();
+  double difference = get_difference(solver.get_sln_vector(), symmetric_solver.get_sln_vector(), ndof);
+  if (difference > 1e-10)
+  {
+    std::cout << "Failure - the solution with the symmetric storage differs by " << difference << "!";
+    return -1;
+  }
+
+  double* x = new double[ndof];
+  double* y = new double[ndof];
+  double* symmetric_y = new double[ndof];
+  for (int i = 0; i < ndof; i++)
+    x[i] = std::sin(1.0 + i);
+  solver.get_jacobian()->multiply_with_vector(x, y, true);
+  symmetric_matrix->multiply_with_vector(x, symmetric_y, true);
+  difference = get_difference(y, symmetric_y, ndof);
+  if (difference > 1e-12)
+  {
+    std::cout << "Failure - the product with the symmetric storage differs by " << difference << "!";
+    return -1;
+  }
+
+  // A new factorization with the reused structure - the doubled matrix, the half solution.
+  SymmetricCSCMatrix<double>* matrix = static_cast<SymmetricCSCMatrix<double>*>(symmetric_matrix->duplicate());
+  SimpleVector<double> rhs(ndof);
+  rhs.set_vector(y);
+  Solvers::LinearMatrixSolver<double>* direct_solver = Solvers::create_linear_solver<double>(matrix, &rhs, true);
+  direct_solver->solve();
+  matrix->multiply_with_Scalar(2.0);
+  direct_solver->set_reuse_scheme(Solvers::HERMES_REUSE_MATRIX_REORDERING);
+  direct_solver->solve();
+  for (int i = 0; i < ndof; i++)
+    x[i] *= 0.5;
+  difference = get_difference(x, direct_solver->get_sln_vector(), ndof);
+  delete direct_solver;
+  delete matrix;
+  delete[] x;
+  delete[] y;
+  delete[] symmetric_y;
+  if (difference > 1e-10)
+  {
+    std::cout << "Failure - the refactorization with the symmetric storage differs by " << difference << "!";
+    return -1;
+  }
+
+  // Operations that would use only the stored triangle of a nonsymmetric matrix.
+  bool refused = false;
+  try
+  {
+    symmetric_matrix->set_row_zero(0);
+  }
+  catch (Exceptions::Exception&)
+  {
+    refused = true;
+  }
+  if (!refused)
+  {
+    std::cout << "Failure - SymmetricCSCMatrix::set_row_zero() accepted!";
+    return -1;
+  }
+
+  std::cout << "Success!";
+  return 0;
+}
@@ -0,0 +1,119 @@
+#include "hermes2d.h"
+
+using namespace Hermes;
+using namespace Hermes::Algebra;
+using namespace Hermes::Hermes2D;
+
+// Interface form depending on the side through the normal - the result differs if an interface
+// is assembled from the other side, or twice.
+class SidedJumpForm : public MatrixFormDG<double>
+{
+public:
+  SidedJumpForm() : MatrixFormDG<double>(0, 0) {};
+
+  template<typename Real>
+  Real matrix_form(int n, double *wt, DiscontinuousFunc<Real> *u, DiscontinuousFunc<Real> *v, InterfaceGeom<Real> *e) const
+  {
+    Real result = Real(0);
+    for (int i = 0; i < n; i++)
+    {
+      Real jump_u = (u->fn_central == nullptr ? -u->val_neighbor[i] : u->val[i]);
+      Real jump_v = (v->fn_central == nullptr ? -v->val_neighbor[i] : v->val[i]);
+      result += wt[i] * (1.0 + 0.5 * e->nx[i] + 0.25 * e->ny[i]) * jump_u * jump_v;
+    }
+    return result;
+  }
+
+  virtual double value(int n, double *wt, DiscontinuousFunc<double> **u_ext, DiscontinuousFunc<double> *u, DiscontinuousFunc<double> *v,
+    InterfaceGeom<double> *e, DiscontinuousFunc<double> **ext) const
+  {
+    return matrix_form<double>(n, wt, u, v, e);
+  }
+
+  virtual Ord ord(int n, double *wt, DiscontinuousFunc<Ord> **u_ext, DiscontinuousFunc<Ord> *u, DiscontinuousFunc<Ord> *v,
+    InterfaceGeom<Ord> *e, DiscontinuousFunc<Ord> **ext) const
+  {
+    return matrix_form<Ord>(n, wt, u, v, e);
+  }
+
+  virtual MatrixFormDG<double>* clone() const
+  {
+    return new SidedJumpForm(*this);
+  }
+};
+
+WeakFormSharedPtr<double> create_weak_form()
+{
+  WeakFormSharedPtr<double> wf(new WeakForm<double>(1));
+  wf->add_matrix_form(new WeakFormsH1::DefaultMatrixFormVol<double>(0, 0));
+  wf->add_matrix_form_DG(new SidedJumpForm());
+  wf->add_vector_form(new WeakFormsH1::DefaultVectorFormVol<double>(0, HERMES_ANY, new Hermes2DFunction<double>(1.0)));
+  return wf;
+}
+
+// Assembles with the given number of threads (the DiscreteProblem takes it over in its constructor).
+void assemble(SpaceSharedPtr<double> space, int num_threads, CSCMatrix<double>* matrix, SimpleVector<double>* rhs)
+{
+  HermesCommonApi.set_integral_param_value(numThreads, num_threads);
+  DiscreteProblem<double> dp(create_weak_form(), space, true);
+  dp.assemble(matrix, rhs);
+}
+
+// Bitwise identity of the matrices and right-hand sides.
+bool identical(CSCMatrix<double>* a, SimpleVector<double>* a_rhs, CSCMatrix<double>* b, SimpleVector<double>* b_rhs)
+{
+  if (a->get_nnz() != b->get_nnz() || memcmp(a->get_Ai(), b->get_Ai(), a->get_nnz() * sizeof(int))
+    || memcmp(a->get_Ax(), b->get_Ax(), a->get_nnz() * sizeof(double)))
+    return false;
+  if (a_rhs->get_size() != b_rhs->get_size())
+    return false;
+  for (unsigned int i = 0; i < a_rhs->get_size(); i++)
+  {
+    double a_value = a_rhs->get(i), b_value = b_rhs->get(i);
+    if (memcmp(&a_value, &b_value, sizeof(double)))
+      return false;
+  }
+  return true;
+}
+
+// DG assembly with several threads compared with the serial one. Every interface belongs to one state regardless of
+// the threads, and the additions of the threads are recorded and summed in the order of the states, so that the
+// side-dependent form gives bitwise the same matrix and right-hand side.
+int main(int argc, char* argv[])
+{
+  MeshSharedPtr mesh(new Mesh);
+  MeshReaderH2D mloader;
+  mloader.load("square.mesh", mesh);
+  mesh->refine_all_elements();
+  mesh->refine_all_elements();
+  mesh->refine_all_elements();
+  // Hanging nodes - interfaces between elements of different sizes.
+  int num_elements = mesh->get_max_element_id();
+  for (int id = 0; id < num_elements; id += 3)
+    mesh->refine_element_id(id);
+
+  SpaceSharedPtr<double> space(new L2Space<double>(mesh, 2));
+  int original_num_threads = HermesCommonApi.get_integral_param_value(numThreads);
+
+  CSCMatrix<double> serial_matrix, second_serial_matrix, parallel_matrix;
+  SimpleVector<double> serial_rhs, second_serial_rhs, parallel_rhs;
+  assemble(space, 1, &serial_matrix, &serial_rhs);
+  assemble(space, 1, &second_serial_matrix, &second_serial_rhs);
+  assemble(space, 4, &parallel_matrix, &parallel_rhs);
+  HermesCommonApi.set_integral_param_value(numThreads, original_num_threads);
+
+  if (!identical(&serial_matrix, &serial_rhs, &second_serial_matrix, &second_serial_rhs))
+  {
+    std::cout << "Failure - two serial DG assemblies differ!";
+    return -1;
+  }
+
+  if (!identical(&serial_matrix, &serial_rhs, &parallel_matrix, &parallel_rhs))
+  {
+    std::cout << "Failure - the parallel DG assembly differs from the serial one!";
+    return -1;
+  }
+
+  std::cout << "Success!";
+  return 0;
+}
@@ -0,0 +1,166 @@
+#include "hermes2d.h"
+#include "discrete_problem/dg/dg_face_connectivity.h"
+
+using namespace Hermes;
+using namespace Hermes::Algebra;
+using namespace Hermes::Hermes2D;
+
+// Interface form depending on the side through the normal, coupling the components i and j.
+class SidedJumpForm : public MatrixFormDG<double>
+{
+public:
+  SidedJumpForm(int i, int j) : MatrixFormDG<double>(i, j) {};
+
+  template<typename Real>
+  Real matrix_form(int n, double *wt, DiscontinuousFunc<Real> *u, DiscontinuousFunc<Real> *v, InterfaceGeom<Real> *e) const
+  {
+    Real result = Real(0);
+    for (int i = 0; i < n; i++)
+    {
+      Real jump_u = (u->fn_central == nullptr ? -u->val_neighbor[i] : u->val[i]);
+      Real jump_v = (v->fn_central == nullptr ? -v->val_neighbor[i] : v->val[i]);
+      result += wt[i] * (1.0 + 0.5 * e->nx[i] + 0.25 * e->ny[i]) * jump_u * jump_v;
+    }
+    return result;
+  }
+
+  virtual double value(int n, double *wt, DiscontinuousFunc<double> **u_ext, DiscontinuousFunc<double> *u, DiscontinuousFunc<double> *v,
+    InterfaceGeom<double> *e, DiscontinuousFunc<double> **ext) const
+  {
+    return matrix_form<double>(n, wt, u, v, e);
+  }
+
+  virtual Ord ord(int n, double *wt, DiscontinuousFunc<Ord> **u_ext, DiscontinuousFunc<Ord> *u, DiscontinuousFunc<Ord> *v,
+    InterfaceGeom<Ord> *e, DiscontinuousFunc<Ord> **ext) const
+  {
+    return matrix_form<Ord>(n, wt, u, v, e);
+  }
+
+  virtual MatrixFormDG<double>* clone() const
+  {
+    return new SidedJumpForm(*this);
+  }
+};
+
+// Two components on two different meshes, coupled by the volume and the interface forms.
+WeakFormSharedPtr<double> create_weak_form()
+{
+  WeakFormSharedPtr<double> wf(new WeakForm<double>(2));
+  wf->add_matrix_form(new WeakFormsH1::DefaultMatrixFormVol<double>(0, 0));
+  wf->add_matrix_form(new WeakFormsH1::DefaultMatrixFormVol<double>(1, 1));
+  wf->add_matrix_form(new WeakFormsH1::DefaultMatrixFormVol<double>(0, 1, HERMES_ANY, new Hermes2DFunction<double>(0.5), HERMES_NONSYM));
+  wf->add_matrix_form_DG(new SidedJumpForm(0, 0));
+  wf->add_matrix_form_DG(new SidedJumpForm(1, 1));
+  wf->add_matrix_form_DG(new SidedJumpForm(1, 0));
+  wf->add_vector_form(new WeakFormsH1::DefaultVectorFormVol<double>(0, HERMES_ANY, new Hermes2DFunction<double>(1.0)));
+  wf->add_vector_form(new WeakFormsH1::DefaultVectorFormVol<double>(1, HERMES_ANY, new Hermes2DFunction<double>(2.0)));
+  return wf;
+}
+
+bool identical(CSCMatrix<double>* a, SimpleVector<double>* a_rhs, CSCMatrix<double>* b, SimpleVector<double>* b_rhs)
+{
+  if (a->get_size() != b->get_size() || a->get_nnz() != b->get_nnz())
+    return false;
+  if (memcmp(a->get_Ap(), b->get_Ap(), (a->get_size() + 1) * sizeof(int)) || memcmp(a->get_Ai(), b->get_Ai(), a->get_nnz() * sizeof(int)))
+    return false;
+  if (memcmp(a->get_Ax(), b->get_Ax(), a->get_nnz() * sizeof(double)))
+    return false;
+  for (unsigned int i = 0; i < a_rhs->get_size(); i++)
+  {
+    if (a_rhs->get(i) != b_rhs->get(i))
+      return false;
+  }
+  return true;
+}
+
+// The stored neighbors of every inner edge compared with what NeighborSearch::set_active_edge() finds.
+bool check_connectivity(MeshSharedPtr mesh)
+{
+  DGFaceConnectivity<double> connectivity(mesh);
+  Element* e;
+  for_all_active_elements(e, mesh)
+  {
+    for (int edge = 0; edge < e->get_nvert(); edge++)
+    {
+      NeighborSearch<double> ns(e, mesh), stored_ns(e, mesh);
+      bool stored = connectivity.set_active_edge(&stored_ns, edge);
+      if (e->en[edge]->bnd)
+      {
+        if (stored)
+          return false;
+        continue;
+      }
+      ns.set_active_edge(edge);
+      if (!stored || ns.get_num_neighbors() != stored_ns.get_num_neighbors() || *ns.get_neighbors() != *stored_ns.get_neighbors())
+        return false;
+    }
+  }
+  if (!connectivity.is_up_to_date())
+    return false;
+  mesh->refine_element_id(mesh->get_max_element_id() - 1);
+  return !connectivity.is_up_to_date();
+}
+
+// DG assembling with the face connectivities kept in the DiscreteProblem: the stored neighbors, the reassembling with them,
+// and the reassembling after a refinement of one of the meshes (the connectivity rebuilt), each compared with a new
+// DiscreteProblem. With one thread, so that the results are bitwise identical.
+int main(int argc, char* argv[])
+{
+  MeshSharedPtr mesh(new Mesh), other_mesh(new Mesh), check_mesh(new Mesh);
+  MeshReaderH2D mloader;
+  mloader.load("square.mesh", mesh);
+  mloader.load("square.mesh", other_mesh);
+  mloader.load("square.mesh", check_mesh);
+  for (int i = 0; i < 2; i++)
+  {
+    mesh->refine_all_elements();
+    other_mesh->refine_all_elements();
+    check_mesh->refine_all_elements();
+  }
+  // Hanging nodes, different on each mesh.
+  mesh->refine_element_id(1);
+  other_mesh->refine_element_id(5);
+  check_mesh->refine_element_id(1);
+  check_mesh->refine_element_id(check_mesh->get_max_element_id() - 1);
+
+  if (!check_connectivity(check_mesh))
+  {
+    std::cout << "Failure - the stored DG face connectivity differs from the neighbor search!";
+    return -1;
+  }
+
+  int original_num_threads = HermesCommonApi.get_integral_param_value(numThreads);
+  HermesCommonApi.set_integral_param_value(numThreads, 1);
+
+  std::vector<SpaceSharedPtr<double> > spaces({ new L2Space<double>(mesh, 2), new L2Space<double>(other_mesh, 1) });
+  DiscreteProblem<double> dp(create_weak_form(), spaces, true);
+  CSCMatrix<double> matrix, reassembled_matrix;
+  SimpleVector<double> rhs, reassembled_rhs;
+  dp.assemble(&matrix, &rhs);
+  dp.assemble(&reassembled_matrix, &reassembled_rhs);
+  if (!identical(&matrix, &rhs, &reassembled_matrix, &reassembled_rhs))
+  {
+    HermesCommonApi.set_integral_param_value(numThreads, original_num_threads);
+    std::cout << "Failure - the reassembling with the stored DG face connectivity differs!";
+    return -1;
+  }
+
+  // A refinement of one mesh - the same DiscreteProblem compared with a new one.
+  other_mesh->refine_element_id(other_mesh->get_max_element_id() - 1);
+  std::vector<SpaceSharedPtr<double> > refined_spaces({ spaces[0], new L2Space<double>(other_mesh, 1) });
+  dp.set_spaces(refined_spaces);
+  CSCMatrix<double> refined_matrix, new_matrix;
+  SimpleVector<double> refined_rhs, new_rhs;
+  dp.assemble(&refined_matrix, &refined_rhs);
+  DiscreteProblem<double> new_dp(create_weak_form(), refined_spaces, true);
+  new_dp.assemble(&new_matrix, &new_rhs);
+  HermesCommonApi.set_integral_param_value(numThreads, original_num_threads);
+  if (!identical(&refined_matrix, &refined_rhs, &new_matrix, &new_rhs))
+  {
+    std::cout << "Failure - the reassembling after a mesh refinement differs!";
+    return -1;
+  }
+
+  std::cout << "Success!";
+  return 0;
+}
@@ -0,0 +1,108 @@
+#include "hermes2d.h"
+
+using namespace Hermes;
+using namespace Hermes::Hermes2D;
+
+// The element found by the MeshHashGrid and by the linear scan, both have to contain the point (on shared edges they may differ).
+// \return 1 if found by both, 0 if found by neither, -1 otherwise.
+int locate(MeshSharedPtr mesh, double x, double y)
+{
+  Element* grid_element = RefMap::element_on_physical_coordinates(true, mesh, x, y);
+  Element* scan_element = RefMap::element_on_physical_coordinates(false, mesh, x, y);
+  if (!grid_element && !scan_element)
+    return 0;
+  if (!grid_element || !scan_element)
+    return -1;
+  if (!RefMap::is_element_on_physical_coordinates(grid_element, x, y) || !RefMap::is_element_on_physical_coordinates(scan_element, x, y))
+    return -1;
+  return 1;
+}
+
+// Whether the bounding boxes of the curved elements stored in the MeshHashGrid contain their reference mappings,
+// sampled finely over the reference element.
+bool curved_boxes_enclose(MeshSharedPtr mesh)
+{
+  MeshHashGrid grid(mesh.get());
+  RefMap refmap;
+  Element* e;
+  for_all_active_elements(e, mesh)
+  {
+    if (!e->is_curved())
+      continue;
+    double2 p1, p2;
+    grid.get_element_bounding_box(e, p1, p2);
+    refmap.set_active_element(e);
+    for (int i = 0; i <= 100; i++)
+    {
+      for (int j = 0; j <= 100; j++)
+      {
+        double xi1 = -1. + i / 50., xi2 = -1. + j / 50.;
+        if (e->is_triangle() && xi1 + xi2 > 0.)
+          continue;
+        double x, y;
+        double2x2 m;
+        refmap.inv_ref_map_at_point(xi1, xi2, x, y, m);
+        if (x < p1[0] || x > p2[0] || y < p1[1] || y > p2[1])
+          return false;
+      }
+    }
+  }
+  return true;
+}
+
+// Point location with the MeshHashGrid on a mesh with curved edges (circular arcs of radius 1 from (1, 0) to (0, 1)),
+// compared with the linear scan: points in the bulges of the curved elements (outside of their straightened versions,
+// and of the bounding boxes of their vertices), on shared edges and vertices, and just outside the arcs. The bounding boxes
+// of the curved elements have to enclose them (there is no fallback to a scan of the curved elements).
+int main(int argc, char* argv[])
+{
+  MeshSharedPtr mesh(new Mesh);
+  MeshReaderH2D mloader;
+  mloader.load("domain.mesh", mesh);
+
+  for (int refinement = 0; refinement < 3; refinement++)
+  {
+    if (!curved_boxes_enclose(mesh))
+    {
+      std::cout << "Failure - a curved element outside of its bounding box (refinement " << refinement << ")!";
+      return -1;
+    }
+
+    // Curved bulges, close to the arcs.
+    for (int angle_i = 1; angle_i < 90; angle_i++)
+    {
+      double angle = angle_i * M_PI / 180.;
+      double radii[4] = { 0.9, 0.95, 0.99, 0.995 };
+      for (int radius_i = 0; radius_i < 4; radius_i++)
+      {
+        if (locate(mesh, radii[radius_i] * std::cos(angle), radii[radius_i] * std::sin(angle)) != 1)
+        {
+          std::cout << "Failure - point at the radius " << radii[radius_i] << ", angle " << angle_i << " not located (refinement " << refinement << ")!";
+          return -1;
+        }
+      }
+
+      if (locate(mesh, 1.01 * std::cos(angle), 1.01 * std::sin(angle)) != 0)
+      {
+        std::cout << "Failure - point outside of the arc at the angle " << angle_i << " located (refinement " << refinement << ")!";
+        return -1;
+      }
+    }
+
+    // Shared edges and vertices.
+    double shared_points[6][2] = { { 0.5, 0. }, { 0., 0.5 }, { 0., 0. }, { 0.35, 0.35 }, { -0.5, 0. }, { 0., -0.5 } };
+    for (int point_i = 0; point_i < 6; point_i++)
+    {
+      if (locate(mesh, shared_points[point_i][0], shared_points[point_i][1]) != 1)
+      {
+        std::cout << "Failure - point (" << shared_points[point_i][0] << ", " << shared_points[point_i][1] << ") on a shared edge not located (refinement " << refinement << ")!";
+        return -1;
+      }
+    }
+
+    mesh->refine_all_elements();
+  }
+
+  std::cout << "Success!";
+  return 0;
+}
@@ -0,0 +1,137 @@
+#include "hermes2d.h"
+
+using namespace Hermes;
+using namespace Hermes::Algebra;
+using namespace Hermes::Hermes2D;
+using namespace Hermes::Hermes2D::WeakFormsH1;
+
+// lambda(u) = 1 + u^2.
+class Nonlinearity : public Hermes1DFunction<double>
+{
+public:
+  virtual double value(double u) const { return 1. + u * u; }
+  virtual Ord value(Ord u) const { return Ord(1) + u * u; }
+  virtual double derivative(double u) const { return 2. * u; }
+  virtual Ord derivative(Ord u) const { return u; }
+};
+
+// Time-dependent source -(1 + t) x, the time taken from the weak formulation of the form.
+class TimeDependentSource : public VectorFormVol<double>
+{
+public:
+  TimeDependentSource() : VectorFormVol<double>(0) {};
+
+  virtual double value(int n, double *wt, Func<double> **u_ext, Func<double> *v, GeomVol<double> *e, Func<double> **ext) const
+  {
+    double result = 0.;
+    for (int i = 0; i < n; i++)
+      result += wt[i] * (1. + this->wf->get_current_time()) * e->x[i] * v->val[i];
+    return -result;
+  }
+
+  virtual Ord ord(int n, double *wt, Func<Ord> **u_ext, Func<Ord> *v, GeomVol<Ord> *e, Func<Ord> **ext) const
+  {
+    return e->x[0] * v->val[0];
+  }
+
+  virtual VectorFormVol<double>* clone() const
+  {
+    return new TimeDependentSource(*this);
+  }
+};
+
+// -div(lambda(u) grad u) = (1 + t) x.
+WeakFormSharedPtr<double> create_weak_form()
+{
+  WeakFormSharedPtr<double> wf(new WeakForm<double>(1));
+  wf->add_matrix_form(new DefaultJacobianDiffusion<double>(0, 0, HERMES_ANY, new Nonlinearity));
+  wf->add_vector_form(new DefaultResidualDiffusion<double>(0, HERMES_ANY, new Nonlinearity));
+  wf->add_vector_form(new TimeDependentSource);
+  return wf;
+}
+
+// The residual at coeff_vec by a new DiscreteProblem at the time.
+double get_difference(SpaceSharedPtr<double> space, double time, double* coeff_vec, SimpleVector<double>& lean_residual)
+{
+  DiscreteProblem<double> dp(create_weak_form(), space);
+  dp.set_time(time);
+  SimpleVector<double> residual;
+  dp.assemble(coeff_vec, &residual);
+
+  double max_difference = 0., max_value = 0.;
+  for (unsigned int i = 0; i < residual.get_size(); i++)
+  {
+    max_difference = std::max(max_difference, std::abs(residual.get(i) - lean_residual.get(i)));
+    max_value = std::max(max_value, std::abs(residual.get(i)));
+  }
+  return max_difference / std::max(max_value, 1e-12);
+}
+
+// DiscreteProblem::assemble_residual() reusing the states of the last assemble() compared with assemble() of a new
+// DiscreteProblem, at a different coefficient vector than the one of the last assemble(), after set_time(), and after
+// a change of the weak formulation in place followed by invalidate_lean_residual_assembling().
+int main(int argc, char* argv[])
+{
+  MeshSharedPtr mesh(new Mesh);
+  MeshReaderH2D mloader;
+  mloader.load("square.mesh", mesh);
+  mesh->refine_all_elements();
+  mesh->refine_all_elements();
+  mesh->refine_all_elements();
+
+  DefaultEssentialBCConst<double> bc("Bdy", 0.0);
+  EssentialBCs<double> bcs(&bc);
+  SpaceSharedPtr<double> space(new H1Space<double>(mesh, &bcs, 3));
+  int ndof = space->get_num_dofs();
+
+  double* coeff_vec = new double[ndof];
+  double* other_coeff_vec = new double[ndof];
+  for (int i = 0; i < ndof; i++)
+  {
+    coeff_vec[i] = 0.1 * std::sin(1.0 + i);
+    other_coeff_vec[i] = 0.2 * std::cos(2.0 + i);
+  }
+
+  WeakFormSharedPtr<double> wf = create_weak_form();
+  DiscreteProblem<double> dp(wf, space);
+  dp.set_lean_residual_assembling();
+  CSCMatrix<double> jacobian;
+  SimpleVector<double> residual, lean_residual;
+  dp.assemble(coeff_vec, &jacobian, &residual);
+
+  dp.assemble_residual(other_coeff_vec, &lean_residual);
+  double difference = get_difference(space, 0., other_coeff_vec, lean_residual);
+  if (difference > 1e-12)
+  {
+    std::cout << "Failure - the lean residual differs from assemble() by " << difference << "!";
+    return -1;
+  }
+
+  // set_time() invalidates the copies of the weak formulation.
+  dp.set_time(1.0);
+  dp.assemble_residual(other_coeff_vec, &lean_residual);
+  difference = get_difference(space, 1.0, other_coeff_vec, lean_residual);
+  if (difference > 1e-12)
+  {
+    std::cout << "Failure - the lean residual after set_time() differs from assemble() by " << difference << "!";
+    return -1;
+  }
+
+  // A change in place, invalidated explicitly.
+  dp.assemble(coeff_vec, &jacobian, &residual);
+  wf->set_current_time(2.0);
+  dp.invalidate_lean_residual_assembling();
+  dp.assemble_residual(other_coeff_vec, &lean_residual);
+  difference = get_difference(space, 2.0, other_coeff_vec, lean_residual);
+
+  delete[] coeff_vec;
+  delete[] other_coeff_vec;
+  if (difference > 1e-12)
+  {
+    std::cout << "Failure - the lean residual after invalidate_lean_residual_assembling() differs from assemble() by " << difference << "!";
+    return -1;
+  }
+
+  std::cout << "Success!";
+  return 0;
+}
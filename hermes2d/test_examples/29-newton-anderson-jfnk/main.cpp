@@ -0,0 +1,183 @@
+#include "hermes2d.h"
+
+using namespace Hermes;
+using namespace Hermes::Hermes2D;
+using namespace Hermes::Hermes2D::WeakFormsH1;
+
+// lambda(u) = 1 + u^2.
+class Nonlinearity : public Hermes1DFunction<double>
+{
+public:
+  virtual double value(double u) const { return 1. + u * u; }
+  virtual Ord value(Ord u) const { return Ord(1) + u * u; }
+  virtual double derivative(double u) const { return 2. * u; }
+  virtual Ord derivative(Ord u) const { return u; }
+};
+
+// -div(lambda(u) grad u) = 4.
+WeakFormSharedPtr<double> create_weak_form()
+{
+  WeakFormSharedPtr<double> wf(new WeakForm<double>(1));
+  wf->add_matrix_form(new DefaultJacobianDiffusion<double>(0, 0, HERMES_ANY, new Nonlinearity));
+  wf->add_vector_form(new DefaultResidualDiffusion<double>(0, HERMES_ANY, new Nonlinearity));
+  wf->add_vector_form(new DefaultVectorFormVol<double>(0, HERMES_ANY, new Hermes2DFunction<double>(-4.0)));
+  return wf;
+}
+
+// Counts the residual and Jacobian assemblings (those of the Jacobian-free steps separately), and records whether the
+// Anderson acceleration was set up.
+class CountingNewtonSolver : public NewtonSolver<double>
+{
+public:
+  CountingNewtonSolver(SpaceSharedPtr<double> space) : NewtonSolver<double>(create_weak_form(), space),
+    residual_count(0), jacobian_count(0), jfnk_residual_count(0), anderson_used(false)
+  {
+    this->set_tolerance(1e-10, Hermes::Solvers::ResidualNormAbsolute);
+  }
+
+  int residual_count;
+  int jacobian_count;
+  int jfnk_residual_count;
+  bool anderson_used;
+
+protected:
+  virtual void assemble_residual(bool store_previous_residual)
+  {
+    this->residual_count++;
+    NewtonSolver<double>::assemble_residual(store_previous_residual);
+  }
+
+  virtual bool assemble_jacobian(bool store_previous_jacobian)
+  {
+    this->jacobian_count++;
+    return NewtonSolver<double>::assemble_jacobian(store_previous_jacobian);
+  }
+
+  virtual bool assemble(bool store_previous_jacobian, bool store_previous_residual)
+  {
+    this->residual_count++;
+    this->jacobian_count++;
+    return NewtonSolver<double>::assemble(store_previous_jacobian, store_previous_residual);
+  }
+
+  virtual void assemble_jfnk_residual()
+  {
+    this->jfnk_residual_count++;
+    NewtonSolver<double>::assemble_jfnk_residual();
+  }
+
+  virtual double update_solution_return_change_norm(double* linear_system_solution)
+  {
+    this->anderson_used = this->anderson_used || this->anderson_iterates;
+    return NewtonSolver<double>::update_solution_return_change_norm(linear_system_solution);
+  }
+};
+
+// Relative difference of two vectors.
+double get_difference(double* a, double* b, int size)
+{
+  double max_difference = 0., max_value = 0.;
+  for (int i = 0; i < size; i++)
+  {
+    max_difference = std::max(max_difference, std::abs(a[i] - b[i]));
+    max_value = std::max(max_value, std::abs(a[i]));
+  }
+  return max_difference / std::max(max_value, 1e-12);
+}
+
+// The Anderson acceleration and the Jacobian-free Newton-Krylov steps compared with the plain Newton's method: the steps
+// with a recalculated Jacobian are not combined (with a non-unit beta), the Anderson acceleration of the steps with a reused
+// Jacobian (fewer assemblings or iterations than the same reuse without it), the Jacobian-free steps (their residuals by
+// assemble_jfnk_residual()), and the Anderson acceleration where the Jacobian-free steps are turned on but not used
+// (constant Jacobian).
+int main(int argc, char* argv[])
+{
+  MeshSharedPtr mesh(new Mesh);
+  MeshReaderH2D mloader;
+  mloader.load("square.mesh", mesh);
+  mesh->refine_all_elements();
+  mesh->refine_all_elements();
+
+  DefaultEssentialBCConst<double> bc("Bdy", 0.0);
+  EssentialBCs<double> bcs(&bc);
+  SpaceSharedPtr<double> space(new H1Space<double>(mesh, &bcs, 3));
+  int ndof = space->get_num_dofs();
+
+  CountingNewtonSolver newton(space);
+  newton.set_max_steps_with_reused_jacobian(0);
+  newton.solve();
+
+  // Only steps with a recalculated Jacobian - the same iterates as without the acceleration.
+  CountingNewtonSolver newton_anderson_fresh(space);
+  newton_anderson_fresh.set_max_steps_with_reused_jacobian(0);
+  newton_anderson_fresh.use_Anderson_acceleration(true);
+  newton_anderson_fresh.set_anderson_beta(0.5);
+  newton_anderson_fresh.solve();
+  double difference = get_difference(newton.get_sln_vector(), newton_anderson_fresh.get_sln_vector(), ndof);
+  if (!newton_anderson_fresh.anderson_used || newton_anderson_fresh.get_num_iters() != newton.get_num_iters() || difference > 1e-12)
+  {
+    std::cout << "Failure - the Anderson acceleration changed the steps with a recalculated Jacobian!";
+    return -1;
+  }
+
+  // The steps with a reused Jacobian without the acceleration.
+  CountingNewtonSolver newton_reuse(space);
+  newton_reuse.set_max_steps_with_reused_jacobian(5);
+  newton_reuse.set_sufficient_improvement_factor_jacobian(0.9);
+  newton_reuse.solve();
+
+  // The Anderson acceleration of the steps with a reused Jacobian.
+  CountingNewtonSolver newton_anderson(space);
+  newton_anderson.set_max_steps_with_reused_jacobian(5);
+  newton_anderson.set_sufficient_improvement_factor_jacobian(0.9);
+  newton_anderson.use_Anderson_acceleration(true);
+  newton_anderson.set_anderson_beta(0.5);
+  newton_anderson.solve();
+  difference = get_difference(newton.get_sln_vector(), newton_anderson.get_sln_vector(), ndof);
+  if (difference > 1e-8)
+  {
+    std::cout << "Failure - the solution with the Anderson acceleration differs by " << difference << "!";
+    return -1;
+  }
+  // The acceleration has to pay off - fewer assemblings, or fewer iterations.
+  int reuse_assemblings = newton_reuse.residual_count + newton_reuse.jacobian_count;
+  int anderson_assemblings = newton_anderson.residual_count + newton_anderson.jacobian_count;
+  if (!newton_anderson.anderson_used || (anderson_assemblings >= reuse_assemblings && newton_anderson.get_num_iters() >= newton_reuse.get_num_iters()))
+  {
+    std::cout << "Failure - the Anderson acceleration needed " << anderson_assemblings << " assemblings in " << newton_anderson.get_num_iters()
+      << " iterations, without it " << reuse_assemblings << " in " << newton_reuse.get_num_iters() << "!";
+    return -1;
+  }
+
+  // The Jacobian-free steps, the Anderson acceleration turned on is not used with them.
+  CountingNewtonSolver newton_jfnk(space);
+  newton_jfnk.set_max_steps_with_reused_jacobian(5);
+  newton_jfnk.set_sufficient_improvement_factor_jacobian(0.9);
+  newton_jfnk.use_Jacobian_free_Newton_Krylov(true);
+  newton_jfnk.use_Anderson_acceleration(true);
+  newton_jfnk.solve();
+  difference = get_difference(newton.get_sln_vector(), newton_jfnk.get_sln_vector(), ndof);
+  if (newton_jfnk.jfnk_residual_count == 0 || newton_jfnk.anderson_used || difference > 1e-8)
+  {
+    std::cout << "Failure - the Jacobian-free Newton-Krylov solution differs by " << difference << "!";
+    return -1;
+  }
+
+  // A constant Jacobian - no Jacobian-free steps, the Anderson acceleration used instead.
+  CountingNewtonSolver newton_constant(space);
+  newton_constant.set_jacobian_constant();
+  newton_constant.set_sufficient_improvement_factor_jacobian(0.9);
+  newton_constant.set_max_allowed_iterations(50);
+  newton_constant.use_Jacobian_free_Newton_Krylov(true);
+  newton_constant.use_Anderson_acceleration(true);
+  newton_constant.solve();
+  difference = get_difference(newton.get_sln_vector(), newton_constant.get_sln_vector(), ndof);
+  if (newton_constant.jfnk_residual_count != 0 || !newton_constant.anderson_used || difference > 1e-8)
+  {
+    std::cout << "Failure - the solution with a constant Jacobian differs by " << difference << "!";
+    return -1;
+  }
+
+  std::cout << "Success!";
+  return 0;
+}
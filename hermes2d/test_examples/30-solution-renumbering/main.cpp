@@ -0,0 +1,85 @@
+#include "hermes2d.h"
+
+using namespace Hermes;
+using namespace Hermes::Hermes2D;
+
+// Largest difference of the values of two solutions at the points of a regular grid.
+double get_difference(Solution<double>* a, Solution<double>* b)
+{
+  double max_difference = 0.;
+  for (int i = 1; i < 20; i++)
+  {
+    for (int j = 1; j < 20; j++)
+    {
+      Func<double>* value_a = a->get_pt_value(i / 20., j / 20.);
+      Func<double>* value_b = b->get_pt_value(i / 20., j / 20.);
+      max_difference = std::max(max_difference, std::abs(value_a->val[0] - value_b->val[0]));
+      delete value_a;
+      delete value_b;
+    }
+  }
+  return max_difference;
+}
+
+// The incremental Solution::set_coeff_vector() (through vector_to_solution()) reusing one Solution instance, compared with
+// new Solutions: after a change of a part of the coefficients, and after a renumbering of the space by set_essential_bcs()
+// and assign_dofs() - the same seq and number of DOFs, but a different DOF numbering (and Dirichlet lift), so that the
+// monomial coefficients have to be calculated again even though the coefficient vector is the same.
+int main(int argc, char* argv[])
+{
+  MeshSharedPtr mesh(new Mesh);
+  MeshReaderH2D mloader;
+  mloader.load("square.mesh", mesh);
+  mesh->refine_all_elements();
+  mesh->refine_all_elements();
+
+  DefaultEssentialBCConst<double> bc_bottom("Bottom", 1.0), bc_top("Top", 1.0);
+  EssentialBCs<double> bcs_bottom(&bc_bottom), bcs_top(&bc_top);
+  SpaceSharedPtr<double> space(new H1Space<double>(mesh, &bcs_bottom, 3));
+  int ndof = space->get_num_dofs();
+
+  double* coeff_vec = new double[ndof];
+  for (int i = 0; i < ndof; i++)
+    coeff_vec[i] = std::sin(1.0 + i);
+
+  Solution<double> sln;
+  Solution<double>::vector_to_solution(coeff_vec, space, &sln);
+
+  // A part of the coefficients changed - the incremental update.
+  for (int i = 0; i < ndof; i += 3)
+    coeff_vec[i] *= 2.0;
+  Solution<double>::vector_to_solution(coeff_vec, space, &sln);
+  Solution<double> new_sln(space, coeff_vec);
+  double difference = get_difference(&sln, &new_sln);
+  if (difference > 1e-12)
+  {
+    delete[] coeff_vec;
+    std::cout << "Failure - the incremental update differs by " << difference << "!";
+    return -1;
+  }
+
+  // The Dirichlet condition moved to the opposite side - the same seq and number of DOFs, a new numbering.
+  int seq = space->get_seq();
+  unsigned int stamp = space->get_dof_assignment_stamp();
+  space->set_essential_bcs(&bcs_top);
+  space->assign_dofs();
+  if (space->get_seq() != seq || space->get_num_dofs() != ndof || space->get_dof_assignment_stamp() == stamp)
+  {
+    delete[] coeff_vec;
+    std::cout << "Failure - the renumbering is not the one this test needs!";
+    return -1;
+  }
+
+  Solution<double>::vector_to_solution(coeff_vec, space, &sln);
+  Solution<double> renumbered_sln(space, coeff_vec);
+  difference = get_difference(&sln, &renumbered_sln);
+  delete[] coeff_vec;
+  if (difference > 1e-12)
+  {
+    std::cout << "Failure - the monomials were not recalculated after the renumbering, difference " << difference << "!";
+    return -1;
+  }
+
+  std::cout << "Success!";
+  return 0;
+}
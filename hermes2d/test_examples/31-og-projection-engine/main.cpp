@@ -0,0 +1,149 @@
+#include "hermes2d.h"
+
+using namespace Hermes;
+using namespace Hermes::Hermes2D;
+
+// The projection by a new LinearSolver with the global mass matrix.
+void project_with_linear_solver(SpaceSharedPtr<double> space, MeshFunctionSharedPtr<double> source, NormType norm, double* target_vec)
+{
+  WeakFormSharedPtr<double> wf(new WeakForm<double>(1));
+  wf->set_verbose_output(false);
+  wf->set_ext(source);
+  wf->add_matrix_form(new MatrixDefaultNormFormVol<double>(0, 0, norm));
+  wf->add_vector_form(new VectorDefaultNormFormVol<double>(0, norm));
+  LinearSolver<double> solver(wf, space, true);
+  solver.set_verbose_output(false);
+  solver.solve();
+  memcpy(target_vec, solver.get_sln_vector(), space->get_num_dofs() * sizeof(double));
+}
+
+// Relative difference of two vectors.
+double get_difference(double* a, double* b, int size)
+{
+  double max_difference = 0., max_value = 0.;
+  for (int i = 0; i < size; i++)
+  {
+    max_difference = std::max(max_difference, std::abs(a[i] - b[i]));
+    max_value = std::max(max_value, std::abs(a[i]));
+  }
+  return max_difference / std::max(max_value, 1e-12);
+}
+
+// Projects source by the engine and by a new LinearSolver.
+double get_engine_difference(OGProjectionEngine<double>& engine, SpaceSharedPtr<double> space, MeshFunctionSharedPtr<double> source, NormType norm)
+{
+  int ndof = space->get_num_dofs();
+  double* engine_vec = new double[ndof];
+  double* vec = new double[ndof];
+  engine.project(space, source, engine_vec, norm);
+  project_with_linear_solver(space, source, norm, vec);
+  double difference = get_difference(vec, engine_vec, ndof);
+  delete[] engine_vec;
+  delete[] vec;
+  return difference;
+}
+
+// OGProjectionEngine compared with the projection by a new LinearSolver: the element-wise L2 projection (elements with
+// a constant jacobian using the reference blocks, curved elements their own), the reused factorized global mass matrix for
+// another source, after a refinement of the mesh, and after new essential BCs (the same seq of the space, a new DOF
+// numbering). And a LinearSolver with set_jacobian_constant() after new essential BCs.
+int main(int argc, char* argv[])
+{
+  MeshSharedPtr mesh(new Mesh), target_mesh(new Mesh);
+  MeshReaderH2D mloader;
+  mloader.load("domain.mesh", mesh);
+  mloader.load("domain.mesh", target_mesh);
+  mesh->refine_all_elements();
+  mesh->refine_all_elements();
+  target_mesh->refine_all_elements();
+  // Hanging nodes.
+  target_mesh->refine_element_id(target_mesh->get_max_element_id() - 1);
+
+  // Sources on the other mesh.
+  SpaceSharedPtr<double> source_space(new H1Space<double>(mesh, 4));
+  int source_ndof = source_space->get_num_dofs();
+  double* source_vec = new double[source_ndof];
+  double* other_source_vec = new double[source_ndof];
+  for (int i = 0; i < source_ndof; i++)
+  {
+    source_vec[i] = std::sin(1.0 + i);
+    other_source_vec[i] = std::cos(2.0 + i);
+  }
+  MeshFunctionSharedPtr<double> source(new Solution<double>(source_space, source_vec));
+  MeshFunctionSharedPtr<double> other_source(new Solution<double>(source_space, other_source_vec));
+  delete[] source_vec;
+  delete[] other_source_vec;
+
+  OGProjectionEngine<double> engine;
+
+  // Element-wise, twice (the second time with the stored reference blocks).
+  SpaceSharedPtr<double> l2_space(new L2Space<double>(target_mesh, 3));
+  for (int i = 0; i < 2; i++)
+  {
+    double difference = get_engine_difference(engine, l2_space, i ? other_source : source, HERMES_L2_NORM);
+    if (difference > 1e-10)
+    {
+      std::cout << "Failure - the element-wise L2 projection differs by " << difference << "!";
+      return -1;
+    }
+  }
+
+  // Global, the factorization reused for the other source.
+  DefaultEssentialBCConst<double> bc_bottom("Bottom", 1.0), bc_left("Left", 2.0);
+  EssentialBCs<double> bcs_bottom(&bc_bottom), bcs_left(&bc_left);
+  SpaceSharedPtr<double> h1_space(new H1Space<double>(target_mesh, &bcs_bottom, 3));
+  for (int i = 0; i < 2; i++)
+  {
+    double difference = get_engine_difference(engine, h1_space, i ? other_source : source, HERMES_H1_NORM);
+    if (difference > 1e-10)
+    {
+      std::cout << "Failure - the projection with the reused mass matrix differs by " << difference << "!";
+      return -1;
+    }
+  }
+
+  // A refinement of the mesh.
+  target_mesh->refine_element_id(target_mesh->get_max_element_id() - 1);
+  h1_space->assign_dofs();
+  double difference = get_engine_difference(engine, h1_space, source, HERMES_H1_NORM);
+  if (difference > 1e-10)
+  {
+    std::cout << "Failure - the projection after a mesh refinement differs by " << difference << "!";
+    return -1;
+  }
+
+  // New essential BCs.
+  h1_space->set_essential_bcs(&bcs_left);
+  difference = get_engine_difference(engine, h1_space, source, HERMES_H1_NORM);
+  if (difference > 1e-10)
+  {
+    std::cout << "Failure - the projection after new essential BCs differs by " << difference << "!";
+    return -1;
+  }
+
+  // A LinearSolver with a constant matrix, the essential BCs changed back.
+  WeakFormSharedPtr<double> wf(new WeakForm<double>(1));
+  wf->set_verbose_output(false);
+  wf->set_ext(source);
+  wf->add_matrix_form(new MatrixDefaultNormFormVol<double>(0, 0, HERMES_H1_NORM));
+  wf->add_vector_form(new VectorDefaultNormFormVol<double>(0, HERMES_H1_NORM));
+  LinearSolver<double> solver(wf, h1_space, true);
+  solver.set_verbose_output(false);
+  solver.set_jacobian_constant();
+  solver.solve();
+  h1_space->set_essential_bcs(&bcs_bottom);
+  solver.solve();
+  int ndof = h1_space->get_num_dofs();
+  double* vec = new double[ndof];
+  project_with_linear_solver(h1_space, source, HERMES_H1_NORM, vec);
+  difference = get_difference(vec, solver.get_sln_vector(), ndof);
+  delete[] vec;
+  if (difference > 1e-10)
+  {
+    std::cout << "Failure - the constant matrix of a LinearSolver was reused after new essential BCs, difference " << difference << "!";
+    return -1;
+  }
+
+  std::cout << "Success!";
+  return 0;
+}
@@ -0,0 +1,200 @@
+#include "hermes2d.h"
+
+using namespace Hermes;
+using namespace Hermes::Hermes2D;
+
+int get_edge_degree(MeshSharedPtr mesh, Node* v1, Node* v2)
+{
+  Node* v3 = mesh->peek_vertex_node(v1->id, v2->id);
+  return v3 ? 1 + std::max(get_edge_degree(mesh, v1, v3), get_edge_degree(mesh, v3, v2)) : 0;
+}
+
+// The serial loop of Mesh::regularize(n) for n >= 1 refining the elements one by one - the reference.
+std::vector<int> regularize_serially(MeshSharedPtr mesh, int n)
+{
+  Element* e;
+  std::vector<int> parents(mesh->get_max_element_id());
+  for_all_active_elements(e, mesh)
+    parents[e->id] = e->id;
+
+  bool ok;
+  do
+  {
+    ok = true;
+    for_all_active_elements(e, mesh)
+    {
+      int iso = -1;
+      if (e->is_triangle())
+      {
+        for (unsigned int i = 0; i < e->get_nvert(); i++)
+        {
+          if (get_edge_degree(mesh, e->vn[i], e->vn[e->next_vert(i)]) > n)
+          {
+            iso = 0; ok = false; break;
+          }
+        }
+      }
+      else
+      {
+        if (((get_edge_degree(mesh, e->vn[0], e->vn[1]) > n) || (get_edge_degree(mesh, e->vn[2], e->vn[3]) > n))
+          && (get_edge_degree(mesh, e->vn[1], e->vn[2]) <= n) && (get_edge_degree(mesh, e->vn[3], e->vn[0]) <= n))
+        {
+          iso = 2; ok = false;
+        }
+        else if ((get_edge_degree(mesh, e->vn[0], e->vn[1]) <= n) && (get_edge_degree(mesh, e->vn[2], e->vn[3]) <= n)
+          && ((get_edge_degree(mesh, e->vn[1], e->vn[2]) > n) || (get_edge_degree(mesh, e->vn[3], e->vn[0]) > n)))
+        {
+          iso = 1; ok = false;
+        }
+        else
+        {
+          for (unsigned int i = 0; i < e->get_nvert(); i++)
+          {
+            if (get_edge_degree(mesh, e->vn[i], e->vn[e->next_vert(i)]) > n)
+            {
+              iso = 0; ok = false; break;
+            }
+          }
+        }
+      }
+
+      if (iso >= 0)
+      {
+        mesh->refine_element_id(e->id, iso);
+        for (int i = 0; i < 4; i++)
+        {
+          if (e->sons[i])
+          {
+            if (e->sons[i]->id >= (int)parents.size())
+              parents.resize(2 * e->sons[i]->id);
+            parents[e->sons[i]->id] = parents[e->id];
+          }
+        }
+      }
+    }
+  } while (!ok);
+
+  return parents;
+}
+
+// Several levels of hanging nodes: nested refinements towards one point, anisotropic refinements of a quad, and nested
+// refinements of a triangle.
+MeshSharedPtr create_mesh()
+{
+  MeshSharedPtr mesh(new Mesh);
+  MeshReaderH2D mloader;
+  mloader.load("domain.mesh", mesh);
+  mesh->refine_all_elements();
+
+  for (int i = 0; i < 4; i++)
+    mesh->refine_element_id(mesh->get_max_element_id() - 1);
+
+  Element* e;
+  for_all_active_elements(e, mesh)
+  {
+    if (e->is_quad())
+    {
+      mesh->refine_element_id(e->id, 1);
+      mesh->refine_element_id(mesh->get_max_element_id() - 1, 2);
+      mesh->refine_element_id(mesh->get_max_element_id() - 1, 1);
+      break;
+    }
+  }
+
+  for_all_active_elements(e, mesh)
+  {
+    if (e->is_triangle())
+    {
+      mesh->refine_element_id(e->id);
+      for (int i = 0; i < 3; i++)
+        mesh->refine_element_id(mesh->get_max_element_id() - 2);
+      break;
+    }
+  }
+
+  return mesh;
+}
+
+// The same elements (ids, activity, vertices) in both meshes.
+bool same(MeshSharedPtr a, MeshSharedPtr b)
+{
+  if (a->get_max_element_id() != b->get_max_element_id() || a->get_num_active_elements() != b->get_num_active_elements())
+    return false;
+
+  for (int id = 0; id < a->get_max_element_id(); id++)
+  {
+    Element* e_a = a->get_element_fast(id);
+    Element* e_b = b->get_element_fast(id);
+    if (e_a->used != e_b->used)
+      return false;
+    if (!e_a->used)
+      continue;
+    if (e_a->active != e_b->active || e_a->get_nvert() != e_b->get_nvert())
+      return false;
+    for (unsigned int i = 0; i < e_a->get_nvert(); i++)
+    {
+      if (e_a->vn[i]->id != e_b->vn[i]->id || e_a->vn[i]->x != e_b->vn[i]->x || e_a->vn[i]->y != e_b->vn[i]->y)
+        return false;
+    }
+  }
+  return true;
+}
+
+// Mesh::regularize(1) (the sweeps with the decisions made in parallel) and Mesh::refine_elements() (the batch) compared with
+// the serial loop refining the elements one by one, on a mesh with several levels of hanging nodes, with one and more
+// threads: the same refinements (types of the refined quads included), element ids and parents.
+int main(int argc, char* argv[])
+{
+  int original_num_threads = HermesCommonApi.get_integral_param_value(numThreads);
+  int thread_counts[2] = { 1, 4 };
+  for (int t = 0; t < 2; t++)
+  {
+    HermesCommonApi.set_integral_param_value(numThreads, thread_counts[t]);
+
+    MeshSharedPtr mesh = create_mesh(), reference_mesh = create_mesh();
+    int* parents = mesh->regularize(1);
+    std::vector<int> reference_parents = regularize_serially(reference_mesh, 1);
+    if (!same(mesh, reference_mesh))
+    {
+      free_with_check(parents);
+      std::cout << "Failure - regularize(1) with " << thread_counts[t] << " threads differs from the serial loop!";
+      return -1;
+    }
+
+    Element* e;
+    for_all_active_elements(e, mesh)
+    {
+      if (parents[e->id] != reference_parents[e->id])
+      {
+        free_with_check(parents);
+        std::cout << "Failure - regularize(1) with " << thread_counts[t] << " threads gives a different parent of element " << e->id << "!";
+        return -1;
+      }
+    }
+    free_with_check(parents);
+
+    // Every third active element, the quads in all three ways.
+    MeshSharedPtr batch_mesh = create_mesh(), one_by_one_mesh = create_mesh();
+    std::vector<int> ids, refinements;
+    for_all_active_elements(e, batch_mesh)
+    {
+      if (e->id % 3 == 0)
+      {
+        ids.push_back(e->id);
+        refinements.push_back(e->is_triangle() ? 0 : (int)ids.size() % 3);
+      }
+    }
+    batch_mesh->refine_elements(ids, refinements);
+    for (unsigned int i = 0; i < ids.size(); i++)
+      one_by_one_mesh->refine_element_id(ids[i], refinements[i]);
+    if (!same(batch_mesh, one_by_one_mesh))
+    {
+      std::cout << "Failure - refine_elements() with " << thread_counts[t] << " threads differs from refine_element_id()!";
+      return -1;
+    }
+  }
+  HermesCommonApi.set_integral_param_value(numThreads, original_num_threads);
+
+  std::cout << "Success!";
+  return 0;
+}
@@ -0,0 +1,94 @@
+#include "hermes2d.h"
+
+using namespace Hermes;
+using namespace Hermes::Hermes2D;
+
+// A solution with untransformed derivatives, those of the reference element as in get_ref_value().
+template<typename Scalar>
+class ReferenceSolution : public Solution<Scalar>
+{
+public:
+  ReferenceSolution(SpaceSharedPtr<Scalar> space, Scalar* coeff_vec) : Solution<Scalar>(space, coeff_vec)
+  {
+    this->enable_transform(false);
+  }
+};
+
+// Largest difference (relative to the largest value) of the values and reference derivatives of the solution at the
+// integration points of the order quad_order (the order-specialized kernels of Solution::precalculate()), and of the
+// generic Horner's scheme of Solution::get_ref_value(), on all elements.
+template<typename Scalar>
+double get_difference(Solution<Scalar>& sln, MeshSharedPtr mesh, int quad_order)
+{
+  double max_difference = 0., max_value = 0.;
+  Element* e;
+  for_all_active_elements(e, mesh)
+  {
+    sln.set_active_element(e);
+    sln.set_quad_order(quad_order, H2D_FN_DEFAULT);
+    int np = sln.get_quad_2d()->get_num_points(quad_order, e->get_mode());
+    double3* pt = sln.get_quad_2d()->get_points(quad_order, e->get_mode());
+
+    std::vector<Scalar> values[3];
+    for (int item = 0; item < 3; item++)
+      values[item].assign(sln.get_values(0, item), sln.get_values(0, item) + np);
+
+    for (int item = 0; item < 3; item++)
+    {
+      for (int i = 0; i < np; i++)
+      {
+        Scalar value = sln.get_ref_value(e, pt[i][0], pt[i][1], 0, item);
+        max_difference = std::max(max_difference, std::abs(values[item][i] - value));
+        max_value = std::max(max_value, std::abs(value));
+      }
+    }
+  }
+  return max_difference / std::max(max_value, 1e-12);
+}
+
+// Solutions of all orders on triangles and quads.
+template<typename Scalar>
+bool check_orders(MeshSharedPtr mesh, Scalar coefficient_multiplier)
+{
+  for (int order = 0; order <= H2DRS_MAX_ORDER; order++)
+  {
+    SpaceSharedPtr<Scalar> space(new L2Space<Scalar>(mesh, order));
+    int ndof = space->get_num_dofs();
+    Scalar* coeff_vec = new Scalar[ndof];
+    for (int i = 0; i < ndof; i++)
+      coeff_vec[i] = std::sin(1.0 + i) * coefficient_multiplier;
+    ReferenceSolution<Scalar> sln(space, coeff_vec);
+    delete[] coeff_vec;
+
+    // Fewer points than one block of the kernels, and several blocks with a remainder.
+    int quad_orders[2] = { 2, 19 };
+    for (int q = 0; q < 2; q++)
+    {
+      double difference = get_difference(sln, mesh, quad_orders[q]);
+      if (difference > 1e-12)
+      {
+        std::cout << "Failure - the kernel of the order " << order << " differs by " << difference << "!";
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+// The order-specialized polynomial kernels of Solution::precalculate() compared with the generic evaluation
+// Solution::get_ref_value(), for all orders 0, ..., H2DRS_MAX_ORDER, on triangles and quads, real and complex.
+int main(int argc, char* argv[])
+{
+  MeshSharedPtr mesh(new Mesh);
+  MeshReaderH2D mloader;
+  mloader.load("domain.mesh", mesh);
+
+  if (!check_orders<double>(mesh, 1.0))
+    return -1;
+
+  if (!check_orders<std::complex<double> >(mesh, std::complex<double>(1.0, -2.0)))
+    return -1;
+
+  std::cout << "Success!";
+  return 0;
+}
@@ -0,0 +1,124 @@
+#include "hermes2d.h"
+
+using namespace Hermes;
+using namespace Hermes::Hermes2D;
+
+// u = 1 + t x^2 on the boundary, a Dirichlet lift changing with the time.
+class TimeDependentEssentialBC : public EssentialBoundaryCondition<double>
+{
+public:
+  TimeDependentEssentialBC(std::string marker) : EssentialBoundaryCondition<double>(marker) {};
+
+  virtual double value(double x, double y) const
+  {
+    return 1. + this->get_current_time() * x * x;
+  }
+
+  virtual EssentialBCValueType get_value_type() const
+  {
+    return BC_FUNCTION;
+  }
+};
+
+// The triplets (idx, dof, coef) of the assembly lists of all active elements.
+class AssemblyLists
+{
+public:
+  AssemblyLists(SpaceSharedPtr<double> space)
+  {
+    AsmList<double> al;
+    Element* e;
+    for_all_active_elements(e, space->get_mesh())
+    {
+      space->get_element_assembly_list(e, &al);
+      for (unsigned int i = 0; i < al.cnt; i++)
+      {
+        idx.push_back(al.idx[i]);
+        dof.push_back(al.dof[i]);
+        coef.push_back(al.coef[i]);
+      }
+    }
+  }
+
+  bool operator==(const AssemblyLists& other) const
+  {
+    return idx == other.idx && dof == other.dof && coef == other.coef;
+  }
+
+  std::vector<int> idx, dof;
+  std::vector<double> coef;
+};
+
+// The assembly lists of a space with the cached lists compared with those of a space without the cache: when built,
+// after a new DOF numbering by set_essential_bcs() and assign_dofs() (the same seq), and after new Dirichlet values by
+// update_essential_bc_values() (the same seq and numbering) - both before and after the cache is built again.
+int main(int argc, char* argv[])
+{
+  MeshSharedPtr mesh(new Mesh);
+  MeshReaderH2D mloader;
+  mloader.load("square.mesh", mesh);
+  mesh->refine_all_elements();
+  mesh->refine_all_elements();
+  // Hanging nodes.
+  mesh->refine_element_id(mesh->get_max_element_id() - 1);
+
+  TimeDependentEssentialBC bc_bottom("Bottom"), bc_top("Top");
+  EssentialBCs<double> bcs_bottom(&bc_bottom), bcs_top(&bc_top);
+  SpaceSharedPtr<double> space(new H1Space<double>(mesh, &bcs_bottom, 3));
+  SpaceSharedPtr<double> reference_space(new H1Space<double>(mesh, &bcs_bottom, 3));
+  space->set_assembly_list_caching();
+  space->update_assembly_list_cache();
+  AssemblyLists lists(space);
+  if (!(lists == AssemblyLists(reference_space)))
+  {
+    std::cout << "Failure - the cached assembly lists differ!";
+    return -1;
+  }
+
+  // A new DOF numbering with the same seq.
+  int seq = space->get_seq();
+  space->set_essential_bcs(&bcs_top);
+  space->assign_dofs();
+  reference_space->set_essential_bcs(&bcs_top);
+  reference_space->assign_dofs();
+  AssemblyLists renumbered_lists(reference_space);
+  if (space->get_seq() != seq || renumbered_lists == lists)
+  {
+    std::cout << "Failure - the renumbering is not the one this test needs!";
+    return -1;
+  }
+  for (int i = 0; i < 2; i++)
+  {
+    if (i)
+      space->update_assembly_list_cache();
+    if (!(AssemblyLists(space) == renumbered_lists))
+    {
+      std::cout << "Failure - the assembly lists cached before assign_dofs() were used!";
+      return -1;
+    }
+  }
+
+  // New Dirichlet values with the same seq and numbering.
+  space->update_assembly_list_cache();
+  Space<double>::update_essential_bc_values(space, 1.0);
+  Space<double>::update_essential_bc_values(reference_space, 1.0);
+  AssemblyLists updated_lists(reference_space);
+  if (space->get_seq() != seq || updated_lists == renumbered_lists)
+  {
+    std::cout << "Failure - the new Dirichlet values are not the ones this test needs!";
+    return -1;
+  }
+  for (int i = 0; i < 2; i++)
+  {
+    if (i)
+      space->update_assembly_list_cache();
+    if (!(AssemblyLists(space) == updated_lists))
+    {
+      std::cout << "Failure - the assembly lists cached before update_essential_bc_values() were used!";
+      return -1;
+    }
+  }
+
+  std::cout << "Success!";
+  return 0;
+}
@@ -0,0 +1,128 @@
+#include "hermes2d.h"
+
+using namespace Hermes;
+using namespace Hermes::Hermes2D;
+
+static const int num_orders = 2;
+static const int orders[num_orders] = { 4, 12 };
+
+// The geometry of the active element of a RefMap using the cache and of one without it, bitwise.
+bool same_geometry(RefMap& cached_rm, RefMap& rm)
+{
+  Element* e = rm.get_active_element();
+  for (int o = 0; o < num_orders; o++)
+  {
+    int np = g_quad_2d_std.get_num_points(orders[o], e->get_mode());
+    if (memcmp(cached_rm.get_jacobian(orders[o]), rm.get_jacobian(orders[o]), np * sizeof(double))
+      || memcmp(cached_rm.get_inv_ref_map(orders[o]), rm.get_inv_ref_map(orders[o]), np * sizeof(double2x2))
+      || memcmp(cached_rm.get_phys_x(orders[o]), rm.get_phys_x(orders[o]), np * sizeof(double))
+      || memcmp(cached_rm.get_phys_y(orders[o]), rm.get_phys_y(orders[o]), np * sizeof(double)))
+      return false;
+
+    for (unsigned char edge = 0; edge < e->get_nvert(); edge++)
+    {
+      int eo = g_quad_2d_std.get_edge_points(edge, orders[o], e->get_mode());
+      int edge_np = g_quad_2d_std.get_num_points(eo, e->get_mode());
+      if (memcmp(cached_rm.get_tangent(edge, eo), rm.get_tangent(edge, eo), edge_np * sizeof(double3)))
+        return false;
+    }
+  }
+  return true;
+}
+
+// The geometry of all curved elements and of their sons (sub-element transformations) with and without the cache.
+bool same_geometry(MeshSharedPtr mesh, MeshGeometryCache* cache)
+{
+  RefMap cached_rm, rm;
+  cached_rm.set_geometry_cache(cache);
+  Element* e;
+  for_all_active_elements(e, mesh)
+  {
+    if (!e->is_curved())
+      continue;
+
+    cached_rm.set_active_element(e);
+    rm.set_active_element(e);
+    if (!same_geometry(cached_rm, rm))
+      return false;
+
+    for (int son = 0; son < 4; son++)
+    {
+      cached_rm.push_transform(son);
+      rm.push_transform(son);
+      bool same = same_geometry(cached_rm, rm);
+      cached_rm.pop_transform();
+      rm.pop_transform();
+      if (!same)
+        return false;
+    }
+  }
+  return true;
+}
+
+// Some curved element.
+Element* get_curved_element(MeshSharedPtr mesh)
+{
+  Element* e;
+  for_all_active_elements(e, mesh)
+  {
+    if (e->is_curved())
+      return e;
+  }
+  return nullptr;
+}
+
+// MeshGeometryCache: the RefMaps using the cache compared with those without it, when the values are computed and stored
+// (pending), and when they are taken from the cache (published by the next Mesh::get_geometry_cache()). A change of the
+// mesh (its seq) replaces the cache with an empty one.
+int main(int argc, char* argv[])
+{
+  MeshSharedPtr mesh(new Mesh);
+  MeshReaderH2D mloader;
+  mloader.load("domain.mesh", mesh);
+  mesh->refine_all_elements();
+  mesh->set_geometry_caching();
+
+  for (int refinement = 0; refinement < 2; refinement++)
+  {
+    MeshGeometryCache* cache = mesh->get_geometry_cache();
+    Element* e = get_curved_element(mesh);
+    double x[H2D_MAX_INTEGRATION_POINTS_COUNT];
+    if (cache->get_size_in_bytes() != 0 || cache->get(e->id, 0, MeshGeometryCache::GeometryCachePhysX, orders[0], x))
+    {
+      std::cout << "Failure - the geometry cache is not empty for a new mesh!";
+      return -1;
+    }
+
+    // Computed and stored.
+    if (!same_geometry(mesh, cache))
+    {
+      std::cout << "Failure - the geometry computed with the cache differs!";
+      return -1;
+    }
+
+    // Taken from the cache.
+    if (mesh->get_geometry_cache() != cache || !cache->get(e->id, 0, MeshGeometryCache::GeometryCachePhysX, orders[0], x))
+    {
+      std::cout << "Failure - the geometry was not stored in the cache!";
+      return -1;
+    }
+    if (!same_geometry(mesh, cache))
+    {
+      std::cout << "Failure - the geometry taken from the cache differs!";
+      return -1;
+    }
+
+    // A new seq of the mesh.
+    int seq = mesh->get_seq();
+    mesh->refine_element_id(e->id);
+    if (mesh->get_seq() == seq || cache->is_up_to_date(mesh.get()))
+    {
+      std::cout << "Failure - the geometry cache is up to date after a refinement of the mesh!";
+      return -1;
+    }
+  }
+
+  std::cout << "Success!";
+  return 0;
+}
@@ -0,0 +1,100 @@
+#include "hermes2d.h"
+
+using namespace Hermes;
+using namespace Hermes::Hermes2D;
+
+static const int num_orders = 2;
+static const int orders[num_orders] = { 4, 12 };
+
+// The geometry of the active elements of two RefMaps (computed from the reference mapping coefficients), bitwise.
+bool same_geometry(RefMap& rm, RefMap& other_rm)
+{
+  Element* e = rm.get_active_element();
+  for (int o = 0; o < num_orders; o++)
+  {
+    int np = g_quad_2d_std.get_num_points(orders[o], e->get_mode());
+    if (memcmp(rm.get_jacobian(orders[o]), other_rm.get_jacobian(orders[o]), np * sizeof(double))
+      || memcmp(rm.get_inv_ref_map(orders[o]), other_rm.get_inv_ref_map(orders[o]), np * sizeof(double2x2))
+      || memcmp(rm.get_phys_x(orders[o]), other_rm.get_phys_x(orders[o]), np * sizeof(double))
+      || memcmp(rm.get_phys_y(orders[o]), other_rm.get_phys_y(orders[o]), np * sizeof(double)))
+      return false;
+
+    for (unsigned char edge = 0; edge < e->get_nvert(); edge++)
+    {
+      int eo = g_quad_2d_std.get_edge_points(edge, orders[o], e->get_mode());
+      int edge_np = g_quad_2d_std.get_num_points(eo, e->get_mode());
+      if (memcmp(rm.get_tangent(edge, eo), other_rm.get_tangent(edge, eo), edge_np * sizeof(double3)))
+        return false;
+    }
+  }
+  return true;
+}
+
+// The same curved elements with the same reference mappings, and the same inverse reference map orders, in both meshes.
+bool same_refmaps(MeshSharedPtr mesh, MeshSharedPtr other_mesh)
+{
+  if (mesh->get_max_element_id() != other_mesh->get_max_element_id())
+    return false;
+
+  RefMap rm, other_rm;
+  Element* e;
+  for_all_used_elements(e, mesh)
+  {
+    Element* other_e = other_mesh->get_element_fast(e->id);
+    if (!other_e->used || e->active != other_e->active || e->iro_cache != other_e->iro_cache || !e->cm != !other_e->cm)
+      return false;
+    if (!e->active || !e->cm)
+      continue;
+
+    rm.set_active_element(e);
+    other_rm.set_active_element(other_e);
+    if (!same_geometry(rm, other_rm))
+      return false;
+  }
+  return true;
+}
+
+MeshSharedPtr load_mesh(int num_threads)
+{
+  HermesCommonApi.set_integral_param_value(numThreads, num_threads);
+  MeshSharedPtr mesh(new Mesh);
+  MeshReaderH2D mloader;
+  mloader.load("domain.mesh", mesh);
+  return mesh;
+}
+
+// The reference mapping coefficients of the curved elements computed in parallel - by Mesh::update_all_refmap_coeffs() when
+// the mesh is loaded, and for the curved sons after Mesh::refine_all_elements() - compared with those computed by one
+// thread, through the geometry of the reference maps (bitwise) and the inverse reference map orders.
+int main(int argc, char* argv[])
+{
+  int original_num_threads = HermesCommonApi.get_integral_param_value(numThreads);
+
+  MeshSharedPtr serial_mesh = load_mesh(1);
+  MeshSharedPtr parallel_mesh = load_mesh(4);
+  if (!same_refmaps(serial_mesh, parallel_mesh))
+  {
+    HermesCommonApi.set_integral_param_value(numThreads, original_num_threads);
+    std::cout << "Failure - the reference mappings of the loaded mesh differ with 4 threads!";
+    return -1;
+  }
+
+  // Enough curved sons for several chunks of the parallel loop.
+  for (int i = 0; i < 3; i++)
+  {
+    HermesCommonApi.set_integral_param_value(numThreads, 1);
+    serial_mesh->refine_all_elements();
+    HermesCommonApi.set_integral_param_value(numThreads, 4);
+    parallel_mesh->refine_all_elements();
+  }
+  HermesCommonApi.set_integral_param_value(numThreads, original_num_threads);
+
+  if (!same_refmaps(serial_mesh, parallel_mesh))
+  {
+    std::cout << "Failure - the reference mappings of the refined mesh differ with 4 threads!";
+    return -1;
+  }
+
+  std::cout << "Success!";
+  return 0;
+}
@@ -37,6 +37,8 @@ namespace Hermes
     SOLVER_AMESOS = 6,
     SOLVER_AZTECOO = 7,
     SOLVER_EXTERNAL = 8,
+    // Hierarchical p-multigrid, implemented in Hermes2D (PMultigridSolver), needs the spaces.
+    SOLVER_PMULTIGRID = 9,
     SOLVER_EMPTY = 100
   };
 
@@ -54,7 +56,8 @@ namespace Hermes
   {
     ITERATIVE_SOLVER_PARALUTION = 1,
     ITERATIVE_SOLVER_PETSC = 3,
-    ITERATIVE_SOLVER_AZTECOO = 7
+    ITERATIVE_SOLVER_AZTECOO = 7,
+    ITERATIVE_SOLVER_PMULTIGRID = 9
   };
 
   enum AMGMatrixSolverType
@@ -67,6 +67,8 @@ namespace Hermes
 
       /// Allocate utility storage (row, column indices, etc.).
       virtual void alloc();
+      /// Copies the column-compressed arrays of the pattern.
+      virtual void alloc_from_pattern(const SparsityPattern* pattern);
       // Allocate data storage.
       virtual void alloc_data();
       /// Utility method.
@@ -154,6 +156,61 @@ namespace Hermes
       SparseMatrix<Scalar>* duplicate() const;
     };
 
+    /// \brief CSC Matrix class for symmetric matrices, only the lower triangle (row >= column) is stored.
+    /// Meant for matrices assembled from symmetric forms (both (i, j) and (j, i) are assembled, the entries
+    /// above the diagonal are skipped), the assembled matrix has to be symmetric - this is not checked.
+    /// Complex matrices are complex symmetric (A = A^T), not Hermitian.
+    /// Direct solvers: UMFPACK (expanded to the full storage), MUMPS (symmetric mode), see create_full_matrix().
+    /// Returned by create_matrix() if the parameter useSymmetricMatrices of HermesCommonApi is set.
+    /// Operations that would break the symmetry (set_row_zero(), off-diagonal blocks) throw.
+    template <typename Scalar>
+    class HERMES_API SymmetricCSCMatrix : public CSCMatrix < Scalar >
+    {
+    public:
+      /// \brief Default constructor.
+      SymmetricCSCMatrix();
+
+      virtual ~SymmetricCSCMatrix();
+
+      /// Returns the entry, (m, n) and (n, m) are the same entry.
+      virtual Scalar get(unsigned int m, unsigned int n) const;
+
+      /// Adds to the lower triangle, entries above the diagonal are ignored.
+      virtual void add(unsigned int m, unsigned int n, Scalar v);
+
+      /// Scatter of a local matrix, entries above the diagonal are skipped before the position lookup.
+      virtual void add(unsigned int m, unsigned int n, Scalar *mat, int *rows, int *cols, const int size);
+
+      /// Symmetric SpMV - both triangles from the stored one.
+      void multiply_with_vector(Scalar* vector_in, Scalar*& vector_out, bool vector_out_initialized) const;
+
+      /// Entries above the diagonal are stored as their mirror images.
+      virtual void pre_add_ij(unsigned int row, unsigned int col);
+
+      /// The lower triangle of the (symmetrized) pattern.
+      virtual void alloc_from_pattern(const SparsityPattern* pattern);
+
+      /// Zeroing one row would make the matrix nonsymmetric - throws.
+      virtual void set_row_zero(unsigned int n);
+
+      /// Only diagonal blocks (offset_i == offset_j) of a symmetric matrix, the upper triangle of mat is not used.
+      using SparseMatrix<Scalar>::add_as_block;
+      virtual void add_as_block(unsigned int offset_i, unsigned int offset_j, SparseMatrix<Scalar>* mat);
+
+      /// Exports the full matrix (both triangles).
+      virtual void export_to_file(const char *filename, const char *var_name, MatrixExportFormat fmt, char* number_format = "%lf");
+      /// Not supported, the file need not contain a symmetric matrix - throws, import into a CSCMatrix.
+      virtual void import_from_file(const char *filename, const char *var_name, MatrixExportFormat fmt);
+
+      /// Duplicates a matrix (including allocation).
+      SparseMatrix<Scalar>* duplicate() const;
+
+      /// Creates the same matrix in the full storage (CSCMatrix), for solvers that do not accept one triangle.
+      CSCMatrix<Scalar>* create_full_matrix() const;
+      /// Copies the values to a matrix created by create_full_matrix() for the same structure.
+      void copy_values_to_full_matrix(CSCMatrix<Scalar>* full_matrix) const;
+    };
+
     /// \brief General CSR Matrix class.
     /// (can be used in umfpack, in that case use the
     /// CSCMatrix subclass, or with EigenSolver, or anything else).
@@ -188,6 +245,9 @@ namespace Hermes
       /// @param[in] row  - row index
       /// @param[in] col  - column index
       virtual void pre_add_ij(unsigned int row, unsigned int col);
+
+      /// The same applies here - the row-compressed form of the pattern is used.
+      virtual void alloc_from_pattern(const SparsityPattern* pattern);
     };
   }
 }
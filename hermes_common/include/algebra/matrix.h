@@ -31,6 +31,38 @@ namespace Hermes
   /// \brief Namespace containing classes for vector / matrix operations.
   namespace Algebra
   {
+    /// \brief Nonzero structure of a square sparse matrix, compressed by columns.
+    /// Can be built once (e.g. from the DOF-to-element graph in the assembler) and used to allocate
+    /// any number of matrices with the same structure, see SparseMatrix::alloc_from_pattern().
+    class HERMES_API SparsityPattern
+    {
+    public:
+      /// Takes over the ownership of the arrays (allocated with malloc_with_check).
+      /// @param[in] size size of the matrix (number of rows and columns)
+      /// @param[in] Ap index to Ai, where each column starts (size + 1 entries)
+      /// @param[in] Ai row indices of all columns, sorted and without duplicities within a column
+      SparsityPattern(unsigned int size, int* Ap, int* Ai);
+      ~SparsityPattern();
+
+      unsigned int get_size() const { return this->size; }
+      unsigned int get_nnz() const { return this->Ap[this->size]; }
+
+      /// Column-compressed form.
+      const int* get_Ap() const { return this->Ap; }
+      /// Column-compressed form.
+      const int* get_Ai() const { return this->Ai; }
+
+      /// Fill the row-compressed form of the pattern (i.e. of the transposed column-compressed one).
+      /// @param[out] Ap_rows index to Ai_rows, where each row starts (size + 1 entries)
+      /// @param[out] Ai_rows column indices of all rows (nnz entries), sorted within a row
+      void get_row_compressed(int* Ap_rows, int* Ai_rows) const;
+
+    protected:
+      unsigned int size;
+      int* Ap;
+      int* Ai;
+    };
+
     /// \brief General (abstract) matrix representation in Hermes.
     template<typename Scalar>
     class HERMES_API Matrix : public Hermes::Mixins::Loggable, public Algebra::Mixins::MatrixRhsImportExport < Scalar >
@@ -121,6 +153,12 @@ namespace Hermes
       /// @param[in] col  - column index
       virtual void pre_add_ij(unsigned int row, unsigned int col);
 
+      /// Allocate the matrix with a precalculated structure.
+      /// Replaces the sequence prealloc() - pre_add_ij() - alloc(), the default implementation
+      /// does exactly that, compressed storage formats copy the arrays directly.
+      /// @param[in] pattern - the structure, its size determines the size of the matrix
+      virtual void alloc_from_pattern(const SparsityPattern* pattern);
+
       /// Finish manipulation with matrix (called before solving)
       virtual void finish();
 
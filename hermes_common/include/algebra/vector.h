@@ -149,6 +149,47 @@ namespace Hermes
       Scalar *v;
     };
 
+    /// \brief Several vectors of the same size stored in one contiguous array, one after another.
+    /// Used for multiple right-hand sides (load cases) that are solved with one factorization of the matrix,
+    /// the layout (column-major, leading dimension = size) is the one expected by the direct solvers.
+    template <typename Scalar>
+    class HERMES_API SimpleVectorBlock : public Hermes::Mixins::Loggable
+    {
+    public:
+      SimpleVectorBlock();
+      SimpleVectorBlock(unsigned int size, unsigned int num_vectors);
+      virtual ~SimpleVectorBlock();
+
+      /// Allocate (and zero) memory for num_vectors vectors of size entries.
+      void alloc(unsigned int size, unsigned int num_vectors);
+      void free();
+      void zero();
+
+      /// Get the value from a position of the vector_i-th vector.
+      Scalar get(unsigned int vector_i, unsigned int idx) const;
+      /// Update the entry on a position of the vector_i-th vector.
+      /// Thread-safe in the same way as SimpleVector::add().
+      void add(unsigned int vector_i, unsigned int idx, Scalar y);
+      /// Add a vector to all vectors of the block.
+      void add_vector_to_all(Vector<Scalar>* vec);
+
+      /// Raw data of the vector_i-th vector.
+      Scalar* get_vector(unsigned int vector_i) const;
+      /// Copy the vector_i-th vector into a vector.
+      void extract(unsigned int vector_i, Vector<Scalar>* vec) const;
+
+      unsigned int get_size() const { return this->size; }
+      unsigned int get_num_vectors() const { return this->num_vectors; }
+
+      /// Raw data, size * num_vectors entries.
+      Scalar *v;
+
+    protected:
+      /// Size of one vector.
+      unsigned int size;
+      unsigned int num_vectors;
+    };
+
     /// \brief Function returning a vector according to the users's choice.
     /// @return created vector
     template<typename Scalar> HERMES_API
@@ -37,7 +37,10 @@ namespace Hermes
     directMatrixSolverType,
     showInternalWarnings,
     checkMeshesOnLoad,
-    useAccelerators
+    useAccelerators,
+    /// create_matrix() returns SymmetricCSCMatrix (one triangle) for UMFPACK and MUMPS.
+    /// Only for problems where all the assembled matrices are symmetric, default 0.
+    useSymmetricMatrices
   };
 
   /// API Class containing settings for the whole HermesCommon.
@@ -192,6 +192,24 @@ namespace Hermes
   inline double pow(double x, double y) { return std::pow(x, y); }
   inline double log(double x) { return std::log(x); }
 
+  /// x += y, thread-safe - for the parallel scatter of the assembling.
+  inline void atomic_add(double& x, double y)
+  {
+#pragma omp atomic
+    x += y;
+  }
+
+  /// x += y, thread-safe - the real and the imaginary part (a complex number is an array of two doubles) are updated by two
+  /// atomic additions, which is enough when no thread reads x before all the additions are done.
+  inline void atomic_add(std::complex<double>& x, std::complex<double> y)
+  {
+    double* parts = reinterpret_cast<double*>(&x);
+#pragma omp atomic
+    parts[0] += y.real();
+#pragma omp atomic
+    parts[1] += y.imag();
+  }
+
   /* event codes */
 #define HERMES_EC_ERROR 'E' ///< An event code: warnings. \internal
 #define HERMES_EC_WARNING 'W' ///< An event code: warnings. \internal
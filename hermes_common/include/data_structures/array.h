@@ -140,7 +140,8 @@ namespace Hermes
       TYPE* item;
       if (!nunused || append_only)
       {
-        if (!(size & HERMES_PAGE_MASK))
+        // A new page is needed, unless it has been allocated in advance (reserve(), skip_slot()).
+        if (!(size & HERMES_PAGE_MASK) && (size >> HERMES_PAGE_BITS) >= page_count)
         {
           this->pages = realloc_with_check <Array<TYPE>, TYPE*>(this->pages, this->page_count + 1, this);
           TYPE* new_page = malloc_with_check<Array<TYPE>, TYPE>(HERMES_PAGE_SIZE, this);
@@ -160,6 +161,30 @@ namespace Hermes
       return item;
     }
 
+    /// Allocates the pages for num_items more items to be appended, so that the following
+    /// additions (e.g. a batch of mesh refinements) do not reallocate the page table one page at a time.
+    void reserve(unsigned int num_items)
+    {
+      unsigned int new_page_count = (size + num_items + HERMES_PAGE_MASK) >> HERMES_PAGE_BITS;
+      if (new_page_count <= this->page_count)
+        return;
+      this->pages = realloc_with_check<Array, TYPE*>(this->pages, new_page_count, this);
+      for (unsigned int new_i = this->page_count; new_i < new_page_count; new_i++)
+        pages[new_i] = malloc_with_check<Array, TYPE>(HERMES_PAGE_SIZE, this);
+      this->page_count = new_page_count;
+    }
+
+    /// Frees the pages after the last item, e.g. the ones allocated by reserve() and not used in the end.
+    void trim()
+    {
+      unsigned int needed_page_count = (size + HERMES_PAGE_MASK) >> HERMES_PAGE_BITS;
+      if (needed_page_count >= this->page_count)
+        return;
+      for (unsigned int page_i = needed_page_count; page_i < this->page_count; page_i++)
+        free_with_check(pages[page_i]);
+      this->page_count = needed_page_count;
+    }
+
     /// Removes the given item from the array, ie., marks it as unused.
     /// Note that the array is never physically shrinked. This should not
     /// be a problem, since meshes tend to grow rather than become smaller.
@@ -278,6 +303,11 @@ namespace Hermes
     int get_size() const { return size; }
     int get_num_items() const { return nitems; }
 
+    /// The ids of the removed items, in the order of removal (the last one is reused first by add()).
+    /// Used for saving the array in a way that reproduces the ids of items added later.
+    int get_num_unused() const { return nunused; }
+    int get_unused(int i) const { return unused[i]; }
+
     TYPE& get(int id) const { return pages[id >> HERMES_PAGE_BITS][id & HERMES_PAGE_MASK]; }
     TYPE& operator[] (int id) const { return get(id); }
   };
@@ -61,6 +61,15 @@ namespace Hermes
     /// One-dimensional function derivative integration order.
     virtual Hermes::Ord derivative(Hermes::Ord x) const;
 
+    /// One-dimensional function values in n points, result[i] = value(x[i]).
+    /// By default calls value(x[i]) for each point, descendants may override it by a vectorized version.
+    /// Not an overload of value(), which would hide value() of descendants overriding only the point versions.
+    virtual void values(int n, const Scalar* x, Scalar* result) const;
+
+    /// One-dimensional function derivative values in n points, result[i] = derivative(x[i]).
+    /// By default calls derivative(x[i]) for each point, descendants may override it by a vectorized version.
+    virtual void derivatives(int n, const Scalar* x, Scalar* result) const;
+
     /// The function is constant.
     /// Returns the value of is_const.
     bool is_constant() const;
@@ -106,6 +115,10 @@ namespace Hermes
     virtual Hermes::Ord derivative_x(Hermes::Ord x, Hermes::Ord y) const;
     virtual Hermes::Ord derivative_y(Hermes::Ord x, Hermes::Ord y) const;
 
+    /// Two-dimensional function values in n points, result[i] = value(x[i], y[i]).
+    /// By default calls value(x[i], y[i]) for each point, descendants may override it by a vectorized version.
+    virtual void values(int n, const double* x, const double* y, Scalar* result) const;
+
     /// The function is constant.
     /// Returns the value of is_const.
     bool is_constant() const;
@@ -134,14 +134,23 @@ namespace Hermes
       /// @param[in] m matrix pointer
       /// @param[in] rhs right hand side pointer
       MumpsSolver(MumpsMatrix<Scalar> *m, SimpleVector<Scalar> *rhs);
+      /// Constructor of MumpsSolver in the symmetric mode (LDL^T factorization of the stored triangle).
+      /// The matrix is converted to the MUMPS format (owned by the solver) whenever it is factorized.
+      /// @param[in] m matrix pointer
+      /// @param[in] rhs right hand side pointer
+      MumpsSolver(SymmetricCSCMatrix<Scalar> *m, SimpleVector<Scalar> *rhs);
       virtual ~MumpsSolver();
       void free();
 
       virtual void solve();
+      /// One factorization and one (multi-RHS) solution phase of MUMPS.
+      virtual void solve_multiple(Scalar* rhs_block, unsigned int num_rhs);
       virtual int get_matrix_size();
 
       /// Matrix to solve.
       MumpsMatrix<Scalar> *m;
+      /// The matrix passed to the symmetric constructor, nullptr otherwise.
+      SymmetricCSCMatrix<Scalar> *symmetric_matrix;
       /// Right hand side.
       SimpleVector<Scalar> *rhs;
 
@@ -158,6 +167,9 @@ namespace Hermes
       /// @return true on succes
       /// \sa #check_status()
       bool reinit();
+
+      /// Symmetric mode: (re)creates m from symmetric_matrix.
+      void convert_symmetric_matrix();
     private:
       //wrapper around dmums_c or zmumps_c
       void mumps_c(typename mumps_type<Scalar>::mumps_struct * param);
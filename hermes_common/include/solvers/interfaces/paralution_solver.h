@@ -61,7 +61,8 @@ namespace Hermes
 
       virtual void free();
       virtual void zero();
-      virtual void alloc();
+      /// Hands the CSR arrays over to PARALUTION (for both alloc() and alloc_from_pattern()).
+      virtual void alloc_data();
 
       paralution::LocalMatrix<Scalar>& get_paralutionMatrix();
 
@@ -54,6 +54,10 @@ namespace Hermes
       UMFPackLinearMatrixSolver(CSCMatrix<Scalar> *m, SimpleVector<Scalar> *rhs);
       virtual ~UMFPackLinearMatrixSolver();
       virtual void solve();
+      /// One factorization, the right-hand sides are back-substituted with a shared workspace.
+      /// UMFPACK has no blocked multi-RHS solve, so this is one umfpack_*_wsolve call per right-hand side -
+      /// the saving is in the factorization (and the workspace), not in the back-substitutions.
+      virtual void solve_multiple(Scalar* rhs_block, unsigned int num_rhs);
       virtual void free();
       virtual int get_matrix_size();
 
@@ -68,6 +72,15 @@ namespace Hermes
       /// LU factorization of matrix A.
       void *numeric;
 
+      /// For a SymmetricCSCMatrix, the matrix in the full storage - UMFPACK does not take one triangle, so the memory
+      /// saving of the symmetric storage does not extend to the factorization (it does with MUMPS).
+      /// The structure is kept while the reuse scheme allows it, only the values are copied for a new factorization.
+      CSCMatrix<Scalar> *full_matrix;
+      /// Expands a SymmetricCSCMatrix into full_matrix, no-op otherwise.
+      void update_full_matrix(MatrixStructureReuseScheme scheme);
+      /// The matrix passed to UMFPACK - m, or full_matrix.
+      CSCMatrix<Scalar>* get_factorized_matrix() const;
+
       /// \todo document
       void free_factorization_data();
       /// \todo document
@@ -117,6 +117,14 @@ namespace Hermes
       /// \param[in] initial guess.
       virtual void solve(Scalar* initial_guess) = 0;
 
+      /// Solve for several right-hand sides with the same matrix.
+      /// After the call, get_sln_vector() contains num_rhs solutions stored one after another.
+      /// The default implementation solves the right-hand sides one by one reusing the factorization (preconditioner),
+      /// it overwrites the right-hand side vector of the solver. MUMPS overrides it by a blocked (nrhs > 1) solution phase,
+      /// UMFPACK by a loop of back-substitutions with one factorization and a shared workspace.
+      /// \param[in] rhs_block num_rhs right-hand sides stored one after another (see SimpleVectorBlock).
+      virtual void solve_multiple(Scalar* rhs_block, unsigned int num_rhs);
+
       /// Get solution vector.
       /// @return solution vector ( #sln )
       Scalar *get_sln_vector();
@@ -210,6 +218,16 @@ namespace Hermes
       virtual std::string command() = 0;
     };
 
+    /// \brief Creation of the p-multigrid solver (SOLVER_PMULTIGRID) in create_linear_solver().
+    /// The solver needs the finite element spaces, it lives in Hermes2D, which sets the creation function.
+    template <typename Scalar>
+    class HERMES_API PMultigridSolverCreation
+    {
+    public:
+      typedef LinearMatrixSolver<Scalar>* (*creation)(SparseMatrix<Scalar> *m, Vector<Scalar> *rhs);
+      static creation create_pmultigrid_solver;
+    };
+
     /// \brief Base class for defining interface for direct linear solvers.
     /// Internal, though utilizable for defining interfaces to other algebraic packages.
     template <typename Scalar>
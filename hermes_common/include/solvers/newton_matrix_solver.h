@@ -28,6 +28,19 @@ namespace Hermes
 {
   namespace Solvers
   {
+    /// Reduction of the damping coefficient of a Newton step rejected by the automatic damping.
+    enum NewtonLineSearch
+    {
+      /// Division by the ratio set by set_auto_damping_ratio().
+      NewtonLineSearchBacktracking = 0,
+      /// The minimizer of the quadratic (first rejection), resp. cubic (further rejections of the same step) model of
+      /// 1/2 ||F(x + lambda dx)||^2, using the slope -||F(x)||^2 of the Newton direction at lambda = 0,
+      /// safeguarded to [0.1, 0.5] times the rejected coefficient.
+      /// The slope only holds if dx solves the system with the Jacobian of x - for steps with a reused or constant Jacobian,
+      /// or combined by the Anderson acceleration, the reduction of NewtonLineSearchBacktracking is used.
+      NewtonLineSearchCubic = 1
+    };
+
     template<typename Scalar>
     class HERMES_API NewtonMatrixSolver : public NonlinearMatrixSolver < Scalar >
     {
@@ -35,9 +48,69 @@ namespace Hermes
       NewtonMatrixSolver();
       virtual ~NewtonMatrixSolver() {};
 
+      /// Line search of the automatic damping (see set_manual_damping_coeff()).
+      /// Each trial step costs one residual assembling.
+      /// Default: NewtonLineSearchBacktracking.
+      void set_line_search(NewtonLineSearch line_search);
+
+#pragma region anderson-public
+      /// Turn on / off the Anderson acceleration of the steps with a reused Jacobian. By default it is off.
+      /// With the Jacobian J reused (set_max_steps_with_reused_jacobian(), set_jacobian_constant()), the steps x + J^{-1} R(x) are
+      /// a fixed-point iteration, whose last iterates and increments are combined by the Anderson acceleration (least squares
+      /// in the increments). The history is cleared whenever the Jacobian is recalculated, the step with the recalculated Jacobian
+      /// is the plain Newton step.
+      /// Not used together with the Jacobian-free Newton-Krylov steps, unless these are not used (set_jacobian_constant(),
+      /// an iterative linear solver).
+      void use_Anderson_acceleration(bool to_set);
+
+      /// Set how many last vectors will be used for Anderson acceleration (at least 2). Default: 4.
+      void set_num_last_vector_used(int num);
+
+      /// Set the Anderson beta coefficient (the weight of the increments in the combination), only for the steps with a reused Jacobian.
+      /// Default: 1.0.
+      void set_anderson_beta(double beta);
+#pragma endregion
+
+#pragma region jfnk-public
+      /// Turn on / off the Jacobian-free Newton-Krylov steps. By default it is off.
+      /// The steps with a reused Jacobian (their number is set by set_max_steps_with_reused_jacobian()) then solve the Newton
+      /// system with the Jacobian of the current iterate, whose action is approximated by the finite difference of the residual
+      /// (one residual assembling per GMRES iteration). The GMRES is right-preconditioned by the factorization of the last
+      /// assembled Jacobian, so the linear solver has to be a direct one.
+      /// Not used with set_jacobian_constant(), nor with an iterative linear solver - the Anderson acceleration is then used if turned on.
+      void use_Jacobian_free_Newton_Krylov(bool to_set);
+
+      /// Parameters of the GMRES of the Jacobian-free Newton-Krylov steps.
+      /// \param[in] tolerance Relative (to the norm of the residual) tolerance. Default: 1e-4.
+      /// \param[in] max_iterations Maximum number of the GMRES iterations per step. Default: 50.
+      /// \param[in] restart Number of the iterations after which the GMRES is restarted. Default: 20.
+      void set_JFNK_GMRES_parameters(double tolerance, int max_iterations, int restart);
+#pragma endregion
+
     protected:
       virtual double update_solution_return_change_norm(Scalar* linear_system_solution);
 
+      /// Initialization - called at the beginning of solving.
+      virtual void init_solving(Scalar* coeff_vec);
+
+      /// Internal.
+      virtual void deinit_solving();
+
+      /// Solve the step's linear system.
+      /// Overriden because of the Jacobian-free Newton-Krylov steps.
+      virtual void solve_linear_system();
+
+      /// See NewtonLineSearch.
+      virtual double get_reduced_damping_factor(double current_damping_factor);
+
+      NewtonLineSearch line_search;
+      /// The iteration of the last rejected step, and its damping coefficient and residual norm (for the cubic model).
+      int line_search_iteration;
+      double line_search_previous_damping_factor;
+      double line_search_previous_residual_norm;
+      /// The last step was the (damped) Newton direction of the Jacobian of the iterate, see NewtonLineSearchCubic.
+      bool line_search_newton_direction;
+
       /// Find out the convergence state.
       virtual NonlinearConvergenceState get_convergence_state();
 
@@ -47,6 +120,39 @@ namespace Hermes
 
       /// State querying helpers.
       inline std::string getClassName() const { return "NewtonMatrixSolver"; }
+
+#pragma region anderson-private
+      bool anderson_is_on;
+      int num_last_vectors_used;
+      double anderson_beta;
+      /// The last iterates and their increments (solutions of the linear systems), the oldest first.
+      Scalar** anderson_iterates;
+      Scalar** anderson_increments;
+      int anderson_vec_in_memory;
+
+      /// Stores the iterate and its increment, and combines the history into the new iterate.
+      /// \param[in] reused_jacobian False for the step with a recalculated Jacobian - the history is cleared, the step not combined.
+      /// \return The norm of the change of the iterate.
+      double anderson_update_solution_return_change_norm(Scalar* linear_system_solution, double damping_factor, bool reused_jacobian);
+      void deinit_anderson();
+#pragma endregion
+
+#pragma region jfnk-private
+      bool jfnk_is_on;
+      double jfnk_tolerance;
+      int jfnk_max_iterations;
+      int jfnk_restart;
+
+      /// Solves J(x) increment = R(x) by the preconditioned GMRES, x is previous_sln_vector, R(x) is in get_residual().
+      void jfnk_solve(Scalar* increment);
+      /// z = J_0^{-1} v, J_0 being the factorized Jacobian.
+      void jfnk_precondition(const Scalar* v, Scalar* z);
+      /// Av = J(x) J_0^{-1} v by the finite difference of the residual, residual = R(x), preconditioned_v is work space.
+      void jfnk_apply(const Scalar* v, Scalar* Av, const Scalar* residual, Scalar* preconditioned_v);
+      /// The residual at sln_vector for jfnk_apply() (once per GMRES iteration), by default assemble_residual(false).
+      /// Overriden to skip the output processing of the step's residual.
+      virtual void assemble_jfnk_residual();
+#pragma endregion
     };
   }
 }
@@ -229,6 +229,10 @@ namespace Hermes
       /// Calculates the new_ damping coefficient.
       bool calculate_damping_factor(unsigned int& successful_steps);
 
+      /// The damping coefficient the step is restarted with after it was not successful with current_damping_factor.
+      /// Default: current_damping_factor / auto_damping_ratio.
+      virtual double get_reduced_damping_factor(double current_damping_factor);
+
       /// Returns iff the damping factor condition is fulfilled.
       virtual bool damping_factor_condition();
 
@@ -60,6 +60,18 @@ namespace Hermes
       virtual ~Precond() {};
     };
 
+    /// \brief Abstract class for preconditioners applied directly to (raw) vectors,
+    /// e.g. by a user's own Krylov method (Hermes2D::PMultigridSolver implements it).
+    template <typename Scalar>
+    class VectorPrecond : public Precond < Scalar >
+    {
+    public:
+      /// Applies the preconditioner: z = M^{-1} r.
+      /// \param[in] r Vector of the size of the preconditioned matrix.
+      /// \param[out] z Vector of the same size.
+      virtual void apply(const Scalar* r, Scalar* z) = 0;
+    };
+
     /// \brief Abstract class for Epetra preconditioners.
     ///
     template <typename Scalar>
@@ -21,6 +21,7 @@
 */
 #include "cs_matrix.h"
 #include "util/memory_handling.h"
+#include <algorithm>
 
 namespace Hermes
 {
@@ -123,6 +124,20 @@ namespace Hermes
       this->alloc_data();
     }
 
+    template<typename Scalar>
+    void CSMatrix<Scalar>::alloc_from_pattern(const SparsityPattern* pattern)
+    {
+      this->size = pattern->get_size();
+      nnz = pattern->get_nnz();
+
+      Ap = malloc_with_check<CSMatrix<Scalar>, int>(this->size + 1, this);
+      Ai = malloc_with_check<CSMatrix<Scalar>, int>(nnz, this);
+      memcpy(Ap, pattern->get_Ap(), (this->size + 1) * sizeof(int));
+      memcpy(Ai, pattern->get_Ai(), nnz * sizeof(int));
+
+      this->alloc_data();
+    }
+
     template<typename Scalar>
     void CSMatrix<Scalar>::alloc_data()
     {
@@ -286,8 +301,7 @@ namespace Hermes
           throw Hermes::Exceptions::Exception("Sparse matrix entry not found: [%i, %i]", m, n);
         }
 
-#pragma omp critical (CSMatrixAdd)
-        Ax[Ap[n] + pos] += v;
+        atomic_add(Ax[Ap[n] + pos], v);
       }
     }
 
@@ -744,6 +758,258 @@ namespace Hermes
       return new_matrix;
     }
 
+    template<typename Scalar>
+    SymmetricCSCMatrix<Scalar>::SymmetricCSCMatrix() : CSCMatrix<Scalar>()
+    {
+    }
+
+    template<typename Scalar>
+    SymmetricCSCMatrix<Scalar>::~SymmetricCSCMatrix()
+    {
+    }
+
+    template<typename Scalar>
+    Scalar SymmetricCSCMatrix<Scalar>::get(unsigned int m, unsigned int n) const
+    {
+      if (m < n)
+        return CSMatrix<Scalar>::get(n, m);
+      else
+        return CSMatrix<Scalar>::get(m, n);
+    }
+
+    template<typename Scalar>
+    void SymmetricCSCMatrix<Scalar>::add(unsigned int m, unsigned int n, Scalar v)
+    {
+      // The mirror image (n, m) is added as well.
+      if (m >= n)
+        CSMatrix<Scalar>::add(m, n, v);
+    }
+
+    template<typename Scalar>
+    void SymmetricCSCMatrix<Scalar>::add(unsigned int m, unsigned int n, Scalar *mat, int *rows, int *cols, const int size)
+    {
+      for (unsigned int i = 0; i < m; i++)
+      {
+        if (rows[i] < 0)
+          continue;
+        for (unsigned int j = 0; j < n; j++)
+        {
+          // Dirichlet dofs and the upper triangle.
+          if (cols[j] < 0 || rows[i] < cols[j])
+            continue;
+          Scalar entry = mat[i * size + j];
+          if (entry != Scalar(0))
+            CSMatrix<Scalar>::add(rows[i], cols[j], entry);
+        }
+      }
+    }
+
+    template<typename Scalar>
+    void SymmetricCSCMatrix<Scalar>::multiply_with_vector(Scalar* vector_in, Scalar*& vector_out, bool vector_out_initialized) const
+    {
+      if (!vector_out_initialized)
+        vector_out = malloc_with_check<Scalar>(this->size);
+      memset(vector_out, 0, sizeof(Scalar)* this->size);
+
+      for (int col = 0; col < this->size; col++)
+      {
+        Scalar x_col = vector_in[col];
+        Scalar y_col = Scalar(0);
+        for (int i = this->Ap[col]; i < this->Ap[col + 1]; i++)
+        {
+          int row = this->Ai[i];
+          vector_out[row] += this->Ax[i] * x_col;
+          // The transposed entry (col, row) from the upper triangle.
+          if (row != col)
+            y_col += this->Ax[i] * vector_in[row];
+        }
+        vector_out[col] += y_col;
+      }
+    }
+
+    template<typename Scalar>
+    void SymmetricCSCMatrix<Scalar>::pre_add_ij(unsigned int row, unsigned int col)
+    {
+      if (row < col)
+        SparseMatrix<Scalar>::pre_add_ij(col, row);
+      else
+        SparseMatrix<Scalar>::pre_add_ij(row, col);
+    }
+
+    template<typename Scalar>
+    void SymmetricCSCMatrix<Scalar>::alloc_from_pattern(const SparsityPattern* pattern)
+    {
+      this->size = pattern->get_size();
+      const int* pattern_Ap = pattern->get_Ap();
+      const int* pattern_Ai = pattern->get_Ai();
+
+      // Entries above the diagonal are mirrored, so that also a pattern that is not symmetric is covered.
+      this->Ap = calloc_with_check<CSMatrix<Scalar>, int>(this->size + 1, this);
+      for (int col = 0; col < this->size; col++)
+        for (int i = pattern_Ap[col]; i < pattern_Ap[col + 1]; i++)
+          this->Ap[std::min(pattern_Ai[i], col) + 1]++;
+      for (int col = 0; col < this->size; col++)
+        this->Ap[col + 1] += this->Ap[col];
+
+      int* positions = malloc_with_check<CSMatrix<Scalar>, int>(this->size + 1, this);
+      memcpy(positions, this->Ap, (this->size + 1) * sizeof(int));
+      int* Ai_candidates = malloc_with_check<CSMatrix<Scalar>, int>(std::max(this->Ap[this->size], 1), this);
+      for (int col = 0; col < this->size; col++)
+      {
+        for (int i = pattern_Ap[col]; i < pattern_Ap[col + 1]; i++)
+        {
+          int row = pattern_Ai[i];
+          if (row >= col)
+            Ai_candidates[positions[col]++] = row;
+          else
+            Ai_candidates[positions[row]++] = col;
+        }
+      }
+
+      // Sort and remove duplicities (the mirrored entries of a symmetric pattern) in each column.
+      this->nnz = 0;
+      int candidates_start = 0;
+      for (int col = 0; col < this->size; col++)
+      {
+        int candidates_end = this->Ap[col + 1];
+        std::sort(Ai_candidates + candidates_start, Ai_candidates + candidates_end);
+        this->Ap[col] = this->nnz;
+        for (int i = candidates_start; i < candidates_end; i++)
+          if (i == candidates_start || Ai_candidates[i] != Ai_candidates[i - 1])
+            Ai_candidates[this->nnz++] = Ai_candidates[i];
+        candidates_start = candidates_end;
+      }
+      this->Ap[this->size] = this->nnz;
+
+      this->Ai = malloc_with_check<CSMatrix<Scalar>, int>(std::max(this->nnz, 1u), this);
+      memcpy(this->Ai, Ai_candidates, this->nnz * sizeof(int));
+      free_with_check(Ai_candidates);
+      free_with_check(positions);
+
+      this->alloc_data();
+    }
+
+    template<typename Scalar>
+    void SymmetricCSCMatrix<Scalar>::set_row_zero(unsigned int n)
+    {
+      throw Hermes::Exceptions::Exception("SymmetricCSCMatrix::set_row_zero() would make the matrix nonsymmetric, use CSCMatrix.");
+    }
+
+    template<typename Scalar>
+    void SymmetricCSCMatrix<Scalar>::add_as_block(unsigned int offset_i, unsigned int offset_j, SparseMatrix<Scalar>* mat)
+    {
+      // An off-diagonal block would need its transpose added as well.
+      if (offset_i != offset_j)
+        throw Hermes::Exceptions::Exception("SymmetricCSCMatrix::add_as_block() only adds diagonal blocks.");
+      CSMatrix<Scalar>::add_as_block(offset_i, offset_j, mat);
+    }
+
+    template<typename Scalar>
+    void SymmetricCSCMatrix<Scalar>::export_to_file(const char *filename, const char *var_name, MatrixExportFormat fmt, char* number_format)
+    {
+      CSCMatrix<Scalar>* full_matrix = this->create_full_matrix();
+      full_matrix->export_to_file(filename, var_name, fmt, number_format);
+      delete full_matrix;
+    }
+
+    template<typename Scalar>
+    void SymmetricCSCMatrix<Scalar>::import_from_file(const char *filename, const char *var_name, MatrixExportFormat fmt)
+    {
+      throw Hermes::Exceptions::Exception("SymmetricCSCMatrix::import_from_file() is not supported, import into a CSCMatrix.");
+    }
+
+    template<typename Scalar>
+    SparseMatrix<Scalar>* SymmetricCSCMatrix<Scalar>::duplicate() const
+    {
+      SymmetricCSCMatrix<Scalar>* new_matrix = new SymmetricCSCMatrix<Scalar>();
+      new_matrix->create(this->get_size(), this->get_nnz(), this->get_Ap(), this->get_Ai(), this->get_Ax());
+      return new_matrix;
+    }
+
+    template<typename Scalar>
+    CSCMatrix<Scalar>* SymmetricCSCMatrix<Scalar>::create_full_matrix() const
+    {
+      // Column j of the full matrix: the upper part (row < j) are the entries of the row j of the stored triangle,
+      // followed by the stored column j.
+      int* full_Ap = calloc_with_check<int>(this->size + 1);
+      int* upper_counts = calloc_with_check<int>(std::max(this->size, 1u));
+      for (int col = 0; col < this->size; col++)
+      {
+        for (int i = this->Ap[col]; i < this->Ap[col + 1]; i++)
+        {
+          full_Ap[col + 1]++;
+          if (this->Ai[i] != col)
+          {
+            full_Ap[this->Ai[i] + 1]++;
+            upper_counts[this->Ai[i]]++;
+          }
+        }
+      }
+      for (int col = 0; col < this->size; col++)
+        full_Ap[col + 1] += full_Ap[col];
+
+      int full_nnz = full_Ap[this->size];
+      int* full_Ai = malloc_with_check<int>(std::max(full_nnz, 1));
+      Scalar* full_Ax = malloc_with_check<Scalar>(std::max(full_nnz, 1));
+      int* upper_positions = malloc_with_check<int>(std::max(this->size, 1u));
+      for (int col = 0; col < this->size; col++)
+        upper_positions[col] = full_Ap[col];
+
+      // Columns are traversed in the increasing order, the transposed entries thus come sorted.
+      for (int col = 0; col < this->size; col++)
+      {
+        int lower_position = full_Ap[col] + upper_counts[col];
+        for (int i = this->Ap[col]; i < this->Ap[col + 1]; i++)
+        {
+          int row = this->Ai[i];
+          full_Ai[lower_position] = row;
+          full_Ax[lower_position++] = this->Ax[i];
+          if (row != col)
+          {
+            full_Ai[upper_positions[row]] = col;
+            full_Ax[upper_positions[row]++] = this->Ax[i];
+          }
+        }
+      }
+
+      CSCMatrix<Scalar>* full_matrix = new CSCMatrix<Scalar>();
+      full_matrix->create(this->size, full_nnz, full_Ap, full_Ai, full_Ax);
+
+      free_with_check(full_Ap);
+      free_with_check(full_Ai);
+      free_with_check(full_Ax);
+      free_with_check(upper_counts);
+      free_with_check(upper_positions);
+
+      return full_matrix;
+    }
+
+    template<typename Scalar>
+    void SymmetricCSCMatrix<Scalar>::copy_values_to_full_matrix(CSCMatrix<Scalar>* full_matrix) const
+    {
+      int* full_Ap = full_matrix->get_Ap();
+      Scalar* full_Ax = full_matrix->get_Ax();
+
+      // The same traversal as in create_full_matrix(), the upper part of the full column col has
+      // (full column length - stored column length) entries.
+      int* upper_positions = malloc_with_check<int>(std::max(this->size, 1u));
+      for (int col = 0; col < this->size; col++)
+        upper_positions[col] = full_Ap[col];
+
+      for (int col = 0; col < this->size; col++)
+      {
+        int lower_position = full_Ap[col + 1] - (this->Ap[col + 1] - this->Ap[col]);
+        for (int i = this->Ap[col]; i < this->Ap[col + 1]; i++)
+        {
+          full_Ax[lower_position++] = this->Ax[i];
+          if (this->Ai[i] != col)
+            full_Ax[upper_positions[this->Ai[i]]++] = this->Ax[i];
+        }
+      }
+
+      free_with_check(upper_positions);
+    }
+
     template<typename Scalar>
     CSRMatrix<Scalar>::CSRMatrix() : CSMatrix<Scalar>()
     {
@@ -777,6 +1043,19 @@ namespace Hermes
       return CSMatrix<Scalar>::get(n, m);
     }
 
+    template<typename Scalar>
+    void CSRMatrix<Scalar>::alloc_from_pattern(const SparsityPattern* pattern)
+    {
+      this->size = pattern->get_size();
+      this->nnz = pattern->get_nnz();
+
+      this->Ap = malloc_with_check<CSMatrix<Scalar>, int>(this->size + 1, this);
+      this->Ai = malloc_with_check<CSMatrix<Scalar>, int>(this->nnz, this);
+      pattern->get_row_compressed(this->Ap, this->Ai);
+
+      this->alloc_data();
+    }
+
     template<typename Scalar>
     void CSRMatrix<Scalar>::pre_add_ij(unsigned int row, unsigned int col)
     {
@@ -813,5 +1092,8 @@ template class HERMES_API Hermes::Algebra::CSMatrix < std::complex<double> > ;
 template class HERMES_API Hermes::Algebra::CSCMatrix < double > ;
 template class HERMES_API Hermes::Algebra::CSCMatrix < std::complex<double> > ;
 
+template class HERMES_API Hermes::Algebra::SymmetricCSCMatrix < double > ;
+template class HERMES_API Hermes::Algebra::SymmetricCSCMatrix < std::complex<double> > ;
+
 template class HERMES_API Hermes::Algebra::CSRMatrix < double > ;
 template class HERMES_API Hermes::Algebra::CSRMatrix < std::complex<double> > ;
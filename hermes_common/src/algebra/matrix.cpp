@@ -39,6 +39,34 @@ namespace Hermes
 {
   namespace Algebra
   {
+    SparsityPattern::SparsityPattern(unsigned int size, int* Ap, int* Ai) : size(size), Ap(Ap), Ai(Ai)
+    {
+    }
+
+    SparsityPattern::~SparsityPattern()
+    {
+      free_with_check(this->Ap);
+      free_with_check(this->Ai);
+    }
+
+    void SparsityPattern::get_row_compressed(int* Ap_rows, int* Ai_rows) const
+    {
+      // Counting transposition - the columns are traversed in the increasing order,
+      // so that the column indices end up sorted within every row.
+      memset(Ap_rows, 0, (this->size + 1) * sizeof(int));
+      for (int k = 0; k < this->Ap[this->size]; k++)
+        Ap_rows[this->Ai[k] + 1]++;
+      for (unsigned int i = 0; i < this->size; i++)
+        Ap_rows[i + 1] += Ap_rows[i];
+
+      int* position = malloc_with_check<int>(this->size);
+      memcpy(position, Ap_rows, this->size * sizeof(int));
+      for (unsigned int col = 0; col < this->size; col++)
+        for (int k = this->Ap[col]; k < this->Ap[col + 1]; k++)
+          Ai_rows[position[this->Ai[k]]++] = col;
+      free_with_check(position);
+    }
+
     template<typename Scalar>
     Matrix<Scalar>::Matrix(unsigned int size) : size(size)
     {
@@ -238,6 +266,20 @@ namespace Hermes
       pages = malloc_with_check<SparseMatrix<Scalar>, Page>(n, this);
     }
 
+    template<typename Scalar>
+    void SparseMatrix<Scalar>::alloc_from_pattern(const SparsityPattern* pattern)
+    {
+      this->prealloc(pattern->get_size());
+
+      const int* Ap = pattern->get_Ap();
+      const int* Ai = pattern->get_Ai();
+      for (unsigned int col = 0; col < pattern->get_size(); col++)
+        for (int k = Ap[col]; k < Ap[col + 1]; k++)
+          this->pre_add_ij(Ai[k], col);
+
+      this->alloc();
+    }
+
     template<typename Scalar>
     void SparseMatrix<Scalar>::pre_add_ij(unsigned int row, unsigned int col)
     {
@@ -303,6 +345,12 @@ namespace Hermes
       {
         return new CSCMatrix < double > ;
       }
+      case Hermes::SOLVER_PMULTIGRID:
+      {
+        if (use_direct_solver)
+          throw Hermes::Exceptions::Exception("The iterative solver p-multigrid selected as a direct solver.");
+        return new CSRMatrix < double > ;
+      }
 
       case Hermes::SOLVER_AMESOS:
       {
@@ -327,6 +375,8 @@ namespace Hermes
       case Hermes::SOLVER_MUMPS:
       {
 #ifdef WITH_MUMPS
+        if (Hermes::HermesCommonApi.get_integral_param_value(Hermes::useSymmetricMatrices))
+          return new SymmetricCSCMatrix < double > ;
         return new MumpsMatrix < double > ;
 #else
         throw Hermes::Exceptions::Exception("MUMPS not installed.");
@@ -347,6 +397,8 @@ namespace Hermes
       case Hermes::SOLVER_UMFPACK:
       {
 #ifdef WITH_UMFPACK
+        if (Hermes::HermesCommonApi.get_integral_param_value(Hermes::useSymmetricMatrices))
+          return new SymmetricCSCMatrix < double > ;
         return new CSCMatrix < double > ;
 #else
         throw Hermes::Exceptions::Exception("UMFPACK was not installed.");
@@ -389,6 +441,12 @@ namespace Hermes
       {
         return new CSCMatrix < std::complex<double> > ;
       }
+      case Hermes::SOLVER_PMULTIGRID:
+      {
+        if (use_direct_solver)
+          throw Hermes::Exceptions::Exception("The iterative solver p-multigrid selected as a direct solver.");
+        return new CSRMatrix < std::complex<double> > ;
+      }
       case Hermes::SOLVER_AMESOS:
       {
 #if defined HAVE_AMESOS && defined HAVE_EPETRA
@@ -412,6 +470,8 @@ namespace Hermes
       case Hermes::SOLVER_MUMPS:
       {
 #ifdef WITH_MUMPS
+        if (Hermes::HermesCommonApi.get_integral_param_value(Hermes::useSymmetricMatrices))
+          return new SymmetricCSCMatrix < std::complex<double> > ;
         return new MumpsMatrix < std::complex<double> > ;
 #else
         throw Hermes::Exceptions::Exception("MUMPS not installed.");
@@ -432,6 +492,8 @@ namespace Hermes
       case Hermes::SOLVER_UMFPACK:
       {
 #ifdef WITH_UMFPACK
+        if (Hermes::HermesCommonApi.get_integral_param_value(Hermes::useSymmetricMatrices))
+          return new SymmetricCSCMatrix < std::complex<double> > ;
         return new CSCMatrix < std::complex<double> > ;
 #else
         throw Hermes::Exceptions::Exception("UMFPACK was not installed.");
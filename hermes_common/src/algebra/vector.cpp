@@ -461,8 +461,8 @@ namespace Hermes
     template<>
     void SimpleVector<std::complex<double> >::add(unsigned int idx, std::complex<double> y)
     {
-#pragma omp critical (SimpleVector_add)
-      this->v[idx] += y;
+      if (y != 0.0)
+        atomic_add(this->v[idx], y);
     }
 
     template<typename Scalar>
@@ -535,6 +535,12 @@ namespace Hermes
       {
         return new SimpleVector < double > ;
       }
+      case Hermes::SOLVER_PMULTIGRID:
+      {
+        if (use_direct_solver)
+          throw Hermes::Exceptions::Exception("The iterative solver p-multigrid selected as a direct solver.");
+        return new SimpleVector < double > ;
+      }
       case Hermes::SOLVER_AMESOS:
       {
 #if defined HAVE_AMESOS && defined HAVE_EPETRA
@@ -620,6 +626,12 @@ namespace Hermes
       {
         return new SimpleVector < std::complex<double> > ;
       }
+      case Hermes::SOLVER_PMULTIGRID:
+      {
+        if (use_direct_solver)
+          throw Hermes::Exceptions::Exception("The iterative solver p-multigrid selected as a direct solver.");
+        return new SimpleVector < std::complex<double> > ;
+      }
 
       case Hermes::SOLVER_AMESOS:
       {
@@ -698,10 +710,107 @@ namespace Hermes
       return nullptr;
     }
 
+    template<typename Scalar>
+    SimpleVectorBlock<Scalar>::SimpleVectorBlock() : v(nullptr), size(0), num_vectors(0)
+    {
+    }
+
+    template<typename Scalar>
+    SimpleVectorBlock<Scalar>::SimpleVectorBlock(unsigned int size, unsigned int num_vectors) : v(nullptr), size(0), num_vectors(0)
+    {
+      if (size == 0)
+        throw Exceptions::ValueException("size", size, 1);
+      if (num_vectors == 0)
+        throw Exceptions::ValueException("num_vectors", num_vectors, 1);
+      this->alloc(size, num_vectors);
+    }
+
+    template<typename Scalar>
+    SimpleVectorBlock<Scalar>::~SimpleVectorBlock()
+    {
+      free();
+    }
+
+    template<typename Scalar>
+    void SimpleVectorBlock<Scalar>::alloc(unsigned int size, unsigned int num_vectors)
+    {
+      free();
+      this->size = size;
+      this->num_vectors = num_vectors;
+      this->v = malloc_with_check<SimpleVectorBlock<Scalar>, Scalar>(size * num_vectors, this);
+      zero();
+    }
+
+    template<typename Scalar>
+    void SimpleVectorBlock<Scalar>::free()
+    {
+      free_with_check(this->v);
+      this->size = 0;
+      this->num_vectors = 0;
+    }
+
+    template<typename Scalar>
+    void SimpleVectorBlock<Scalar>::zero()
+    {
+      memset(this->v, 0, this->size * this->num_vectors * sizeof(Scalar));
+    }
+
+    template<typename Scalar>
+    Scalar SimpleVectorBlock<Scalar>::get(unsigned int vector_i, unsigned int idx) const
+    {
+      return this->v[vector_i * this->size + idx];
+    }
+
+    template<>
+    void SimpleVectorBlock<double>::add(unsigned int vector_i, unsigned int idx, double y)
+    {
+      if (y != 0.0)
+      {
+#pragma omp atomic
+        this->v[vector_i * this->size + idx] += y;
+      }
+    }
+
+    template<>
+    void SimpleVectorBlock<std::complex<double> >::add(unsigned int vector_i, unsigned int idx, std::complex<double> y)
+    {
+      if (y != 0.0)
+        atomic_add(this->v[vector_i * this->size + idx], y);
+    }
+
+    template<typename Scalar>
+    void SimpleVectorBlock<Scalar>::add_vector_to_all(Vector<Scalar>* vec)
+    {
+      assert(this->size == vec->get_size());
+      for (unsigned int i = 0; i < this->size; i++)
+      {
+        Scalar value = vec->get(i);
+        for (unsigned int vector_i = 0; vector_i < this->num_vectors; vector_i++)
+          this->v[vector_i * this->size + i] += value;
+      }
+    }
+
+    template<typename Scalar>
+    Scalar* SimpleVectorBlock<Scalar>::get_vector(unsigned int vector_i) const
+    {
+      return this->v + vector_i * this->size;
+    }
+
+    template<typename Scalar>
+    void SimpleVectorBlock<Scalar>::extract(unsigned int vector_i, Vector<Scalar>* vec) const
+    {
+      if (vec->get_size() != this->size)
+        vec->alloc(this->size);
+      vec->set_vector(this->get_vector(vector_i));
+    }
+
     template class Vector < double > ;
     template class Vector < std::complex<double> > ;
 
     template class SimpleVector < double > ;
     template class SimpleVector < std::complex<double> > ;
+
+    template class SimpleVectorBlock < double > ;
+    template class SimpleVectorBlock < std::complex<double> > ;
   }
 }
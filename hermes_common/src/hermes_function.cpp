@@ -118,6 +118,20 @@ namespace Hermes
     }
   };
 
+  template<typename Scalar>
+  void Hermes1DFunction<Scalar>::values(int n, const Scalar* x, Scalar* result) const
+  {
+    for (int i = 0; i < n; i++)
+      result[i] = this->value(x[i]);
+  };
+
+  template<typename Scalar>
+  void Hermes1DFunction<Scalar>::derivatives(int n, const Scalar* x, Scalar* result) const
+  {
+    for (int i = 0; i < n; i++)
+      result[i] = this->derivative(x[i]);
+  };
+
   template<typename Scalar>
   Hermes2DFunction<Scalar>::Hermes2DFunction()
   {
@@ -237,6 +251,13 @@ namespace Hermes
     }
   };
 
+  template<typename Scalar>
+  void Hermes2DFunction<Scalar>::values(int n, const double* x, const double* y, Scalar* result) const
+  {
+    for (int i = 0; i < n; i++)
+      result[i] = this->value(x[i], y[i]);
+  };
+
   template<typename Scalar>
   Hermes3DFunction<Scalar>::Hermes3DFunction()
   {
@@ -190,8 +190,10 @@ namespace Hermes
         throw Hermes::Exceptions::Exception("Sparse matrix entry not found");
       // Add offset to the n-th column.
       pos += this->Ap[n];
-#pragma omp critical (MumpsMatrix_add)
-      Ax[pos] += v;
+#pragma omp atomic
+      Ax[pos].r += v.real();
+#pragma omp atomic
+      Ax[pos].i += v.imag();
       // MUMPS is indexing from 1
       irn[pos] = m + 1;
       jcn[pos] = n + 1;
@@ -578,18 +580,19 @@ namespace Hermes
       irn = malloc_with_check<MumpsMatrix<Scalar>, int>(this->nnz, this);
       jcn = malloc_with_check<MumpsMatrix<Scalar>, int>(this->nnz, this);
 
+      // MUMPS is indexing from 1
       for (unsigned int i = 0; i < this->size; i++)
       {
         this->Ap[i] = ap[i];
         for (int j = ap[i]; j < ap[i + 1]; j++)
-          jcn[j] = i;
+          jcn[j] = i + 1;
       }
       this->Ap[this->size] = ap[this->size];
       for (unsigned int i = 0; i < this->nnz; i++)
       {
         mumps_assign_Scalar(this->Ax[i], ax[i]);
         this->Ai[i] = ai[i];
-        irn[i] = ai[i];
+        irn[i] = ai[i] + 1;
       }
     }
 
@@ -639,7 +642,7 @@ namespace Hermes
 
     template<typename Scalar>
     MumpsSolver<Scalar>::MumpsSolver(MumpsMatrix<Scalar> *m, SimpleVector<Scalar> *rhs) :
-      DirectSolver<Scalar>(m, rhs), m(m), rhs(rhs), icntl_14(init_icntl_14)
+      DirectSolver<Scalar>(m, rhs), m(m), symmetric_matrix(nullptr), rhs(rhs), icntl_14(init_icntl_14)
     {
       inited = false;
 
@@ -651,10 +654,38 @@ namespace Hermes
       // in setup_factorization()
     }
 
+    template<typename Scalar>
+    MumpsSolver<Scalar>::MumpsSolver(SymmetricCSCMatrix<Scalar> *m, SimpleVector<Scalar> *rhs) :
+      DirectSolver<Scalar>(m, rhs), m(new MumpsMatrix<Scalar>()), symmetric_matrix(m), rhs(rhs), icntl_14(init_icntl_14)
+    {
+      inited = false;
+
+      // See the other constructor.
+      param.rhs = nullptr;
+      param.INFOG(33) = -999;
+    }
+
     template<typename Scalar>
     MumpsSolver<Scalar>::~MumpsSolver()
     {
       free();
+      if (symmetric_matrix)
+        delete m;
+    }
+
+    template<typename Scalar>
+    void MumpsSolver<Scalar>::convert_symmetric_matrix()
+    {
+      // The stored lower triangle in the coordinate format is exactly the input of the symmetric mode.
+      m->free();
+      m->create(symmetric_matrix->get_size(), symmetric_matrix->get_nnz(), symmetric_matrix->get_Ap(), symmetric_matrix->get_Ai(), symmetric_matrix->get_Ax());
+
+      // The arrays have been reallocated.
+      param.n = m->size;
+      param.nz = m->nnz;
+      param.irn = m->irn;
+      param.jcn = m->jcn;
+      param.a = m->Ax;
     }
 
     template<typename Scalar>
@@ -718,8 +749,8 @@ namespace Hermes
       param.job = JOB_INIT;
       // host also performs calculations
       param.par = 1;
-      // 0 = unsymmetric
-      param.sym = 0;
+      // 0 = unsymmetric, 2 = general symmetric (one triangle given)
+      param.sym = symmetric_matrix ? 2 : 0;
       param.comm_fortran = USE_COMM_WORLD;
 
       mumps_c(&param);
@@ -765,6 +796,8 @@ namespace Hermes
     template<typename Scalar>
     int MumpsSolver<Scalar>::get_matrix_size()
     {
+      if (symmetric_matrix)
+        return symmetric_matrix->get_size();
       return m->size;
     }
 
@@ -829,6 +862,58 @@ namespace Hermes
       param.rhs = nullptr;
     }
 
+    template<typename Scalar>
+    void MumpsSolver<Scalar>::solve_multiple(Scalar* rhs_block, unsigned int num_rhs)
+    {
+      assert(m != nullptr);
+
+      this->tick();
+
+      if (!setup_factorization())
+        throw Hermes::Exceptions::LinearMatrixSolverException("LU factorization could not be completed.");
+
+      // Specify the right-hand sides (will be replaced by the solutions), centralized dense, one after another.
+      param.nrhs = num_rhs;
+      param.lrhs = m->size;
+      param.rhs = malloc_with_check<MumpsSolver<Scalar>, typename mumps_type<Scalar>::mumps_Scalar>(m->size * num_rhs, this);
+      memcpy(param.rhs, rhs_block, m->size * num_rhs * sizeof(typename mumps_type<Scalar>::mumps_Scalar));
+
+      // Do the jobs specified in setup_factorization().
+      mumps_c(&param);
+
+      param.nrhs = 1;
+
+      // Throws appropriate exception.
+      if (check_status())
+      {
+        free_with_check(this->sln);
+        this->sln = malloc_with_check<MumpsSolver<Scalar>, Scalar>(m->size * num_rhs, this);
+        for (unsigned int i = 0; i < m->size * num_rhs; i++)
+          this->sln[i] = mumps_to_Scalar(param.rhs[i]);
+      }
+      else
+      {
+        free_with_check(param.rhs);
+
+        // See solve().
+        icntl_14 *= 2;
+        if (icntl_14 > max_icntl_14)
+          throw Hermes::Exceptions::LinearMatrixSolverException("MUMPS memory overflow - potentially singular matrix");
+        else
+        {
+          this->reinit();
+          this->solve_multiple(rhs_block, num_rhs);
+        }
+        return;
+      }
+
+      this->tick();
+      this->time = this->accumulated();
+
+      free_with_check(param.rhs);
+      param.rhs = nullptr;
+    }
+
     template<typename Scalar>
     bool MumpsSolver<Scalar>::setup_factorization()
     {
@@ -839,6 +924,9 @@ namespace Hermes
         if (this->reuse_scheme == HERMES_REUSE_MATRIX_REORDERING || this->reuse_scheme == HERMES_REUSE_MATRIX_STRUCTURE_COMPLETELY)
           eff_fact_scheme = HERMES_CREATE_STRUCTURE_FROM_SCRATCH;
 
+      if (symmetric_matrix && eff_fact_scheme != HERMES_REUSE_MATRIX_STRUCTURE_COMPLETELY)
+        convert_symmetric_matrix();
+
       switch (eff_fact_scheme)
       {
       case HERMES_CREATE_STRUCTURE_FROM_SCRATCH:
@@ -66,9 +66,9 @@ namespace Hermes
     }
 
     template<typename Scalar>
-    void ParalutionMatrix<Scalar>::alloc()
+    void ParalutionMatrix<Scalar>::alloc_data()
     {
-      CSRMatrix<Scalar>::alloc();
+      CSRMatrix<Scalar>::alloc_data();
 
 	  // This is here because PARALUTION for some reason NULLs these at the end of SetDataPtrCSR routine.
 	  int* ap = this->Ap;
@@ -28,10 +28,12 @@
 #define umfpack_real_symbolic umfpack_di_symbolic
 #define umfpack_real_numeric umfpack_di_numeric
 #define umfpack_real_solve umfpack_di_solve
+#define umfpack_real_wsolve umfpack_di_wsolve
 
 #define umfpack_complex_symbolic umfpack_zi_symbolic
 #define umfpack_complex_numeric umfpack_zi_numeric
 #define umfpack_complex_solve umfpack_zi_solve
+#define umfpack_complex_wsolve umfpack_zi_wsolve
 
 namespace Hermes
 {
@@ -45,9 +47,12 @@ namespace Hermes
 
     template<typename Scalar>
     UMFPackLinearMatrixSolver<Scalar>::UMFPackLinearMatrixSolver(CSCMatrix<Scalar> *m, SimpleVector<Scalar> *rhs)
-      : DirectSolver<Scalar>(m, rhs), m(m), rhs(rhs), symbolic(nullptr), numeric(nullptr)
+      : DirectSolver<Scalar>(m, rhs), m(m), rhs(rhs), symbolic(nullptr), numeric(nullptr), full_matrix(nullptr)
     {
       umfpack_di_defaults(Control);
+      // UMFPACK does not take one triangle, but it can use the ordering for symmetric matrices.
+      if (dynamic_cast<SymmetricCSCMatrix<Scalar>*>(m))
+        Control[UMFPACK_STRATEGY] = UMFPACK_STRATEGY_SYMMETRIC;
     }
 
     template<typename Scalar>
@@ -60,6 +65,35 @@ namespace Hermes
     void UMFPackLinearMatrixSolver<Scalar>::free()
     {
       free_factorization_data();
+      if (full_matrix)
+      {
+        delete full_matrix;
+        full_matrix = nullptr;
+      }
+    }
+
+    template<typename Scalar>
+    void UMFPackLinearMatrixSolver<Scalar>::update_full_matrix(MatrixStructureReuseScheme scheme)
+    {
+      SymmetricCSCMatrix<Scalar>* symmetric_matrix = dynamic_cast<SymmetricCSCMatrix<Scalar>*>(m);
+      if (symmetric_matrix)
+      {
+        // The structure is the same unless it is created from scratch, only the values are copied.
+        if (full_matrix && scheme != HERMES_CREATE_STRUCTURE_FROM_SCRATCH && full_matrix->get_size() == m->get_size())
+          symmetric_matrix->copy_values_to_full_matrix(full_matrix);
+        else
+        {
+          if (full_matrix)
+            delete full_matrix;
+          full_matrix = symmetric_matrix->create_full_matrix();
+        }
+      }
+    }
+
+    template<typename Scalar>
+    CSCMatrix<Scalar>* UMFPackLinearMatrixSolver<Scalar>::get_factorized_matrix() const
+    {
+      return full_matrix ? full_matrix : m;
     }
 
     template<typename Scalar>
@@ -75,6 +109,9 @@ namespace Hermes
       if (reuse_scheme != HERMES_CREATE_STRUCTURE_FROM_SCRATCH && symbolic == nullptr && numeric == nullptr)
         reuse_scheme = HERMES_CREATE_STRUCTURE_FROM_SCRATCH;
 
+      if (reuse_scheme != HERMES_REUSE_MATRIX_STRUCTURE_COMPLETELY)
+        update_full_matrix(reuse_scheme);
+
       int status;
       switch (reuse_scheme)
       {
@@ -86,7 +123,7 @@ namespace Hermes
         }
 
         // Factorizing symbolically.
-        status = umfpack_real_symbolic(m->get_size(), m->get_size(), m->get_Ap(), m->get_Ai(), m->get_Ax(), &symbolic, Control, Info);
+        status = umfpack_real_symbolic(m->get_size(), m->get_size(), get_factorized_matrix()->get_Ap(), get_factorized_matrix()->get_Ai(), get_factorized_matrix()->get_Ax(), &symbolic, Control, Info);
         if (status != UMFPACK_OK)
         {
           if (symbolic)
@@ -103,7 +140,7 @@ namespace Hermes
         }
 
         // Factorizing numerically.
-        status = umfpack_real_numeric(m->get_Ap(), m->get_Ai(), m->get_Ax(), symbolic, &numeric, Control, Info);
+        status = umfpack_real_numeric(get_factorized_matrix()->get_Ap(), get_factorized_matrix()->get_Ai(), get_factorized_matrix()->get_Ax(), symbolic, &numeric, Control, Info);
         if (status != UMFPACK_OK)
         {
           if (numeric)
@@ -127,6 +164,9 @@ namespace Hermes
       else
         eff_fact_scheme = reuse_scheme;
 
+      if (eff_fact_scheme != HERMES_REUSE_MATRIX_STRUCTURE_COMPLETELY)
+        update_full_matrix((MatrixStructureReuseScheme)eff_fact_scheme);
+
       int status;
       switch (eff_fact_scheme)
       {
@@ -134,7 +174,7 @@ namespace Hermes
         if (symbolic != nullptr)
           umfpack_zi_free_symbolic(&symbolic);
 
-        status = umfpack_complex_symbolic(m->get_size(), m->get_size(), m->get_Ap(), m->get_Ai(), (double *)m->get_Ax(), nullptr, &symbolic, nullptr, nullptr);
+        status = umfpack_complex_symbolic(m->get_size(), m->get_size(), get_factorized_matrix()->get_Ap(), get_factorized_matrix()->get_Ai(), (double *)get_factorized_matrix()->get_Ax(), nullptr, &symbolic, nullptr, nullptr);
         if (status != UMFPACK_OK)
         {
           if (symbolic)
@@ -147,7 +187,7 @@ namespace Hermes
         if (numeric != nullptr)
           umfpack_zi_free_numeric(&numeric);
 
-        status = umfpack_complex_numeric(m->get_Ap(), m->get_Ai(), (double *)m->get_Ax(), nullptr, symbolic, &numeric, nullptr, nullptr);
+        status = umfpack_complex_numeric(get_factorized_matrix()->get_Ap(), get_factorized_matrix()->get_Ai(), (double *)get_factorized_matrix()->get_Ax(), nullptr, symbolic, &numeric, nullptr, nullptr);
         if (status != UMFPACK_OK)
         {
           if (numeric)
@@ -192,7 +232,7 @@ namespace Hermes
       free_with_check(sln);
 
       sln = calloc_with_check<UMFPackLinearMatrixSolver<double>, double>(m->get_size(), this);
-      int status = umfpack_real_solve(UMFPACK_A, m->get_Ap(), m->get_Ai(), m->get_Ax(), sln, rhs->v, numeric, nullptr, nullptr);
+      int status = umfpack_real_solve(UMFPACK_A, get_factorized_matrix()->get_Ap(), get_factorized_matrix()->get_Ai(), get_factorized_matrix()->get_Ax(), sln, rhs->v, numeric, nullptr, nullptr);
       if (status != UMFPACK_OK)
       {
         this->free_factorization_data();
@@ -217,7 +257,7 @@ namespace Hermes
       sln = malloc_with_check<UMFPackLinearMatrixSolver<std::complex<double> >, std::complex<double> >(m->get_size(), this);
 
       memset(sln, 0, m->get_size() * sizeof(std::complex<double>));
-      int status = umfpack_complex_solve(UMFPACK_A, m->get_Ap(), m->get_Ai(), (double *)m->get_Ax(), nullptr, (double*)sln, nullptr, (double *)rhs->v, nullptr, numeric, nullptr, nullptr);
+      int status = umfpack_complex_solve(UMFPACK_A, get_factorized_matrix()->get_Ap(), get_factorized_matrix()->get_Ai(), (double *)get_factorized_matrix()->get_Ax(), nullptr, (double*)sln, nullptr, (double *)rhs->v, nullptr, numeric, nullptr, nullptr);
       if (status != UMFPACK_OK)
       {
         this->free_factorization_data();
@@ -228,6 +268,80 @@ namespace Hermes
       time = this->accumulated();
     }
 
+    template<>
+    void UMFPackLinearMatrixSolver<double>::solve_multiple(double* rhs_block, unsigned int num_rhs)
+    {
+      assert(m != nullptr);
+
+      this->tick();
+
+      if (!setup_factorization())
+        throw Exceptions::LinearMatrixSolverException("LU factorization could not be completed.");
+
+      unsigned int size = m->get_size();
+      free_with_check(sln);
+      sln = calloc_with_check<UMFPackLinearMatrixSolver<double>, double>(size * num_rhs, this);
+
+      // Workspace for umfpack_di_wsolve (sized for iterative refinement), shared by all right-hand sides.
+      int* Wi = malloc_with_check<UMFPackLinearMatrixSolver<double>, int>(size, this);
+      double* W = malloc_with_check<UMFPackLinearMatrixSolver<double>, double>(5 * size, this);
+
+      for (unsigned int rhs_i = 0; rhs_i < num_rhs; rhs_i++)
+      {
+        int status = umfpack_real_wsolve(UMFPACK_A, get_factorized_matrix()->get_Ap(), get_factorized_matrix()->get_Ai(), get_factorized_matrix()->get_Ax(), sln + rhs_i * size, rhs_block + rhs_i * size, numeric, nullptr, nullptr, Wi, W);
+        if (status != UMFPACK_OK)
+        {
+          free_with_check(Wi);
+          free_with_check(W);
+          this->free_factorization_data();
+          throw Exceptions::LinearMatrixSolverException(check_status("UMFPACK solution", status));
+        }
+      }
+
+      free_with_check(Wi);
+      free_with_check(W);
+
+      this->tick();
+      time = this->accumulated();
+    }
+
+    template<>
+    void UMFPackLinearMatrixSolver<std::complex<double> >::solve_multiple(std::complex<double>* rhs_block, unsigned int num_rhs)
+    {
+      assert(m != nullptr);
+
+      this->tick();
+
+      if (!setup_factorization())
+        throw Exceptions::LinearMatrixSolverException("LU factorization could not be completed.");
+
+      unsigned int size = m->get_size();
+      free_with_check(sln);
+      sln = calloc_with_check<UMFPackLinearMatrixSolver<std::complex<double> >, std::complex<double> >(size * num_rhs, this);
+
+      // Workspace for umfpack_zi_wsolve (sized for iterative refinement), shared by all right-hand sides.
+      int* Wi = malloc_with_check<UMFPackLinearMatrixSolver<std::complex<double> >, int>(size, this);
+      double* W = malloc_with_check<UMFPackLinearMatrixSolver<std::complex<double> >, double>(10 * size, this);
+
+      for (unsigned int rhs_i = 0; rhs_i < num_rhs; rhs_i++)
+      {
+        int status = umfpack_complex_wsolve(UMFPACK_A, get_factorized_matrix()->get_Ap(), get_factorized_matrix()->get_Ai(), (double *)get_factorized_matrix()->get_Ax(), nullptr, (double*)(sln + rhs_i * size), nullptr, (double *)(rhs_block + rhs_i * size), nullptr, numeric, nullptr, nullptr, Wi, W);
+        if (status != UMFPACK_OK)
+        {
+          free_with_check(Wi);
+          free_with_check(W);
+          this->free_factorization_data();
+          throw Exceptions::LinearMatrixSolverException(check_status("UMFPACK solution", status));
+        }
+      }
+
+      free_with_check(Wi);
+      free_with_check(W);
+
+      this->tick();
+      time = this->accumulated();
+    }
+
     template<typename Scalar>
     char* UMFPackLinearMatrixSolver<Scalar>::check_status(const char *fn_name, int status)
     {
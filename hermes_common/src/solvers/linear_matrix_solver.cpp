@@ -109,6 +109,39 @@ namespace Hermes
       this->node_wise_ordering = false;
     }
 
+    template<typename Scalar>
+    void LinearMatrixSolver<Scalar>::solve_multiple(Scalar* rhs_block, unsigned int num_rhs)
+    {
+      unsigned int size = this->get_matrix_size();
+      Scalar* sln_block = malloc_with_check<LinearMatrixSolver<Scalar>, Scalar>(size * num_rhs, this);
+
+      if (this->general_rhs->get_size() != size)
+        this->general_rhs->alloc(size);
+
+      // The first right-hand side sets up the factorization as requested, the others only reuse it.
+      MatrixStructureReuseScheme original_reuse_scheme = this->reuse_scheme;
+      try
+      {
+        for (unsigned int rhs_i = 0; rhs_i < num_rhs; rhs_i++)
+        {
+          this->general_rhs->set_vector(rhs_block + rhs_i * size);
+          this->solve();
+          memcpy(sln_block + rhs_i * size, this->sln, size * sizeof(Scalar));
+          this->set_reuse_scheme(HERMES_REUSE_MATRIX_STRUCTURE_COMPLETELY);
+        }
+      }
+      catch (...)
+      {
+        free_with_check(sln_block);
+        this->set_reuse_scheme(original_reuse_scheme);
+        throw;
+      }
+      this->set_reuse_scheme(original_reuse_scheme);
+
+      free_with_check(this->sln);
+      this->sln = sln_block;
+    }
+
     template<typename Scalar>
     double LinearMatrixSolver<Scalar>::get_residual_norm()
     {
@@ -176,6 +209,18 @@ namespace Hermes
     template<>
     ExternalSolver<std::complex<double> >::creation ExternalSolver<std::complex<double> >::create_external_solver = static_create_external_solver < std::complex<double> > ;
 
+    template<typename Scalar>
+    LinearMatrixSolver<Scalar>* static_create_pmultigrid_solver(SparseMatrix<Scalar> *m, Vector<Scalar> *rhs)
+    {
+      throw Exceptions::Exception("The p-multigrid solver is a part of Hermes2D, it can not be used without it.");
+      return nullptr;
+    }
+
+    template<>
+    PMultigridSolverCreation<double>::creation PMultigridSolverCreation<double>::create_pmultigrid_solver = static_create_pmultigrid_solver < double > ;
+    template<>
+    PMultigridSolverCreation<std::complex<double> >::creation PMultigridSolverCreation<std::complex<double> >::create_pmultigrid_solver = static_create_pmultigrid_solver < std::complex<double> > ;
+
     template<>
     HERMES_API LinearMatrixSolver<double>* create_linear_solver(Matrix<double>* matrix, Vector<double>* rhs, bool use_direct_solver)
     {
@@ -189,6 +234,12 @@ namespace Hermes
         else
           return ExternalSolver<double>::create_external_solver(static_cast<CSCMatrix<double>*>(matrix), static_cast<SimpleVector<double>*>(rhs_dummy));
       }
+      case Hermes::SOLVER_PMULTIGRID:
+      {
+        if (use_direct_solver)
+          throw Hermes::Exceptions::Exception("The iterative solver p-multigrid selected as a direct solver.");
+        return PMultigridSolverCreation<double>::create_pmultigrid_solver(static_cast<SparseMatrix<double>*>(matrix), rhs);
+      }
       case Hermes::SOLVER_AZTECOO:
       {
         if (use_direct_solver)
@@ -214,6 +265,9 @@ namespace Hermes
       case Hermes::SOLVER_MUMPS:
       {
 #ifdef WITH_MUMPS
+        // One triangle - the symmetric mode.
+        if (dynamic_cast<SymmetricCSCMatrix<double>*>(matrix))
+          return new MumpsSolver<double>(static_cast<SymmetricCSCMatrix<double>*>(matrix), static_cast<SimpleVector<double>*>(rhs));
         if (rhs != nullptr) return new MumpsSolver<double>(static_cast<MumpsMatrix<double>*>(matrix), static_cast<SimpleVector<double>*>(rhs));
         else return new MumpsSolver<double>(static_cast<MumpsMatrix<double>*>(matrix), static_cast<SimpleVector<double>*>(rhs_dummy));
 #else
@@ -268,6 +322,8 @@ namespace Hermes
       case Hermes::SOLVER_SUPERLU:
       {
 #ifdef WITH_SUPERLU
+        if (dynamic_cast<SymmetricCSCMatrix<double>*>(matrix))
+          throw Hermes::Exceptions::Exception("SuperLU does not support SymmetricCSCMatrix, use UMFPACK or MUMPS.");
         if (rhs != nullptr) return new SuperLUSolver<double>(static_cast<CSCMatrix<double>*>(matrix), static_cast<SimpleVector<double>*>(rhs));
         else return new SuperLUSolver<double>(static_cast<CSCMatrix<double>*>(matrix), static_cast<SimpleVector<double>*>(rhs_dummy));
 #else
@@ -294,6 +350,12 @@ namespace Hermes
         else
           return ExternalSolver<std::complex<double> >::create_external_solver(static_cast<CSCMatrix<std::complex<double> >*>(matrix), static_cast<SimpleVector<std::complex<double> >*>(rhs_dummy));
       }
+      case Hermes::SOLVER_PMULTIGRID:
+      {
+        if (use_direct_solver)
+          throw Hermes::Exceptions::Exception("The iterative solver p-multigrid selected as a direct solver.");
+        return PMultigridSolverCreation<std::complex<double> >::create_pmultigrid_solver(static_cast<SparseMatrix<std::complex<double> >*>(matrix), rhs);
+      }
       case Hermes::SOLVER_AZTECOO:
       {
         if (use_direct_solver)
@@ -319,6 +381,9 @@ namespace Hermes
       case Hermes::SOLVER_MUMPS:
       {
 #ifdef WITH_MUMPS
+        // One triangle - the symmetric mode.
+        if (dynamic_cast<SymmetricCSCMatrix<std::complex<double> >*>(matrix))
+          return new MumpsSolver<std::complex<double> >(static_cast<SymmetricCSCMatrix<std::complex<double> >*>(matrix), static_cast<SimpleVector<std::complex<double> >*>(rhs));
         if (rhs != nullptr) return new MumpsSolver<std::complex<double> >(static_cast<MumpsMatrix<std::complex<double> >*>(matrix), static_cast<SimpleVector<std::complex<double> >*>(rhs));
         else return new MumpsSolver<std::complex<double> >(static_cast<MumpsMatrix<std::complex<double> >*>(matrix), static_cast<SimpleVector<std::complex<double> >*>(rhs_dummy));
 #else
@@ -363,6 +428,8 @@ namespace Hermes
       case Hermes::SOLVER_SUPERLU:
       {
 #ifdef WITH_SUPERLU
+        if (dynamic_cast<SymmetricCSCMatrix<std::complex<double> >*>(matrix))
+          throw Hermes::Exceptions::Exception("SuperLU does not support SymmetricCSCMatrix, use UMFPACK or MUMPS.");
         if (rhs != nullptr) return new SuperLUSolver<std::complex<double> >(static_cast<CSCMatrix<std::complex<double> >*>(matrix), static_cast<SimpleVector<std::complex<double> >*>(rhs));
         else return new SuperLUSolver<std::complex<double> >(static_cast<CSCMatrix<std::complex<double> >*>(matrix), static_cast<SimpleVector<std::complex<double> >*>(rhs_dummy));
 #else
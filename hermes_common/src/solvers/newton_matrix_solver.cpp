@@ -18,8 +18,11 @@
 // Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
 
 #include "newton_matrix_solver.h"
+#include "dense_matrix_operations.h"
+#include "util/memory_handling.h"
 
 using namespace Hermes::Algebra;
+using namespace Hermes::Algebra::DenseMatrixOperations;
 
 namespace Hermes
 {
@@ -44,9 +47,176 @@ namespace Hermes
       this->sufficient_improvement_factor_jacobian = 1e-1;
       this->max_steps_with_reused_jacobian = 3;
 
+      this->line_search = NewtonLineSearchBacktracking;
+      this->line_search_iteration = -1;
+      this->line_search_newton_direction = false;
+
+      this->anderson_is_on = false;
+      this->num_last_vectors_used = 4;
+      this->anderson_beta = 1.0;
+      this->anderson_iterates = nullptr;
+      this->anderson_increments = nullptr;
+      this->anderson_vec_in_memory = 0;
+
+      this->jfnk_is_on = false;
+      this->jfnk_tolerance = 1e-4;
+      this->jfnk_max_iterations = 50;
+      this->jfnk_restart = 20;
+
       this->set_tolerance(1e-8, ResidualNormAbsolute);
     }
 
+    template<typename Scalar>
+    void NewtonMatrixSolver<Scalar>::set_line_search(NewtonLineSearch line_search_)
+    {
+      if (this->manual_damping)
+        this->warn("Manual damping is turned on and you called set_line_search(), turn off manual damping first by set_manual_damping_coeff(false);");
+      this->line_search = line_search_;
+    }
+
+    template<typename Scalar>
+    void NewtonMatrixSolver<Scalar>::use_Anderson_acceleration(bool to_set)
+    {
+      this->anderson_is_on = to_set;
+    }
+
+    template<typename Scalar>
+    void NewtonMatrixSolver<Scalar>::set_num_last_vector_used(int num)
+    {
+      if (num < 2)
+        throw Exceptions::ValueException("num_last_vectors_used", num, 2);
+      this->num_last_vectors_used = num;
+    }
+
+    template<typename Scalar>
+    void NewtonMatrixSolver<Scalar>::set_anderson_beta(double beta)
+    {
+      this->anderson_beta = beta;
+    }
+
+    template<typename Scalar>
+    void NewtonMatrixSolver<Scalar>::use_Jacobian_free_Newton_Krylov(bool to_set)
+    {
+      this->jfnk_is_on = to_set;
+    }
+
+    template<typename Scalar>
+    void NewtonMatrixSolver<Scalar>::set_JFNK_GMRES_parameters(double tolerance, int max_iterations, int restart)
+    {
+      if (max_iterations < 1)
+        throw Exceptions::ValueException("max_iterations", max_iterations, 1);
+      if (restart < 1)
+        throw Exceptions::ValueException("restart", restart, 1);
+      this->jfnk_tolerance = tolerance;
+      this->jfnk_max_iterations = max_iterations;
+      this->jfnk_restart = restart;
+    }
+
+    template<typename Scalar>
+    void NewtonMatrixSolver<Scalar>::init_solving(Scalar* coeff_vec)
+    {
+      NonlinearMatrixSolver<Scalar>::init_solving(coeff_vec);
+      this->line_search_iteration = -1;
+
+      // The same conditions as in solve_linear_system(), except for the reuse scheme of the step.
+      bool loop_solver = dynamic_cast<LoopSolver<Scalar>*>(this->linear_matrix_solver) != nullptr;
+      if (this->jfnk_is_on && loop_solver)
+        this->warn("The Jacobian-free Newton-Krylov steps need a direct linear solver, they will not be used.");
+      bool jfnk_used = this->jfnk_is_on && !this->constant_jacobian && !loop_solver;
+
+      if (this->anderson_is_on && !jfnk_used)
+      {
+        this->anderson_iterates = malloc_with_check<NewtonMatrixSolver<Scalar>, Scalar*>(this->num_last_vectors_used, this);
+        this->anderson_increments = malloc_with_check<NewtonMatrixSolver<Scalar>, Scalar*>(this->num_last_vectors_used, this);
+        for (int i = 0; i < this->num_last_vectors_used; i++)
+        {
+          this->anderson_iterates[i] = malloc_with_check<NewtonMatrixSolver<Scalar>, Scalar>(this->problem_size, this);
+          this->anderson_increments[i] = malloc_with_check<NewtonMatrixSolver<Scalar>, Scalar>(this->problem_size, this);
+        }
+        this->anderson_vec_in_memory = 0;
+      }
+    }
+
+    template<typename Scalar>
+    void NewtonMatrixSolver<Scalar>::deinit_solving()
+    {
+      this->deinit_anderson();
+      NonlinearMatrixSolver<Scalar>::deinit_solving();
+    }
+
+    template<typename Scalar>
+    void NewtonMatrixSolver<Scalar>::deinit_anderson()
+    {
+      if (this->anderson_iterates)
+      {
+        for (int i = 0; i < this->num_last_vectors_used; i++)
+        {
+          free_with_check(this->anderson_iterates[i]);
+          free_with_check(this->anderson_increments[i]);
+        }
+        free_with_check(this->anderson_iterates);
+        free_with_check(this->anderson_increments);
+      }
+    }
+
+    template<typename Scalar>
+    double NewtonMatrixSolver<Scalar>::get_reduced_damping_factor(double current_damping_factor)
+    {
+      // The slope below is not known for other steps.
+      if (this->line_search == NewtonLineSearchBacktracking || !this->line_search_newton_direction)
+        return NonlinearMatrixSolver<Scalar>::get_reduced_damping_factor(current_damping_factor);
+
+      // phi(lambda) = 1/2 ||F(x + lambda dx)||^2, phi'(0) = -||F(x)||^2 for the Newton direction dx.
+      std::vector<double>& residual_norms = this->get_parameter_value(this->p_residual_norms);
+      double residual_norm = residual_norms.back();
+      double previous_residual_norm = residual_norms[residual_norms.size() - 2];
+      double phi_0 = 0.5 * previous_residual_norm * previous_residual_norm;
+      double slope = -previous_residual_norm * previous_residual_norm;
+      double lambda = current_damping_factor;
+      double phi = 0.5 * residual_norm * residual_norm;
+
+      double new_damping_factor;
+      if (this->line_search_iteration != this->get_current_iteration_number())
+      {
+        // First rejection of this step - quadratic model.
+        new_damping_factor = -slope * lambda * lambda / (2. * (phi - phi_0 - slope * lambda));
+      }
+      else
+      {
+        // Cubic model through the last two rejected coefficients.
+        double lambda_2 = this->line_search_previous_damping_factor;
+        double phi_2 = 0.5 * this->line_search_previous_residual_norm * this->line_search_previous_residual_norm;
+        double rhs_1 = (phi - phi_0 - slope * lambda) / (lambda * lambda);
+        double rhs_2 = (phi_2 - phi_0 - slope * lambda_2) / (lambda_2 * lambda_2);
+        double a = (rhs_1 - rhs_2) / (lambda - lambda_2);
+        double b = (-lambda_2 * rhs_1 + lambda * rhs_2) / (lambda - lambda_2);
+        if (a == 0.)
+          new_damping_factor = -slope / (2. * b);
+        else
+        {
+          double discriminant = b * b - 3. * a * slope;
+          if (discriminant < 0.)
+            new_damping_factor = 0.5 * lambda;
+          else if (b <= 0.)
+            new_damping_factor = (-b + std::sqrt(discriminant)) / (3. * a);
+          else
+            new_damping_factor = -slope / (b + std::sqrt(discriminant));
+        }
+      }
+
+      // Safeguard (also against non-finite residual norms).
+      if (!(new_damping_factor <= 0.5 * lambda))
+        new_damping_factor = 0.5 * lambda;
+      if (!(new_damping_factor >= 0.1 * lambda))
+        new_damping_factor = 0.1 * lambda;
+
+      this->line_search_iteration = this->get_current_iteration_number();
+      this->line_search_previous_damping_factor = lambda;
+      this->line_search_previous_residual_norm = residual_norm;
+
+      return new_damping_factor;
+    }
+
     template<typename Scalar>
     NonlinearConvergenceState NewtonMatrixSolver<Scalar>::get_convergence_state()
     {
@@ -63,6 +233,13 @@ namespace Hermes
     {
       double current_damping_factor = this->get_parameter_value(this->p_damping_factors).back();
 
+      // J(x) dx = -F(x) with the Jacobian assembled at this iterate (such steps are not combined by the Anderson acceleration).
+      bool reused_jacobian = this->linear_matrix_solver->get_used_reuse_scheme() == HERMES_REUSE_MATRIX_STRUCTURE_COMPLETELY;
+      this->line_search_newton_direction = !this->constant_jacobian && !reused_jacobian;
+
+      if (this->anderson_iterates)
+        return this->anderson_update_solution_return_change_norm(linear_system_solution, current_damping_factor, reused_jacobian);
+
       double solution_change_norm = 0.;
       for (int i = 0; i < this->problem_size; i++)
       {
@@ -72,6 +249,308 @@ namespace Hermes
       return std::sqrt(solution_change_norm) * current_damping_factor;
     }
 
+#pragma region anderson
+    template<typename Scalar>
+    double NewtonMatrixSolver<Scalar>::anderson_update_solution_return_change_norm(Scalar* linear_system_solution, double damping_factor, bool reused_jacobian)
+    {
+      // A recalculated Jacobian means a different fixed-point map, the history does not belong to it.
+      // Its step starts the new history, and is the plain (damped) Newton step.
+      if (!reused_jacobian)
+        this->anderson_vec_in_memory = 0;
+
+      // Drop the oldest pair if the memory is full.
+      if (this->anderson_vec_in_memory == this->num_last_vectors_used)
+      {
+        Scalar* oldest_iterate = this->anderson_iterates[0];
+        Scalar* oldest_increment = this->anderson_increments[0];
+        for (int i = 0; i < this->num_last_vectors_used - 1; i++)
+        {
+          this->anderson_iterates[i] = this->anderson_iterates[i + 1];
+          this->anderson_increments[i] = this->anderson_increments[i + 1];
+        }
+        this->anderson_iterates[this->num_last_vectors_used - 1] = oldest_iterate;
+        this->anderson_increments[this->num_last_vectors_used - 1] = oldest_increment;
+        this->anderson_vec_in_memory--;
+      }
+
+      // The current iterate (the solution vector before the update) and its increment.
+      int m = this->anderson_vec_in_memory++;
+      Scalar* iterate = this->anderson_iterates[m];
+      Scalar* increment = this->anderson_increments[m];
+      memcpy(iterate, this->sln_vector, this->problem_size * sizeof(Scalar));
+      memcpy(increment, linear_system_solution, this->problem_size * sizeof(Scalar));
+
+      // gamma minimizes || increment - sum_j gamma_j (increments[j + 1] - increments[j]) ||, from the normal equations.
+      Scalar* gamma = nullptr;
+      if (m > 0)
+      {
+        Scalar** mat = new_matrix<Scalar>(m, m);
+        gamma = calloc_with_check<NewtonMatrixSolver<Scalar>, Scalar>(m, this);
+        for (int k = 0; k < this->problem_size; k++)
+        {
+          for (int i = 0; i < m; i++)
+          {
+            Scalar difference_i = conj(this->anderson_increments[i + 1][k] - this->anderson_increments[i][k]);
+            gamma[i] += difference_i * increment[k];
+            for (int j = 0; j <= i; j++)
+              mat[i][j] += difference_i * (this->anderson_increments[j + 1][k] - this->anderson_increments[j][k]);
+          }
+        }
+        for (int i = 0; i < m; i++)
+          for (int j = 0; j < i; j++)
+            mat[j][i] = conj(mat[i][j]);
+
+        int* perm = malloc_with_check<NewtonMatrixSolver<Scalar>, int>(m, this);
+        try
+        {
+          double d;
+          ludcmp(mat, m, perm, &d);
+          lubksb<Scalar>(mat, m, perm, gamma);
+          for (int i = 0; i < m; i++)
+            if (!(std::abs(gamma[i]) < std::numeric_limits<double>::max()))
+              throw Exceptions::Exception("Non-finite Anderson coefficient.");
+        }
+        catch (Exceptions::Exception&)
+        {
+          // Linearly dependent increments, plain step.
+          free_with_check(gamma);
+        }
+        free_with_check(perm);
+        free_with_check(mat, true);
+      }
+
+      // x = x_m + beta f_m - sum_j gamma_j ((x_{j + 1} - x_j) + beta (f_{j + 1} - f_j)).
+      double beta = reused_jacobian ? this->anderson_beta * damping_factor : damping_factor;
+      double solution_change_norm = 0.;
+      for (int k = 0; k < this->problem_size; k++)
+      {
+        Scalar change = beta * increment[k];
+        if (gamma)
+        {
+          for (int j = 0; j < m; j++)
+            change -= gamma[j] * ((this->anderson_iterates[j + 1][k] - this->anderson_iterates[j][k]) + beta * (this->anderson_increments[j + 1][k] - this->anderson_increments[j][k]));
+        }
+        solution_change_norm += std::pow(std::abs(change), 2.);
+        this->sln_vector[k] = iterate[k] + change;
+      }
+      free_with_check(gamma);
+
+      return std::sqrt(solution_change_norm);
+    }
+#pragma endregion
+
+#pragma region jfnk
+    template<typename Scalar>
+    void NewtonMatrixSolver<Scalar>::solve_linear_system()
+    {
+      if (!this->jfnk_is_on || this->constant_jacobian || this->linear_matrix_solver->get_used_reuse_scheme() != HERMES_REUSE_MATRIX_STRUCTURE_COMPLETELY
+        || dynamic_cast<LoopSolver<Scalar>*>(this->linear_matrix_solver))
+      {
+        NonlinearMatrixSolver<Scalar>::solve_linear_system();
+        return;
+      }
+
+      // store the previous solution to previous_sln_vector.
+      memcpy(this->previous_sln_vector, this->sln_vector, sizeof(Scalar)*this->problem_size);
+
+      Scalar* increment = malloc_with_check<NewtonMatrixSolver<Scalar>, Scalar>(this->problem_size, this);
+      this->jfnk_solve(increment);
+
+      // 1. store the solution.
+      double solution_change_norm = this->update_solution_return_change_norm(increment);
+      free_with_check(increment);
+
+      // 2. store the solution change.
+      this->get_parameter_value(this->p_solution_change_norms).push_back(solution_change_norm);
+
+      // 3. store the solution norm.
+      this->get_parameter_value(this->p_solution_norms).push_back(get_l2_norm(this->sln_vector, this->problem_size));
+    }
+
+    template<typename Scalar>
+    void NewtonMatrixSolver<Scalar>::jfnk_solve(Scalar* increment)
+    {
+      int n = this->problem_size;
+      int restart = std::min(this->jfnk_restart, this->jfnk_max_iterations);
+
+      Scalar* residual = malloc_with_check<NewtonMatrixSolver<Scalar>, Scalar>(n, this);
+      this->get_residual()->extract(residual);
+
+      // Krylov basis, Hessenberg matrix, Givens rotations, and the right-hand side of the least squares problem.
+      Scalar** basis = new_matrix<Scalar>(restart + 1, n);
+      Scalar** hessenberg = new_matrix<Scalar>(restart + 1, restart);
+      double* rotation_cos = malloc_with_check<NewtonMatrixSolver<Scalar>, double>(restart, this);
+      Scalar* rotation_sin = malloc_with_check<NewtonMatrixSolver<Scalar>, Scalar>(restart, this);
+      Scalar* g = malloc_with_check<NewtonMatrixSolver<Scalar>, Scalar>(restart + 1, this);
+      Scalar* y = malloc_with_check<NewtonMatrixSolver<Scalar>, Scalar>(restart, this);
+      // The iterate of the right-preconditioned system, the increment is J_0^{-1} of it.
+      Scalar* u = calloc_with_check<NewtonMatrixSolver<Scalar>, Scalar>(n, this);
+      Scalar* work = malloc_with_check<NewtonMatrixSolver<Scalar>, Scalar>(n, this);
+
+      double tolerance = this->jfnk_tolerance * get_l2_norm(residual, n);
+      double residual_norm = 0.;
+      int iterations = 0;
+      bool converged = false;
+      while (true)
+      {
+        // r = R - J J_0^{-1} u.
+        if (iterations == 0)
+          memcpy(basis[0], residual, n * sizeof(Scalar));
+        else
+        {
+          this->jfnk_apply(u, basis[0], residual, work);
+          for (int k = 0; k < n; k++)
+            basis[0][k] = residual[k] - basis[0][k];
+        }
+        residual_norm = get_l2_norm(basis[0], n);
+        if (residual_norm <= tolerance)
+        {
+          converged = true;
+          break;
+        }
+        for (int k = 0; k < n; k++)
+          basis[0][k] /= residual_norm;
+        g[0] = residual_norm;
+
+        int j = 0;
+        while (j < restart && iterations < this->jfnk_max_iterations)
+        {
+          iterations++;
+          this->jfnk_apply(basis[j], basis[j + 1], residual, work);
+
+          // Modified Gram-Schmidt.
+          for (int i = 0; i <= j; i++)
+          {
+            Scalar h = 0.;
+            for (int k = 0; k < n; k++)
+              h += conj(basis[i][k]) * basis[j + 1][k];
+            hessenberg[i][j] = h;
+            for (int k = 0; k < n; k++)
+              basis[j + 1][k] -= h * basis[i][k];
+          }
+          double h_norm = get_l2_norm(basis[j + 1], n);
+          if (h_norm != 0.)
+            for (int k = 0; k < n; k++)
+              basis[j + 1][k] /= h_norm;
+
+          // Previous rotations.
+          for (int i = 0; i < j; i++)
+          {
+            Scalar temp = rotation_cos[i] * hessenberg[i][j] + rotation_sin[i] * hessenberg[i + 1][j];
+            hessenberg[i + 1][j] = -conj(rotation_sin[i]) * hessenberg[i][j] + rotation_cos[i] * hessenberg[i + 1][j];
+            hessenberg[i][j] = temp;
+          }
+
+          // The rotation eliminating the subdiagonal h_norm.
+          double diagonal_abs = std::abs(hessenberg[j][j]);
+          double r = std::sqrt(diagonal_abs * diagonal_abs + h_norm * h_norm);
+          if (r == 0.)
+          {
+            rotation_cos[j] = 1.;
+            rotation_sin[j] = 0.;
+          }
+          else if (diagonal_abs == 0.)
+          {
+            rotation_cos[j] = 0.;
+            rotation_sin[j] = 1.;
+          }
+          else
+          {
+            rotation_cos[j] = diagonal_abs / r;
+            rotation_sin[j] = (hessenberg[j][j] / diagonal_abs) * (h_norm / r);
+          }
+          hessenberg[j][j] = rotation_cos[j] * hessenberg[j][j] + rotation_sin[j] * h_norm;
+          hessenberg[j + 1][j] = 0.;
+          g[j + 1] = -conj(rotation_sin[j]) * g[j];
+          g[j] = rotation_cos[j] * g[j];
+
+          j++;
+          residual_norm = std::abs(g[j]);
+          if (residual_norm <= tolerance)
+          {
+            converged = true;
+            break;
+          }
+        }
+
+        // u += basis y, hessenberg y = g.
+        for (int i = j - 1; i >= 0; i--)
+        {
+          y[i] = g[i];
+          for (int l = i + 1; l < j; l++)
+            y[i] -= hessenberg[i][l] * y[l];
+          y[i] = (hessenberg[i][i] == 0.) ? Scalar(0.) : y[i] / hessenberg[i][i];
+        }
+        for (int l = 0; l < j; l++)
+          for (int k = 0; k < n; k++)
+            u[k] += y[l] * basis[l][k];
+
+        if (converged || iterations >= this->jfnk_max_iterations)
+          break;
+      }
+
+      if (!converged)
+        this->warn("\tNonlinearSolver: GMRES of the Jacobian-free step did not converge in %i iterations, relative residual: %g.", iterations, residual_norm * this->jfnk_tolerance / tolerance);
+      else
+        this->info("\tNonlinearSolver: Jacobian-free step, GMRES iterations: %i.", iterations);
+
+      this->jfnk_precondition(u, increment);
+
+      // Restore the state after the residual assemblings.
+      memcpy(this->sln_vector, this->previous_sln_vector, n * sizeof(Scalar));
+      this->get_residual()->set_vector(residual);
+
+      free_with_check(residual);
+      free_with_check(basis, true);
+      free_with_check(hessenberg, true);
+      free_with_check(rotation_cos);
+      free_with_check(rotation_sin);
+      free_with_check(g);
+      free_with_check(y);
+      free_with_check(u);
+      free_with_check(work);
+    }
+
+    template<typename Scalar>
+    void NewtonMatrixSolver<Scalar>::assemble_jfnk_residual()
+    {
+      this->assemble_residual(false);
+    }
+
+    template<typename Scalar>
+    void NewtonMatrixSolver<Scalar>::jfnk_precondition(const Scalar* v, Scalar* z)
+    {
+      // The reuse scheme is HERMES_REUSE_MATRIX_STRUCTURE_COMPLETELY, the factorization is reused.
+      this->get_residual()->set_vector(const_cast<Scalar*>(v));
+      this->linear_matrix_solver->solve();
+      memcpy(z, this->linear_matrix_solver->get_sln_vector(), this->problem_size * sizeof(Scalar));
+    }
+
+    template<typename Scalar>
+    void NewtonMatrixSolver<Scalar>::jfnk_apply(const Scalar* v, Scalar* Av, const Scalar* residual, Scalar* preconditioned_v)
+    {
+      this->jfnk_precondition(v, preconditioned_v);
+
+      double preconditioned_v_norm = get_l2_norm(preconditioned_v, this->problem_size);
+      if (preconditioned_v_norm == 0.)
+      {
+        memset(Av, 0, this->problem_size * sizeof(Scalar));
+        return;
+      }
+
+      // The finite difference step relative to the size of the iterate.
+      double epsilon = std::sqrt(std::numeric_limits<double>::epsilon()) * (1. + get_l2_norm(this->previous_sln_vector, this->problem_size)) / preconditioned_v_norm;
+      for (int k = 0; k < this->problem_size; k++)
+        this->sln_vector[k] = this->previous_sln_vector[k] + epsilon * preconditioned_v[k];
+      this->assemble_jfnk_residual();
+      this->get_residual()->extract(Av);
+
+      // The residual is -F, J w = (F(x + epsilon w) - F(x)) / epsilon.
+      for (int k = 0; k < this->problem_size; k++)
+        Av[k] = (residual[k] - Av[k]) / epsilon;
+    }
+#pragma endregion
+
     template class HERMES_API NewtonMatrixSolver < double > ;
     template class HERMES_API NewtonMatrixSolver < std::complex<double> > ;
   }
@@ -359,7 +359,7 @@ namespace Hermes
         }
         else
         {
-          double new_damping_factor = (1. / this->auto_damping_ratio) * current_damping_factor;
+          double new_damping_factor = this->get_reduced_damping_factor(current_damping_factor);
           this->warn("\t\tNOT successful, step restarted with factor: %g.", new_damping_factor);
           damping_factors_vector.push_back(new_damping_factor);
         }
@@ -368,6 +368,12 @@ namespace Hermes
       }
     }
 
+    template<typename Scalar>
+    double NonlinearMatrixSolver<Scalar>::get_reduced_damping_factor(double current_damping_factor)
+    {
+      return (1. / this->auto_damping_ratio) * current_damping_factor;
+    }
+
     template<typename Scalar>
     void NonlinearMatrixSolver<Scalar>::deinit_solving()
     {
@@ -542,6 +548,7 @@ namespace Hermes
 
           // Inspect the damping factor.
           this->info("\tNonlinearSolver: Probing the damping factor...");
+          double tried_damping_factor = damping_factors.back();
           try
           {
             // Calculate damping factor, and return whether or not was this a successful step.
@@ -560,14 +567,17 @@ namespace Hermes
             residual_norms.pop_back();
             solution_norms.pop_back();
 
+            // The ratio of the rejected and the new damping factor.
+            double damping_ratio = tried_damping_factor / damping_factors.back();
+
             // Adjust the previous solution change norm.
-            solution_change_norms.back() /= this->auto_damping_ratio;
+            solution_change_norms.back() /= damping_ratio;
 
             // Try with the different damping factor.
             // Important thing here is the factor used that must be calculated from the current one and the previous one.
             // This results in the following relation (since the damping factor is only updated one way).
             for (int i = 0; i < this->problem_size; i++)
-              this->sln_vector[i] = this->previous_sln_vector[i] + (this->sln_vector[i] - this->previous_sln_vector[i]) / this->auto_damping_ratio;
+              this->sln_vector[i] = this->previous_sln_vector[i] + (this->sln_vector[i] - this->previous_sln_vector[i]) / damping_ratio;
 
             // Add new_ solution norm.
             solution_norms.push_back(get_l2_norm(this->sln_vector, this->problem_size));